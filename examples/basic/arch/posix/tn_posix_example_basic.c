@@ -0,0 +1,223 @@
+//
+// main.c
+//
+
+#include <stdio.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "tn.h"
+
+
+//-- kernel ticks (system timer) period, in microseconds
+#define SYS_TMR_PERIOD_US  1000
+
+
+
+//-- idle task stack size, in words
+#define IDLE_TASK_STACK_SIZE          (TN_MIN_STACK_SIZE + 32)
+
+//-- interrupt stack size, in words
+#define INTERRUPT_STACK_SIZE          (TN_MIN_STACK_SIZE + 64)
+
+//-- stack sizes of user tasks
+#define TASK_A_STK_SIZE    (TN_MIN_STACK_SIZE + 1024)
+#define TASK_B_STK_SIZE    (TN_MIN_STACK_SIZE + 1024)
+#define TASK_C_STK_SIZE    (TN_MIN_STACK_SIZE + 1024)
+
+//-- user task priorities
+#define TASK_A_PRIORITY    7
+#define TASK_B_PRIORITY    6
+#define TASK_C_PRIORITY    5
+
+
+
+/*******************************************************************************
+ *    DATA
+ ******************************************************************************/
+
+//-- Allocate arrays for stacks: stack for idle task
+//   and for interrupts are the requirement of the kernel;
+//   others are application-dependent.
+//
+//   We use convenience macro TN_STACK_ARR_DEF() for that.
+
+TN_STACK_ARR_DEF(idle_task_stack, IDLE_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(interrupt_stack, INTERRUPT_STACK_SIZE);
+
+TN_STACK_ARR_DEF(task_a_stack, TASK_A_STK_SIZE);
+TN_STACK_ARR_DEF(task_b_stack, TASK_B_STK_SIZE);
+TN_STACK_ARR_DEF(task_c_stack, TASK_C_STK_SIZE);
+
+
+
+//-- task structures
+
+struct TN_Task task_a;
+struct TN_Task task_b;
+struct TN_Task task_c;
+
+//-- all the tasks run in a single host thread, so printf() should be
+//   protected by the mutex
+struct TN_Mutex printf_mutex;
+
+//-- signalled by the "button" ISR, see usr1_isr()
+struct TN_Sem button_sem;
+
+
+
+/*******************************************************************************
+ *    ISRs
+ ******************************************************************************/
+
+/**
+ * system timer ISR
+ */
+static void tick_isr(void)
+{
+   tn_tick_int_processing();
+}
+
+/**
+ * "Button" ISR: send SIGUSR1 to the process to trigger it, like this:
+ *
+ *    $ kill -USR1 <pid>
+ */
+static void usr1_isr(void)
+{
+   tn_sem_isignal(&button_sem);
+}
+
+
+
+/*******************************************************************************
+ *    FUNCTIONS
+ ******************************************************************************/
+
+static void task_printf(const char *name)
+{
+   tn_mutex_lock(&printf_mutex, TN_WAIT_INFINITE);
+   printf("%s, sys time: %lu\n", name, (unsigned long)tn_sys_time_get());
+   fflush(stdout);
+   tn_mutex_unlock(&printf_mutex);
+}
+
+void appl_init(void);
+
+void task_a_body(void *par)
+{
+   //-- this is a first created application task, so it needs to perform
+   //   all the application initialization.
+   appl_init();
+
+   //-- and then, let's get to the primary job of the task
+   //   (job for which task was created at all)
+   for(;;)
+   {
+      task_printf("task a");
+      tn_task_sleep(500);
+   }
+}
+
+void task_b_body(void *par)
+{
+   for(;;)
+   {
+      task_printf("task b");
+      tn_task_sleep(1000);
+   }
+}
+
+void task_c_body(void *par)
+{
+   for(;;)
+   {
+      tn_sem_wait(&button_sem, TN_WAIT_INFINITE);
+      task_printf("task c: button pressed");
+   }
+}
+
+/**
+ * Application init: called from the first created application task
+ */
+void appl_init(void)
+{
+   tn_mutex_create(&printf_mutex, TN_MUTEX_PROT_INHERIT, 0);
+   tn_sem_create(&button_sem, 0, 1);
+
+   printf("pid: %d, send SIGUSR1 to press the button\n", (int)getpid());
+
+   //-- attach ISRs to signals, and start system timer
+   tn_posix_isr_set(SIGUSR1, usr1_isr);
+   tn_posix_isr_set(SIGALRM, tick_isr);
+   tn_posix_timer_start(SYS_TMR_PERIOD_US);
+
+   //-- create all the rest application tasks
+   tn_task_create(
+         &task_b,
+         task_b_body,
+         TASK_B_PRIORITY,
+         task_b_stack,
+         TASK_B_STK_SIZE,
+         NULL,
+         (TN_TASK_CREATE_OPT_START)
+         );
+
+   tn_task_create(
+         &task_c,
+         task_c_body,
+         TASK_C_PRIORITY,
+         task_c_stack,
+         TASK_C_STK_SIZE,
+         NULL,
+         (TN_TASK_CREATE_OPT_START)
+         );
+}
+
+//-- idle callback that is called periodically from idle task
+void idle_task_callback (void)
+{
+   //-- don't burn host CPU: wait for the next signal (at least, system tick)
+   pause();
+}
+
+//-- create first application task(s)
+void init_task_create(void)
+{
+   //-- task A performs complete application initialization,
+   //   it's the first created application task
+   tn_task_create(
+         &task_a,                   //-- task structure
+         task_a_body,               //-- task body function
+         TASK_A_PRIORITY,           //-- task priority
+         task_a_stack,              //-- task stack
+         TASK_A_STK_SIZE,           //-- task stack size (in words)
+         NULL,                      //-- task function parameter
+         TN_TASK_CREATE_OPT_START   //-- creation option
+         );
+
+}
+
+
+int main(void)
+{
+
+   //-- unconditionally disable interrupts
+   tn_arch_int_dis();
+
+   //-- call to tn_sys_start() never returns
+   tn_sys_start(
+         idle_task_stack,
+         IDLE_TASK_STACK_SIZE,
+         interrupt_stack,
+         INTERRUPT_STACK_SIZE,
+         init_task_create,
+         idle_task_callback
+         );
+
+   //-- unreachable
+   return 1;
+
+}
+
+
@@ -0,0 +1,300 @@
+//
+// main.c
+//
+// Interrupt entry latency benchmark: see readme.txt in the example directory.
+//
+
+#include <stdio.h>
+#include "stm32f4xx.h"
+
+#include "tn.h"
+
+
+//-- system frequency
+#define SYS_FREQ           168000000L
+
+//-- kernel ticks (system timer) frequency
+#define SYS_TMR_FREQ       1000
+
+//-- system timer period (auto-calculated)
+#define SYS_TMR_PERIOD              \
+   (SYS_FREQ / SYS_TMR_FREQ)
+
+
+
+//-- idle task stack size, in words
+#define IDLE_TASK_STACK_SIZE          (TN_MIN_STACK_SIZE + 32)
+
+//-- interrupt stack size, in words
+#define INTERRUPT_STACK_SIZE          (TN_MIN_STACK_SIZE + 64)
+
+//-- stack sizes of user tasks
+#define TASK_FPU_STK_SIZE  (TN_MIN_STACK_SIZE + 128)
+#define TASK_INT_STK_SIZE  (TN_MIN_STACK_SIZE + 128)
+
+//-- user task priorities
+#define TASK_FPU_PRIORITY  6
+#define TASK_INT_PRIORITY  7
+
+//-- interrupt used for the benchmark: it's triggered by software only
+#define BENCH_IRQN         EXTI0_IRQn
+
+//-- how many times interrupt is triggered by each task per round
+#define BENCH_CNT          1000
+
+
+
+/*******************************************************************************
+ *    DATA
+ ******************************************************************************/
+
+TN_STACK_ARR_DEF(idle_task_stack, IDLE_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(interrupt_stack, INTERRUPT_STACK_SIZE);
+
+TN_STACK_ARR_DEF(task_fpu_stack, TASK_FPU_STK_SIZE);
+TN_STACK_ARR_DEF(task_int_stack, TASK_INT_STK_SIZE);
+
+
+
+//-- task structures
+
+struct TN_Task task_fpu;
+struct TN_Task task_int;
+
+//-- results of a single round of measurements
+struct BenchResult {
+   unsigned long min;
+   unsigned long max;
+   unsigned long long sum;
+};
+
+//-- value of the cycle counter at the ISR entry
+static volatile unsigned long isr_entry_cyc;
+
+//-- used by the tasks to keep computation running, so that the compiler
+//   doesn't throw it away
+static volatile float fpu_acc = 1.0f;
+static volatile unsigned long int_acc = 1;
+
+
+
+/*******************************************************************************
+ *    ISRs
+ ******************************************************************************/
+
+/**
+ * system timer ISR
+ */
+void SysTick_Handler(void)
+{
+   tn_tick_int_processing();
+}
+
+/**
+ * Benchmark ISR: just get the cycle counter as soon as possible. It doesn't
+ * use FPU, so, with lazy stacking, FPU registers of the interrupted task
+ * are never saved.
+ */
+void EXTI0_IRQHandler(void)
+{
+   isr_entry_cyc = DWT->CYCCNT;
+}
+
+
+
+/*******************************************************************************
+ *    FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * Needed for STM debug printf
+ */
+int fputc(int c, FILE *stream)
+{
+   return ITM_SendChar(c);
+}
+
+/**
+ * Trigger the benchmark interrupt and return the time (in cycles) from the
+ * trigger until the ISR entry
+ */
+static unsigned long _isr_latency_get(void)
+{
+   unsigned long start_cyc = DWT->CYCCNT;
+
+   NVIC->STIR = BENCH_IRQN;
+   __DSB();
+   __ISB();
+
+   return (isr_entry_cyc - start_cyc);
+}
+
+static void _bench_result_reset(struct BenchResult *res)
+{
+   res->min = 0xffffffff;
+   res->max = 0;
+   res->sum = 0;
+}
+
+static void _bench_result_add(struct BenchResult *res, unsigned long val)
+{
+   if (val < res->min){
+      res->min = val;
+   }
+   if (val > res->max){
+      res->max = val;
+   }
+   res->sum += val;
+}
+
+static void _bench_result_print(
+      const char *name,
+      struct TN_Task *task,
+      const struct BenchResult *res
+      )
+{
+   printf("%s: ISR entry, cycles: min=%lu max=%lu avg=%lu\n",
+         name, res->min, res->max, (unsigned long)(res->sum / BENCH_CNT)
+         );
+
+#if TN_PROFILER && defined(_TN_FPU_CTX_SAVED)
+   {
+      struct TN_TaskTiming timing;
+      tn_task_profiler_timing_get(task, &timing);
+      printf("%s: context switches with FPU registers saved: %lu\n",
+            name, (unsigned long)timing.fpu_ctx_switch_cnt
+            );
+   }
+#endif
+}
+
+void appl_init(void);
+
+void task_fpu_body(void *par)
+{
+   //-- this is a first created application task, so it needs to perform
+   //   all the application initialization.
+   appl_init();
+
+   struct BenchResult res;
+
+   for(;;)
+   {
+      int i;
+      _bench_result_reset(&res);
+
+      for (i = 0; i < BENCH_CNT; i++){
+         //-- use FPU right before the interrupt, so that FPU context
+         //   is certainly active
+         fpu_acc = fpu_acc * 1.0001f + 0.5f;
+
+         _bench_result_add(&res, _isr_latency_get());
+      }
+
+      _bench_result_print("task_fpu", &task_fpu, &res);
+
+      //-- let task_int run its round
+      tn_task_sleep(1000);
+   }
+}
+
+void task_int_body(void *par)
+{
+   struct BenchResult res;
+
+   for(;;)
+   {
+      int i;
+      _bench_result_reset(&res);
+
+      for (i = 0; i < BENCH_CNT; i++){
+         int_acc = int_acc * 3 + 1;
+
+         _bench_result_add(&res, _isr_latency_get());
+      }
+
+      _bench_result_print("task_int", &task_int, &res);
+
+      tn_task_sleep(1000);
+   }
+}
+
+/**
+ * Hardware init: called from main() with interrupts disabled
+ */
+void hw_init(void)
+{
+   //-- init system timer
+   SysTick_Config(SYS_TMR_PERIOD);
+
+   //-- enable cycle counter
+   CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+   DWT->CYCCNT = 0;
+   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+   //-- benchmark interrupt: highest priority, so that it preempts
+   //   the task immediately
+   NVIC_SetPriority(BENCH_IRQN, 0);
+   NVIC_EnableIRQ(BENCH_IRQN);
+}
+
+/**
+ * Application init: called from the first created application task
+ */
+void appl_init(void)
+{
+   tn_task_create(
+         &task_int,
+         task_int_body,
+         TASK_INT_PRIORITY,
+         task_int_stack,
+         TASK_INT_STK_SIZE,
+         NULL,
+         (TN_TASK_CREATE_OPT_START)
+         );
+}
+
+//-- idle callback that is called periodically from idle task
+void idle_task_callback (void)
+{
+}
+
+//-- create first application task(s)
+void init_task_create(void)
+{
+   tn_task_create(
+         &task_fpu,                 //-- task structure
+         task_fpu_body,             //-- task body function
+         TASK_FPU_PRIORITY,         //-- task priority
+         task_fpu_stack,            //-- task stack
+         TASK_FPU_STK_SIZE,         //-- task stack size (in words)
+         NULL,                      //-- task function parameter
+         TN_TASK_CREATE_OPT_START   //-- creation option
+         );
+}
+
+
+int main(void)
+{
+
+   //-- unconditionally disable interrupts
+   tn_arch_int_dis();
+
+   //-- init hardware
+   hw_init();
+
+   //-- call to tn_sys_start() never returns
+   tn_sys_start(
+         idle_task_stack,
+         IDLE_TASK_STACK_SIZE,
+         interrupt_stack,
+         INTERRUPT_STACK_SIZE,
+         init_task_create,
+         idle_task_callback
+         );
+
+   //-- unreachable
+   return 1;
+
+}
+
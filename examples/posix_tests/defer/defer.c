@@ -0,0 +1,332 @@
+/**
+ * \file
+ *
+ * Test of the deferred call queue (`struct TN_Defer`):
+ *
+ * - parameter checks; calls are executed in order, as a batch, once the
+ *   lower-priority service task gets the CPU;
+ * - overflow: calls from the ISR (and from the task) which don't fit are
+ *   dropped with `TN_RC_OVERFLOW`, and the rest are executed;
+ * - wrap-around of the indexes over many calls;
+ * - statistics: number of calls executed and dropped, max depth, max and
+ *   total latency (in nanoseconds on POSIX, since the port provides the
+ *   cycle counter), and reset;
+ * - wakeup race: the call is queued by the ISR right after the service task
+ *   has found the queue empty, but before it goes to wait. The hook of the
+ *   POSIX port (`tn_posix_int_dis_hook_set()`) raises the signal of the ISR
+ *   right before the service task enters the critical section, so the task
+ *   has to find the call by itself;
+ * - deletion discards pending calls.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <signal.h>
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- max number of pending calls
+#define _DEFER_ITEMS_CNT         4
+
+//-- priority of the service task: lower than the main task, so the calls
+//   are executed only when the main task sleeps
+#define _DEFER_PRIORITY          5
+
+//-- number of calls queued by the ISR in the overflow test
+#define _OVERFLOW_CALLS_CNT      (_DEFER_ITEMS_CNT + 2)
+
+//-- number of rounds in the wrap-around test, and calls queued each round
+#define _WRAP_ROUNDS_CNT         50
+#define _WRAP_CALLS_CNT          3
+
+//-- for how long the call waits for the service task in the latency test,
+//   in ticks
+#define _LATENCY_TICKS           3
+
+//-- units of latency per system tick
+#if defined(_TN_CYCLE_CNT_GET)
+#  define _LATENCY_PER_TICK      ((TN_UWord)TT_TICK_PERIOD_US * 1000)
+#else
+#  define _LATENCY_PER_TICK      ((TN_UWord)1)
+#endif
+
+//-- size of the log of executed calls
+#define _LOG_SIZE                256
+
+//-- make the argument of the call from the number
+#define _ARG(n)                  ((void *)(TN_UIntPtr)(n))
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "defer";
+
+static struct TN_Defer _defer;
+TN_DEFER_BUF_DEF(_defer_buf, _DEFER_ITEMS_CNT);
+static TN_UWord _defer_stack[ TT_TASK_STACK_SIZE ] TN_ARCH_STK_ATTR_AFTER;
+
+//-- arguments of the executed calls, in order
+static int _log[ _LOG_SIZE ];
+static volatile int _log_cnt;
+
+//-- first argument and number of calls queued by the ISR, and the results
+static volatile int _isr_arg;
+static volatile int _isr_calls_cnt;
+static volatile enum TN_RCode _isr_rc[ _OVERFLOW_CALLS_CNT ];
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _job(void *arg)
+{
+   TT_CHECK(_log_cnt < _LOG_SIZE);
+   _log[_log_cnt++] = (int)(TN_UIntPtr)arg;
+}
+
+static void _usr1_isr(void)
+{
+   int i;
+
+   for (i = 0; i < _isr_calls_cnt; i++){
+      _isr_rc[i] = tn_defer_icall(&_defer, _job, _ARG(_isr_arg + i));
+   }
+}
+
+/**
+ * Queue `cnt` calls from the ISR, with arguments starting from `arg`
+ */
+static void _isr_calls(int arg, int cnt)
+{
+   _isr_arg = arg;
+   _isr_calls_cnt = cnt;
+   raise(SIGUSR1);
+}
+
+static void _log_reset(void)
+{
+   _log_cnt = 0;
+}
+
+static void _defer_create(void)
+{
+   TT_CHECK(tn_defer_create(
+            &_defer, _defer_buf, _DEFER_ITEMS_CNT,
+            _defer_stack, TT_TASK_STACK_SIZE, _DEFER_PRIORITY
+            ) == TN_RC_OK);
+}
+
+
+
+//-- Order and overflow {{{
+
+static void _overflow_test(void)
+{
+   int i;
+
+   //-- wrong params
+   TT_CHECK(tn_defer_create(
+            &_defer, _defer_buf, _DEFER_ITEMS_CNT,
+            _defer_stack, TT_TASK_STACK_SIZE, _DEFER_PRIORITY
+            ) == TN_RC_WPARAM);
+   TT_CHECK(tn_defer_call(&_defer, TN_NULL, _ARG(0)) == TN_RC_WPARAM);
+   TT_CHECK(tn_defer_icall(&_defer, _job, _ARG(0)) == TN_RC_WCONTEXT);
+
+   //-- once it has run, the service task waits for the calls
+   tn_task_sleep(1);
+   TT_CHECK(_defer.task.task_state == TN_TASK_STATE_WAIT);
+   TT_CHECK(_defer.task.task_wait_reason == TN_WAIT_REASON_DEFER);
+
+   //-- calls from the task are executed in order, when we sleep
+   _log_reset();
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(1)) == TN_RC_OK);
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(2)) == TN_RC_OK);
+   TT_CHECK(_log_cnt == 0);
+   tn_task_sleep(1);
+   TT_CHECK(_log_cnt == 2 && _log[0] == 1 && _log[1] == 2);
+
+   //-- the ISR queues more calls than fit: the rest are dropped
+   _log_reset();
+   _isr_calls(100, _OVERFLOW_CALLS_CNT);
+   for (i = 0; i < _OVERFLOW_CALLS_CNT; i++){
+      TT_CHECK(_isr_rc[i] == ((i < _DEFER_ITEMS_CNT)
+               ? TN_RC_OK : TN_RC_OVERFLOW));
+   }
+
+   //-- the same from the task
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(200)) == TN_RC_OVERFLOW);
+
+   tn_task_sleep(1);
+   TT_CHECK(_log_cnt == _DEFER_ITEMS_CNT);
+   for (i = 0; i < _DEFER_ITEMS_CNT; i++){
+      TT_CHECK(_log[i] == 100 + i);
+   }
+
+   //-- there's room again
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(3)) == TN_RC_OK);
+   tn_task_sleep(1);
+   TT_CHECK(_log_cnt == _DEFER_ITEMS_CNT + 1);
+}
+
+// }}}
+
+//-- Wrap-around {{{
+
+static void _wrap_test(void)
+{
+   int round;
+   int i;
+
+   _log_reset();
+   for (round = 0; round < _WRAP_ROUNDS_CNT; round++){
+      _isr_calls(round * _WRAP_CALLS_CNT, _WRAP_CALLS_CNT);
+      for (i = 0; i < _WRAP_CALLS_CNT; i++){
+         TT_CHECK(_isr_rc[i] == TN_RC_OK);
+      }
+      tn_task_sleep(1);
+   }
+
+   TT_CHECK(_log_cnt == _WRAP_ROUNDS_CNT * _WRAP_CALLS_CNT);
+   for (i = 0; i < _log_cnt; i++){
+      TT_CHECK(_log[i] == i);
+   }
+}
+
+// }}}
+
+//-- Statistics {{{
+
+static void _stat_test(void)
+{
+   struct TN_DeferStat stat;
+   TN_TickCnt start;
+
+   TT_CHECK(tn_defer_stat_get(&_defer, TN_NULL, TN_FALSE) == TN_RC_WPARAM);
+
+   //-- everything since the creation: overflow test and wrap-around test
+   TT_CHECK(tn_defer_stat_get(&_defer, &stat, TN_TRUE) == TN_RC_OK);
+   TT_CHECK(stat.calls_cnt
+         == 2 + _DEFER_ITEMS_CNT + 1 + _WRAP_ROUNDS_CNT * _WRAP_CALLS_CNT);
+   TT_CHECK(stat.overflows_cnt == _OVERFLOW_CALLS_CNT - _DEFER_ITEMS_CNT + 1);
+   TT_CHECK(stat.max_depth == _DEFER_ITEMS_CNT);
+   TT_CHECK(stat.total_latency >= stat.max_latency);
+
+   //-- reset
+   TT_CHECK(tn_defer_stat_get(&_defer, &stat, TN_FALSE) == TN_RC_OK);
+   TT_CHECK(stat.calls_cnt == 0 && stat.overflows_cnt == 0);
+   TT_CHECK(stat.max_depth == 0);
+   TT_CHECK(stat.max_latency == 0 && stat.total_latency == 0);
+
+   //-- the call waits for the service task for a few ticks: max latency
+   //   is at least that. The second call is queued right before we sleep,
+   //   so the total latency is not much more than max.
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(0)) == TN_RC_OK);
+   start = tn_sys_time_get();
+   while (tn_sys_time_get() - start < _LATENCY_TICKS){
+      //-- busy-wait, so that the service task doesn't run
+   }
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(1)) == TN_RC_OK);
+   tn_task_sleep(1);
+
+   TT_CHECK(tn_defer_stat_get(&_defer, &stat, TN_FALSE) == TN_RC_OK);
+   TT_CHECK(stat.calls_cnt == 2 && stat.max_depth == 2);
+   TT_CHECK(stat.max_latency >= (_LATENCY_TICKS - 1) * _LATENCY_PER_TICK);
+   TT_CHECK(stat.max_latency <= (_LATENCY_TICKS + 2) * _LATENCY_PER_TICK);
+   TT_CHECK(stat.total_latency >= stat.max_latency);
+   TT_CHECK(stat.total_latency <= 2 * stat.max_latency);
+}
+
+// }}}
+
+//-- Wakeup race {{{
+
+static void _race_hook(void)
+{
+   //-- we're in the service task, right after it has found the queue
+   //   empty: queue the call from the ISR
+   tn_posix_int_dis_hook_set(TN_NULL);
+   _isr_calls(2, 1);
+}
+
+static void _race_job(void *arg)
+{
+   _job(arg);
+
+   //-- the service task is going to find the queue empty after we return
+   tn_posix_int_dis_hook_set(_race_hook);
+}
+
+static void _race_test(void)
+{
+   _log_reset();
+   TT_CHECK(tn_defer_call(&_defer, _race_job, _ARG(1)) == TN_RC_OK);
+   tn_task_sleep(1);
+
+   //-- the call queued by the ISR is executed, although the service task
+   //   wasn't waiting yet, so the ISR didn't wake it up
+   TT_CHECK(_isr_rc[0] == TN_RC_OK);
+   TT_CHECK(_log_cnt == 2 && _log[0] == 1 && _log[1] == 2);
+   TT_CHECK(_defer.task.task_state == TN_TASK_STATE_WAIT);
+}
+
+// }}}
+
+//-- Deletion {{{
+
+static void _delete_test(void)
+{
+   _log_reset();
+
+   //-- pending calls are discarded
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(1)) == TN_RC_OK);
+   TT_CHECK(tn_defer_delete(&_defer) == TN_RC_OK);
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(2)) == TN_RC_INVALID_OBJ);
+   tn_task_sleep(1);
+   TT_CHECK(_log_cnt == 0);
+
+   //-- and the queue can be created again, empty
+   _defer_create();
+   TT_CHECK(tn_defer_call(&_defer, _job, _ARG(3)) == TN_RC_OK);
+   tn_task_sleep(1);
+   TT_CHECK(_log_cnt == 1 && _log[0] == 3);
+}
+
+// }}}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   tn_posix_isr_set(SIGUSR1, _usr1_isr);
+   _defer_create();
+
+   _overflow_test();
+   _wrap_test();
+   _stat_test();
+   _race_test();
+   _delete_test();
+
+   TT_CHECK(tn_defer_delete(&_defer) == TN_RC_OK);
+}
+
@@ -0,0 +1,512 @@
+/**
+ * \file
+ *
+ * Test of the batch send / receive of the data queue
+ * (`tn_queue_send_multi()`, `tn_queue_receive_multi()` and their ISR
+ * counterparts):
+ *
+ * - partial send and receive without waiting, and connected event group;
+ * - direct handoff of the items to the tasks which wait for them, in the
+ *   order they wait: each waiting task gets one item, and the rest goes to
+ *   the FIFO;
+ * - several tasks wait to send: each slot freed by the batch receive is
+ *   taken by the next waiting sender, and the batch receive gets their
+ *   items as well;
+ * - timeout in the middle of the batch send: `timeout` limits the total
+ *   time of all the waits, and the number of items sent is reported;
+ * - batch send from the ISR (the timer callback) to the waiting task.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- capacity of the queue
+#define _QUEUE_ITEMS_CNT         4
+
+//-- max number of items in a single batch
+#define _BATCH_ITEMS_MAX         16
+
+//-- number of helper tasks
+#define _TASKS_CNT               3
+
+//-- priority of the helper task `n`: all of them are lower than the main
+//   task, so they run only when it sleeps
+#define _TASK_PRIORITY(n)        (5 + (n))
+
+//-- timeout of the batch send which times out in the middle, and the time
+//   after which the main task receives one item from the full queue
+#define _SEND_TMO                20
+#define _SEND_TMO_RECEIVE_AT     5
+
+//-- make the item value from the number
+#define _ITEM(n)                 ((void *)(TN_UIntPtr)(0x100 + (n)))
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+enum _JobType {
+   _JOB_SEND,
+   _JOB_SEND_MULTI,
+   _JOB_RECEIVE,
+   _JOB_RECEIVE_MULTI,
+};
+
+/**
+ * The job which the helper task does once, and its result
+ */
+struct _Job {
+   enum _JobType type;
+   void *items[ _BATCH_ITEMS_MAX ];
+   int items_cnt;
+   TN_TickCnt timeout;
+
+   volatile TN_BOOL done;
+   enum TN_RCode rc;
+   int done_cnt;
+   TN_TickCnt elapsed;
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "dqueue_multi";
+
+static struct TN_Task _tasks[ _TASKS_CNT ];
+static TN_UWord _task_stacks[ _TASKS_CNT ][ TT_TASK_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+static struct _Job _jobs[ _TASKS_CNT ];
+
+static struct TN_DQueue _queue;
+static void *_queue_buf[ _QUEUE_ITEMS_CNT ];
+
+static struct TN_EventGrp _eventgrp;
+
+static struct TN_Timer _timer;
+
+//-- result of the batch send from the timer callback
+static volatile enum TN_RCode _isend_rc;
+static volatile int _isend_cnt;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _task_body(void *par)
+{
+   struct _Job *job = (struct _Job *)par;
+   TN_TickCnt start = tn_sys_time_get();
+
+   switch (job->type){
+      case _JOB_SEND:
+         job->rc = tn_queue_send(&_queue, job->items[0], job->timeout);
+         job->done_cnt = (job->rc == TN_RC_OK) ? 1 : 0;
+         break;
+      case _JOB_SEND_MULTI:
+         job->rc = tn_queue_send_multi(
+               &_queue, job->items, job->items_cnt, &job->done_cnt,
+               job->timeout
+               );
+         break;
+      case _JOB_RECEIVE:
+         job->rc = tn_queue_receive(&_queue, &job->items[0], job->timeout);
+         job->done_cnt = (job->rc == TN_RC_OK) ? 1 : 0;
+         break;
+      case _JOB_RECEIVE_MULTI:
+         job->rc = tn_queue_receive_multi(
+               &_queue, job->items, job->items_cnt, &job->done_cnt,
+               job->timeout
+               );
+         break;
+   }
+
+   job->elapsed = tn_sys_time_get() - start;
+   job->done = TN_TRUE;
+
+   tn_task_sleep(TN_WAIT_INFINITE);
+}
+
+/**
+ * Start the helper task `n` doing the job; the job to send `items_cnt`
+ * items numbered from `first_item`, or to receive up to `items_cnt` items.
+ * The task runs (and, probably, starts waiting) right away.
+ */
+static void _job_start(
+      int n,
+      enum _JobType type,
+      int first_item,
+      int items_cnt,
+      TN_TickCnt timeout
+      )
+{
+   struct _Job *job = &_jobs[n];
+   int i;
+
+   job->type = type;
+   job->items_cnt = items_cnt;
+   job->timeout = timeout;
+   job->done = TN_FALSE;
+   job->rc = TN_RC_INTERNAL;
+   job->done_cnt = -1;
+
+   for (i = 0; i < _BATCH_ITEMS_MAX; i++){
+      job->items[i] = (i < items_cnt) ? _ITEM(first_item + i) : TN_NULL;
+   }
+
+   TT_CHECK(tn_task_create(
+            &_tasks[n], _task_body, _TASK_PRIORITY(n), _task_stacks[n],
+            TT_TASK_STACK_SIZE, job, TN_TASK_CREATE_OPT_START
+            ) == TN_RC_OK);
+
+   //-- let it run
+   tn_task_sleep(1);
+}
+
+static void _job_remove(int n)
+{
+   TT_CHECK(tn_task_terminate(&_tasks[n]) == TN_RC_OK);
+   TT_CHECK(tn_task_delete(&_tasks[n]) == TN_RC_OK);
+}
+
+/**
+ * Check that the job is done with the given result, and, if it is a
+ * receive job, that the items numbered from `first_item` are received.
+ */
+static void _job_check(
+      int n,
+      enum TN_RCode rc,
+      int done_cnt,
+      int first_item
+      )
+{
+   struct _Job *job = &_jobs[n];
+   int i;
+
+   TT_CHECK(job->done);
+   TT_CHECK(job->rc == rc);
+   TT_CHECK(job->done_cnt == done_cnt);
+
+   if (job->type == _JOB_RECEIVE || job->type == _JOB_RECEIVE_MULTI){
+      for (i = 0; i < done_cnt; i++){
+         TT_CHECK(job->items[i] == _ITEM(first_item + i));
+      }
+   }
+}
+
+/**
+ * Receive everything from the queue without waiting, and check that it is
+ * exactly `items_cnt` items numbered from `first_item`.
+ */
+static void _queue_drain_check(int first_item, int items_cnt)
+{
+   void *items[ _BATCH_ITEMS_MAX ];
+   int received_cnt = -1;
+   int i;
+
+   TT_CHECK(tn_queue_receive_multi(
+            &_queue, items, _BATCH_ITEMS_MAX, &received_cnt, 0
+            ) == ((items_cnt > 0) ? TN_RC_OK : TN_RC_TIMEOUT));
+   TT_CHECK(received_cnt == items_cnt);
+
+   for (i = 0; i < items_cnt; i++){
+      TT_CHECK(items[i] == _ITEM(first_item + i));
+   }
+}
+
+static void _items_fill(void **items, int first_item, int items_cnt)
+{
+   int i;
+
+   for (i = 0; i < items_cnt; i++){
+      items[i] = _ITEM(first_item + i);
+   }
+}
+
+static TN_BOOL _flag_is_set(void)
+{
+   return tn_eventgrp_wait_polling(
+         &_eventgrp, 1, TN_EVENTGRP_WMODE_OR, TN_NULL
+         ) == TN_RC_OK;
+}
+
+
+
+//-- Polling {{{
+
+static void _polling_test(void)
+{
+   void *items[ _BATCH_ITEMS_MAX ];
+   int cnt;
+
+   //-- wrong params
+   TT_CHECK(tn_queue_send_multi(&_queue, items, 0, &cnt, 0) == TN_RC_WPARAM);
+   TT_CHECK(tn_queue_send_multi(&_queue, TN_NULL, 1, &cnt, 0)
+         == TN_RC_WPARAM);
+   TT_CHECK(tn_queue_receive_multi(&_queue, items, -1, &cnt, 0)
+         == TN_RC_WPARAM);
+   TT_CHECK(tn_queue_isend_multi_polling(&_queue, items, 1, &cnt)
+         == TN_RC_WCONTEXT);
+   TT_CHECK(tn_queue_ireceive_multi_polling(&_queue, items, 1, &cnt)
+         == TN_RC_WCONTEXT);
+
+   //-- nothing to receive
+   _queue_drain_check(0, 0);
+   TT_CHECK(!_flag_is_set());
+
+   //-- partial send: only the capacity of the queue is sent
+   _items_fill(items, 0, _QUEUE_ITEMS_CNT + 2);
+   cnt = -1;
+   TT_CHECK(tn_queue_send_multi(
+            &_queue, items, _QUEUE_ITEMS_CNT + 2, &cnt, 0
+            ) == TN_RC_TIMEOUT);
+   TT_CHECK(cnt == _QUEUE_ITEMS_CNT);
+   TT_CHECK(_flag_is_set());
+
+   //-- the queue is full: nothing is sent
+   TT_CHECK(tn_queue_send_multi(&_queue, items, 1, &cnt, 0)
+         == TN_RC_TIMEOUT);
+   TT_CHECK(cnt == 0);
+
+   //-- partial receive: the flag stays set while there are items left
+   cnt = -1;
+   TT_CHECK(tn_queue_receive_multi(&_queue, items, 1, &cnt, 0) == TN_RC_OK);
+   TT_CHECK(cnt == 1);
+   TT_CHECK(items[0] == _ITEM(0));
+   TT_CHECK(_flag_is_set());
+
+   //-- the single and batch items go in order
+   TT_CHECK(tn_queue_receive_polling(&_queue, &items[0]) == TN_RC_OK);
+   TT_CHECK(items[0] == _ITEM(1));
+   TT_CHECK(tn_queue_send_polling(&_queue, _ITEM(_QUEUE_ITEMS_CNT))
+         == TN_RC_OK);
+
+   _queue_drain_check(2, _QUEUE_ITEMS_CNT - 1);
+   TT_CHECK(!_flag_is_set());
+
+   //-- p_sent_cnt may be TN_NULL
+   _items_fill(items, 0, 2);
+   TT_CHECK(tn_queue_send_multi(&_queue, items, 2, TN_NULL, 0) == TN_RC_OK);
+   _queue_drain_check(0, 2);
+}
+
+// }}}
+
+//-- Direct handoff to the waiting receivers {{{
+
+static void _handoff_test(void)
+{
+   void *items[ _BATCH_ITEMS_MAX ];
+   int cnt = -1;
+
+   //-- three receivers wait, one of them by the batch receive
+   _job_start(0, _JOB_RECEIVE, 0, 1, TN_WAIT_INFINITE);
+   _job_start(1, _JOB_RECEIVE_MULTI, 0, 3, TN_WAIT_INFINITE);
+   _job_start(2, _JOB_RECEIVE, 0, 1, TN_WAIT_INFINITE);
+
+   //-- each one gets one item, in the order they wait, and the rest goes to
+   //   the FIFO. Receivers are of lower priority, so they haven't run yet.
+   _items_fill(items, 0, 5);
+   TT_CHECK(tn_queue_send_multi(&_queue, items, 5, &cnt, 0) == TN_RC_OK);
+   TT_CHECK(cnt == 5);
+   TT_CHECK(_queue.filled_items_cnt == 2);
+   TT_CHECK(!_jobs[0].done && !_jobs[1].done && !_jobs[2].done);
+
+   tn_task_sleep(1);
+   _job_check(0, TN_RC_OK, 1, 0);
+   _job_check(1, TN_RC_OK, 1, 1);
+   _job_check(2, TN_RC_OK, 1, 2);
+   _queue_drain_check(3, 2);
+
+   _job_remove(0);
+   _job_remove(1);
+   _job_remove(2);
+}
+
+// }}}
+
+//-- Several waiting senders {{{
+
+static void _senders_test(void)
+{
+   void *items[ _BATCH_ITEMS_MAX ];
+   int cnt = -1;
+
+   //-- fill the queue, and let three senders wait: items 10, 20..22, 30
+   _items_fill(items, 0, _QUEUE_ITEMS_CNT);
+   TT_CHECK(tn_queue_send_multi(
+            &_queue, items, _QUEUE_ITEMS_CNT, TN_NULL, 0
+            ) == TN_RC_OK);
+
+   _job_start(0, _JOB_SEND, 10, 1, TN_WAIT_INFINITE);
+   _job_start(1, _JOB_SEND_MULTI, 20, 3, TN_WAIT_INFINITE);
+   _job_start(2, _JOB_SEND, 30, 1, TN_WAIT_INFINITE);
+
+   //-- each slot freed by the batch receive is taken by the next sender,
+   //   so the batch gets the queue contents and the items of all the
+   //   senders, but just the first item of the batch sender
+   TT_CHECK(tn_queue_receive_multi(
+            &_queue, items, _BATCH_ITEMS_MAX, &cnt, 0
+            ) == TN_RC_OK);
+   TT_CHECK(cnt == _QUEUE_ITEMS_CNT + 3);
+   TT_CHECK(items[0] == _ITEM(0));
+   TT_CHECK(items[ _QUEUE_ITEMS_CNT - 1 ] == _ITEM(_QUEUE_ITEMS_CNT - 1));
+   TT_CHECK(items[ _QUEUE_ITEMS_CNT + 0 ] == _ITEM(10));
+   TT_CHECK(items[ _QUEUE_ITEMS_CNT + 1 ] == _ITEM(20));
+   TT_CHECK(items[ _QUEUE_ITEMS_CNT + 2 ] == _ITEM(30));
+   TT_CHECK(!_flag_is_set());
+
+   //-- when the batch sender runs, it sends the rest
+   tn_task_sleep(1);
+   _job_check(0, TN_RC_OK, 1, 0);
+   _job_check(1, TN_RC_OK, 3, 0);
+   _job_check(2, TN_RC_OK, 1, 0);
+   _queue_drain_check(21, 2);
+
+   _job_remove(0);
+   _job_remove(1);
+   _job_remove(2);
+
+   //-- the batch larger than the queue, received by portions of 3 items
+   //   while the sender waits: after each portion, the sender refills the
+   //   queue, and it's done when the rest fits in the queue
+   _job_start(0, _JOB_SEND_MULTI, 0, _BATCH_ITEMS_MAX, TN_WAIT_INFINITE);
+   for (cnt = 0; cnt < _BATCH_ITEMS_MAX - _QUEUE_ITEMS_CNT; cnt += 3){
+      int received_cnt = -1;
+
+      TT_CHECK(!_jobs[0].done);
+      TT_CHECK(tn_queue_receive_multi(
+               &_queue, items, 3, &received_cnt, 0
+               ) == TN_RC_OK);
+      TT_CHECK(received_cnt == 3);
+      TT_CHECK(items[0] == _ITEM(cnt));
+      TT_CHECK(items[1] == _ITEM(cnt + 1));
+      TT_CHECK(items[2] == _ITEM(cnt + 2));
+      tn_task_sleep(1);
+   }
+   _job_check(0, TN_RC_OK, _BATCH_ITEMS_MAX, 0);
+   _queue_drain_check(_BATCH_ITEMS_MAX - _QUEUE_ITEMS_CNT, _QUEUE_ITEMS_CNT);
+   _job_remove(0);
+}
+
+// }}}
+
+//-- Timeout in the middle of the batch send {{{
+
+static void _timeout_test(void)
+{
+   void *item;
+
+   //-- the sender fills the queue and waits
+   _job_start(0, _JOB_SEND_MULTI, 0, _QUEUE_ITEMS_CNT + 3, _SEND_TMO);
+   TT_CHECK(!_jobs[0].done);
+   TT_CHECK(_queue.filled_items_cnt == _QUEUE_ITEMS_CNT);
+
+   //-- after a while, take one item: the sender puts the next one and
+   //   waits again, for the rest of the timeout only
+   tn_task_sleep(_SEND_TMO_RECEIVE_AT - 1);
+   TT_CHECK(tn_queue_receive_polling(&_queue, &item) == TN_RC_OK);
+   TT_CHECK(item == _ITEM(0));
+   tn_task_sleep(1);
+   TT_CHECK(!_jobs[0].done);
+
+   tn_task_sleep(_SEND_TMO);
+   _job_check(0, TN_RC_TIMEOUT, _QUEUE_ITEMS_CNT + 1, 0);
+   TT_CHECK(_jobs[0].elapsed >= _SEND_TMO);
+   TT_CHECK(_jobs[0].elapsed <= _SEND_TMO + 2);
+
+   //-- the item which wasn't sent isn't in the queue
+   _queue_drain_check(1, _QUEUE_ITEMS_CNT);
+   _job_remove(0);
+
+   //-- the batch receive times out as a whole
+   _job_start(0, _JOB_RECEIVE_MULTI, 0, 3, _SEND_TMO);
+   tn_task_sleep(_SEND_TMO + 2);
+   _job_check(0, TN_RC_TIMEOUT, 0, 0);
+   _job_remove(0);
+}
+
+// }}}
+
+//-- Batch send from the ISR {{{
+
+static void _timer_func(struct TN_Timer *timer, void *p_user_data)
+{
+   void *items[3];
+   int cnt = -1;
+
+   (void)timer;
+   (void)p_user_data;
+
+   _items_fill(items, 0, 3);
+   _isend_rc = tn_queue_isend_multi_polling(&_queue, items, 3, &cnt);
+   _isend_cnt = cnt;
+}
+
+static void _isr_test(void)
+{
+   void *items[ _BATCH_ITEMS_MAX ];
+   int cnt = -1;
+
+   //-- the main task waits for the batch, and gets just the first item
+   //   handed over to it; the rest goes to the FIFO
+   _isend_cnt = -1;
+   TT_CHECK(tn_timer_create(&_timer, _timer_func, TN_NULL) == TN_RC_OK);
+   TT_CHECK(tn_timer_start(&_timer, 2) == TN_RC_OK);
+
+   TT_CHECK(tn_queue_receive_multi(
+            &_queue, items, _BATCH_ITEMS_MAX, &cnt, 10
+            ) == TN_RC_OK);
+   TT_CHECK(cnt == 1);
+   TT_CHECK(items[0] == _ITEM(0));
+   TT_CHECK(_isend_rc == TN_RC_OK);
+   TT_CHECK(_isend_cnt == 3);
+   _queue_drain_check(1, 2);
+
+   TT_CHECK(tn_timer_delete(&_timer) == TN_RC_OK);
+}
+
+// }}}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   TT_CHECK(tn_queue_create(&_queue, _queue_buf, _QUEUE_ITEMS_CNT)
+         == TN_RC_OK);
+   TT_CHECK(tn_eventgrp_create(&_eventgrp, 0) == TN_RC_OK);
+   TT_CHECK(tn_queue_eventgrp_connect(&_queue, &_eventgrp, 1) == TN_RC_OK);
+
+   _polling_test();
+   _handoff_test();
+   _senders_test();
+   _timeout_test();
+   _isr_test();
+
+   TT_CHECK(tn_queue_delete(&_queue) == TN_RC_OK);
+   TT_CHECK(tn_eventgrp_delete(&_eventgrp) == TN_RC_OK);
+}
+
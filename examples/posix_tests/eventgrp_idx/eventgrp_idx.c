@@ -0,0 +1,312 @@
+/**
+ * \file
+ *
+ * Test of the per-bit index of waiters of the event group
+ * (`#TN_EVENTGRP_WAIT_INDEX`) with all the flags of the word, including
+ * the ones above 31 on the 64-bit host: the task waiting for the flag(s) is
+ * kept in the list of the flag which isn't set yet, is moved to another list
+ * as the flags are set, and is woken up when its condition is satisfied.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tt.h"
+#include "_tn_list.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- priority of the waiting task
+#define _WAITER_PRIORITY         (TT_MAIN_PRIORITY + 1)
+
+//-- timeout of the waiter, in ticks: it should be woken up way before
+#define _WAIT_TIMEOUT            50
+
+//-- number of words of the wide event group
+#define _WIDE_WORDS_CNT          2
+
+//-- bit of the given flag
+#define _BIT(n)                  ((TN_UWord)1 << (n))
+
+//-- number of flags in the word: all the bits of `TN_UWord` are checked,
+//   not just `TN_INT_WIDTH` of them
+#define _WORD_WIDTH              ((int)sizeof(TN_UWord) * 8)
+
+//-- flags above 31 on the 64-bit host
+#define _FLAG_TOP                (_WORD_WIDTH - 1)
+#define _FLAG_HIGH               (_WORD_WIDTH / 2 + 8)
+#define _FLAG_MID                (_WORD_WIDTH / 2)
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "eventgrp_idx";
+
+static struct TN_Task _waiter;
+TN_STACK_ARR_DEF(_waiter_stack, TT_TASK_STACK_SIZE);
+
+static struct TN_EventGrp _eventgrp;
+static TN_UWord _wide_buf[ _WIDE_WORDS_CNT ];
+
+//-- what the waiter waits for, and what it has got
+static TN_UWord _wait_pattern[ _WIDE_WORDS_CNT ];
+static enum TN_EGrpWaitMode _wait_mode;
+static TN_BOOL _wait_wide;
+static TN_UWord _actual_pattern[ _WIDE_WORDS_CNT ];
+static enum TN_RCode _wait_rc;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _waiter_body(void *par)
+{
+   (void)par;
+
+   if (_wait_wide){
+      _wait_rc = tn_eventgrp_wide_wait(
+            &_eventgrp, _wait_pattern, _wait_mode, _actual_pattern,
+            _WAIT_TIMEOUT
+            );
+   } else {
+      _wait_rc = tn_eventgrp_wait(
+            &_eventgrp, _wait_pattern[0], _wait_mode, _actual_pattern,
+            _WAIT_TIMEOUT
+            );
+   }
+
+   //-- return from the body terminates the task, so it can be activated
+   //   again
+}
+
+static enum TN_TaskState _waiter_state_get(void)
+{
+   enum TN_TaskState state;
+
+   TT_CHECK(tn_task_state_get(&_waiter, &state) == TN_RC_OK);
+   return state;
+}
+
+/**
+ * Start the waiter and let it begin waiting for the flags given in
+ * `_wait_pattern`.
+ */
+static void _waiter_start(enum TN_EGrpWaitMode mode, TN_BOOL wide)
+{
+   _wait_mode = mode;
+   _wait_wide = wide;
+   _wait_rc = TN_RC_INTERNAL;
+   _actual_pattern[0] = _actual_pattern[1] = 0;
+
+   TT_CHECK(tn_task_activate(&_waiter) == TN_RC_OK);
+   tn_task_sleep(1);
+   TT_CHECK(_waiter_state_get() == TN_TASK_STATE_WAIT);
+}
+
+/**
+ * Check that the waiter is waiting in the list of the given flag only.
+ */
+static void _waiter_list_check(int bit_num)
+{
+   TT_CHECK(_waiter_state_get() == TN_TASK_STATE_WAIT);
+   TT_CHECK(_eventgrp.bit_wait_mask == _BIT(bit_num));
+   TT_CHECK(_waiter.task_queue.prev == &_eventgrp.bit_wait_queue[bit_num]);
+   TT_CHECK(_waiter.task_queue.next == &_eventgrp.bit_wait_queue[bit_num]);
+}
+
+/**
+ * Let the waiter (which should be woken up by now) run, and check that it
+ * has got the flags.
+ */
+static void _waiter_woken_check(TN_UWord word0, TN_UWord word1)
+{
+   //-- the waiter is runnable, but the main task has higher priority
+   TT_CHECK(_waiter_state_get() == TN_TASK_STATE_RUNNABLE);
+   tn_task_sleep(1);
+
+   TT_CHECK(_waiter_state_get() == TN_TASK_STATE_DORMANT);
+   TT_CHECK(_wait_rc == TN_RC_OK);
+   TT_CHECK(_actual_pattern[0] == word0);
+   TT_CHECK(_actual_pattern[1] == word1);
+}
+
+/**
+ * Each flag of the word: the waiter is kept in the list of its flag, setting
+ * another flag doesn't wake it up, and setting its flag does.
+ */
+static void _single_flag_test(void)
+{
+   int bit_num;
+
+   for (bit_num = 0; bit_num < _WORD_WIDTH; bit_num++){
+      int other = (bit_num + 1) % _WORD_WIDTH;
+
+      TT_CHECK(tn_eventgrp_create(&_eventgrp, 0) == TN_RC_OK);
+
+      _wait_pattern[0] = _BIT(bit_num);
+      _waiter_start(TN_EVENTGRP_WMODE_AND, TN_FALSE);
+      _waiter_list_check(bit_num);
+
+      TT_CHECK(tn_eventgrp_modify(
+               &_eventgrp, TN_EVENTGRP_OP_SET, _BIT(other)
+               ) == TN_RC_OK);
+      _waiter_list_check(bit_num);
+
+      TT_CHECK(tn_eventgrp_modify(
+               &_eventgrp, TN_EVENTGRP_OP_SET, _BIT(bit_num)
+               ) == TN_RC_OK);
+      _waiter_woken_check(_BIT(bit_num) | _BIT(other), 0);
+      TT_CHECK(_eventgrp.bit_wait_mask == 0);
+
+      TT_CHECK(tn_eventgrp_delete(&_eventgrp) == TN_RC_OK);
+   }
+}
+
+/**
+ * Waiting for all of several high flags: as the flags are set, the waiter
+ * is moved to the list of the lowest flag which isn't set yet.
+ */
+static void _all_flags_test(void)
+{
+   TN_UWord all = _BIT(_FLAG_TOP) | _BIT(_FLAG_HIGH) | _BIT(_FLAG_MID);
+
+   TT_CHECK(tn_eventgrp_create(&_eventgrp, 0) == TN_RC_OK);
+
+   _wait_pattern[0] = all;
+   _waiter_start(TN_EVENTGRP_WMODE_AND | TN_EVENTGRP_WMODE_AUTOCLR, TN_FALSE);
+   _waiter_list_check(_FLAG_MID);
+
+   TT_CHECK(tn_eventgrp_modify(
+            &_eventgrp, TN_EVENTGRP_OP_SET, _BIT(_FLAG_MID)
+            ) == TN_RC_OK);
+   _waiter_list_check(_FLAG_HIGH);
+
+   TT_CHECK(tn_eventgrp_modify(
+            &_eventgrp, TN_EVENTGRP_OP_SET, _BIT(_FLAG_TOP)
+            ) == TN_RC_OK);
+   _waiter_list_check(_FLAG_HIGH);
+
+   TT_CHECK(tn_eventgrp_modify(
+            &_eventgrp, TN_EVENTGRP_OP_SET, _BIT(_FLAG_HIGH) | _BIT(0)
+            ) == TN_RC_OK);
+   _waiter_woken_check(all | _BIT(0), 0);
+
+   //-- auto-clear has cleared the flags the waiter waited for
+   TT_CHECK(_eventgrp.pattern == _BIT(0));
+   TT_CHECK(_eventgrp.bit_wait_mask == 0);
+
+   TT_CHECK(tn_eventgrp_delete(&_eventgrp) == TN_RC_OK);
+}
+
+/**
+ * Waiting for any of several high flags: the waiter is kept in the common
+ * list, and it is woken up by the top flag.
+ */
+static void _any_flag_test(void)
+{
+   TN_UWord any = _BIT(_FLAG_TOP) | _BIT(_FLAG_HIGH);
+
+   TT_CHECK(tn_eventgrp_create(&_eventgrp, _BIT(_FLAG_MID)) == TN_RC_OK);
+
+   _wait_pattern[0] = any;
+   _waiter_start(TN_EVENTGRP_WMODE_OR, TN_FALSE);
+   TT_CHECK(_eventgrp.bit_wait_mask == 0);
+   TT_CHECK(_eventgrp.any_wait_mask == any);
+
+   TT_CHECK(tn_eventgrp_modify(
+            &_eventgrp, TN_EVENTGRP_OP_SET, _BIT(_FLAG_TOP)
+            ) == TN_RC_OK);
+   _waiter_woken_check(_BIT(_FLAG_TOP) | _BIT(_FLAG_MID), 0);
+
+   TT_CHECK(tn_eventgrp_delete(&_eventgrp) == TN_RC_OK);
+}
+
+/**
+ * Wide event group: the index is shared by the words, so the waiter for the
+ * top flags of both words is moved from the list of the top flag of the
+ * first word to the list of the same flag of the second one. The waiter
+ * which times out is removed from the list.
+ */
+static void _wide_test(void)
+{
+   static const TN_UWord top_first[ _WIDE_WORDS_CNT ] = {
+      _BIT(_FLAG_TOP), 0
+   };
+   static const TN_UWord top_second[ _WIDE_WORDS_CNT ] = {
+      0, _BIT(_FLAG_TOP)
+   };
+
+   TT_CHECK(tn_eventgrp_wide_create(
+            &_eventgrp, _wide_buf, _WIDE_WORDS_CNT, TN_NULL
+            ) == TN_RC_OK);
+
+   _wait_pattern[0] = _BIT(_FLAG_TOP);
+   _wait_pattern[1] = _BIT(_FLAG_TOP);
+   _waiter_start(TN_EVENTGRP_WMODE_AND, TN_TRUE);
+   _waiter_list_check(_FLAG_TOP);
+
+   TT_CHECK(tn_eventgrp_wide_modify(
+            &_eventgrp, TN_EVENTGRP_OP_SET, top_first
+            ) == TN_RC_OK);
+   _waiter_list_check(_FLAG_TOP);
+
+   TT_CHECK(tn_eventgrp_wide_modify(
+            &_eventgrp, TN_EVENTGRP_OP_SET, top_second
+            ) == TN_RC_OK);
+   _waiter_woken_check(_BIT(_FLAG_TOP), _BIT(_FLAG_TOP));
+
+   //-- the waiter for the flag which is never set times out
+   _wait_pattern[0] = 0;
+   _wait_pattern[1] = _BIT(_FLAG_HIGH);
+   TT_CHECK(tn_eventgrp_wide_modify(
+            &_eventgrp, TN_EVENTGRP_OP_CLEAR, top_second
+            ) == TN_RC_OK);
+   _waiter_start(TN_EVENTGRP_WMODE_AND, TN_TRUE);
+   _waiter_list_check(_FLAG_HIGH);
+
+   tn_task_sleep(_WAIT_TIMEOUT);
+   TT_CHECK(_waiter_state_get() == TN_TASK_STATE_DORMANT);
+   TT_CHECK(_wait_rc == TN_RC_TIMEOUT);
+   TT_CHECK(_tn_list_is_empty(&_eventgrp.bit_wait_queue[_FLAG_HIGH]));
+
+   TT_CHECK(tn_eventgrp_delete(&_eventgrp) == TN_RC_OK);
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   TT_CHECK(tn_task_create(
+            &_waiter,
+            _waiter_body,
+            _WAITER_PRIORITY,
+            _waiter_stack,
+            TT_TASK_STACK_SIZE,
+            TN_NULL,
+            0
+            ) == TN_RC_OK);
+
+   _single_flag_test();
+   _all_flags_test();
+   _any_flag_test();
+   _wide_test();
+}
+
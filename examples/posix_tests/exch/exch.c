@@ -0,0 +1,449 @@
+/**
+ * \file
+ *
+ * Test of the exchange object (`tn_exch.h`) and its links: reads and writes
+ * from task and ISR, notification of all the link types, failing links,
+ * connecting and disconnecting links, and consistency of the lock-free
+ * reads while the data is being written from the timer.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <signal.h>
+#include <string.h>
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- number of words in the exchange data
+#define _DATA_WORDS_CNT          4
+
+//-- number of blocks in the memory pool used by the queue link
+#define _FMEM_BLOCKS_CNT         2
+
+//-- number of items in the queues used by the queue links
+#define _QUEUE_ITEMS_CNT         4
+
+//-- flags set by the event group link
+#define _EGRP_PATTERN            (1 << 3)
+
+//-- number of words in the exchange data of the consistency test: large
+//   enough for the reader to be interrupted in the middle of the copy
+#define _BIG_WORDS_CNT           256
+
+//-- duration of the consistency test, in ticks
+#define _BIG_TEST_TICKS          300
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+struct _Data {
+   TN_UWord data[ _DATA_WORDS_CNT ];
+};
+
+struct _BigData {
+   TN_UWord data[ _BIG_WORDS_CNT ];
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "exch";
+
+static struct TN_Exch _exch;
+TN_EXCH_DATA_BUF_DEF(_exch_buf, struct _Data);
+
+//-- exchange with the data which fits in a pointer, for the queue link
+//   without memory pool
+static struct TN_Exch _exch_word;
+TN_EXCH_DATA_BUF_DEF(_exch_word_buf, TN_UWord);
+
+static struct TN_Exch _exch_big;
+TN_EXCH_DATA_BUF_DEF(_exch_big_buf, struct _BigData);
+
+static struct TN_FMem _fmem;
+TN_FMEM_BUF_DEF(_fmem_buf, struct _Data, _FMEM_BLOCKS_CNT);
+
+static struct TN_DQueue _queue;
+static void *_queue_buf[ _QUEUE_ITEMS_CNT ];
+
+static struct TN_DQueue _queue_word;
+static void *_queue_word_buf[ _QUEUE_ITEMS_CNT ];
+
+static struct TN_EventGrp _eventgrp;
+
+static struct TN_ExchLinkQueue _link_queue;
+static struct TN_ExchLinkQueue _link_queue_word;
+static struct TN_ExchLinkEventGrp _link_eventgrp;
+static struct TN_ExchLinkCallback _link_callback;
+
+//-- what the callback link has got
+static int _cb_cnt;
+static struct _Data _cb_data;
+static void *_cb_user_data;
+static TN_BOOL _cb_in_isr;
+
+//-- data written by the ISR, and the return code
+static struct _Data _isr_data;
+static enum TN_RCode _isr_rc;
+
+//-- timer which writes `_exch_big` each tick
+static struct TN_Timer _timer;
+static TN_UWord _big_cnt;
+
+
+
+/*******************************************************************************
+ *    ISRs
+ ******************************************************************************/
+
+static void _usr1_isr(void)
+{
+   _isr_rc = tn_exch_write(&_exch, &_isr_data);
+}
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _data_fill(struct _Data *data, TN_UWord val)
+{
+   int i;
+
+   for (i = 0; i < _DATA_WORDS_CNT; i++){
+      data->data[i] = val + i;
+   }
+}
+
+static void _callback(
+      struct TN_Exch   *exch,
+      void             *data,
+      unsigned int      size,
+      void             *p_user_data
+      )
+{
+   TT_CHECK(exch == &_exch);
+   TT_CHECK(size == sizeof(struct _Data));
+
+   memcpy(&_cb_data, data, size);
+   _cb_user_data = p_user_data;
+   _cb_in_isr = !tn_is_task_context();
+   _cb_cnt++;
+}
+
+static void _timer_func(struct TN_Timer *timer, void *p_user_data)
+{
+   struct _BigData data;
+   int i;
+
+   (void)p_user_data;
+
+   _big_cnt++;
+   for (i = 0; i < _BIG_WORDS_CNT; i++){
+      data.data[i] = _big_cnt;
+   }
+
+   tn_exch_write(&_exch_big, &data);
+   tn_timer_start(timer, 1);
+}
+
+/**
+ * Wrong params, and initial contents of the buffer.
+ */
+static void _create_test(void)
+{
+   struct _Data data;
+
+   TT_CHECK(tn_exch_create(&_exch, _exch_buf, 3) == TN_RC_WPARAM);
+   TT_CHECK(tn_exch_create(
+            &_exch, (char *)_exch_buf + 1, sizeof(_exch_buf)
+            ) == TN_RC_WPARAM);
+   TT_CHECK(tn_exch_read(&_exch, &data) == TN_RC_INVALID_OBJ);
+
+   _data_fill((struct _Data *)_exch_buf, 100);
+   TT_CHECK(tn_exch_create(&_exch, _exch_buf, sizeof(_exch_buf)) == TN_RC_OK);
+   TT_CHECK(tn_exch_create(
+            &_exch, _exch_buf, sizeof(_exch_buf)
+            ) == TN_RC_WPARAM);
+
+   TT_CHECK(tn_exch_read(&_exch, &data) == TN_RC_OK);
+   TT_CHECK(data.data[0] == 100 && data.data[_DATA_WORDS_CNT - 1] == 103);
+
+   TT_CHECK(tn_exch_read(&_exch, TN_NULL) == TN_RC_WPARAM);
+   TT_CHECK(tn_exch_write(&_exch, TN_NULL) == TN_RC_WPARAM);
+}
+
+/**
+ * All the link types are notified by the write from task and from ISR.
+ */
+static void _links_test(void)
+{
+   struct _Data data;
+   struct _Data *p_msg;
+   TN_UWord flags;
+
+   TT_CHECK(tn_fmem_create(
+            &_fmem, _fmem_buf, TN_MAKE_ALIG_SIZE(sizeof(struct _Data)),
+            _FMEM_BLOCKS_CNT
+            ) == TN_RC_OK);
+   TT_CHECK(tn_queue_create(&_queue, _queue_buf, _QUEUE_ITEMS_CNT)
+         == TN_RC_OK);
+   TT_CHECK(tn_eventgrp_create(&_eventgrp, 0) == TN_RC_OK);
+
+   TT_CHECK(tn_exch_link_queue_create(&_link_queue, &_queue, &_fmem)
+         == TN_RC_OK);
+   TT_CHECK(tn_exch_link_eventgrp_create(
+            &_link_eventgrp, &_eventgrp, _EGRP_PATTERN
+            ) == TN_RC_OK);
+   TT_CHECK(tn_exch_link_callback_create(&_link_callback, _callback, &_cb_cnt)
+         == TN_RC_OK);
+
+   TT_CHECK(tn_exch_link_add(
+            &_exch, tn_exch_link_queue_base_get(&_link_queue)
+            ) == TN_RC_OK);
+   TT_CHECK(tn_exch_link_add(
+            &_exch, tn_exch_link_eventgrp_base_get(&_link_eventgrp)
+            ) == TN_RC_OK);
+   TT_CHECK(tn_exch_link_add(
+            &_exch, tn_exch_link_callback_base_get(&_link_callback)
+            ) == TN_RC_OK);
+
+   //-- write from task
+   _data_fill(&data, 200);
+   TT_CHECK(tn_exch_write(&_exch, &data) == TN_RC_OK);
+
+   TT_CHECK(tn_queue_receive_polling(&_queue, (void **)&p_msg) == TN_RC_OK);
+   TT_CHECK(memcmp(p_msg, &data, sizeof(data)) == 0);
+   TT_CHECK(tn_fmem_release(&_fmem, p_msg) == TN_RC_OK);
+
+   TT_CHECK(tn_eventgrp_wait_polling(
+            &_eventgrp, _EGRP_PATTERN,
+            TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AUTOCLR, &flags
+            ) == TN_RC_OK);
+
+   TT_CHECK(_cb_cnt == 1 && !_cb_in_isr && _cb_user_data == &_cb_cnt);
+   TT_CHECK(memcmp(&_cb_data, &data, sizeof(data)) == 0);
+
+   //-- write from ISR
+   _data_fill(&_isr_data, 300);
+   tn_posix_isr_set(SIGUSR1, _usr1_isr);
+   raise(SIGUSR1);
+   TT_CHECK(_isr_rc == TN_RC_OK);
+
+   TT_CHECK(tn_exch_read(&_exch, &data) == TN_RC_OK);
+   TT_CHECK(memcmp(&data, &_isr_data, sizeof(data)) == 0);
+
+   TT_CHECK(tn_queue_receive_polling(&_queue, (void **)&p_msg) == TN_RC_OK);
+   TT_CHECK(memcmp(p_msg, &_isr_data, sizeof(data)) == 0);
+   TT_CHECK(tn_fmem_release(&_fmem, p_msg) == TN_RC_OK);
+
+   TT_CHECK(tn_eventgrp_wait_polling(
+            &_eventgrp, _EGRP_PATTERN,
+            TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AUTOCLR, &flags
+            ) == TN_RC_OK);
+
+   TT_CHECK(_cb_cnt == 2 && _cb_in_isr);
+   TT_CHECK(memcmp(&_cb_data, &_isr_data, sizeof(data)) == 0);
+}
+
+/**
+ * When the memory pool of the queue link is exhausted, the write returns
+ * the error, but the data is written and other links are notified anyway.
+ */
+static void _link_fail_test(void)
+{
+   struct _Data data;
+   struct _Data *p_msg;
+   int i;
+
+   for (i = 0; i < _FMEM_BLOCKS_CNT; i++){
+      _data_fill(&data, 400 + i);
+      TT_CHECK(tn_exch_write(&_exch, &data) == TN_RC_OK);
+   }
+   TT_CHECK(tn_fmem_free_blocks_cnt_get(&_fmem) == 0);
+
+   _cb_cnt = 0;
+   _data_fill(&data, 500);
+   TT_CHECK(tn_exch_write(&_exch, &data) == TN_RC_TIMEOUT);
+   TT_CHECK(_cb_cnt == 1);
+   TT_CHECK(memcmp(&_cb_data, &data, sizeof(data)) == 0);
+   TT_CHECK(tn_exch_read(&_exch, &data) == TN_RC_OK);
+   TT_CHECK(data.data[0] == 500);
+
+   //-- messages which were sent are intact
+   for (i = 0; i < _FMEM_BLOCKS_CNT; i++){
+      TT_CHECK(tn_queue_receive_polling(&_queue, (void **)&p_msg)
+            == TN_RC_OK);
+      TT_CHECK(p_msg->data[0] == (TN_UWord)(400 + i));
+      TT_CHECK(tn_fmem_release(&_fmem, p_msg) == TN_RC_OK);
+   }
+   TT_CHECK(tn_queue_receive_polling(&_queue, (void **)&p_msg)
+         == TN_RC_TIMEOUT);
+   TT_CHECK(tn_fmem_free_blocks_cnt_get(&_fmem) == _FMEM_BLOCKS_CNT);
+}
+
+/**
+ * Queue link without memory pool: the data is sent by value.
+ */
+static void _link_by_value_test(void)
+{
+   TN_UWord val = 0x12345678;
+   void *p_msg;
+
+   TT_CHECK(tn_exch_create(
+            &_exch_word, _exch_word_buf, sizeof(_exch_word_buf)
+            ) == TN_RC_OK);
+   TT_CHECK(tn_queue_create(&_queue_word, _queue_word_buf, _QUEUE_ITEMS_CNT)
+         == TN_RC_OK);
+   TT_CHECK(tn_exch_link_queue_create(&_link_queue_word, &_queue_word, TN_NULL)
+         == TN_RC_OK);
+   TT_CHECK(tn_exch_link_add(
+            &_exch_word, tn_exch_link_queue_base_get(&_link_queue_word)
+            ) == TN_RC_OK);
+
+   TT_CHECK(tn_exch_write(&_exch_word, &val) == TN_RC_OK);
+   TT_CHECK(tn_queue_receive_polling(&_queue_word, &p_msg) == TN_RC_OK);
+   TT_CHECK((TN_UWord)p_msg == val);
+
+   //-- the link can't be connected to the other exchange while connected
+   TT_CHECK(tn_exch_link_add(
+            &_exch, tn_exch_link_queue_base_get(&_link_queue_word)
+            ) == TN_RC_ILLEGAL_USE);
+   TT_CHECK(tn_exch_link_remove(
+            &_exch, tn_exch_link_queue_base_get(&_link_queue_word)
+            ) == TN_RC_ILLEGAL_USE);
+
+   //-- deleting the link disconnects it
+   TT_CHECK(tn_exch_link_queue_delete(&_link_queue_word) == TN_RC_OK);
+   TT_CHECK(tn_exch_write(&_exch_word, &val) == TN_RC_OK);
+   TT_CHECK(tn_queue_receive_polling(&_queue_word, &p_msg) == TN_RC_TIMEOUT);
+}
+
+/**
+ * Disconnected links are not notified anymore; deleting the exchange
+ * disconnects all the links, so they can be connected again.
+ */
+static void _link_remove_test(void)
+{
+   struct _Data data;
+   void *p_msg;
+   TN_UWord flags;
+
+   TT_CHECK(tn_exch_link_remove(
+            &_exch, tn_exch_link_queue_base_get(&_link_queue)
+            ) == TN_RC_OK);
+   TT_CHECK(tn_exch_link_remove(
+            &_exch, tn_exch_link_queue_base_get(&_link_queue)
+            ) == TN_RC_ILLEGAL_USE);
+
+   _cb_cnt = 0;
+   _data_fill(&data, 600);
+   TT_CHECK(tn_exch_write(&_exch, &data) == TN_RC_OK);
+   TT_CHECK(tn_queue_receive_polling(&_queue, &p_msg) == TN_RC_TIMEOUT);
+   TT_CHECK(_cb_cnt == 1);
+
+   TT_CHECK(tn_exch_delete(&_exch) == TN_RC_OK);
+   TT_CHECK(tn_exch_write(&_exch, &data) == TN_RC_INVALID_OBJ);
+
+   TT_CHECK(tn_exch_create(&_exch, _exch_buf, sizeof(_exch_buf)) == TN_RC_OK);
+   TT_CHECK(tn_exch_link_add(
+            &_exch, tn_exch_link_eventgrp_base_get(&_link_eventgrp)
+            ) == TN_RC_OK);
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_CLEAR, ~0)
+         == TN_RC_OK);
+
+   _cb_cnt = 0;
+   TT_CHECK(tn_exch_write(&_exch, &data) == TN_RC_OK);
+   TT_CHECK(_cb_cnt == 0);
+   TT_CHECK(tn_eventgrp_wait_polling(
+            &_eventgrp, _EGRP_PATTERN, TN_EVENTGRP_WMODE_OR, &flags
+            ) == TN_RC_OK);
+
+   TT_CHECK(tn_exch_link_eventgrp_delete(&_link_eventgrp) == TN_RC_OK);
+   TT_CHECK(tn_exch_link_callback_delete(&_link_callback) == TN_RC_OK);
+   TT_CHECK(tn_exch_link_queue_delete(&_link_queue) == TN_RC_OK);
+}
+
+/**
+ * The task reads the large exchange data in a loop, while the timer writes
+ * it each tick: each read should get all the words written by the same
+ * write, and the values should never go back.
+ */
+static void _consistency_test(void)
+{
+   static struct _BigData data;
+   TN_UWord prev = 0;
+   TN_UWord changes = 0;
+   unsigned long reads = 0;
+   TN_TickCnt start;
+   int i;
+
+   TT_CHECK(tn_exch_create(
+            &_exch_big, _exch_big_buf, sizeof(_exch_big_buf)
+            ) == TN_RC_OK);
+   TT_CHECK(tn_timer_create(&_timer, _timer_func, TN_NULL) == TN_RC_OK);
+   TT_CHECK(tn_timer_start(&_timer, 1) == TN_RC_OK);
+
+   start = tn_sys_time_get();
+   while (tn_sys_time_get() - start < _BIG_TEST_TICKS){
+      TT_CHECK(tn_exch_read(&_exch_big, &data) == TN_RC_OK);
+      reads++;
+
+      for (i = 1; i < _BIG_WORDS_CNT; i++){
+         if (data.data[i] != data.data[0]){
+            tt_msg("torn read: word %d is %lu, word 0 is %lu",
+                  i, (unsigned long)data.data[i],
+                  (unsigned long)data.data[0]);
+            TT_CHECK(0);
+         }
+      }
+
+      TT_CHECK(data.data[0] >= prev);
+      if (data.data[0] != prev){
+         changes++;
+         prev = data.data[0];
+      }
+   }
+
+   TT_CHECK(tn_timer_cancel(&_timer) == TN_RC_OK);
+   tt_msg("%lu reads, %lu different values", reads, (unsigned long)changes);
+
+   //-- the timer did write while the task was reading
+   TT_CHECK(changes > _BIG_TEST_TICKS / 2);
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   _create_test();
+   _links_test();
+   _link_fail_test();
+   _link_by_value_test();
+   _link_remove_test();
+   _consistency_test();
+}
+
@@ -0,0 +1,671 @@
+/**
+ * \file
+ *
+ * Test of the lock-free fast paths (`#TN_FAST_PATH`) of semaphores, event
+ * groups and mutexes, on the emulated exclusive access of the POSIX port.
+ *
+ * The hook of the emulated exclusive store (see
+ * `tn_posix_excl_store_hook_set()`) counts the stores, so that we know
+ * whether the fast path was taken, and, when armed, raises `SIGUSR1` right
+ * between the exclusive load and store: the ISR modifies the object or
+ * wakes up the high-priority task which does it, and the store fails.
+ *
+ * Mutex scenarios are performed by two worker tasks: the low-priority one
+ * locks and unlocks the mutex, and the high-priority one is started by the
+ * ISR in the middle of that.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <signal.h>
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- priorities of the worker tasks
+#define _HIGH_PRIORITY           2
+#define _LOW_PRIORITY            4
+
+//-- how long the main task waits for the worker to complete its job, in
+//   ticks: it takes much less than that, unless the job is stuck
+#define _DONE_TIMEOUT            100
+
+//-- how long the high-priority worker sleeps to let the low-priority one
+//   run, in ticks
+#define _LET_LOW_RUN_TICKS       2
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+typedef void (_WorkerFunc)(void);
+
+/**
+ * Worker task: it runs `func` each time `start_sem` is signalled, and then
+ * signals `done_sem`.
+ */
+struct _Worker {
+   struct TN_Task task;
+   struct TN_Sem start_sem;
+   struct TN_Sem done_sem;
+   _WorkerFunc *volatile func;
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "fast_path";
+
+static struct _Worker _high;
+static struct _Worker _low;
+TN_STACK_ARR_DEF(_high_stack, TT_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(_low_stack, TT_TASK_STACK_SIZE);
+
+static struct TN_Sem _sem;
+static struct TN_EventGrp _eventgrp;
+static struct TN_Mutex _mutex;
+
+//-- number of emulated exclusive stores
+static volatile int _stores_cnt;
+
+//-- if set, the next exclusive store raises `SIGUSR1` before it is
+//   performed
+static volatile TN_BOOL _preempt_armed;
+
+//-- job of `SIGUSR1` ISR
+static _WorkerFunc *volatile _isr_func;
+
+//-- set by the high-priority worker when it has seen what it expected
+//   inside the window between exclusive load and store of the low-priority
+//   one
+static volatile TN_BOOL _window_seen;
+
+
+
+/*******************************************************************************
+ *    ISRs
+ ******************************************************************************/
+
+static void _usr1_isr(void)
+{
+   _isr_func();
+}
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _excl_store_hook(void)
+{
+   _stores_cnt++;
+
+   if (_preempt_armed){
+      _preempt_armed = TN_FALSE;
+      raise(SIGUSR1);
+   }
+}
+
+static void _worker_body(void *par)
+{
+   struct _Worker *worker = (struct _Worker *)par;
+
+   for (;;){
+      TT_CHECK(tn_sem_wait(&worker->start_sem, TN_WAIT_INFINITE) == TN_RC_OK);
+      worker->func();
+      TT_CHECK(tn_sem_signal(&worker->done_sem) == TN_RC_OK);
+   }
+}
+
+static void _worker_create(struct _Worker *worker, int priority,
+      TN_UWord *stack)
+{
+   TT_CHECK(tn_sem_create(&worker->start_sem, 0, 1) == TN_RC_OK);
+   TT_CHECK(tn_sem_create(&worker->done_sem, 0, 1) == TN_RC_OK);
+   TT_CHECK(tn_task_create(
+            &worker->task,
+            _worker_body,
+            priority,
+            stack,
+            TT_TASK_STACK_SIZE,
+            worker,
+            TN_TASK_CREATE_OPT_START
+            ) == TN_RC_OK);
+}
+
+//-- make the worker run `func`: called from task or ISR
+static void _worker_start(struct _Worker *worker, _WorkerFunc *func)
+{
+   worker->func = func;
+
+   if (tn_is_task_context()){
+      TT_CHECK(tn_sem_signal(&worker->start_sem) == TN_RC_OK);
+   } else {
+      TT_CHECK(tn_sem_isignal(&worker->start_sem) == TN_RC_OK);
+   }
+}
+
+static void _worker_done_wait(struct _Worker *worker)
+{
+   TT_CHECK(tn_sem_wait(&worker->done_sem, _DONE_TIMEOUT) == TN_RC_OK);
+}
+
+//-- the worker was terminated in the middle of the job: make it ready for
+//   the next one
+static void _worker_restart(struct _Worker *worker)
+{
+   TT_CHECK(worker->task.task_state == TN_TASK_STATE_DORMANT);
+   TT_CHECK(tn_task_activate(&worker->task) == TN_RC_OK);
+}
+
+static TN_BOOL _task_holds_no_mutexes(struct TN_Task *task)
+{
+   return (1
+         && task->fast_mutex == TN_NULL
+         && task->mutex_queue.next == &task->mutex_queue
+         );
+}
+
+static void _mutex_free_check(void)
+{
+   TT_CHECK(_mutex.holder == TN_NULL);
+   TT_CHECK(_mutex.cnt == 0);
+   TT_CHECK(_task_holds_no_mutexes(&_low.task));
+   TT_CHECK(_task_holds_no_mutexes(&_high.task));
+}
+
+
+
+//-- Semaphore {{{
+
+static void _sem_isignal(void)
+{
+   TT_CHECK(tn_sem_isignal(&_sem) == TN_RC_OK);
+}
+
+static void _sem_iwait(void)
+{
+   TT_CHECK(tn_sem_iwait_polling(&_sem) == TN_RC_OK);
+}
+
+static void _sem_test(void)
+{
+   int stores_cnt;
+
+   TT_CHECK(tn_sem_create(&_sem, 0, 5) == TN_RC_OK);
+
+   //-- uncontended: fast path
+   stores_cnt = _stores_cnt;
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+   TT_CHECK(_sem.count == 1);
+   TT_CHECK(tn_sem_wait_polling(&_sem) == TN_RC_OK);
+   TT_CHECK(_sem.count == 0);
+   TT_CHECK(_stores_cnt == stores_cnt + 2);
+
+   //-- nothing to take, and at maximum: usual path
+   stores_cnt = _stores_cnt;
+   TT_CHECK(tn_sem_wait_polling(&_sem) == TN_RC_TIMEOUT);
+   _sem.count = 5;
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OVERFLOW);
+   _sem.count = 0;
+   TT_CHECK(_stores_cnt == stores_cnt);
+
+   //-- signal preempted by ISR which signals the same semaphore: the store
+   //   fails and the count is loaded again, so neither signal is lost
+   stores_cnt = _stores_cnt;
+   _isr_func = _sem_isignal;
+   _preempt_armed = TN_TRUE;
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+   TT_CHECK(_sem.count == 2);
+   TT_CHECK(_stores_cnt == stores_cnt + 3);
+
+   //-- the same for waiting
+   stores_cnt = _stores_cnt;
+   _isr_func = _sem_iwait;
+   _preempt_armed = TN_TRUE;
+   TT_CHECK(tn_sem_wait_polling(&_sem) == TN_RC_OK);
+   TT_CHECK(_sem.count == 0);
+   TT_CHECK(_stores_cnt == stores_cnt + 3);
+
+   TT_CHECK(tn_sem_delete(&_sem) == TN_RC_OK);
+}
+
+// }}}
+
+//-- Event group {{{
+
+static void _eventgrp_iset(void)
+{
+   TT_CHECK(tn_eventgrp_imodify(&_eventgrp, TN_EVENTGRP_OP_SET, 0x2)
+         == TN_RC_OK);
+}
+
+static void _eventgrp_test(void)
+{
+   int stores_cnt;
+
+   TT_CHECK(tn_eventgrp_create(&_eventgrp, 0) == TN_RC_OK);
+
+   //-- nobody waits: fast path
+   stores_cnt = _stores_cnt;
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_SET, 0x9)
+         == TN_RC_OK);
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_CLEAR, 0x8)
+         == TN_RC_OK);
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_TOGGLE, 0x3)
+         == TN_RC_OK);
+   TT_CHECK(_eventgrp.pattern == 0x2);
+   TT_CHECK(_stores_cnt == stores_cnt + 3);
+
+   //-- modification preempted by ISR which modifies the same word: no
+   //   flags are lost
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_CLEAR, 0x2)
+         == TN_RC_OK);
+   stores_cnt = _stores_cnt;
+   _isr_func = _eventgrp_iset;
+   _preempt_armed = TN_TRUE;
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_SET, 0x4)
+         == TN_RC_OK);
+   TT_CHECK(_eventgrp.pattern == 0x6);
+   TT_CHECK(_stores_cnt == stores_cnt + 3);
+
+   TT_CHECK(tn_eventgrp_delete(&_eventgrp) == TN_RC_OK);
+}
+
+// }}}
+
+//-- Mutex: uncontended and contended {{{
+
+static void _high_lock_unlock(void)
+{
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_mutex.holder == &_high.task);
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+}
+
+static void _high_start_lock_unlock(void)
+{
+   _worker_start(&_high, _high_lock_unlock);
+}
+
+/**
+ * The mutex locked by the fast path is moved to the holder's list as soon
+ * as some other task has to wait for it, so the holder inherits priority
+ * of the waiter.
+ */
+static void _low_lock_contended(void)
+{
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_low.task.fast_mutex == &_mutex);
+   TT_CHECK(_mutex.holder == &_low.task && _mutex.cnt == 1);
+
+   //-- the high-priority task preempts us and waits for the mutex
+   _isr_func = _high_start_lock_unlock;
+   raise(SIGUSR1);
+
+   TT_CHECK(_high.task.task_wait_reason == TN_WAIT_REASON_MUTEX_I);
+   TT_CHECK(_low.task.fast_mutex == TN_NULL);
+   TT_CHECK(_low.task.priority == _HIGH_PRIORITY);
+
+   //-- usual path: the mutex is handed over to the waiter, which runs
+   //   right away
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+   TT_CHECK(_low.task.priority == _LOW_PRIORITY);
+   TT_CHECK(_mutex.holder == TN_NULL);
+}
+
+static void _mutex_test(void)
+{
+   int stores_cnt;
+
+   TT_CHECK(tn_mutex_create(&_mutex, TN_MUTEX_PROT_INHERIT, 0) == TN_RC_OK);
+
+   //-- uncontended: fast path
+   stores_cnt = _stores_cnt;
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(tn_cur_task_get()->fast_mutex == &_mutex);
+   TT_CHECK(_mutex.holder == tn_cur_task_get() && _mutex.cnt == 1);
+
+   //-- recursive locking: usual path
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_mutex.cnt == 2);
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+   TT_CHECK(_mutex.cnt == 1);
+
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+   TT_CHECK(tn_cur_task_get()->fast_mutex == TN_NULL);
+   TT_CHECK(_stores_cnt == stores_cnt + 2);
+   _mutex_free_check();
+
+   _worker_start(&_low, _low_lock_contended);
+   _worker_done_wait(&_low);
+   _worker_done_wait(&_high);
+   _mutex_free_check();
+}
+
+// }}}
+
+//-- Mutex: lock preempted between setting `fast_mutex` and the store {{{
+
+/**
+ * Runs in the window of `_low_lock_preempted()`: the low-priority task has
+ * already set its `fast_mutex`, but the mutex is not locked yet. We lock it
+ * ourselves, and let the low-priority task complete its lock.
+ */
+static void _high_lock_in_window(void)
+{
+   _window_seen = (1
+         && _low.task.fast_mutex == &_mutex
+         && _mutex.holder == TN_NULL
+         );
+
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_high.task.fast_mutex == &_mutex);
+
+   //-- the low-priority task fails to store, sees that the mutex is locked,
+   //   and waits for it: the mutex is moved to our list
+   tn_task_sleep(_LET_LOW_RUN_TICKS);
+   TT_CHECK(_low.task.task_wait_reason == TN_WAIT_REASON_MUTEX_I);
+   TT_CHECK(_low.task.fast_mutex == TN_NULL);
+   TT_CHECK(_high.task.fast_mutex == TN_NULL);
+
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+   TT_CHECK(_mutex.holder == &_low.task);
+}
+
+static void _high_start_lock_in_window(void)
+{
+   _worker_start(&_high, _high_lock_in_window);
+}
+
+static void _low_lock_preempted(void)
+{
+   _window_seen = TN_FALSE;
+   _isr_func = _high_start_lock_in_window;
+   _preempt_armed = TN_TRUE;
+
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_window_seen);
+
+   //-- got the mutex by the usual path
+   TT_CHECK(_mutex.holder == &_low.task && _mutex.cnt == 1);
+   TT_CHECK(_low.task.fast_mutex == TN_NULL);
+
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+}
+
+static void _lock_preempted_test(void)
+{
+   _worker_start(&_low, _low_lock_preempted);
+   _worker_done_wait(&_low);
+   _worker_done_wait(&_high);
+   _mutex_free_check();
+}
+
+// }}}
+
+//-- Mutex: unlock preempted after the lock count is decremented {{{
+
+/**
+ * Runs in the window of `_low_unlock_preempted()`: the low-priority task
+ * still holds the mutex, but it has already decremented the lock count.
+ * We wait for the mutex, so it is moved to the holder's list and then
+ * unlocked by the usual path.
+ */
+static void _high_lock_in_unlock_window(void)
+{
+   _window_seen = (1
+         && _low.task.fast_mutex == &_mutex
+         && _mutex.holder == &_low.task
+         && _mutex.cnt == 0
+         );
+
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_mutex.holder == &_high.task && _mutex.cnt == 1);
+   TT_CHECK(_high.task.fast_mutex == TN_NULL);
+   TT_CHECK(_low.task.priority == _LOW_PRIORITY);
+
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+}
+
+static void _high_start_lock_in_unlock_window(void)
+{
+   _worker_start(&_high, _high_lock_in_unlock_window);
+}
+
+/**
+ * Runs in the window of `_low_unlock_preempted()` as well, but gives up
+ * waiting for the mutex before the low-priority task goes on: the mutex is
+ * in the holder's list already, though nobody waits for it anymore.
+ */
+static void _high_lock_timeout_in_unlock_window(void)
+{
+   TT_CHECK(tn_task_suspend(&_low.task) == TN_RC_OK);
+   TT_CHECK(tn_mutex_lock(&_mutex, _LET_LOW_RUN_TICKS) == TN_RC_TIMEOUT);
+   TT_CHECK(_low.task.fast_mutex == TN_NULL);
+   TT_CHECK(_low.task.mutex_queue.next == &_mutex.mutex_queue);
+   TT_CHECK(tn_task_resume(&_low.task) == TN_RC_OK);
+}
+
+static void _high_start_lock_timeout_in_unlock_window(void)
+{
+   _worker_start(&_high, _high_lock_timeout_in_unlock_window);
+}
+
+static void _nothing(void)
+{
+}
+
+static void _low_unlock_preempted(void)
+{
+   int stores_cnt;
+
+   //-- preempted by ISR which doesn't touch the mutex: the store fails, and
+   //   the second attempt succeeds
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_low.task.fast_mutex == &_mutex);
+
+   stores_cnt = _stores_cnt;
+   _isr_func = _nothing;
+   _preempt_armed = TN_TRUE;
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+   TT_CHECK(_stores_cnt == stores_cnt + 2);
+   _mutex_free_check();
+
+   //-- preempted by the task which waits for the mutex
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_low.task.fast_mutex == &_mutex);
+
+   _window_seen = TN_FALSE;
+   _isr_func = _high_start_lock_in_unlock_window;
+   _preempt_armed = TN_TRUE;
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+   TT_CHECK(_window_seen);
+   TT_CHECK(_low.task.fast_mutex == TN_NULL);
+   _worker_done_wait(&_high);
+
+   //-- preempted by the task which waits for the mutex and gives up: the
+   //   mutex should be removed from our list by the usual path
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+
+   _isr_func = _high_start_lock_timeout_in_unlock_window;
+   _preempt_armed = TN_TRUE;
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+   _mutex_free_check();
+}
+
+static void _unlock_preempted_test(void)
+{
+   _worker_start(&_low, _low_unlock_preempted);
+   _worker_done_wait(&_low);
+   _worker_done_wait(&_high);
+   _mutex_free_check();
+}
+
+// }}}
+
+//-- Mutex: holder terminated {{{
+
+static void _low_lock_and_sleep(void)
+{
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(tn_sem_signal(&_low.done_sem) == TN_RC_OK);
+   tn_task_sleep(TN_WAIT_INFINITE);
+}
+
+static void _low_lock_and_exit(void)
+{
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(_low.task.fast_mutex == &_mutex);
+   tn_task_exit(0);
+}
+
+//-- runs in the window of the low-priority task, and terminates it
+static void _high_terminate_low_in_lock_window(void)
+{
+   _window_seen = (1
+         && _low.task.fast_mutex == &_mutex
+         && _mutex.holder == TN_NULL
+         );
+
+   TT_CHECK(tn_task_terminate(&_low.task) == TN_RC_OK);
+   _mutex_free_check();
+}
+
+static void _high_terminate_low_in_unlock_window(void)
+{
+   _window_seen = (1
+         && _low.task.fast_mutex == &_mutex
+         && _mutex.holder == &_low.task
+         && _mutex.cnt == 0
+         );
+
+   TT_CHECK(tn_task_terminate(&_low.task) == TN_RC_OK);
+   _mutex_free_check();
+}
+
+static void _high_start_terminate_in_lock_window(void)
+{
+   _worker_start(&_high, _high_terminate_low_in_lock_window);
+}
+
+static void _high_start_terminate_in_unlock_window(void)
+{
+   _worker_start(&_high, _high_terminate_low_in_unlock_window);
+}
+
+static void _low_lock_terminated(void)
+{
+   _isr_func = _high_start_terminate_in_lock_window;
+   _preempt_armed = TN_TRUE;
+   tn_mutex_lock(&_mutex, TN_WAIT_INFINITE);
+
+   TT_CHECK(0);   //-- should never be here
+}
+
+static void _low_unlock_terminated(void)
+{
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+
+   _isr_func = _high_start_terminate_in_unlock_window;
+   _preempt_armed = TN_TRUE;
+   tn_mutex_unlock(&_mutex);
+
+   TT_CHECK(0);   //-- should never be here
+}
+
+static void _terminate_test(void)
+{
+   //-- holder locked the mutex by the fast path, and is terminated
+   _worker_start(&_low, _low_lock_and_sleep);
+   _worker_done_wait(&_low);
+   TT_CHECK(_low.task.fast_mutex == &_mutex);
+   TT_CHECK(tn_task_terminate(&_low.task) == TN_RC_OK);
+   _mutex_free_check();
+   _worker_restart(&_low);
+
+   //-- the same, but some task waits for the mutex: it gets the mutex
+   _worker_start(&_low, _low_lock_and_sleep);
+   _worker_done_wait(&_low);
+   _worker_start(&_high, _high_lock_unlock);
+   tn_task_sleep(_LET_LOW_RUN_TICKS);
+   TT_CHECK(_high.task.task_wait_reason == TN_WAIT_REASON_MUTEX_I);
+   TT_CHECK(_low.task.priority == _HIGH_PRIORITY);
+   TT_CHECK(tn_task_terminate(&_low.task) == TN_RC_OK);
+   _worker_done_wait(&_high);
+   _mutex_free_check();
+   _worker_restart(&_low);
+
+   //-- holder exits by itself
+   _worker_start(&_low, _low_lock_and_exit);
+   tn_task_sleep(_LET_LOW_RUN_TICKS);
+   _mutex_free_check();
+   _worker_restart(&_low);
+
+   //-- terminated between setting `fast_mutex` and the store
+   _window_seen = TN_FALSE;
+   _worker_start(&_low, _low_lock_terminated);
+   _worker_done_wait(&_high);
+   TT_CHECK(_window_seen);
+   _mutex_free_check();
+   _worker_restart(&_low);
+
+   //-- terminated in the middle of unlocking, after the lock count is
+   //   decremented
+   _window_seen = TN_FALSE;
+   _worker_start(&_low, _low_unlock_terminated);
+   _worker_done_wait(&_high);
+   TT_CHECK(_window_seen);
+   _mutex_free_check();
+   _worker_restart(&_low);
+
+   //-- after all that, the mutex is still usable by the fast path
+   TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+   TT_CHECK(tn_cur_task_get()->fast_mutex == &_mutex);
+   TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+   _mutex_free_check();
+}
+
+// }}}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   tn_posix_isr_set(SIGUSR1, _usr1_isr);
+   tn_posix_excl_store_hook_set(_excl_store_hook);
+
+   _worker_create(&_high, _HIGH_PRIORITY, _high_stack);
+   _worker_create(&_low, _LOW_PRIORITY, _low_stack);
+
+   _sem_test();
+   _eventgrp_test();
+   _mutex_test();
+   _lock_preempted_test();
+   _unlock_preempted_test();
+   _terminate_test();
+
+   tn_posix_excl_store_hook_set(TN_NULL);
+}
+
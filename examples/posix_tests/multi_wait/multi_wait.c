@@ -0,0 +1,531 @@
+/**
+ * \file
+ *
+ * Test of the multi-object wait (`#TN_MULTI_WAIT`, `tn_multi_wait()`):
+ *
+ * - parameter checks, and order of items when several of them can be
+ *   satisfied right away;
+ * - each event wakes up exactly one multi-waiting task, in FIFO order, and
+ *   the result (semaphore count, queue item, memory block, event pattern)
+ *   is handed over to it directly;
+ * - tasks which wait for the object alone take precedence over the
+ *   multi-waiting ones;
+ * - the task which stops waiting for any reason (`tn_task_release_wait()`,
+ *   timeout, deletion of the object, termination) is removed from the lists
+ *   of all its objects, so that later events aren't lost to it.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <signal.h>
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- number of helper tasks
+#define _TASKS_CNT               3
+
+//-- priority of the helper task `n`: all of them are lower than the main
+//   task, so they run only when it sleeps. Task 1 has higher priority than
+//   task 0, so that the order of waking up is FIFO indeed.
+#define _TASK_PRIORITY(n)        (((n) == 1) ? 5 : (6 + (n)))
+
+//-- max number of items of a single multi-wait
+#define _ITEMS_MAX               4
+
+//-- capacity of the queue and the memory pool
+#define _QUEUE_ITEMS_CNT         2
+#define _FMEM_BLOCKS_CNT         2
+
+//-- timeout in the timeout test
+#define _WAIT_TMO                5
+
+//-- make the queue item value from the number
+#define _ITEM(n)                 ((void *)(TN_UIntPtr)(0x100 + (n)))
+
+//-- whether the list of multi-wait items of the object is empty
+#define _MULTI_LIST_IS_EMPTY(obj)                                       \
+   ((obj)->multi_wait_list.next == &(obj)->multi_wait_list)
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/**
+ * The wait which the helper task does once, and its result
+ */
+struct _Waiter {
+   ///
+   /// if `TN_TRUE`, the task waits for the semaphore alone, by
+   /// `tn_sem_wait()`; otherwise, by `tn_multi_wait()` for `items`
+   TN_BOOL plain;
+   struct TN_MultiWaitItem items[ _ITEMS_MAX ];
+   int items_cnt;
+   TN_TickCnt timeout;
+
+   volatile TN_BOOL done;
+   enum TN_RCode rc;
+   int fired_idx;
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "multi_wait";
+
+static struct TN_Task _tasks[ _TASKS_CNT ];
+static TN_UWord _task_stacks[ _TASKS_CNT ][ TT_TASK_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+static struct _Waiter _waiters[ _TASKS_CNT ];
+
+static struct TN_Sem _sem;
+static struct TN_DQueue _queue;
+static void *_queue_buf[ _QUEUE_ITEMS_CNT ];
+static struct TN_FMem _fmem;
+TN_FMEM_BUF_DEF(_fmem_buf, TN_UWord, _FMEM_BLOCKS_CNT);
+static struct TN_EventGrp _eventgrp;
+
+//-- result of the multi-wait in the ISR
+static volatile enum TN_RCode _isr_rc;
+static volatile int _isr_fired_idx;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _task_body(void *par)
+{
+   struct _Waiter *waiter = (struct _Waiter *)par;
+
+   if (waiter->plain){
+      waiter->rc = tn_sem_wait(&_sem, waiter->timeout);
+   } else {
+      waiter->rc = tn_multi_wait(
+            waiter->items, waiter->items_cnt, &waiter->fired_idx,
+            waiter->timeout
+            );
+   }
+   waiter->done = TN_TRUE;
+
+   tn_task_sleep(TN_WAIT_INFINITE);
+}
+
+static void _item_set(
+      struct TN_MultiWaitItem *item,
+      enum TN_MultiWaitObjType obj_type,
+      void *p_obj
+      )
+{
+   item->obj_type = obj_type;
+   item->p_obj = p_obj;
+   item->wait_pattern = 0;
+   item->wait_mode = TN_EVENTGRP_WMODE_OR;
+   item->p_data = TN_NULL;
+   item->actual_pattern = 0;
+}
+
+/**
+ * Fill the items of the waiter `n` with the objects given by the string:
+ * 's' for the semaphore, 'q' for the queue, 'f' for the memory pool and 'e'
+ * for the event group (to wait for the flags 0x3 with `AND` and `AUTOCLR`).
+ */
+static void _items_set(int n, const char *objs)
+{
+   struct _Waiter *waiter = &_waiters[n];
+   int i;
+
+   for (i = 0; objs[i] != '\0'; i++){
+      struct TN_MultiWaitItem *item = &waiter->items[i];
+
+      switch (objs[i]){
+         case 's':
+            _item_set(item, TN_MULTI_WAIT_OBJ_SEM, &_sem);
+            break;
+         case 'q':
+            _item_set(item, TN_MULTI_WAIT_OBJ_DQUEUE, &_queue);
+            break;
+         case 'f':
+            _item_set(item, TN_MULTI_WAIT_OBJ_FMEM, &_fmem);
+            break;
+         case 'e':
+            _item_set(item, TN_MULTI_WAIT_OBJ_EVENTGRP, &_eventgrp);
+            item->wait_pattern = 0x3;
+            item->wait_mode = TN_EVENTGRP_WMODE_AND | TN_EVENTGRP_WMODE_AUTOCLR;
+            break;
+         default:
+            TT_CHECK(0);
+            break;
+      }
+   }
+
+   waiter->items_cnt = i;
+}
+
+/**
+ * Start the helper task `n` which waits for the given objects (see
+ * `_items_set()`), or for the semaphore alone if `objs` is `TN_NULL`. The
+ * task runs (and starts waiting) right away.
+ */
+static void _waiter_start(int n, const char *objs, TN_TickCnt timeout)
+{
+   struct _Waiter *waiter = &_waiters[n];
+
+   waiter->plain = (objs == TN_NULL);
+   if (!waiter->plain){
+      _items_set(n, objs);
+   }
+   waiter->timeout = timeout;
+   waiter->done = TN_FALSE;
+   waiter->rc = TN_RC_INTERNAL;
+   waiter->fired_idx = -2;
+
+   TT_CHECK(tn_task_create(
+            &_tasks[n], _task_body, _TASK_PRIORITY(n), _task_stacks[n],
+            TT_TASK_STACK_SIZE, waiter, TN_TASK_CREATE_OPT_START
+            ) == TN_RC_OK);
+
+   //-- let it run
+   tn_task_sleep(1);
+   TT_CHECK(!waiter->done);
+}
+
+static void _waiter_remove(int n)
+{
+   TT_CHECK(tn_task_terminate(&_tasks[n]) == TN_RC_OK);
+   TT_CHECK(tn_task_delete(&_tasks[n]) == TN_RC_OK);
+}
+
+/**
+ * Let the helpers run, and check the result of the waiter `n`
+ */
+static void _waiter_check(int n, enum TN_RCode rc, int fired_idx)
+{
+   struct _Waiter *waiter = &_waiters[n];
+
+   tn_task_sleep(1);
+
+   TT_CHECK(waiter->done);
+   TT_CHECK(waiter->rc == rc);
+   if (!waiter->plain){
+      TT_CHECK(waiter->fired_idx == fired_idx);
+   }
+}
+
+/**
+ * Check that nobody multi-waits for any object
+ */
+static void _lists_check(void)
+{
+   TT_CHECK(_MULTI_LIST_IS_EMPTY(&_sem));
+   TT_CHECK(_MULTI_LIST_IS_EMPTY(&_queue));
+   TT_CHECK(_MULTI_LIST_IS_EMPTY(&_fmem));
+   TT_CHECK(_MULTI_LIST_IS_EMPTY(&_eventgrp));
+}
+
+static void _objects_create(void)
+{
+   TT_CHECK(tn_sem_create(&_sem, 0, 10) == TN_RC_OK);
+   TT_CHECK(tn_queue_create(&_queue, _queue_buf, _QUEUE_ITEMS_CNT)
+         == TN_RC_OK);
+   TT_CHECK(tn_fmem_create(
+            &_fmem, _fmem_buf, TN_MAKE_ALIG_SIZE(sizeof(TN_UWord)),
+            _FMEM_BLOCKS_CNT
+            ) == TN_RC_OK);
+   TT_CHECK(tn_eventgrp_create(&_eventgrp, 0) == TN_RC_OK);
+}
+
+static void _usr1_isr(void)
+{
+   struct TN_MultiWaitItem items[2];
+   int fired_idx = -2;
+
+   _item_set(&items[0], TN_MULTI_WAIT_OBJ_DQUEUE, &_queue);
+   _item_set(&items[1], TN_MULTI_WAIT_OBJ_SEM, &_sem);
+
+   _isr_rc = tn_multi_iwait_polling(items, 2, &fired_idx);
+   _isr_fired_idx = fired_idx;
+}
+
+
+
+//-- Parameters and polling {{{
+
+static void _polling_test(void)
+{
+   struct TN_MultiWaitItem items[3];
+   int fired_idx;
+
+   //-- wrong params
+   _item_set(&items[0], TN_MULTI_WAIT_OBJ_SEM, &_sem);
+   _item_set(&items[1], TN_MULTI_WAIT_OBJ_DQUEUE, &_queue);
+   TT_CHECK(tn_multi_wait_polling(TN_NULL, 1, &fired_idx) == TN_RC_WPARAM);
+   TT_CHECK(tn_multi_wait_polling(items, 0, &fired_idx) == TN_RC_WPARAM);
+   TT_CHECK(tn_multi_wait_polling(items, 1, TN_NULL) == TN_RC_WPARAM);
+   TT_CHECK(tn_multi_iwait_polling(items, 1, &fired_idx) == TN_RC_WCONTEXT);
+
+   //-- the same object twice, the object of the wrong type, and no object
+   _item_set(&items[2], TN_MULTI_WAIT_OBJ_SEM, &_sem);
+   TT_CHECK(tn_multi_wait_polling(items, 3, &fired_idx) == TN_RC_WPARAM);
+   _item_set(&items[2], TN_MULTI_WAIT_OBJ_FMEM, &_sem);
+   TT_CHECK(tn_multi_wait_polling(items, 3, &fired_idx)
+         == TN_RC_INVALID_OBJ);
+   _item_set(&items[2], TN_MULTI_WAIT_OBJ_FMEM, TN_NULL);
+   TT_CHECK(tn_multi_wait_polling(items, 3, &fired_idx) == TN_RC_WPARAM);
+
+   //-- nothing to take
+   _item_set(&items[2], TN_MULTI_WAIT_OBJ_FMEM, &_fmem);
+   TT_CHECK(tn_fmem_get_polling(&_fmem, &items[0].p_data) == TN_RC_OK);
+   TT_CHECK(tn_fmem_get_polling(&_fmem, &items[1].p_data) == TN_RC_OK);
+   TT_CHECK(tn_fmem_release(&_fmem, items[0].p_data) == TN_RC_OK);
+   TT_CHECK(tn_fmem_release(&_fmem, items[1].p_data) == TN_RC_OK);
+
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+   TT_CHECK(tn_queue_send_polling(&_queue, _ITEM(1)) == TN_RC_OK);
+
+   //-- when several items can be satisfied, the first one is taken
+   _item_set(&items[0], TN_MULTI_WAIT_OBJ_DQUEUE, &_queue);
+   _item_set(&items[1], TN_MULTI_WAIT_OBJ_SEM, &_sem);
+   TT_CHECK(tn_multi_wait_polling(items, 2, &fired_idx) == TN_RC_OK);
+   TT_CHECK(fired_idx == 0 && items[0].p_data == _ITEM(1));
+   TT_CHECK(tn_multi_wait_polling(items, 2, &fired_idx) == TN_RC_OK);
+   TT_CHECK(fired_idx == 1 && _sem.count == 0);
+   TT_CHECK(tn_multi_wait_polling(items, 2, &fired_idx) == TN_RC_TIMEOUT);
+   TT_CHECK(fired_idx == -1);
+
+   //-- the same from ISR
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+   tn_posix_isr_set(SIGUSR1, _usr1_isr);
+   raise(SIGUSR1);
+   TT_CHECK(_isr_rc == TN_RC_OK && _isr_fired_idx == 1);
+   TT_CHECK(_sem.count == 0);
+   raise(SIGUSR1);
+   TT_CHECK(_isr_rc == TN_RC_TIMEOUT && _isr_fired_idx == -1);
+
+   _lists_check();
+}
+
+// }}}
+
+//-- Single wakeup, FIFO and handoff {{{
+
+static void _handoff_test(void)
+{
+   void *blocks[ _FMEM_BLOCKS_CNT ];
+   void *items[3];
+   TN_UWord flags;
+   int i;
+
+   //-- two tasks wait for the semaphore and the queue: each event wakes up
+   //   just the first one, and the semaphore count isn't incremented
+   _waiter_start(0, "sq", TN_WAIT_INFINITE);
+   _waiter_start(1, "sq", TN_WAIT_INFINITE);
+
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+   _waiter_check(0, TN_RC_OK, 0);
+   TT_CHECK(!_waiters[1].done);
+   TT_CHECK(_sem.count == 0);
+
+   //-- the first task isn't in the queue's list anymore: the item goes to
+   //   the second one, and not to the FIFO
+   TT_CHECK(tn_queue_send_polling(&_queue, _ITEM(2)) == TN_RC_OK);
+   _waiter_check(1, TN_RC_OK, 1);
+   TT_CHECK(_waiters[1].items[1].p_data == _ITEM(2));
+   TT_CHECK(_queue.filled_items_cnt == 0);
+
+   _waiter_remove(0);
+   _waiter_remove(1);
+   _lists_check();
+
+   //-- batch send: one item for each waiting task, the rest to the FIFO
+   for (i = 0; i < _FMEM_BLOCKS_CNT; i++){
+      TT_CHECK(tn_fmem_get_polling(&_fmem, &blocks[i]) == TN_RC_OK);
+   }
+   _waiter_start(0, "q", TN_WAIT_INFINITE);
+   _waiter_start(1, "fq", TN_WAIT_INFINITE);
+   for (i = 0; i < 3; i++){
+      items[i] = _ITEM(10 + i);
+   }
+   TT_CHECK(tn_queue_send_multi(&_queue, items, 3, TN_NULL, 0) == TN_RC_OK);
+   _waiter_check(0, TN_RC_OK, 0);
+   _waiter_check(1, TN_RC_OK, 1);
+   TT_CHECK(_waiters[0].items[0].p_data == _ITEM(10));
+   TT_CHECK(_waiters[1].items[1].p_data == _ITEM(11));
+   TT_CHECK(tn_queue_receive_polling(&_queue, &items[0]) == TN_RC_OK);
+   TT_CHECK(items[0] == _ITEM(12));
+   _waiter_remove(0);
+   _waiter_remove(1);
+
+   //-- memory block release: the block is handed over to the waiting task
+   _waiter_start(0, "qf", TN_WAIT_INFINITE);
+   TT_CHECK(tn_fmem_release(&_fmem, blocks[1]) == TN_RC_OK);
+   _waiter_check(0, TN_RC_OK, 1);
+   TT_CHECK(_waiters[0].items[1].p_data == blocks[1]);
+   TT_CHECK(tn_fmem_free_blocks_cnt_get(&_fmem) == 0);
+   TT_CHECK(tn_fmem_release(&_fmem, blocks[0]) == TN_RC_OK);
+   TT_CHECK(tn_fmem_release(&_fmem, blocks[1]) == TN_RC_OK);
+   _waiter_remove(0);
+
+   //-- event group with AND and AUTOCLR: fires when both flags are set,
+   //   and clears them
+   _waiter_start(0, "se", TN_WAIT_INFINITE);
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_SET, 0x1)
+         == TN_RC_OK);
+   tn_task_sleep(1);
+   TT_CHECK(!_waiters[0].done);
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_SET, 0x6)
+         == TN_RC_OK);
+   _waiter_check(0, TN_RC_OK, 1);
+   TT_CHECK(_waiters[0].items[1].actual_pattern == 0x7);
+   TT_CHECK(tn_eventgrp_wait_polling(
+            &_eventgrp, 0x7, TN_EVENTGRP_WMODE_OR, &flags
+            ) == TN_RC_OK);
+   TT_CHECK(flags == 0x4);
+   TT_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_CLEAR, 0x4)
+         == TN_RC_OK);
+   _waiter_remove(0);
+
+   _lists_check();
+}
+
+// }}}
+
+//-- Precedence of the plain waiters {{{
+
+static void _precedence_test(void)
+{
+   //-- the task which waits for the semaphore alone starts waiting after
+   //   the multi-waiting one, but gets the semaphore first
+   _waiter_start(0, "qs", TN_WAIT_INFINITE);
+   _waiter_start(1, TN_NULL, TN_WAIT_INFINITE);
+
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+   _waiter_check(1, TN_RC_OK, 0);
+   TT_CHECK(!_waiters[0].done);
+
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+   _waiter_check(0, TN_RC_OK, 1);
+   TT_CHECK(_sem.count == 0);
+
+   _waiter_remove(0);
+   _waiter_remove(1);
+   _lists_check();
+}
+
+// }}}
+
+//-- Release wait, timeout, deletion and termination {{{
+
+/**
+ * After the waiter has stopped waiting, events go to the objects as usual
+ */
+static void _events_not_lost_check(void)
+{
+   void *item;
+
+   _lists_check();
+
+   TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+   TT_CHECK(_sem.count == 1);
+   TT_CHECK(tn_sem_wait_polling(&_sem) == TN_RC_OK);
+
+   TT_CHECK(tn_queue_send_polling(&_queue, _ITEM(20)) == TN_RC_OK);
+   TT_CHECK(tn_queue_receive_polling(&_queue, &item) == TN_RC_OK);
+   TT_CHECK(item == _ITEM(20));
+}
+
+static void _release_test(void)
+{
+   void *blocks[ _FMEM_BLOCKS_CNT ];
+   TN_TickCnt start;
+   TN_TickCnt elapsed;
+   int i;
+
+   //-- take all the memory blocks, so that nobody gets them right away
+   for (i = 0; i < _FMEM_BLOCKS_CNT; i++){
+      TT_CHECK(tn_fmem_get_polling(&_fmem, &blocks[i]) == TN_RC_OK);
+   }
+
+   //-- release wait
+   _waiter_start(0, "sqfe", TN_WAIT_INFINITE);
+   TT_CHECK(!_MULTI_LIST_IS_EMPTY(&_fmem));
+   TT_CHECK(tn_task_release_wait(&_tasks[0]) == TN_RC_OK);
+   _waiter_check(0, TN_RC_FORCED, -1);
+   _events_not_lost_check();
+   _waiter_remove(0);
+
+   //-- timeout
+   start = tn_sys_time_get();
+   _waiter_start(0, "sqfe", _WAIT_TMO);
+   tn_task_sleep(_WAIT_TMO);
+   _waiter_check(0, TN_RC_TIMEOUT, -1);
+   elapsed = tn_sys_time_get() - start;
+   TT_CHECK(elapsed >= _WAIT_TMO + 1 && elapsed <= _WAIT_TMO + 3);
+   _events_not_lost_check();
+   _waiter_remove(0);
+
+   //-- termination
+   _waiter_start(0, "sqfe", TN_WAIT_INFINITE);
+   _waiter_remove(0);
+   _events_not_lost_check();
+
+   //-- deletion of one of the objects: the item of this object fires with
+   //   TN_RC_DELETED, and the task is removed from the other lists
+   _waiter_start(0, "sq", TN_WAIT_INFINITE);
+   _waiter_start(1, "fq", TN_WAIT_INFINITE);
+   TT_CHECK(tn_queue_delete(&_queue) == TN_RC_OK);
+   _waiter_check(0, TN_RC_DELETED, 1);
+   _waiter_check(1, TN_RC_DELETED, 1);
+   TT_CHECK(_MULTI_LIST_IS_EMPTY(&_sem));
+   TT_CHECK(_MULTI_LIST_IS_EMPTY(&_fmem));
+   TT_CHECK(tn_queue_create(&_queue, _queue_buf, _QUEUE_ITEMS_CNT)
+         == TN_RC_OK);
+   _events_not_lost_check();
+   _waiter_remove(0);
+   _waiter_remove(1);
+
+   for (i = 0; i < _FMEM_BLOCKS_CNT; i++){
+      TT_CHECK(tn_fmem_release(&_fmem, blocks[i]) == TN_RC_OK);
+   }
+}
+
+// }}}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   _objects_create();
+
+   _polling_test();
+   _handoff_test();
+   _precedence_test();
+   _release_test();
+
+   TT_CHECK(tn_sem_delete(&_sem) == TN_RC_OK);
+   TT_CHECK(tn_queue_delete(&_queue) == TN_RC_OK);
+   TT_CHECK(tn_fmem_delete(&_fmem) == TN_RC_OK);
+   TT_CHECK(tn_eventgrp_delete(&_eventgrp) == TN_RC_OK);
+}
+
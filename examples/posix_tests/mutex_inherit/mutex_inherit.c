@@ -0,0 +1,472 @@
+/**
+ * \file
+ *
+ * Stress test of mutex priority inheritance, with both wait orders (see
+ * `tn_mutex_create_wattr()`):
+ *
+ * - deep chain: each task holds its own mutex and waits for the one held by
+ *   the previous task, so the priority of the top waiter should propagate
+ *   down to the bottom of the chain, and back when the waiter gives up;
+ * - random workers lock and unlock random subsets of mutexes of all kinds
+ *   (inheritance with FIFO and priority order, and priority ceiling), with
+ *   random timeouts, in random order.
+ *
+ * After each step, priority of every task is checked against the reference
+ * model computed from scratch: it is the highest of the base priority of
+ * the task, ceilings of the `#TN_MUTEX_PROT_CEILING` mutexes it holds, and
+ * priorities (computed recursively) of the tasks which wait for the
+ * `#TN_MUTEX_PROT_INHERIT` mutexes it holds. Order of the wait queues of
+ * the mutexes with `#TN_WAIT_ORDER_PRIO` is checked as well.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- depth of the chain
+#define _CHAIN_DEPTH             8
+
+//-- priority of the bottom task of the chain: each next task has higher
+//   priority (numerically lower) by one
+#define _CHAIN_BOTTOM_PRIORITY   (TN_PRIORITIES_CNT - 2)
+#define _CHAIN_TOP_PRIORITY      (_CHAIN_BOTTOM_PRIORITY - _CHAIN_DEPTH + 1)
+
+//-- extra waiters for the top mutex of the chain: the first one waits
+//   forever, and the second one, of higher priority, gives up
+#define _WAITER_PRIORITY         10
+#define _WAITER_TMO_PRIORITY     5
+#define _WAITER_TMO              20
+
+//-- number of random workers and mutexes they lock
+#define _WORKERS_CNT             10
+#define _MUTEXES_CNT             6
+
+//-- index of the random mutex with priority ceiling, and its ceiling
+#define _CEIL_MUTEX_IDX          4
+#define _CEIL_PRIORITY           3
+
+//-- priority of the worker `n`: workers are spread over priorities
+//   below the ceiling
+#define _WORKER_PRIORITY(n)      (4 + ((n) * 7) % 20)
+
+//-- duration of the random stress, in ticks
+#define _STRESS_TICKS            2000
+
+//-- limit of recursion of the reference model: wait-for graph is a tree
+//   without cycles, so it is never reached unless something is broken
+#define _MAX_DEPTH               64
+
+//-- get the structure by the pointer to its list item
+#define _ENTRY(item, type, member)                                      \
+   ((type *)((char *)(item) - offsetof(type, member)))
+
+//-- iterate over the list of structures
+#define _LIST_FOR_EACH_ENTRY(pos, type, list, member)                   \
+   for (struct TN_ListItem *_item = (list)->next;                       \
+         _item != (list) && ((pos) = _ENTRY(_item, type, member), 1);   \
+         _item = _item->next)
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "mutex_inherit";
+
+static struct TN_Task _chain_tasks[ _CHAIN_DEPTH ];
+static struct TN_Mutex _chain_mutexes[ _CHAIN_DEPTH ];
+static TN_UWord _chain_stacks[ _CHAIN_DEPTH ][ TT_TASK_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+
+static struct TN_Task _waiter_tasks[ 2 ];
+static TN_UWord _waiter_stacks[ 2 ][ TT_TASK_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+
+static struct TN_Task _worker_tasks[ _WORKERS_CNT ];
+static struct TN_Mutex _mutexes[ _MUTEXES_CNT ];
+static TN_UWord _worker_stacks[ _WORKERS_CNT ][ TT_TASK_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+
+//-- all the tasks to check
+static struct TN_Task *_tasks[ _CHAIN_DEPTH + 2 + _WORKERS_CNT ];
+static int _tasks_cnt;
+
+//-- number of chain tasks which have completed
+static volatile int _chain_done_cnt;
+
+//-- set when random workers should stop
+static volatile TN_BOOL _stress_stop;
+
+//-- statistics of the random stress
+static unsigned long _checks_cnt;
+static unsigned long _locks_cnt;
+static unsigned long _timeouts_cnt;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * Reference model: priority the task should have.
+ */
+static int _expected_priority_get(struct TN_Task *task, int depth)
+{
+   int priority = task->base_priority;
+   struct TN_Mutex *mutex;
+   struct TN_Task *waiter;
+
+   TT_CHECK(depth < _MAX_DEPTH);
+
+   _LIST_FOR_EACH_ENTRY(
+         mutex, struct TN_Mutex, &task->mutex_queue, mutex_queue
+         )
+   {
+      if (mutex->protocol == TN_MUTEX_PROT_CEILING){
+         if (mutex->ceil_priority < priority){
+            priority = mutex->ceil_priority;
+         }
+      } else {
+         int prev_priority = 0;
+
+         _LIST_FOR_EACH_ENTRY(
+               waiter, struct TN_Task, &mutex->wait_queue, task_queue
+               )
+         {
+            int waiter_priority = _expected_priority_get(waiter, depth + 1);
+
+            if (waiter_priority < priority){
+               priority = waiter_priority;
+            }
+
+            if (mutex->wait_order == TN_WAIT_ORDER_PRIO){
+               TT_CHECK(waiter->priority >= prev_priority);
+               prev_priority = waiter->priority;
+            }
+         }
+      }
+   }
+
+   return priority;
+}
+
+/**
+ * Check priorities of all the tasks against the reference model.
+ */
+static void _priorities_check(void)
+{
+   TN_UWord sr = tn_arch_sr_save_int_dis();
+   int i;
+
+   for (i = 0; i < _tasks_cnt; i++){
+      struct TN_Task *task = _tasks[i];
+
+      if (     task->task_state != TN_TASK_STATE_NONE
+            && task->task_state != TN_TASK_STATE_DORMANT
+         )
+      {
+         int expected = _expected_priority_get(task, 0);
+
+         if (task->priority != expected){
+            tt_msg("task %d: priority %d, expected %d",
+                  i, task->priority, expected);
+            TT_CHECK(0);
+         }
+      }
+   }
+
+   _checks_cnt++;
+
+   tn_arch_sr_restore(sr);
+}
+
+static void _task_add(struct TN_Task *task)
+{
+   _tasks[ _tasks_cnt++ ] = task;
+}
+
+static void _task_create(
+      struct TN_Task *task,
+      TN_TaskBody    *task_func,
+      int             priority,
+      TN_UWord       *stack,
+      void           *param
+      )
+{
+   TT_CHECK(tn_task_create(
+            task, task_func, priority, stack, TT_TASK_STACK_SIZE, param, 0
+            ) == TN_RC_OK);
+   _task_add(task);
+}
+
+static void _task_remove(struct TN_Task *task)
+{
+   TT_CHECK(tn_task_terminate(task) == TN_RC_OK);
+   TT_CHECK(tn_task_delete(task) == TN_RC_OK);
+}
+
+
+
+//-- Deep chain {{{
+
+/**
+ * Chain task `n` locks its own mutex, and then the mutex of the task
+ * `n - 1`. The bottom task sleeps instead, until it is woken up by the main
+ * task.
+ */
+static void _chain_task_body(void *par)
+{
+   int n = (int)(TN_UIntPtr)par;
+
+   TT_CHECK(tn_mutex_lock(&_chain_mutexes[n], TN_WAIT_INFINITE) == TN_RC_OK);
+
+   if (n > 0){
+      TT_CHECK(tn_mutex_lock(&_chain_mutexes[n - 1], TN_WAIT_INFINITE)
+            == TN_RC_OK);
+      _priorities_check();
+      TT_CHECK(tn_mutex_unlock(&_chain_mutexes[n - 1]) == TN_RC_OK);
+   } else {
+      tn_task_sleep(TN_WAIT_INFINITE);
+   }
+
+   _priorities_check();
+   TT_CHECK(tn_mutex_unlock(&_chain_mutexes[n]) == TN_RC_OK);
+   TT_CHECK(_chain_tasks[n].priority == _chain_tasks[n].base_priority);
+   _priorities_check();
+
+   _chain_done_cnt++;
+   tn_task_sleep(TN_WAIT_INFINITE);
+}
+
+/**
+ * Extra waiter for the top mutex of the chain, `par` is the timeout.
+ */
+static void _waiter_task_body(void *par)
+{
+   struct TN_Mutex *mutex = &_chain_mutexes[ _CHAIN_DEPTH - 1 ];
+
+   if (tn_mutex_lock(mutex, (TN_TickCnt)(TN_UIntPtr)par) == TN_RC_OK){
+      _priorities_check();
+      TT_CHECK(tn_mutex_unlock(mutex) == TN_RC_OK);
+   }
+
+   _priorities_check();
+   tn_task_sleep(TN_WAIT_INFINITE);
+}
+
+static void _chain_priorities_check(int priority)
+{
+   int n;
+
+   for (n = 0; n < _CHAIN_DEPTH; n++){
+      TT_CHECK(_chain_tasks[n].priority == priority);
+   }
+}
+
+static void _chain_test(enum TN_WaitOrder wait_order)
+{
+   int n;
+
+   _tasks_cnt = 0;
+   _chain_done_cnt = 0;
+
+   for (n = 0; n < _CHAIN_DEPTH; n++){
+      TT_CHECK(tn_mutex_create_wattr(
+               &_chain_mutexes[n], TN_MUTEX_PROT_INHERIT, 0, wait_order
+               ) == TN_RC_OK);
+   }
+
+   //-- build the chain from the bottom: each next task preempts the
+   //   previous one, and waits for its mutex
+   for (n = 0; n < _CHAIN_DEPTH; n++){
+      _task_create(
+            &_chain_tasks[n], _chain_task_body, _CHAIN_BOTTOM_PRIORITY - n,
+            _chain_stacks[n], (void *)(TN_UIntPtr)n
+            );
+      TT_CHECK(tn_task_activate(&_chain_tasks[n]) == TN_RC_OK);
+      tn_task_sleep(1);
+      _priorities_check();
+   }
+   _chain_priorities_check(_CHAIN_TOP_PRIORITY);
+
+   //-- two more waiters for the top mutex: priority propagates down to the
+   //   bottom of the chain, and back when the higher one gives up
+   _task_create(
+         &_waiter_tasks[0], _waiter_task_body, _WAITER_PRIORITY,
+         _waiter_stacks[0], (void *)(TN_UIntPtr)TN_WAIT_INFINITE
+         );
+   _task_create(
+         &_waiter_tasks[1], _waiter_task_body, _WAITER_TMO_PRIORITY,
+         _waiter_stacks[1], (void *)(TN_UIntPtr)_WAITER_TMO
+         );
+
+   TT_CHECK(tn_task_activate(&_waiter_tasks[0]) == TN_RC_OK);
+   tn_task_sleep(1);
+   _priorities_check();
+   _chain_priorities_check(_WAITER_PRIORITY);
+
+   TT_CHECK(tn_task_activate(&_waiter_tasks[1]) == TN_RC_OK);
+   tn_task_sleep(1);
+   _priorities_check();
+   _chain_priorities_check(_WAITER_TMO_PRIORITY);
+
+   tn_task_sleep(_WAITER_TMO + 5);
+   _priorities_check();
+   _chain_priorities_check(_WAITER_PRIORITY);
+
+   //-- let the bottom task go: the chain unwinds
+   TT_CHECK(tn_task_wakeup(&_chain_tasks[0]) == TN_RC_OK);
+   tn_task_sleep(5);
+   _priorities_check();
+   TT_CHECK(_chain_done_cnt == _CHAIN_DEPTH);
+
+   for (n = 0; n < _CHAIN_DEPTH; n++){
+      TT_CHECK(_chain_tasks[n].priority == _chain_tasks[n].base_priority);
+      _task_remove(&_chain_tasks[n]);
+      TT_CHECK(tn_mutex_delete(&_chain_mutexes[n]) == TN_RC_OK);
+   }
+   _task_remove(&_waiter_tasks[0]);
+   _task_remove(&_waiter_tasks[1]);
+}
+
+// }}}
+
+//-- Random stress {{{
+
+static void _worker_task_body(void *par)
+{
+   int idx = (int)(TN_UIntPtr)par;
+   unsigned int seed = idx * 7919 + 1;
+
+   while (!_stress_stop){
+      int held[ _MUTEXES_CNT ];
+      int held_cnt = 0;
+      int i;
+
+      //-- lock random subset of mutexes, in order of their indexes (so that
+      //   workers never deadlock), with random timeouts
+      for (i = 0; i < _MUTEXES_CNT; i++){
+         if (rand_r(&seed) % 3 == 0){
+            TN_TickCnt timeout = 1 + rand_r(&seed) % 4;
+            enum TN_RCode rc = tn_mutex_lock(&_mutexes[i], timeout);
+
+            _locks_cnt++;
+            if (rc == TN_RC_OK){
+               held[ held_cnt++ ] = i;
+            } else {
+               TT_CHECK(rc == TN_RC_TIMEOUT);
+               _timeouts_cnt++;
+            }
+            _priorities_check();
+         }
+      }
+
+      if (rand_r(&seed) % 2){
+         tn_task_sleep(rand_r(&seed) % 3);
+      }
+      _priorities_check();
+
+      //-- unlock them in random order
+      while (held_cnt > 0){
+         int j = rand_r(&seed) % held_cnt;
+
+         TT_CHECK(tn_mutex_unlock(&_mutexes[ held[j] ]) == TN_RC_OK);
+         held[j] = held[ --held_cnt ];
+         _priorities_check();
+      }
+
+      tn_task_sleep(rand_r(&seed) % 2);
+   }
+
+   tn_task_sleep(TN_WAIT_INFINITE);
+}
+
+static void _stress_test(void)
+{
+   int i;
+
+   _tasks_cnt = 0;
+
+   for (i = 0; i < _MUTEXES_CNT; i++){
+      if (i == _CEIL_MUTEX_IDX){
+         TT_CHECK(tn_mutex_create_wattr(
+                  &_mutexes[i], TN_MUTEX_PROT_CEILING, _CEIL_PRIORITY,
+                  TN_WAIT_ORDER_PRIO
+                  ) == TN_RC_OK);
+      } else {
+         TT_CHECK(tn_mutex_create_wattr(
+                  &_mutexes[i], TN_MUTEX_PROT_INHERIT, 0,
+                  (i & 1) ? TN_WAIT_ORDER_FIFO : TN_WAIT_ORDER_PRIO
+                  ) == TN_RC_OK);
+      }
+   }
+
+   for (i = 0; i < _WORKERS_CNT; i++){
+      _task_create(
+            &_worker_tasks[i], _worker_task_body, _WORKER_PRIORITY(i),
+            _worker_stacks[i], (void *)(TN_UIntPtr)i
+            );
+      TT_CHECK(tn_task_activate(&_worker_tasks[i]) == TN_RC_OK);
+   }
+
+   tn_task_sleep(_STRESS_TICKS);
+   _stress_stop = TN_TRUE;
+   tn_task_sleep(50);
+   _priorities_check();
+
+   for (i = 0; i < _WORKERS_CNT; i++){
+      TT_CHECK(
+            _worker_tasks[i].priority == _worker_tasks[i].base_priority
+            );
+      _task_remove(&_worker_tasks[i]);
+   }
+
+   for (i = 0; i < _MUTEXES_CNT; i++){
+      TT_CHECK(tn_mutex_delete(&_mutexes[i]) == TN_RC_OK);
+   }
+
+   tt_msg("stress: %lu checks, %lu locks, %lu timeouts",
+         _checks_cnt, _locks_cnt, _timeouts_cnt);
+
+   //-- make sure that workers have actually competed for mutexes
+   TT_CHECK(_timeouts_cnt > 100);
+}
+
+// }}}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   struct TN_Mutex mutex;
+
+   TT_CHECK(tn_mutex_create_wattr(
+            &mutex, TN_MUTEX_PROT_INHERIT, 0, (enum TN_WaitOrder)5
+            ) == TN_RC_WPARAM);
+
+   _chain_test(TN_WAIT_ORDER_FIFO);
+   _chain_test(TN_WAIT_ORDER_PRIO);
+   _stress_test();
+}
+
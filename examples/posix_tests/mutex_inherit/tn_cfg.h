@@ -0,0 +1,18 @@
+/*******************************************************************************
+ *    TNeo configuration for the mutex priority inheritance test, see
+ *    mutex_inherit.c
+ *
+ *    The tests Makefile puts this directory to the include path before the
+ *    TNeo's `src`, so, this file is used instead of `src/tn_cfg.h`.
+ *    Everything not defined here is taken from `src/tn_cfg_default.h`.
+ *
+ ******************************************************************************/
+
+#ifndef _TN_CFG_H
+#define _TN_CFG_H
+
+#define TN_CHECK_PARAM                 1
+#define TN_DEBUG                       1
+
+#endif // _TN_CFG_H
+
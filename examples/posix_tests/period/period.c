@@ -0,0 +1,211 @@
+/**
+ * \file
+ *
+ * Test of the periodic schedule (`tn_task_period_start()`,
+ * `tn_task_period_wait()`): normal releases, overruns, and early wake up
+ * by `tn_task_wakeup()` / `tn_task_release_wait()`.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- release period of the schedule, in ticks
+#define _PERIOD                  10
+
+//-- priority of the helper task which wakes up the main one
+#define _HELPER_PRIORITY         (TT_MAIN_PRIORITY + 1)
+
+//-- delay after which the helper wakes up the main task, in ticks
+#define _HELPER_DELAY            3
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+//-- what the helper task does to the main task
+enum _HelperAction {
+   _HELPER_ACTION_WAKEUP,
+   _HELPER_ACTION_RELEASE_WAIT,
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "period";
+
+static struct TN_Task _helper;
+TN_STACK_ARR_DEF(_helper_stack, TT_TASK_STACK_SIZE);
+
+static struct TN_Task *_main_task;
+static enum _HelperAction _helper_action;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _helper_body(void *par)
+{
+   (void)par;
+
+   tn_task_sleep(_HELPER_DELAY);
+
+   switch (_helper_action){
+      case _HELPER_ACTION_WAKEUP:
+         TT_CHECK(tn_task_wakeup(_main_task) == TN_RC_OK);
+         break;
+      case _HELPER_ACTION_RELEASE_WAIT:
+         TT_CHECK(tn_task_release_wait(_main_task) == TN_RC_OK);
+         break;
+   }
+
+   //-- return from the body terminates the task, so it can be activated
+   //   again
+}
+
+static void _helper_start(enum _HelperAction action)
+{
+   _helper_action = action;
+   TT_CHECK(tn_task_activate(&_helper) == TN_RC_OK);
+}
+
+/**
+ * Check that the next release of the schedule is `release`, wait for it,
+ * check the return code and that the schedule is advanced by one period.
+ */
+static void _release_wait_check(
+      struct TN_TaskPeriod *per,
+      TN_TickCnt release,
+      enum TN_RCode rc_exp
+      )
+{
+   TT_CHECK(per->next_release == release);
+   TT_CHECK(tn_task_period_wait(per) == rc_exp);
+   TT_CHECK(per->next_release == release + _PERIOD);
+}
+
+/**
+ * Normal releases: the task gets back at exactly the release time.
+ */
+static void _release_test(void)
+{
+   struct TN_TaskPeriod per;
+   TN_TickCnt start;
+   int i;
+
+   TT_CHECK(tn_task_period_start(&per, 0) == TN_RC_WPARAM);
+   TT_CHECK(tn_task_period_start(TN_NULL, _PERIOD) == TN_RC_WPARAM);
+   TT_CHECK(tn_task_period_wait(TN_NULL) == TN_RC_WPARAM);
+
+   //-- start right after the tick, so that the whole period is ahead
+   tn_task_sleep(1);
+   start = tn_sys_time_get();
+   TT_CHECK(tn_task_period_start(&per, _PERIOD) == TN_RC_OK);
+
+   for (i = 1; i <= 3; i++){
+      _release_wait_check(&per, start + i * _PERIOD, TN_RC_OK);
+      TT_CHECK(tn_sys_time_get() == start + i * _PERIOD);
+   }
+   TT_CHECK(per.overruns_cnt == 0);
+}
+
+/**
+ * Late task: the function returns immediately, the missed releases are
+ * counted, and the schedule keeps its phase.
+ */
+static void _overrun_test(void)
+{
+   struct TN_TaskPeriod per;
+   TN_TickCnt start;
+
+   tn_task_sleep(1);
+   start = tn_sys_time_get();
+   TT_CHECK(tn_task_period_start(&per, _PERIOD) == TN_RC_OK);
+
+   //-- miss two releases and a half
+   while (tn_sys_time_get() - start < 2 * _PERIOD + _PERIOD / 2){
+      //-- busy wait
+   }
+
+   TT_CHECK(tn_task_period_wait(&per) == TN_RC_OVERFLOW);
+   TT_CHECK(per.overruns_cnt == 2);
+   TT_CHECK(per.next_release == start + 3 * _PERIOD);
+
+   TT_CHECK(tn_task_period_wait(&per) == TN_RC_OK);
+   TT_CHECK(tn_sys_time_get() == start + 3 * _PERIOD);
+   TT_CHECK(per.overruns_cnt == 2);
+}
+
+/**
+ * The task is woken up before the release time: the function returns
+ * `TN_RC_FORCED`, and the next call waits for the next release.
+ */
+static void _early_wakeup_test(void)
+{
+   struct TN_TaskPeriod per;
+   TN_TickCnt start;
+
+   _main_task = tn_cur_task_get();
+
+   tn_task_sleep(1);
+   start = tn_sys_time_get();
+   TT_CHECK(tn_task_period_start(&per, _PERIOD) == TN_RC_OK);
+
+   _helper_start(_HELPER_ACTION_WAKEUP);
+   _release_wait_check(&per, start + _PERIOD, TN_RC_FORCED);
+   TT_CHECK(tn_sys_time_get() == start + _HELPER_DELAY);
+
+   _release_wait_check(&per, start + 2 * _PERIOD, TN_RC_OK);
+   TT_CHECK(tn_sys_time_get() == start + 2 * _PERIOD);
+
+   _helper_start(_HELPER_ACTION_RELEASE_WAIT);
+   _release_wait_check(&per, start + 3 * _PERIOD, TN_RC_FORCED);
+   TT_CHECK(tn_sys_time_get() == start + 2 * _PERIOD + _HELPER_DELAY);
+
+   _release_wait_check(&per, start + 4 * _PERIOD, TN_RC_OK);
+   TT_CHECK(tn_sys_time_get() == start + 4 * _PERIOD);
+   TT_CHECK(per.overruns_cnt == 0);
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   TT_CHECK(tn_task_create(
+            &_helper,
+            _helper_body,
+            _HELPER_PRIORITY,
+            _helper_stack,
+            TT_TASK_STACK_SIZE,
+            TN_NULL,
+            0
+            ) == TN_RC_OK);
+
+   _release_test();
+   _overrun_test();
+   _early_wakeup_test();
+}
+
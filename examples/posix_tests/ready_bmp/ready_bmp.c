@@ -0,0 +1,278 @@
+/**
+ * \file
+ *
+ * Test of the two-level bitmap of runnable priorities
+ * (`#TN_PRIORITIES_2LEVEL_BMP`), with `#TN_PRIORITIES_CNT` greater than
+ * `#TN_INT_WIDTH`: tasks of all the priorities are added to and removed
+ * from the ready queue, and both the bitmap and the order in which the
+ * tasks run are checked.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tt.h"
+#include "_tn_sys.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- one task for each priority except the main task's (0) and the idle
+//   task's (the last one)
+#define _TASKS_CNT               (TN_PRIORITIES_CNT - 2)
+
+//-- priority of the task `n`
+#define _TASK_PRIORITY(n)        ((n) + 1)
+
+//-- get task index from the task body parameter
+#define _TASK_IDX(par)           ((int)(TN_UIntPtr)(par))
+
+//-- priority which has two tasks: it is in the second group of the bitmap
+#define _TWIN_PRIORITY           (TN_INT_WIDTH + 1)
+
+//-- index of the twin task in the log
+#define _TWIN_IDX                _TASKS_CNT
+
+//-- priority of the idle task
+#define _IDLE_PRIORITY           (TN_PRIORITIES_CNT - 1)
+
+//-- how long the main task sleeps to let other tasks run, in ticks. The
+//   next tick may come right after the main task goes to sleep, so it
+//   should be way more than one tick.
+#define _OTHERS_RUN_TICKS        20
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "ready_bmp";
+
+static TN_UWord _task_stacks[ _TASKS_CNT + 1 ][ TT_TASK_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+static struct TN_Task _tasks[ _TASKS_CNT + 1 ];
+
+//-- indexes of the tasks in the order they have run
+static int _log[ _TASKS_CNT + 1 ];
+static int _log_cnt;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- each task just writes its index to the log and exits
+static void _task_body(void *par)
+{
+   _log[ _log_cnt++ ] = _TASK_IDX(par);
+   tn_task_exit(0);
+}
+
+static TN_BOOL _prio_bit_get(int priority)
+{
+   return !!(_tn_ready_to_run_bmp[ priority / TN_INT_WIDTH ]
+         & ((TN_UWord)1 << (priority % TN_INT_WIDTH)));
+}
+
+static TN_BOOL _group_bit_get(int priority)
+{
+   return !!(_tn_ready_to_run_grp_bmp
+         & ((TN_UWord)1 << (priority / TN_INT_WIDTH)));
+}
+
+/**
+ * Check that the bitmap has bits set for the given priorities only (in
+ * addition to the main task's and idle task's ones, which are always
+ * runnable here), and that the group bits match the bitmap.
+ */
+static void _bmp_check(const int *priorities, int cnt)
+{
+   int prio;
+   int i;
+
+   for (prio = 0; prio < TN_PRIORITIES_CNT; prio++){
+      TN_BOOL expected = (prio == TT_MAIN_PRIORITY || prio == _IDLE_PRIORITY);
+
+      for (i = 0; i < cnt; i++){
+         if (priorities[i] == prio){
+            expected = TN_TRUE;
+         }
+      }
+
+      TT_CHECK(_prio_bit_get(prio) == expected);
+   }
+
+   for (i = 0; i < _TN_READY_BMP_GROUPS_CNT; i++){
+      TT_CHECK(
+            !!(_tn_ready_to_run_grp_bmp & ((TN_UWord)1 << i))
+            == (_tn_ready_to_run_bmp[i] != 0)
+            );
+   }
+
+   //-- no stray group bits beyond the last group
+   TT_CHECK((_tn_ready_to_run_grp_bmp >> _TN_READY_BMP_GROUPS_CNT) == 0);
+}
+
+//-- let lower-priority tasks run until they exit
+static void _others_run(void)
+{
+   _log_cnt = 0;
+   tn_task_sleep(_OTHERS_RUN_TICKS);
+}
+
+/**
+ * All the priorities, activated in the scattered order: each task is added
+ * to the empty list of its priority, and the last one runs first.
+ */
+static void _all_priorities_test(void)
+{
+   int i;
+
+   _bmp_check(TN_NULL, 0);
+
+   //-- 37 is coprime with the number of tasks, so each task is activated
+   //   exactly once
+   for (i = 0; i < _TASKS_CNT; i++){
+      int idx = (i * 37) % _TASKS_CNT;
+      int prio = _TASK_PRIORITY(idx);
+
+      TT_CHECK(tn_task_activate(&_tasks[idx]) == TN_RC_OK);
+      TT_CHECK(_prio_bit_get(prio) && _group_bit_get(prio));
+   }
+
+   _others_run();
+
+   TT_CHECK(_log_cnt == _TASKS_CNT);
+   for (i = 0; i < _TASKS_CNT; i++){
+      TT_CHECK(_log[i] == i);
+   }
+
+   _bmp_check(TN_NULL, 0);
+}
+
+/**
+ * Removing tasks from the ready queue: the priority bit is cleared when the
+ * last task of this priority is removed, and the group bit is cleared when
+ * the last priority of the group is.
+ */
+static void _remove_test(void)
+{
+   struct TN_Task *twin_a = &_tasks[ _TWIN_PRIORITY - 1 ];
+   struct TN_Task *twin_b = &_tasks[ _TWIN_IDX ];
+   //-- the last task of the previous group, and the only task of the next
+   //   group
+   int prio_prev = TN_INT_WIDTH - 1;
+   int prio_next = 2 * TN_INT_WIDTH;
+   int prios_all[]  = { prio_prev, prio_next, _TWIN_PRIORITY };
+   int prios_next[] = { prio_next };
+
+   TT_CHECK(tn_task_activate(twin_a) == TN_RC_OK);
+   TT_CHECK(tn_task_activate(twin_b) == TN_RC_OK);
+   TT_CHECK(tn_task_activate(&_tasks[ prio_prev - 1 ]) == TN_RC_OK);
+   TT_CHECK(tn_task_activate(&_tasks[ prio_next - 1 ]) == TN_RC_OK);
+   _bmp_check(prios_all, 3);
+
+   //-- twin task remains, so the bit remains too
+   TT_CHECK(tn_task_suspend(twin_a) == TN_RC_OK);
+   _bmp_check(prios_all, 3);
+
+   //-- now the priority is empty, and so is its group
+   TT_CHECK(tn_task_suspend(twin_b) == TN_RC_OK);
+   _bmp_check(prios_all, 2);
+   TT_CHECK(!_group_bit_get(_TWIN_PRIORITY));
+
+   //-- previous group is emptied as well
+   TT_CHECK(tn_task_suspend(&_tasks[ prio_prev - 1 ]) == TN_RC_OK);
+   _bmp_check(prios_next, 1);
+   TT_CHECK(_tn_ready_to_run_grp_bmp
+         == (((TN_UWord)1 << (prio_next / TN_INT_WIDTH))
+            | ((TN_UWord)1 << (TT_MAIN_PRIORITY / TN_INT_WIDTH))
+            | ((TN_UWord)1 << (_IDLE_PRIORITY / TN_INT_WIDTH))));
+
+   //-- only the task of the next group runs
+   _others_run();
+   TT_CHECK(_log_cnt == 1 && _log[0] == prio_next - 1);
+
+   //-- resume in the reverse order: the twins run in the order of resuming
+   TT_CHECK(tn_task_resume(twin_b) == TN_RC_OK);
+   TT_CHECK(tn_task_resume(&_tasks[ prio_prev - 1 ]) == TN_RC_OK);
+   TT_CHECK(tn_task_resume(twin_a) == TN_RC_OK);
+   prios_all[1] = _TWIN_PRIORITY;
+   _bmp_check(prios_all, 2);
+
+   _others_run();
+   TT_CHECK(_log_cnt == 3);
+   TT_CHECK(_log[0] == prio_prev - 1);
+   TT_CHECK(_log[1] == _TWIN_IDX);
+   TT_CHECK(_log[2] == _TWIN_PRIORITY - 1);
+
+   _bmp_check(TN_NULL, 0);
+}
+
+/**
+ * Changing priority of the runnable task moves it between the groups.
+ */
+static void _priority_change_test(void)
+{
+   //-- the task in the last (incomplete) group, along with the idle task
+   int idx_low = _TASKS_CNT - 1;
+   int idx_mid = 2 * TN_INT_WIDTH + 5;
+   int new_prio = 5;
+   int prios[] = { _TASK_PRIORITY(idx_low), _TASK_PRIORITY(idx_mid) };
+
+   TT_CHECK(tn_task_activate(&_tasks[idx_low]) == TN_RC_OK);
+   TT_CHECK(tn_task_activate(&_tasks[idx_mid]) == TN_RC_OK);
+   _bmp_check(prios, 2);
+
+   TT_CHECK(tn_task_change_priority(&_tasks[idx_low], new_prio) == TN_RC_OK);
+   prios[0] = new_prio;
+   _bmp_check(prios, 2);
+
+   //-- the last group still has the idle task
+   TT_CHECK(_group_bit_get(_IDLE_PRIORITY));
+
+   _others_run();
+   TT_CHECK(_log_cnt == 2);
+   TT_CHECK(_log[0] == idx_low);
+   TT_CHECK(_log[1] == idx_mid);
+
+   _bmp_check(TN_NULL, 0);
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   int i;
+
+   for (i = 0; i <= _TASKS_CNT; i++){
+      TT_CHECK(tn_task_create(
+               &_tasks[i],
+               _task_body,
+               (i == _TWIN_IDX) ? _TWIN_PRIORITY : _TASK_PRIORITY(i),
+               _task_stacks[i],
+               TT_TASK_STACK_SIZE,
+               (void *)(TN_UIntPtr)i,
+               0
+               ) == TN_RC_OK);
+   }
+
+   _all_priorities_test();
+   _remove_test();
+   _priority_change_test();
+}
+
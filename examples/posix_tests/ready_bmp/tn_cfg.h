@@ -0,0 +1,23 @@
+/*******************************************************************************
+ *    TNeo configuration for the ready bitmap test, see ready_bmp.c
+ *
+ *    The tests Makefile puts this directory to the include path before the
+ *    TNeo's `src`, so, this file is used instead of `src/tn_cfg.h`.
+ *    Everything not defined here is taken from `src/tn_cfg_default.h`.
+ *
+ ******************************************************************************/
+
+#ifndef _TN_CFG_H
+#define _TN_CFG_H
+
+#define TN_CHECK_PARAM                 1
+#define TN_DEBUG                       1
+
+//-- more than three groups of `TN_INT_WIDTH` priorities (64 on 64-bit
+//   POSIX), and not a multiple of it, so that the last group of the bitmap
+//   is incomplete
+#define TN_PRIORITIES_CNT              200
+#define TN_PRIORITIES_2LEVEL_BMP       1
+
+#endif // _TN_CFG_H
+
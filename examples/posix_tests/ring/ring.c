@@ -0,0 +1,487 @@
+/**
+ * \file
+ *
+ * Test of the lock-free SPSC ring buffer (`struct TN_Ring`):
+ *
+ * - parameter checks, wrap-around of the indexes (which run over
+ *   `2 * items_cnt`) and overflow;
+ * - flag race: the item is written by the ISR right after the consumer has
+ *   found the ring empty, but before it raises the "consumer is waiting"
+ *   flag. The hook of the POSIX port (`tn_posix_int_dis_hook_set()`)
+ *   raises the signal of the producer ISR right before the consumer enters
+ *   the critical section. The producer doesn't see the flag, so the
+ *   consumer has to find the item by itself, not to go to sleep;
+ * - the consumer which waits is woken up once for several items;
+ * - timeout clears the flag, so the producer doesn't enter the kernel
+ *   afterwards; deletion wakes the consumer up;
+ * - streaming from the tick ISR in random bursts, with overflows.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <signal.h>
+#include <stdlib.h>
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- capacity of the ring
+#define _RING_ITEMS_CNT          8
+
+//-- timeout of the consumer in the timeout test
+#define _READ_TMO                5
+
+//-- duration of the streaming test, in ticks, and max number of items
+//   written by the producer each tick
+#define _STREAM_TICKS            1000
+#define _STREAM_BURST_MAX        (_RING_ITEMS_CNT + 2)
+
+//-- priority of the helper consumer task in the deletion test
+#define _TASK_PRIORITY           5
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/**
+ * Ring item: the sequence number, and some more bytes so that the size
+ * isn't the size of a word
+ */
+struct _Item {
+   unsigned long seq;
+   unsigned short check;
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "ring";
+
+static struct TN_Ring _ring;
+TN_RING_BUF_DEF(_ring_buf, struct _Item, _RING_ITEMS_CNT);
+
+static struct TN_Timer _timer;
+
+static struct TN_Task _task;
+static TN_UWord _task_stack[ TT_TASK_STACK_SIZE ] TN_ARCH_STK_ATTR_AFTER;
+static volatile enum TN_RCode _task_rc;
+
+//-- producer state: number of items to write by the next ISR, sequence
+//   number of the next item, and results
+static volatile int _isr_items_cnt;
+static volatile unsigned long _isr_seq;
+static volatile int _isr_cnt;
+static volatile int _isr_written_cnt;
+
+//-- value of the `consumer_waiting` flag which the producer has seen
+//   before and after each write in the last ISR: bit per item
+static volatile unsigned long _isr_flag_before;
+static volatile unsigned long _isr_flag_after;
+
+//-- streaming statistics
+static volatile unsigned long _stream_overflows_cnt;
+static volatile unsigned long _stream_wakeups_cnt;
+static volatile TN_BOOL _stream_stop;
+
+//-- rand_r() state of the streaming producer
+static unsigned int _stream_seed = 1;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static struct _Item _item_make(unsigned long seq)
+{
+   struct _Item item;
+
+   item.seq = seq;
+   item.check = (unsigned short)(seq * 7919);
+
+   return item;
+}
+
+static void _item_check(const struct _Item *item, unsigned long seq)
+{
+   TT_CHECK(item->seq == seq);
+   TT_CHECK(item->check == (unsigned short)(seq * 7919));
+}
+
+/**
+ * Producer: write `_isr_items_cnt` items, recording the flag before and
+ * after each write. Called from ISR.
+ */
+static void _produce(void)
+{
+   int i;
+
+   _isr_cnt++;
+   _isr_written_cnt = 0;
+   _isr_flag_before = 0;
+   _isr_flag_after = 0;
+
+   for (i = 0; i < _isr_items_cnt; i++){
+      struct _Item item = _item_make(_isr_seq);
+
+      if (_ring.consumer_waiting){
+         _isr_flag_before |= (1UL << i);
+      }
+
+      if (tn_ring_iwrite(&_ring, &item) == TN_RC_OK){
+         _isr_seq++;
+         _isr_written_cnt++;
+      }
+
+      if (_ring.consumer_waiting){
+         _isr_flag_after |= (1UL << i);
+      }
+   }
+}
+
+static void _usr1_isr(void)
+{
+   _produce();
+}
+
+static void _timer_func(struct TN_Timer *timer, void *p_user_data)
+{
+   (void)timer;
+   (void)p_user_data;
+
+   _produce();
+}
+
+static void _int_dis_hook(void)
+{
+   //-- disarm first: the ISR disables interrupts as well
+   tn_posix_int_dis_hook_set(TN_NULL);
+   raise(SIGUSR1);
+}
+
+static void _producer_reset(int items_cnt)
+{
+   _isr_items_cnt = items_cnt;
+   _isr_cnt = 0;
+   _isr_written_cnt = 0;
+}
+
+
+
+//-- Wrap-around and overflow {{{
+
+static void _wrap_test(void)
+{
+   struct _Item item;
+   unsigned long write_seq = 0;
+   unsigned long read_seq = 0;
+   unsigned int seed = 1;
+   int i;
+
+   //-- wrong params
+   TT_CHECK(tn_ring_create(&_ring, _ring_buf, 0, _RING_ITEMS_CNT)
+         == TN_RC_WPARAM);
+   TT_CHECK(tn_ring_create(&_ring, _ring_buf, sizeof(struct _Item), 0)
+         == TN_RC_WPARAM);
+   TT_CHECK(tn_ring_create(
+            &_ring, TN_NULL, sizeof(struct _Item), _RING_ITEMS_CNT
+            ) == TN_RC_WPARAM);
+   TT_CHECK(tn_ring_read_polling(&_ring, &item) == TN_RC_INVALID_OBJ);
+
+   TT_CHECK(tn_ring_create(
+            &_ring, _ring_buf, TN_MAKE_ALIG_SIZE(sizeof(struct _Item)),
+            _RING_ITEMS_CNT
+            ) == TN_RC_OK);
+
+   TT_CHECK(tn_ring_write(&_ring, TN_NULL) == TN_RC_WPARAM);
+   TT_CHECK(tn_ring_read_polling(&_ring, TN_NULL) == TN_RC_WPARAM);
+   TT_CHECK(tn_ring_iwrite(&_ring, &item) == TN_RC_WCONTEXT);
+   TT_CHECK(tn_ring_read_polling(&_ring, &item) == TN_RC_TIMEOUT);
+   TT_CHECK(tn_ring_used_items_cnt_get(&_ring) == 0);
+
+   //-- overflow
+   for (i = 0; i < _RING_ITEMS_CNT; i++){
+      item = _item_make(write_seq++);
+      TT_CHECK(tn_ring_write(&_ring, &item) == TN_RC_OK);
+   }
+   item = _item_make(write_seq);
+   TT_CHECK(tn_ring_write(&_ring, &item) == TN_RC_TIMEOUT);
+   TT_CHECK(tn_ring_used_items_cnt_get(&_ring) == _RING_ITEMS_CNT);
+
+   //-- random portions: indexes go around `2 * items_cnt` many times, with
+   //   the ring becoming full and empty at different positions
+   for (i = 0; i < 1000; i++){
+      int cnt = rand_r(&seed) % (_RING_ITEMS_CNT + 2);
+
+      while (cnt-- > 0){
+         if (tn_ring_read_polling(&_ring, &item) == TN_RC_OK){
+            _item_check(&item, read_seq++);
+         } else {
+            TT_CHECK(read_seq == write_seq);
+         }
+      }
+
+      cnt = rand_r(&seed) % (_RING_ITEMS_CNT + 2);
+      while (cnt-- > 0){
+         item = _item_make(write_seq);
+         if (tn_ring_write(&_ring, &item) == TN_RC_OK){
+            write_seq++;
+         } else {
+            TT_CHECK(write_seq - read_seq == _RING_ITEMS_CNT);
+         }
+      }
+
+      TT_CHECK(tn_ring_used_items_cnt_get(&_ring)
+            == (int)(write_seq - read_seq));
+   }
+
+   while (read_seq != write_seq){
+      TT_CHECK(tn_ring_read_polling(&_ring, &item) == TN_RC_OK);
+      _item_check(&item, read_seq++);
+   }
+   TT_CHECK(tn_ring_read_polling(&_ring, &item) == TN_RC_TIMEOUT);
+   TT_CHECK(!_ring.consumer_waiting);
+}
+
+// }}}
+
+//-- Flag race {{{
+
+static void _flag_race_test(void)
+{
+   struct _Item item;
+   TN_TickCnt start;
+
+   //-- the item comes right after the consumer has found the ring empty:
+   //   the producer doesn't see the flag, and the consumer finds the item
+   //   when it re-checks the ring after raising the flag, without waiting
+   _producer_reset(1);
+   _isr_seq = 100;
+   start = tn_sys_time_get();
+   tn_posix_int_dis_hook_set(_int_dis_hook);
+
+   TT_CHECK(tn_ring_read(&_ring, &item, _READ_TMO) == TN_RC_OK);
+   TT_CHECK(tn_sys_time_get() - start <= 1);
+
+   TT_CHECK(_isr_cnt == 1 && _isr_written_cnt == 1);
+   TT_CHECK(_isr_flag_after == 0);
+   TT_CHECK(!_ring.consumer_waiting);
+   _item_check(&item, 100);
+   TT_CHECK(tn_ring_used_items_cnt_get(&_ring) == 0);
+
+   //-- the hook only fires when the ring is found empty: nothing happens
+   //   if there is an item already
+   _producer_reset(1);
+   item = _item_make(101);
+   TT_CHECK(tn_ring_write(&_ring, &item) == TN_RC_OK);
+   tn_posix_int_dis_hook_set(_int_dis_hook);
+   TT_CHECK(tn_ring_read(&_ring, &item, TN_WAIT_INFINITE) == TN_RC_OK);
+   _item_check(&item, 101);
+   TT_CHECK(_isr_cnt == 0);
+   tn_posix_int_dis_hook_set(TN_NULL);
+}
+
+// }}}
+
+//-- Single wakeup for several items {{{
+
+static void _wakeup_test(void)
+{
+   struct _Item item;
+   int i;
+
+   //-- the consumer waits; the timer ISR writes 3 items: the first one
+   //   sees the flag and wakes the consumer up (the flag is cleared), the
+   //   rest don't enter the kernel
+   _producer_reset(3);
+   _isr_seq = 200;
+   TT_CHECK(tn_timer_create(&_timer, _timer_func, TN_NULL) == TN_RC_OK);
+   TT_CHECK(tn_timer_start(&_timer, 2) == TN_RC_OK);
+
+   TT_CHECK(tn_ring_read(&_ring, &item, 10) == TN_RC_OK);
+   _item_check(&item, 200);
+
+   TT_CHECK(_isr_cnt == 1 && _isr_written_cnt == 3);
+   TT_CHECK(_isr_flag_before == 0x1);
+   TT_CHECK(_isr_flag_after == 0);
+
+   for (i = 1; i < 3; i++){
+      TT_CHECK(tn_ring_read_polling(&_ring, &item) == TN_RC_OK);
+      _item_check(&item, 200 + i);
+   }
+   TT_CHECK(tn_ring_read_polling(&_ring, &item) == TN_RC_TIMEOUT);
+
+   TT_CHECK(tn_timer_delete(&_timer) == TN_RC_OK);
+}
+
+// }}}
+
+//-- Timeout and deletion {{{
+
+static void _task_body(void *par)
+{
+   struct _Item item;
+
+   (void)par;
+
+   _task_rc = tn_ring_read(&_ring, &item, TN_WAIT_INFINITE);
+   tn_task_sleep(TN_WAIT_INFINITE);
+}
+
+static void _timeout_test(void)
+{
+   struct _Item item;
+   TN_TickCnt start = tn_sys_time_get();
+   TN_TickCnt elapsed;
+
+   //-- timeout clears the flag
+   TT_CHECK(tn_ring_read(&_ring, &item, _READ_TMO) == TN_RC_TIMEOUT);
+   elapsed = tn_sys_time_get() - start;
+   TT_CHECK(elapsed >= _READ_TMO && elapsed <= _READ_TMO + 1);
+   TT_CHECK(!_ring.consumer_waiting);
+
+   //-- so the producer doesn't see it
+   _producer_reset(1);
+   _isr_seq = 300;
+   raise(SIGUSR1);
+   TT_CHECK(_isr_written_cnt == 1);
+   TT_CHECK(_isr_flag_before == 0 && _isr_flag_after == 0);
+   TT_CHECK(tn_ring_read_polling(&_ring, &item) == TN_RC_OK);
+   _item_check(&item, 300);
+
+   //-- deletion wakes the waiting consumer up
+   _task_rc = TN_RC_INTERNAL;
+   TT_CHECK(tn_task_create(
+            &_task, _task_body, _TASK_PRIORITY, _task_stack,
+            TT_TASK_STACK_SIZE, TN_NULL, TN_TASK_CREATE_OPT_START
+            ) == TN_RC_OK);
+   tn_task_sleep(1);
+   TT_CHECK(_ring.consumer_waiting);
+
+   TT_CHECK(tn_ring_delete(&_ring) == TN_RC_OK);
+   tn_task_sleep(1);
+   TT_CHECK(_task_rc == TN_RC_DELETED);
+   TT_CHECK(tn_ring_write(&_ring, &item) == TN_RC_INVALID_OBJ);
+
+   TT_CHECK(tn_task_terminate(&_task) == TN_RC_OK);
+   TT_CHECK(tn_task_delete(&_task) == TN_RC_OK);
+}
+
+// }}}
+
+//-- Streaming {{{
+
+static void _stream_timer_func(struct TN_Timer *timer, void *p_user_data)
+{
+   int cnt = rand_r(&_stream_seed) % (_STREAM_BURST_MAX + 1);
+
+   (void)p_user_data;
+
+   while (cnt-- > 0){
+      struct _Item item = _item_make(_isr_seq);
+      TN_BOOL waiting = _ring.consumer_waiting;
+
+      if (tn_ring_iwrite(&_ring, &item) == TN_RC_OK){
+         _isr_seq++;
+         if (waiting){
+            _stream_wakeups_cnt++;
+         }
+      } else {
+         _stream_overflows_cnt++;
+      }
+   }
+
+   if (!_stream_stop){
+      tn_timer_start(timer, 1);
+   }
+}
+
+static void _stream_test(void)
+{
+   struct _Item item;
+   unsigned long read_seq = 0;
+   unsigned long reads_cnt = 0;
+   TN_TickCnt start = tn_sys_time_get();
+
+   TT_CHECK(tn_ring_create(
+            &_ring, _ring_buf, TN_MAKE_ALIG_SIZE(sizeof(struct _Item)),
+            _RING_ITEMS_CNT
+            ) == TN_RC_OK);
+
+   _isr_seq = 0;
+   _stream_stop = TN_FALSE;
+   TT_CHECK(tn_timer_create(&_timer, _stream_timer_func, TN_NULL)
+         == TN_RC_OK);
+   TT_CHECK(tn_timer_start(&_timer, 1) == TN_RC_OK);
+
+   //-- consumer: read everything, sleeping sometimes so that the ring
+   //   overflows
+   while (tn_sys_time_get() - start < _STREAM_TICKS){
+      enum TN_RCode rc = tn_ring_read(&_ring, &item, 3);
+
+      if (rc == TN_RC_OK){
+         _item_check(&item, read_seq++);
+         if ((++reads_cnt % 64) == 0){
+            tn_task_sleep(2);
+         }
+      } else {
+         TT_CHECK(rc == TN_RC_TIMEOUT);
+      }
+   }
+
+   _stream_stop = TN_TRUE;
+   tn_task_sleep(2);
+
+   while (tn_ring_read_polling(&_ring, &item) == TN_RC_OK){
+      _item_check(&item, read_seq++);
+   }
+   TT_CHECK(read_seq == _isr_seq);
+   TT_CHECK(!_ring.consumer_waiting);
+
+   tt_msg("stream: %lu items, %lu wakeups, %lu overflows",
+         read_seq, _stream_wakeups_cnt, _stream_overflows_cnt);
+
+   //-- make sure that the consumer has actually waited and the ring has
+   //   actually overflowed
+   TT_CHECK(_stream_wakeups_cnt > 10);
+   TT_CHECK(_stream_overflows_cnt > 10);
+
+   TT_CHECK(tn_timer_delete(&_timer) == TN_RC_OK);
+   TT_CHECK(tn_ring_delete(&_ring) == TN_RC_OK);
+}
+
+// }}}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   tn_posix_isr_set(SIGUSR1, _usr1_isr);
+
+   _wrap_test();
+   _flag_race_test();
+   _wakeup_test();
+   _timeout_test();
+   _stream_test();
+}
+
@@ -0,0 +1,193 @@
+/**
+ * \file
+ *
+ * Test of round-robin with the dynamic tick (`#TN_DYNAMIC_TICK`): two busy
+ * tasks of the same priority share the CPU while we sleep.
+ *
+ * - the tasks are switched exactly each time slice, and the kernel asks for
+ *   the tick at the end of each slice only;
+ * - when just one task of that priority is left (the other one is
+ *   suspended), the time slice timer is cancelled, so there are no ticks
+ *   but the one which wakes us up; slicing is resumed when the other task
+ *   is resumed;
+ * - when the time slice is turned off, there are no ticks and no rotation
+ *   either.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+#if !TN_DYNAMIC_TICK
+#  error this test needs TN_DYNAMIC_TICK
+#endif
+
+//-- number of busy tasks
+#define _TASKS_CNT               2
+
+//-- priority of the busy tasks, and their time slice
+#define _TASK_PRIORITY           5
+#define _TSLICE                  5
+
+//-- for how long we sleep in each phase of the test, in ticks
+#define _PHASE_TICKS             50
+
+//-- max number of switches logged
+#define _SWITCHES_MAX            64
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "rr_dyn";
+
+static struct TN_Task _tasks[ _TASKS_CNT ];
+static TN_UWord _task_stacks[ _TASKS_CNT ][ TT_TASK_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+
+//-- number of loops done by each busy task
+static volatile unsigned long _loops_cnt[ _TASKS_CNT ];
+
+//-- index of the busy task which has run last, and the system time of each
+//   switch between the busy tasks
+static volatile int _running_idx;
+static TN_TickCnt _switches[ _SWITCHES_MAX ];
+static volatile int _switches_cnt;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _busy_task_body(void *par)
+{
+   int idx = (int)(TN_UIntPtr)par;
+
+   for (;;){
+      _loops_cnt[idx]++;
+
+      if (_running_idx != idx){
+         //-- we've just been switched to
+         _running_idx = idx;
+         if (_switches_cnt < _SWITCHES_MAX){
+            _switches[_switches_cnt++] = tn_sys_time_get();
+         }
+      }
+   }
+}
+
+/**
+ * Sleep for `_PHASE_TICKS`, logging switches between the busy tasks, and
+ * return the number of tick interrupts during that time
+ */
+static unsigned long _phase_run(void)
+{
+   unsigned long tick_int_cnt;
+   int i;
+
+   _running_idx = -1;
+   _switches_cnt = 0;
+   for (i = 0; i < _TASKS_CNT; i++){
+      _loops_cnt[i] = 0;
+   }
+
+   tick_int_cnt = tt_tick_int_cnt_get();
+   tn_task_sleep(_PHASE_TICKS);
+
+   return tt_tick_int_cnt_get() - tick_int_cnt;
+}
+
+/**
+ * Check that the busy tasks were switched each time slice
+ */
+static void _rotation_check(unsigned long tick_int_cnt)
+{
+   int i;
+
+   TT_CHECK(_switches_cnt >= _PHASE_TICKS / _TSLICE);
+   TT_CHECK(_switches_cnt <= _PHASE_TICKS / _TSLICE + 1);
+   for (i = 1; i < _switches_cnt; i++){
+      TT_CHECK(_switches[i] - _switches[i - 1] == _TSLICE);
+   }
+   for (i = 0; i < _TASKS_CNT; i++){
+      TT_CHECK(_loops_cnt[i] > 0);
+   }
+
+   //-- a tick at the end of each slice, and the one which wakes us up
+   TT_CHECK(tick_int_cnt >= _PHASE_TICKS / _TSLICE);
+   TT_CHECK(tick_int_cnt <= _PHASE_TICKS / _TSLICE + 2);
+}
+
+/**
+ * Check that the task `idx` had the CPU alone, without ticks
+ */
+static void _no_rotation_check(int idx, unsigned long tick_int_cnt)
+{
+   TT_CHECK(_switches_cnt == 1);
+   TT_CHECK(_running_idx == idx);
+   TT_CHECK(_loops_cnt[idx] > 0);
+   TT_CHECK(tick_int_cnt == 1);
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   unsigned long tick_int_cnt;
+   int i;
+
+   TT_CHECK(tn_sys_tslice_set(_TASK_PRIORITY, _TSLICE) == TN_RC_OK);
+
+   for (i = 0; i < _TASKS_CNT; i++){
+      TT_CHECK(tn_task_create(
+               &_tasks[i], _busy_task_body, _TASK_PRIORITY, _task_stacks[i],
+               TT_TASK_STACK_SIZE, (void *)(TN_UIntPtr)i,
+               TN_TASK_CREATE_OPT_START
+               ) == TN_RC_OK);
+   }
+
+   //-- two tasks: they are switched each slice
+   tick_int_cnt = _phase_run();
+   _rotation_check(tick_int_cnt);
+
+   //-- one task left: the slice timer is cancelled
+   TT_CHECK(tn_task_suspend(&_tasks[1]) == TN_RC_OK);
+   tick_int_cnt = _phase_run();
+   _no_rotation_check(0, tick_int_cnt);
+
+   //-- and started again when the other task is back
+   TT_CHECK(tn_task_resume(&_tasks[1]) == TN_RC_OK);
+   tick_int_cnt = _phase_run();
+   _rotation_check(tick_int_cnt);
+
+   //-- no time slice: the task which runs keeps running, without ticks
+   TT_CHECK(tn_sys_tslice_set(_TASK_PRIORITY, TN_NO_TIME_SLICE) == TN_RC_OK);
+   tick_int_cnt = _phase_run();
+   TT_CHECK(_switches_cnt == 1);
+   TT_CHECK(tick_int_cnt == 1);
+
+   for (i = 0; i < _TASKS_CNT; i++){
+      TT_CHECK(tn_task_terminate(&_tasks[i]) == TN_RC_OK);
+      TT_CHECK(tn_task_delete(&_tasks[i]) == TN_RC_OK);
+   }
+}
+
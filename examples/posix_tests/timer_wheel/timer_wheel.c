@@ -0,0 +1,340 @@
+/**
+ * \file
+ *
+ * Test of the hierarchical timing wheel of the dynamic tick
+ * (`#TN_DYNAMIC_TICK_WHEEL`): timers of all the levels (and beyond the top
+ * one) expire exactly in time, timers are cascaded from the higher levels,
+ * the kernel is asked for the tick at the next wheel event only, and
+ * cancelling the last timer of the slot clears the slot.
+ *
+ * The periodic timer of the common part is stopped, and the test generates
+ * ticks itself by raising `SIGALRM`, so the time doesn't go while the test
+ * checks something, and hundreds of thousands of ticks take a second or so.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <signal.h>
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- number of slots of each wheel level
+#define _SLOTS_CNT               ((TN_TickCnt)TN_INT_WIDTH)
+
+//-- number of ticks covered by a slot of the level 1 and 2
+#define _SPAN_1                  (_SLOTS_CNT)
+#define _SPAN_2                  (_SLOTS_CNT * _SLOTS_CNT)
+
+//-- number of ticks covered by the whole wheel
+#define _SPAN_ALL                (_SLOTS_CNT * _SLOTS_CNT * _SLOTS_CNT)
+
+//-- max number of timers used by a single check
+#define _TIMERS_CNT              16
+
+//-- how many times the timer restarts itself in the restart test
+#define _RESTARTS_CNT            10
+
+//-- period of the self-restarting timer: it goes through level 2 and 1
+#define _RESTART_PERIOD          (_SPAN_2 + _SPAN_1 - 3)
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "timer_wheel";
+
+static struct TN_Timer _timers[ _TIMERS_CNT ];
+
+//-- timeouts of the timers in the expiration test: all the levels, slot
+//   boundaries, two timers in the same slot, and ones which are beyond the
+//   top level
+static const TN_TickCnt _expire_timeouts[] = {
+   1,
+   2,
+   10,
+   10,
+   _SPAN_1 - 1,
+   _SPAN_1,
+   _SPAN_1 + 1,
+   2 * _SPAN_1 + 3,
+   _SPAN_2 - 1,
+   _SPAN_2,
+   _SPAN_2 + 1,
+   3 * _SPAN_2 + 7,
+   _SPAN_ALL - 1,
+   _SPAN_ALL,
+   _SPAN_ALL + _SPAN_2 + 1,
+   2 * _SPAN_ALL + 5,
+};
+
+#define _EXPIRE_TIMERS_CNT                                              \
+   ((int)(sizeof(_expire_timeouts) / sizeof(_expire_timeouts[0])))
+
+//-- tick count at which each timer has fired, and number of fired timers
+static volatile TN_TickCnt _fire_time[ _TIMERS_CNT ];
+static volatile int _fired_cnt;
+
+//-- if non-zero, the timer restarts itself with this timeout
+static TN_TickCnt _restart_timeout;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _timer_func(struct TN_Timer *timer, void *p_user_data)
+{
+   int idx = (int)(TN_UIntPtr)p_user_data;
+
+   _fire_time[idx] = tn_sys_time_get();
+   _fired_cnt++;
+
+   if (_restart_timeout != 0){
+      tn_timer_start(timer, _restart_timeout);
+   }
+}
+
+/**
+ * Generate the given number of ticks: the signal is delivered before
+ * `raise()` returns, and the main task is the highest-priority one, so it
+ * gets back here after each tick.
+ */
+static void _ticks_run(TN_TickCnt cnt)
+{
+   TN_TickCnt i;
+
+   for (i = 0; i < cnt; i++){
+      raise(SIGALRM);
+   }
+}
+
+/**
+ * Generate ticks until the tick count is a multiple of `align`.
+ */
+static void _ticks_align(TN_TickCnt align)
+{
+   _ticks_run((align - tn_sys_time_get() % align) % align);
+}
+
+static void _fired_reset(void)
+{
+   int i;
+
+   for (i = 0; i < _TIMERS_CNT; i++){
+      _fire_time[i] = TN_WAIT_INFINITE;
+   }
+   _fired_cnt = 0;
+}
+
+/**
+ * All the timers are started at the same tick, and each of them should
+ * fire at exactly its expiration time. The kernel should be asked for the
+ * ticks at the wheel events only, so there are way less calls to
+ * `tn_tick_int_processing()` than ticks.
+ *
+ * @param phase
+ *    Tick count modulo `_SPAN_2` at which timers are started.
+ */
+static void _expire_test(TN_TickCnt phase)
+{
+   TN_TickCnt start;
+   TN_TickCnt max = 0;
+   unsigned long tick_int_cnt;
+   int i;
+
+   _ticks_align(_SPAN_2);
+   _ticks_run(phase);
+   _fired_reset();
+
+   start = tn_sys_time_get();
+   for (i = 0; i < _EXPIRE_TIMERS_CNT; i++){
+      TT_CHECK(tn_timer_start(&_timers[i], _expire_timeouts[i]) == TN_RC_OK);
+      if (_expire_timeouts[i] > max){
+         max = _expire_timeouts[i];
+      }
+   }
+   TT_CHECK(tt_tick_scheduled_get() == 1);
+
+   tick_int_cnt = tt_tick_int_cnt_get();
+   _ticks_run(max + _SPAN_1);
+   tick_int_cnt = tt_tick_int_cnt_get() - tick_int_cnt;
+
+   TT_CHECK(_fired_cnt == _EXPIRE_TIMERS_CNT);
+   for (i = 0; i < _EXPIRE_TIMERS_CNT; i++){
+      TT_CHECK(_fire_time[i] == start + _expire_timeouts[i]);
+   }
+
+   //-- each timer expires, and it may be cascaded to each lower level (or
+   //   be placed again to the top level) once or twice
+   TT_CHECK(tick_int_cnt <= (unsigned long)_EXPIRE_TIMERS_CNT * 4);
+   TT_CHECK(tt_tick_scheduled_get() == TN_WAIT_INFINITE);
+}
+
+/**
+ * The tick is scheduled at the next wheel event: the expiration of the
+ * level 0 timer, or cascading of the higher-level slot, which happens at
+ * the lower bound of the slot.
+ */
+static void _next_event_test(void)
+{
+   //-- start the timers at the bound of the slot of level 2
+   _ticks_align(_SPAN_2);
+
+   TT_CHECK(tn_timer_start(&_timers[0], 5) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == 5);
+   TT_CHECK(tn_timer_cancel(&_timers[0]) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == TN_WAIT_INFINITE);
+
+   //-- next slot of level 1
+   TT_CHECK(tn_timer_start(&_timers[0], _SPAN_1 + 20) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == _SPAN_1);
+   TT_CHECK(tn_timer_cancel(&_timers[0]) == TN_RC_OK);
+
+   //-- next slot of level 2
+   TT_CHECK(tn_timer_start(&_timers[0], _SPAN_2 + 3) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == _SPAN_2);
+   TT_CHECK(tn_timer_cancel(&_timers[0]) == TN_RC_OK);
+
+   //-- beyond the top level: the farthest slot of it
+   TT_CHECK(tn_timer_start(&_timers[0], 2 * _SPAN_ALL) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == (_SLOTS_CNT - 1) * _SPAN_2);
+
+   //-- the nearest event wins
+   TT_CHECK(tn_timer_start(&_timers[1], _SPAN_1 + 20) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == _SPAN_1);
+   TT_CHECK(tn_timer_start(&_timers[2], 7) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == 7);
+
+   //-- the level 1 slot is cascaded at its lower bound, and the timer is
+   //   moved to the level 0
+   _fired_reset();
+   TT_CHECK(tn_timer_cancel(&_timers[2]) == TN_RC_OK);
+   _ticks_run(_SPAN_1);
+   TT_CHECK(_fired_cnt == 0);
+   TT_CHECK(tt_tick_scheduled_get() == 20);
+
+   _ticks_run(20);
+   TT_CHECK(_fired_cnt == 1 && _fire_time[1] == tn_sys_time_get());
+   TT_CHECK(tt_tick_scheduled_get()
+         == (_SLOTS_CNT - 1) * _SPAN_2 - _SPAN_1 - 20);
+
+   TT_CHECK(tn_timer_cancel(&_timers[0]) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == TN_WAIT_INFINITE);
+}
+
+/**
+ * Cancelling timers: while there are other timers in the slot, it stays
+ * in use; cancelling the last one clears the slot, so the kernel doesn't
+ * get the tick for it.
+ */
+static void _cancel_test(void)
+{
+   unsigned long tick_int_cnt;
+
+   _ticks_align(_SPAN_2);
+
+   //-- two timers in the same slot of level 0, and one at level 1
+   TT_CHECK(tn_timer_start(&_timers[0], 5) == TN_RC_OK);
+   TT_CHECK(tn_timer_start(&_timers[1], 5) == TN_RC_OK);
+   TT_CHECK(tn_timer_start(&_timers[2], _SPAN_1 + 20) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == 5);
+
+   TT_CHECK(tn_timer_cancel(&_timers[0]) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == 5);
+
+   TT_CHECK(tn_timer_cancel(&_timers[1]) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == _SPAN_1);
+
+   TT_CHECK(tn_timer_cancel(&_timers[2]) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == TN_WAIT_INFINITE);
+
+   //-- the last timer of the level 1 slot is cancelled, while the level 0
+   //   timer remains
+   _fired_reset();
+   TT_CHECK(tn_timer_start(&_timers[0], 5) == TN_RC_OK);
+   TT_CHECK(tn_timer_start(&_timers[1], _SPAN_1 + 20) == TN_RC_OK);
+   TT_CHECK(tn_timer_cancel(&_timers[1]) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == 5);
+
+   tick_int_cnt = tt_tick_int_cnt_get();
+   _ticks_run(3 * _SPAN_1);
+   TT_CHECK(_fired_cnt == 1 && _fire_time[0] != TN_WAIT_INFINITE);
+
+   //-- the only tick is the one at which the timer has fired: empty slots
+   //   don't produce ticks
+   TT_CHECK(tt_tick_int_cnt_get() - tick_int_cnt == 1);
+   TT_CHECK(tt_tick_scheduled_get() == TN_WAIT_INFINITE);
+}
+
+/**
+ * The timer which restarts itself from its callback, with the period which
+ * goes through two levels.
+ */
+static void _restart_test(void)
+{
+   TN_TickCnt start;
+
+   _fired_reset();
+   _restart_timeout = _RESTART_PERIOD;
+
+   start = tn_sys_time_get();
+   TT_CHECK(tn_timer_start(&_timers[0], _RESTART_PERIOD) == TN_RC_OK);
+
+   while (_fired_cnt < _RESTARTS_CNT){
+      TN_TickCnt fired_cnt = _fired_cnt;
+
+      _ticks_run(1);
+      if (_fired_cnt != fired_cnt){
+         TT_CHECK(_fire_time[0] == start + _fired_cnt * _RESTART_PERIOD);
+      }
+   }
+
+   _restart_timeout = 0;
+   TT_CHECK(tn_timer_cancel(&_timers[0]) == TN_RC_OK);
+   TT_CHECK(tt_tick_scheduled_get() == TN_WAIT_INFINITE);
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   int i;
+
+   //-- from now on, ticks are generated by the test only
+   tn_posix_timer_start(0);
+
+   for (i = 0; i < _TIMERS_CNT; i++){
+      TT_CHECK(tn_timer_create(
+               &_timers[i], _timer_func, (void *)(TN_UIntPtr)i
+               ) == TN_RC_OK);
+   }
+
+   _expire_test(0);
+   _expire_test(_SPAN_2 - _SPAN_1 / 2);
+   _next_event_test();
+   _cancel_test();
+   _restart_test();
+
+   //-- let the common part run normally
+   tn_posix_timer_start(TT_TICK_PERIOD_US);
+}
+
@@ -0,0 +1,25 @@
+/*******************************************************************************
+ *    TNeo configuration for the timing wheel test, see timer_wheel.c
+ *
+ *    The tests Makefile puts this directory to the include path before the
+ *    TNeo's `src`, so, this file is used instead of `src/tn_cfg.h`.
+ *    Everything not defined here is taken from `src/tn_cfg_default.h`.
+ *
+ ******************************************************************************/
+
+#ifndef _TN_CFG_H
+#define _TN_CFG_H
+
+#define TN_CHECK_PARAM                 1
+#define TN_DEBUG                       1
+
+#define TN_DYNAMIC_TICK                1
+#define TN_DYNAMIC_TICK_WHEEL          1
+
+//-- three levels, so that the test is able to go through all of them (and
+//   beyond) in reasonable time: ticks are generated by the test itself,
+//   one by one
+#define TN_DYNAMIC_TICK_WHEEL_LEVELS   3
+
+#endif // _TN_CFG_H
+
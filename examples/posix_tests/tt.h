@@ -0,0 +1,95 @@
+/**
+ * \file
+ *
+ * Kernel tests on the POSIX port: the interface between the common part
+ * (tt_main.c) and the test itself (`<test>/<test>.c`), see readme.txt.
+ *
+ * Each test is a separate program built with its own kernel configuration
+ * (`<test>/tn_cfg.h`). The common part starts the kernel and runs
+ * `tt_test_run()` in the task of the highest priority (0); when it
+ * returns, the test has passed.
+ */
+
+#ifndef _TT_H
+#define _TT_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn.h"
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- priority of the task which runs `tt_test_run()`
+#define TT_MAIN_PRIORITY         0
+
+//-- period of the system tick, in microseconds
+#define TT_TICK_PERIOD_US        1000
+
+//-- stack size of the test tasks, in words
+#define TT_TASK_STACK_SIZE       (TN_MIN_STACK_SIZE + 256)
+
+/**
+ * Check the condition; if it is false, report the failure and exit
+ * the program with non-zero status.
+ */
+#define TT_CHECK(cond)                                                  \
+   do {                                                                 \
+      if (!(cond)){                                                     \
+         tt_fail(__FILE__, __LINE__, #cond);                            \
+      }                                                                 \
+   } while (0)
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Implemented by the test: name to print in the report.
+ */
+extern const char tt_test_name[];
+
+/**
+ * Implemented by the test: runs all the checks of the test. Called from the
+ * task of priority `#TT_MAIN_PRIORITY`, with the system tick running.
+ */
+void tt_test_run(void);
+
+/**
+ * Implemented by the common part: number of calls to
+ * `tn_tick_int_processing()` made so far. With `#TN_DYNAMIC_TICK`, it is
+ * called only at the ticks scheduled by the kernel.
+ */
+unsigned long tt_tick_int_cnt_get(void);
+
+#if TN_DYNAMIC_TICK
+/**
+ * Implemented by the common part: the timeout last given by the kernel to
+ * the tick schedule callback (see `tn_callback_dyn_tick_set()`), i.e. in
+ * how many ticks the kernel needs `tn_tick_int_processing()` to be called,
+ * or `#TN_WAIT_INFINITE`.
+ */
+TN_TickCnt tt_tick_scheduled_get(void);
+#endif
+
+/**
+ * Implemented by the common part: report the failed check and exit the
+ * program with non-zero status. Typically called by `TT_CHECK()`.
+ */
+void tt_fail(const char *file, int line, const char *expr);
+
+/**
+ * Implemented by the common part: print the progress message (with the
+ * name of the test prepended).
+ */
+void tt_msg(const char *fmt, ...);
+
+#endif // _TT_H
+
@@ -0,0 +1,219 @@
+/**
+ * \file
+ *
+ * Kernel tests on the POSIX port: common part, see readme.txt. It starts the
+ * kernel with `SIGALRM` as the system tick, and runs `tt_test_run()` in the
+ * task of the highest priority.
+ *
+ * With `#TN_DYNAMIC_TICK`, `SIGALRM` plays the role of the free-running
+ * hardware counter with the compare interrupt: each signal increments the
+ * tick count, and `tn_tick_int_processing()` is called if only the kernel has
+ * scheduled it for this tick. So, the time that the kernel sees is counted
+ * in signals, which keeps tests deterministic even if the process is late
+ * to handle some signal.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- idle task stack size, in words
+#define IDLE_TASK_STACK_SIZE          (TN_MIN_STACK_SIZE + 32)
+
+//-- interrupt stack size, in words
+#define INTERRUPT_STACK_SIZE          (TN_MIN_STACK_SIZE + 64)
+
+
+
+/*******************************************************************************
+ *    DATA
+ ******************************************************************************/
+
+TN_STACK_ARR_DEF(idle_task_stack, IDLE_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(interrupt_stack, INTERRUPT_STACK_SIZE);
+TN_STACK_ARR_DEF(main_task_stack, TT_TASK_STACK_SIZE);
+
+static struct TN_Task main_task;
+
+//-- number of calls to `tn_tick_int_processing()`
+static volatile unsigned long tick_int_cnt;
+
+#if TN_DYNAMIC_TICK
+//-- tick count, incremented by each `SIGALRM`
+static volatile TN_TickCnt tick_cnt;
+
+//-- number of signals to get before the next call to
+//   `tn_tick_int_processing()`, or `TN_WAIT_INFINITE`
+static volatile TN_TickCnt tick_wait;
+
+//-- last timeout given to `tick_schedule()`
+static volatile TN_TickCnt tick_scheduled = TN_WAIT_INFINITE;
+#endif
+
+
+
+/*******************************************************************************
+ *    ISRs
+ ******************************************************************************/
+
+/**
+ * system timer ISR
+ */
+static void tick_isr(void)
+{
+#if TN_DYNAMIC_TICK
+   tick_cnt++;
+
+   if (tick_wait == TN_WAIT_INFINITE){
+      //-- no tick needed
+   } else if (tick_wait > 1){
+      tick_wait--;
+   } else {
+      //-- the kernel schedules the next one from tn_tick_int_processing()
+      tick_wait = TN_WAIT_INFINITE;
+      tick_int_cnt++;
+      tn_tick_int_processing();
+   }
+#else
+   tick_int_cnt++;
+   tn_tick_int_processing();
+#endif
+}
+
+
+
+/*******************************************************************************
+ *    FUNCTIONS
+ ******************************************************************************/
+
+#if TN_DYNAMIC_TICK
+//-- called by the kernel (with interrupts disabled) to schedule the next
+//   call to tn_tick_int_processing(): it is called when `timeout` more
+//   signals are got, but not earlier than by the next signal.
+static void tick_schedule(TN_TickCnt timeout)
+{
+   tick_scheduled = timeout;
+   tick_wait = timeout;
+}
+
+//-- called by the kernel to get the current tick count
+static TN_TickCnt tick_cnt_get(void)
+{
+   return tick_cnt;
+}
+
+/*
+ * See comments in the header file
+ */
+TN_TickCnt tt_tick_scheduled_get(void)
+{
+   return tick_scheduled;
+}
+#endif
+
+/*
+ * See comments in the header file
+ */
+unsigned long tt_tick_int_cnt_get(void)
+{
+   return tick_int_cnt;
+}
+
+/*
+ * See comments in the header file
+ */
+void tt_fail(const char *file, int line, const char *expr)
+{
+   printf("%s: FAIL at %s:%d: %s\n", tt_test_name, file, line, expr);
+   fflush(stdout);
+   exit(1);
+}
+
+/*
+ * See comments in the header file
+ */
+void tt_msg(const char *fmt, ...)
+{
+   va_list ap;
+
+   printf("%s: ", tt_test_name);
+   va_start(ap, fmt);
+   vprintf(fmt, ap);
+   va_end(ap);
+   printf("\n");
+   fflush(stdout);
+}
+
+static void main_task_body(void *par)
+{
+   (void)par;
+
+   tn_posix_isr_set(SIGALRM, tick_isr);
+   tn_posix_timer_start(TT_TICK_PERIOD_US);
+
+   tt_test_run();
+
+   tt_msg("PASS");
+   exit(0);
+}
+
+//-- create first application task(s)
+static void init_task_create(void)
+{
+   tn_task_create(
+         &main_task,
+         main_task_body,
+         TT_MAIN_PRIORITY,
+         main_task_stack,
+         TT_TASK_STACK_SIZE,
+         TN_NULL,
+         TN_TASK_CREATE_OPT_START
+         );
+}
+
+//-- idle callback that is called periodically from idle task
+static void idle_task_callback (void)
+{
+   //-- wait for the next signal
+   pause();
+}
+
+int main(void)
+{
+   //-- unconditionally disable interrupts
+   tn_arch_int_dis();
+
+#if TN_DYNAMIC_TICK
+   tick_wait = TN_WAIT_INFINITE;
+   tn_callback_dyn_tick_set(tick_schedule, tick_cnt_get);
+#endif
+
+   //-- call to tn_sys_start() never returns
+   tn_sys_start(
+         idle_task_stack,
+         IDLE_TASK_STACK_SIZE,
+         interrupt_stack,
+         INTERRUPT_STACK_SIZE,
+         init_task_create,
+         idle_task_callback
+         );
+
+   //-- unreachable
+   return 1;
+}
+
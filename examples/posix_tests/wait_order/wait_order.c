@@ -0,0 +1,418 @@
+/**
+ * \file
+ *
+ * Test of the order of waiting tasks (`enum TN_WaitOrder`, see
+ * `tn_sem_create_wattr()` and friends):
+ *
+ * - parameter checks; with `TN_WAIT_ORDER_FIFO` (default), tasks are woken
+ *   up in the order they started waiting, regardless of priority;
+ * - with `TN_WAIT_ORDER_PRIO`, the highest-priority waiter is woken up
+ *   first, and waiters of the same priority are woken up in FIFO order;
+ * - when the priority of the waiting task is changed by
+ *   `tn_task_change_priority()`, it is moved to the new place in the queue
+ *   (after all the tasks of the same or higher priority);
+ * - the same when the priority is changed by the mutex priority
+ *   inheritance: the waiting task holds the mutex, which the higher-priority
+ *   task locks, and then gives up by timeout;
+ * - data queue (both receivers and senders) and memory pool are ordered the
+ *   same way.
+ *
+ * Each helper task waits once, and we release one of them at a time: the
+ * order of wakeups is logged.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tt.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- number of helper tasks
+#define _TASKS_CNT               5
+
+//-- timeout of the mutex lock in the inheritance test
+#define _LOCK_TMO                5
+
+//-- number of blocks in the memory pool (it can't be less than 2)
+#define _FMEM_BLOCKS_CNT         2
+
+//-- make the queue item value from the number
+#define _ITEM(n)                 ((void *)(TN_UIntPtr)(0x100 + (n)))
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/**
+ * What the helper task does
+ */
+enum _Job {
+   ///
+   /// wait for the semaphore
+   _JOB_SEM,
+   ///
+   /// lock the mutex, wait for the semaphore, unlock the mutex
+   _JOB_MUTEX_SEM,
+   ///
+   /// lock the mutex with the timeout `_LOCK_TMO`
+   _JOB_MUTEX,
+   ///
+   /// receive from the data queue
+   _JOB_RECEIVE,
+   ///
+   /// send the item `_ITEM(task index)` to the data queue
+   _JOB_SEND,
+   ///
+   /// get the memory block
+   _JOB_FMEM,
+};
+
+struct _Helper {
+   enum _Job job;
+   volatile TN_BOOL done;
+   enum TN_RCode rc;
+   void *p_data;
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+const char tt_test_name[] = "wait_order";
+
+static struct TN_Task _tasks[ _TASKS_CNT ];
+static TN_UWord _task_stacks[ _TASKS_CNT ][ TT_TASK_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+static struct _Helper _helpers[ _TASKS_CNT ];
+
+static struct TN_Sem _sem;
+static struct TN_Mutex _mutex;
+static struct TN_DQueue _queue;
+static void *_queue_buf[1];
+static struct TN_FMem _fmem;
+TN_FMEM_BUF_DEF(_fmem_buf, TN_UWord, _FMEM_BLOCKS_CNT);
+
+//-- indexes of the tasks, in the order their waits have completed
+static int _log[ _TASKS_CNT ];
+static volatile int _log_cnt;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _task_body(void *par)
+{
+   int idx = (int)(TN_UIntPtr)par;
+   struct _Helper *helper = &_helpers[idx];
+
+   switch (helper->job){
+      case _JOB_SEM:
+         helper->rc = tn_sem_wait(&_sem, TN_WAIT_INFINITE);
+         break;
+      case _JOB_MUTEX_SEM:
+         TT_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK);
+         helper->rc = tn_sem_wait(&_sem, TN_WAIT_INFINITE);
+         break;
+      case _JOB_MUTEX:
+         helper->rc = tn_mutex_lock(&_mutex, _LOCK_TMO);
+         break;
+      case _JOB_RECEIVE:
+         helper->rc = tn_queue_receive(
+               &_queue, &helper->p_data, TN_WAIT_INFINITE
+               );
+         break;
+      case _JOB_SEND:
+         helper->rc = tn_queue_send(&_queue, _ITEM(idx), TN_WAIT_INFINITE);
+         break;
+      case _JOB_FMEM:
+         helper->rc = tn_fmem_get(&_fmem, &helper->p_data, TN_WAIT_INFINITE);
+         break;
+   }
+
+   //-- mutex lockers aren't logged: we check their results directly
+   if (helper->rc == TN_RC_OK && helper->job != _JOB_MUTEX){
+      _log[_log_cnt++] = idx;
+   }
+   helper->done = TN_TRUE;
+
+   if (helper->job == _JOB_MUTEX_SEM || helper->job == _JOB_MUTEX){
+      if (_mutex.holder == &_tasks[idx]){
+         TT_CHECK(tn_mutex_unlock(&_mutex) == TN_RC_OK);
+      }
+   }
+
+   tn_task_sleep(TN_WAIT_INFINITE);
+}
+
+/**
+ * Start the helper task `idx` with the given priority: it runs (and starts
+ * waiting) right away.
+ */
+static void _helper_start(int idx, enum _Job job, int priority)
+{
+   struct _Helper *helper = &_helpers[idx];
+
+   helper->job = job;
+   helper->done = TN_FALSE;
+   helper->rc = TN_RC_INTERNAL;
+   helper->p_data = TN_NULL;
+
+   TT_CHECK(tn_task_create(
+            &_tasks[idx], _task_body, priority, _task_stacks[idx],
+            TT_TASK_STACK_SIZE, (void *)(TN_UIntPtr)idx,
+            TN_TASK_CREATE_OPT_START
+            ) == TN_RC_OK);
+
+   tn_task_sleep(1);
+   TT_CHECK(!helper->done);
+}
+
+static void _helpers_remove(int cnt)
+{
+   int i;
+
+   for (i = 0; i < cnt; i++){
+      TT_CHECK(tn_task_terminate(&_tasks[i]) == TN_RC_OK);
+      TT_CHECK(tn_task_delete(&_tasks[i]) == TN_RC_OK);
+   }
+
+   _log_cnt = 0;
+}
+
+/**
+ * Signal the semaphore `cnt` times, letting the woken up task run each
+ * time, and check the order of the wakeups
+ */
+static void _sem_order_check(int cnt, const int *order)
+{
+   int i;
+
+   _log_cnt = 0;
+   for (i = 0; i < cnt; i++){
+      TT_CHECK(tn_sem_signal(&_sem) == TN_RC_OK);
+      tn_task_sleep(1);
+      TT_CHECK(_log_cnt == i + 1);
+      TT_CHECK(_log[i] == order[i]);
+   }
+}
+
+
+
+//-- Order by priority {{{
+
+static void _params_test(void)
+{
+   const enum TN_WaitOrder wrong = (enum TN_WaitOrder)5;
+
+   TT_CHECK(tn_sem_create_wattr(&_sem, 0, 10, wrong) == TN_RC_WPARAM);
+   TT_CHECK(tn_queue_create_wattr(&_queue, _queue_buf, 1, wrong)
+         == TN_RC_WPARAM);
+   TT_CHECK(tn_fmem_create_wattr(
+            &_fmem, _fmem_buf, TN_MAKE_ALIG_SIZE(sizeof(TN_UWord)),
+            _FMEM_BLOCKS_CNT, wrong
+            ) == TN_RC_WPARAM);
+}
+
+static void _fifo_test(void)
+{
+   static const int order[] = { 0, 1, 2 };
+
+   TT_CHECK(tn_sem_create(&_sem, 0, 10) == TN_RC_OK);
+
+   _helper_start(0, _JOB_SEM, 8);
+   _helper_start(1, _JOB_SEM, 6);
+   _helper_start(2, _JOB_SEM, 4);
+
+   //-- priority change doesn't move the task in the FIFO queue
+   TT_CHECK(tn_task_change_priority(&_tasks[1], 2) == TN_RC_OK);
+
+   _sem_order_check(3, order);
+   _helpers_remove(3);
+
+   TT_CHECK(tn_sem_delete(&_sem) == TN_RC_OK);
+}
+
+static void _prio_test(void)
+{
+   static const int order[] = { 2, 1, 3, 0, 4 };
+
+   TT_CHECK(tn_sem_create_wattr(&_sem, 0, 10, TN_WAIT_ORDER_PRIO)
+         == TN_RC_OK);
+
+   _helper_start(0, _JOB_SEM, 8);
+   _helper_start(1, _JOB_SEM, 6);
+   _helper_start(2, _JOB_SEM, 4);
+   _helper_start(3, _JOB_SEM, 6);
+   _helper_start(4, _JOB_SEM, 9);
+
+   _sem_order_check(5, order);
+   _helpers_remove(5);
+
+   TT_CHECK(tn_sem_delete(&_sem) == TN_RC_OK);
+}
+
+// }}}
+
+//-- Priority change {{{
+
+static void _change_priority_test(void)
+{
+   static const int order_1[] = { 0, 2, 1 };
+   static const int order_2[] = { 1, 2, 0 };
+
+   TT_CHECK(tn_sem_create_wattr(&_sem, 0, 10, TN_WAIT_ORDER_PRIO)
+         == TN_RC_OK);
+
+   //-- the lowest waiter becomes the highest one, and vice versa
+   _helper_start(0, _JOB_SEM, 8);
+   _helper_start(1, _JOB_SEM, 6);
+   _helper_start(2, _JOB_SEM, 7);
+   TT_CHECK(tn_task_change_priority(&_tasks[0], 2) == TN_RC_OK);
+   TT_CHECK(tn_task_change_priority(&_tasks[1], 9) == TN_RC_OK);
+   _sem_order_check(3, order_1);
+   _helpers_remove(3);
+
+   //-- the task which gets the same priority as other waiters goes after
+   //   them, and the one which gets lower priority goes after all
+   _helper_start(0, _JOB_SEM, 6);
+   _helper_start(1, _JOB_SEM, 6);
+   _helper_start(2, _JOB_SEM, 8);
+   TT_CHECK(tn_task_change_priority(&_tasks[2], 6) == TN_RC_OK);
+   TT_CHECK(tn_task_change_priority(&_tasks[0], 7) == TN_RC_OK);
+   _sem_order_check(3, order_2);
+   _helpers_remove(3);
+
+   TT_CHECK(tn_sem_delete(&_sem) == TN_RC_OK);
+}
+
+// }}}
+
+//-- Priority inheritance {{{
+
+static void _inherit_test(void)
+{
+   static const int order_1[] = { 0 };
+   static const int order_2[] = { 1 };
+
+   TT_CHECK(tn_sem_create_wattr(&_sem, 0, 10, TN_WAIT_ORDER_PRIO)
+         == TN_RC_OK);
+   TT_CHECK(tn_mutex_create(&_mutex, TN_MUTEX_PROT_INHERIT, 0) == TN_RC_OK);
+
+   //-- task 0 holds the mutex and waits for the semaphore behind task 1
+   _helper_start(0, _JOB_MUTEX_SEM, 9);
+   _helper_start(1, _JOB_SEM, 6);
+
+   //-- task 2 locks the mutex, so task 0 inherits its priority, and then
+   //   gives up: task 0 gets back to its own priority, and to its place
+   //   behind task 1
+   _helper_start(2, _JOB_MUTEX, 3);
+   TT_CHECK(_tasks[0].priority == 3);
+   tn_task_sleep(_LOCK_TMO);
+   TT_CHECK(_helpers[2].done && _helpers[2].rc == TN_RC_TIMEOUT);
+   TT_CHECK(_tasks[0].priority == 9);
+
+   //-- task 3 locks the mutex as well, and doesn't give up: task 0 goes
+   //   first, and then task 3 gets the mutex
+   _helper_start(3, _JOB_MUTEX, 3);
+   TT_CHECK(_tasks[0].priority == 3);
+   _sem_order_check(1, order_1);
+   TT_CHECK(_helpers[3].done && _helpers[3].rc == TN_RC_OK);
+   TT_CHECK(_tasks[0].priority == 9);
+
+   _sem_order_check(1, order_2);
+
+   _helpers_remove(4);
+   TT_CHECK(tn_mutex_delete(&_mutex) == TN_RC_OK);
+   TT_CHECK(tn_sem_delete(&_sem) == TN_RC_OK);
+}
+
+// }}}
+
+//-- Data queue and memory pool {{{
+
+static void _queue_fmem_test(void)
+{
+   void *item;
+   void *blocks[ _FMEM_BLOCKS_CNT ];
+   int i;
+
+   TT_CHECK(tn_queue_create_wattr(&_queue, _queue_buf, 1, TN_WAIT_ORDER_PRIO)
+         == TN_RC_OK);
+   TT_CHECK(tn_fmem_create_wattr(
+            &_fmem, _fmem_buf, TN_MAKE_ALIG_SIZE(sizeof(TN_UWord)),
+            _FMEM_BLOCKS_CNT, TN_WAIT_ORDER_PRIO
+            ) == TN_RC_OK);
+
+   //-- receivers
+   _helper_start(0, _JOB_RECEIVE, 8);
+   _helper_start(1, _JOB_RECEIVE, 4);
+   TT_CHECK(tn_queue_send_polling(&_queue, _ITEM(10)) == TN_RC_OK);
+   tn_task_sleep(1);
+   TT_CHECK(_log_cnt == 1 && _log[0] == 1);
+   TT_CHECK(_helpers[1].p_data == _ITEM(10));
+   _helpers_remove(2);
+
+   //-- senders, to the full queue
+   TT_CHECK(tn_queue_send_polling(&_queue, _ITEM(10)) == TN_RC_OK);
+   _helper_start(0, _JOB_SEND, 8);
+   _helper_start(1, _JOB_SEND, 4);
+   TT_CHECK(tn_queue_receive_polling(&_queue, &item) == TN_RC_OK);
+   TT_CHECK(item == _ITEM(10));
+   tn_task_sleep(1);
+   TT_CHECK(_log_cnt == 1 && _log[0] == 1);
+   TT_CHECK(tn_queue_receive_polling(&_queue, &item) == TN_RC_OK);
+   TT_CHECK(item == _ITEM(1));
+   _helpers_remove(2);
+
+   //-- memory pool
+   for (i = 0; i < _FMEM_BLOCKS_CNT; i++){
+      TT_CHECK(tn_fmem_get_polling(&_fmem, &blocks[i]) == TN_RC_OK);
+   }
+   _helper_start(0, _JOB_FMEM, 8);
+   _helper_start(1, _JOB_FMEM, 4);
+   TT_CHECK(tn_fmem_release(&_fmem, blocks[0]) == TN_RC_OK);
+   tn_task_sleep(1);
+   TT_CHECK(_log_cnt == 1 && _log[0] == 1);
+   TT_CHECK(_helpers[1].p_data == blocks[0]);
+   _helpers_remove(2);
+   TT_CHECK(tn_fmem_release(&_fmem, blocks[0]) == TN_RC_OK);
+   TT_CHECK(tn_fmem_release(&_fmem, blocks[1]) == TN_RC_OK);
+
+   TT_CHECK(tn_queue_delete(&_queue) == TN_RC_OK);
+   TT_CHECK(tn_fmem_delete(&_fmem) == TN_RC_OK);
+}
+
+// }}}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tt_test_run(void)
+{
+   _params_test();
+   _fifo_test();
+   _prio_test();
+   _change_priority_test();
+   _inherit_test();
+   _queue_fmem_test();
+}
+
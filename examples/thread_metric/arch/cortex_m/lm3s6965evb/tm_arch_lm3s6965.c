@@ -0,0 +1,246 @@
+/**
+ * \file
+ *
+ * Thread-Metric style benchmark: Cortex-M3 part, for the TI Stellaris
+ * LM3S6965 (the `lm3s6965evb` board emulated by QEMU).
+ *
+ * It is self-contained: vector table and startup code are here as well, so
+ * no vendor files are needed. The report is printed to UART0 (QEMU connects
+ * it to stdio with `-nographic`); when all tests are done, QEMU is stopped
+ * by the semihosting call (QEMU should be started with `-semihosting`).
+ *
+ * The benchmark interrupt is IRQ 0 (GPIO Port A), which is triggered by
+ * setting its pending bit in NVIC.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn.h"
+#include "../../../tm_bench.h"
+
+#if TN_DYNAMIC_TICK
+#  error dynamic tick isn't supported by this board code: SysTick is periodic
+#endif
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- system frequency: LM3S6965 runs from 12 MHz after reset, and nothing
+//   changes it here
+#define SYS_FREQ           12000000UL
+
+//-- system timer period (auto-calculated)
+#define SYS_TMR_PERIOD     (SYS_FREQ / TM_TICK_FREQ)
+
+//-- idle task stack size, in words
+#define IDLE_TASK_STACK_SIZE          (TN_MIN_STACK_SIZE + 32)
+
+//-- interrupt stack size, in words
+#define INTERRUPT_STACK_SIZE          (TN_MIN_STACK_SIZE + 128)
+
+//-- registers
+#define REG(addr)          (*(volatile unsigned long *)(addr))
+
+#define UART0_DR           REG(0x4000C000)
+#define UART0_FR           REG(0x4000C018)
+#define UART_FR_TXFF       (1 << 5)
+
+#define SYST_CSR           REG(0xE000E010)
+#define SYST_RVR           REG(0xE000E014)
+#define SYST_CVR           REG(0xE000E018)
+
+#define NVIC_ISER0         REG(0xE000E100)
+#define NVIC_ISPR0         REG(0xE000E200)
+
+//-- IRQ used for the benchmark interrupt
+#define BENCH_IRQN         0
+
+//-- semihosting: "application exit" reason for SYS_EXIT
+#define SH_SYS_EXIT                    0x18
+#define SH_ADP_STOPPED_APP_EXIT        0x20026
+
+
+
+/*******************************************************************************
+ *    EXTERNAL DATA
+ ******************************************************************************/
+
+//-- provided by the linker script
+extern unsigned long _sidata;
+extern unsigned long _sdata;
+extern unsigned long _edata;
+extern unsigned long _sbss;
+extern unsigned long _ebss;
+
+//-- top of the stack for main(), used until the kernel is started; after
+//   that, it isn't used at all (interrupts use `interrupt_stack`)
+extern unsigned long _estack;
+
+
+
+/*******************************************************************************
+ *    DATA
+ ******************************************************************************/
+
+TN_STACK_ARR_DEF(idle_task_stack, IDLE_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(interrupt_stack, INTERRUPT_STACK_SIZE);
+
+
+
+/*******************************************************************************
+ *    ISRs
+ ******************************************************************************/
+
+void PendSV_Handler(void);
+void SVC_Handler(void);
+void Reset_Handler(void);
+
+static void Default_Handler(void)
+{
+   for (;;);
+}
+
+/**
+ * system timer ISR
+ */
+static void SysTick_Handler(void)
+{
+   tn_tick_int_processing();
+}
+
+/**
+ * benchmark ISR
+ */
+static void Bench_IRQHandler(void)
+{
+   tm_bench_isr();
+}
+
+/**
+ * Vector table: system exceptions and the first IRQ, which is the only one
+ * we use.
+ */
+__attribute__((section(".isr_vector"), used))
+static void (*const _vectors[])(void) = {
+   (void (*)(void))&_estack,
+   Reset_Handler,
+   Default_Handler,     //-- NMI
+   Default_Handler,     //-- HardFault
+   Default_Handler,     //-- MemManage
+   Default_Handler,     //-- BusFault
+   Default_Handler,     //-- UsageFault
+   0, 0, 0, 0,
+   SVC_Handler,
+   Default_Handler,     //-- DebugMon
+   0,
+   PendSV_Handler,
+   SysTick_Handler,
+   Bench_IRQHandler,    //-- IRQ 0
+};
+
+
+
+/*******************************************************************************
+ *    FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tm_arch_putc(char c)
+{
+   while (UART0_FR & UART_FR_TXFF);
+   UART0_DR = (unsigned long)c;
+}
+
+/*
+ * See comments in the header file
+ */
+void tm_arch_int_trigger(void)
+{
+   NVIC_ISPR0 = (1 << BENCH_IRQN);
+
+   //-- make sure the interrupt is taken right here
+   __asm__ volatile ("dsb\n isb" ::: "memory");
+}
+
+/*
+ * See comments in the header file
+ */
+void tm_arch_exit(void)
+{
+   register unsigned long r0 __asm__("r0") = SH_SYS_EXIT;
+   register unsigned long r1 __asm__("r1") = SH_ADP_STOPPED_APP_EXIT;
+
+   __asm__ volatile ("bkpt #0xab" : : "r" (r0), "r" (r1) : "memory");
+}
+
+/**
+ * Hardware init: called from main() with interrupts disabled
+ */
+static void hw_init(void)
+{
+   //-- init system timer
+   SYST_RVR = SYS_TMR_PERIOD - 1;
+   SYST_CVR = 0;
+   SYST_CSR = (1 << 2)/*CLKSOURCE*/ | (1 << 1)/*TICKINT*/ | (1 << 0)/*ENABLE*/;
+
+   //-- enable the benchmark interrupt (its priority is 0 after reset)
+   NVIC_ISER0 = (1 << BENCH_IRQN);
+}
+
+//-- idle callback that is called periodically from idle task
+static void idle_task_callback (void)
+{
+}
+
+int main(void)
+{
+   //-- unconditionally disable interrupts
+   tn_arch_int_dis();
+
+   //-- init hardware
+   hw_init();
+
+   //-- call to tn_sys_start() never returns
+   tn_sys_start(
+         idle_task_stack,
+         IDLE_TASK_STACK_SIZE,
+         interrupt_stack,
+         INTERRUPT_STACK_SIZE,
+         tm_bench_init_task_create,
+         idle_task_callback
+         );
+
+   //-- unreachable
+   return 1;
+}
+
+/**
+ * Startup code: init .data and .bss, and call main()
+ */
+void Reset_Handler(void)
+{
+   unsigned long *src = &_sidata;
+   unsigned long *dst;
+
+   for (dst = &_sdata; dst < &_edata; ){
+      *dst++ = *src++;
+   }
+
+   for (dst = &_sbss; dst < &_ebss; ){
+      *dst++ = 0;
+   }
+
+   main();
+
+   for (;;);
+}
+
+
@@ -0,0 +1,180 @@
+/**
+ * \file
+ *
+ * Thread-Metric style benchmark: POSIX (Linux host) part. The benchmark
+ * interrupt is `SIGUSR1`, raised by the process itself.
+ *
+ * With `#TN_DYNAMIC_TICK`, `SIGALRM` increments the tick count, like the
+ * free-running hardware counter with the compare interrupt does, and
+ * `tn_tick_int_processing()` is called only at the ticks scheduled by the
+ * kernel.
+ *
+ * Note that results on the host are affected by the host OS scheduler, and
+ * by the cost of the system calls which the port uses to manage signal
+ * masks; they are useful to compare kernel builds on the same machine, not
+ * to compare with the MCU figures.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "tn.h"
+#include "../../tm_bench.h"
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- idle task stack size, in words
+#define IDLE_TASK_STACK_SIZE          (TN_MIN_STACK_SIZE + 32)
+
+//-- interrupt stack size, in words
+#define INTERRUPT_STACK_SIZE          (TN_MIN_STACK_SIZE + 64)
+
+
+
+/*******************************************************************************
+ *    DATA
+ ******************************************************************************/
+
+TN_STACK_ARR_DEF(idle_task_stack, IDLE_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(interrupt_stack, INTERRUPT_STACK_SIZE);
+
+#if TN_DYNAMIC_TICK
+//-- tick count, incremented by each `SIGALRM`
+static volatile TN_TickCnt tick_cnt;
+
+//-- number of signals to get before the next call to
+//   `tn_tick_int_processing()`, or `TN_WAIT_INFINITE`
+static volatile TN_TickCnt tick_wait = TN_WAIT_INFINITE;
+#endif
+
+
+
+/*******************************************************************************
+ *    ISRs
+ ******************************************************************************/
+
+/**
+ * system timer ISR
+ */
+static void tick_isr(void)
+{
+#if TN_DYNAMIC_TICK
+   tick_cnt++;
+
+   if (tick_wait == TN_WAIT_INFINITE){
+      //-- no tick needed
+   } else if (tick_wait > 1){
+      tick_wait--;
+   } else {
+      //-- the kernel schedules the next one from tn_tick_int_processing()
+      tick_wait = TN_WAIT_INFINITE;
+      tn_tick_int_processing();
+   }
+#else
+   tn_tick_int_processing();
+#endif
+}
+
+
+
+/*******************************************************************************
+ *    FUNCTIONS
+ ******************************************************************************/
+
+#if TN_DYNAMIC_TICK
+//-- called by the kernel to schedule the next call to
+//   tn_tick_int_processing(): it is called when `timeout` more signals are
+//   got
+static void tick_schedule(TN_TickCnt timeout)
+{
+   tick_wait = timeout;
+}
+
+//-- called by the kernel to get the current tick count
+static TN_TickCnt tick_cnt_get(void)
+{
+   return tick_cnt;
+}
+#endif
+
+/*
+ * See comments in the header file
+ */
+void tm_arch_putc(char c)
+{
+   putchar(c);
+   if (c == '\n'){
+      fflush(stdout);
+   }
+}
+
+/*
+ * See comments in the header file
+ */
+void tm_arch_int_trigger(void)
+{
+   //-- the signal is delivered before raise() returns
+   raise(SIGUSR1);
+}
+
+/*
+ * See comments in the header file
+ */
+void tm_arch_exit(void)
+{
+   fflush(stdout);
+   exit(0);
+}
+
+//-- create first application task(s)
+static void init_task_create(void)
+{
+   tn_posix_isr_set(SIGUSR1, tm_bench_isr);
+   tn_posix_isr_set(SIGALRM, tick_isr);
+   tn_posix_timer_start(1000000 / TM_TICK_FREQ);
+
+   tm_bench_init_task_create();
+}
+
+//-- idle callback that is called periodically from idle task
+static void idle_task_callback (void)
+{
+   //-- wait for the next signal
+   pause();
+}
+
+int main(void)
+{
+   //-- unconditionally disable interrupts
+   tn_arch_int_dis();
+
+#if TN_DYNAMIC_TICK
+   tn_callback_dyn_tick_set(tick_schedule, tick_cnt_get);
+#endif
+
+   //-- call to tn_sys_start() never returns
+   tn_sys_start(
+         idle_task_stack,
+         IDLE_TASK_STACK_SIZE,
+         interrupt_stack,
+         INTERRUPT_STACK_SIZE,
+         init_task_create,
+         idle_task_callback
+         );
+
+   //-- unreachable
+   return 1;
+}
+
+
@@ -0,0 +1,1324 @@
+/**
+ * \file
+ *
+ * Thread-Metric style benchmark suite for TNeo: portable part, see
+ * readme.txt for details.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tm_bench.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- reporter task has the highest priority, so that it is able to stop
+//   any test
+#define _REPORTER_PRIORITY       1
+
+//-- priorities of the test tasks: 0 is the highest one
+#define _TASK_PRIORITY(n)        (2 + (n))
+
+//-- number of tasks in the context switch tests
+#define _SWITCH_TASKS_CNT        5
+
+//-- get task index from the task body parameter
+#define _TASK_IDX(par)           ((int)(TN_UIntPtr)(par))
+
+//-- size of the message, as in the original Thread-Metric: 16 bytes
+#define _MSG_WORDS_CNT           (16 / sizeof(TN_UWord))
+
+//-- number of items in the queue and in the memory pool
+#define _OBJ_ITEMS_CNT           4
+
+//-- number of items in the burst in the burst message tests, and the size
+//   of the queue for them
+#define _BURST_ITEMS_CNT         16
+
+//-- period of the task in the periodic release jitter test, in ticks
+#define _JITTER_PERIOD           10
+
+//-- number of releases in each mode of the jitter test: the same time
+//   as a single interval of other tests
+#define _JITTER_RELEASES_CNT                                            \
+   ((unsigned long)TM_INTERVAL_SEC * TM_TICK_FREQ / _JITTER_PERIOD)
+
+//-- max amount of work done by the periodic task in each period, in ticks
+#define _JITTER_WORK_MAX         3
+
+//-- period and amount of work of the disturbing higher-priority task,
+//   in ticks
+#define _JITTER_DISTURB_PERIOD   7
+#define _JITTER_DISTURB_WORK     2
+
+//-- number of calls of each service in the uncontended semaphore test
+#define _SEM_COST_CALLS_CNT      1000
+
+//-- number of starts of the probe timer for each number of active timers
+//   in the timer start cost test
+#define _TIMER_COST_CALLS_CNT    1000
+
+//-- range of timeouts of the timers in the timer start cost test: large
+//   enough for none of them to fire during the test
+#define _TIMER_COST_TIMEOUT_MIN  10000
+#define _TIMER_COST_TIMEOUT_MAX  20000
+
+//-- number of waits of the probe task for each number of waiters in the
+//   wait enqueue cost test, max number of waiters, and the size of their
+//   stacks: they just wait, so the stacks are small
+#define _WAIT_COST_CALLS_CNT     1000
+#define _WAIT_COST_WAITERS_MAX   16
+#define _WAIT_COST_STACK_SIZE    (TN_MIN_STACK_SIZE + 64)
+
+//-- size of the exchange data in the exchange read tests: 32 bytes
+#define _EXCH_WORDS_CNT          (32 / sizeof(TN_UWord))
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/**
+ * Descriptor of the single test
+ */
+struct TmTest {
+   ///
+   /// Name to print in the report
+   const char *name;
+   ///
+   /// Create kernel objects and tasks for the test
+   void (*init)(void);
+   ///
+   /// Delete kernel objects of the test; tasks are already deleted by the
+   /// reporter when it is called. May be `TN_NULL`.
+   void (*deinit)(void);
+   ///
+   /// Called from `tm_bench_isr()` while the test is running. May be
+   /// `TN_NULL`.
+   void (*isr)(void);
+};
+
+struct _Msg {
+   TN_UWord data[ _MSG_WORDS_CNT ];
+};
+
+struct _ExchData {
+   TN_UWord data[ _EXCH_WORDS_CNT ];
+};
+
+/**
+ * Cost of the single service call, in cycles
+ */
+struct _Cost {
+   TN_UWord min;
+   unsigned long total;
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+TN_STACK_ARR_DEF(_reporter_stack, TM_TASK_STACK_SIZE);
+
+TN_STACK_ARR_DEF(_task_stack_0, TM_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(_task_stack_1, TM_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(_task_stack_2, TM_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(_task_stack_3, TM_TASK_STACK_SIZE);
+TN_STACK_ARR_DEF(_task_stack_4, TM_TASK_STACK_SIZE);
+
+static TN_UWord *const _task_stacks[ TM_TASKS_MAX ] = {
+   _task_stack_0,
+   _task_stack_1,
+   _task_stack_2,
+   _task_stack_3,
+   _task_stack_4,
+};
+
+static struct TN_Task _reporter_task;
+static struct TN_Task _tasks[ TM_TASKS_MAX ];
+
+//-- number of tasks created by the current test
+static int _tasks_cnt = 0;
+
+//-- operation counters, one per task
+static volatile unsigned long _ops_cnt[ TM_TASKS_MAX ];
+
+//-- currently running test, its `isr` is called from `tm_bench_isr()`
+static const struct TmTest *volatile _cur_test = TN_NULL;
+
+//-- kernel objects used by tests
+static struct TN_Sem _sem_a;
+static struct TN_Sem _sem_b;
+static struct TN_Mutex _mutex;
+static struct TN_DQueue _queue;
+static void *_queue_buf[ _OBJ_ITEMS_CNT ];
+static void *_burst_queue_buf[ _BURST_ITEMS_CNT ];
+static struct TN_FMem _fmem;
+TN_FMEM_BUF_DEF(_fmem_buf, struct _Msg, _OBJ_ITEMS_CNT);
+static struct _Msg _msg;
+static struct TN_Exch _exch;
+TN_EXCH_DATA_BUF_DEF(_exch_buf, struct _ExchData);
+
+//-- results of the jitter test, see `_jitter_run()`
+static TN_BOOL _jitter_periodic;
+static TN_TickCnt _jitter_interval_min;
+static TN_TickCnt _jitter_interval_max;
+static TN_TickCnt _jitter_drift;
+static unsigned long _jitter_overruns;
+
+static struct _Cost _cost_signal;
+static struct _Cost _cost_isignal;
+static struct _Cost _cost_wait;
+
+static struct TN_Timer _cost_timers[ TM_TIMERS_MAX ];
+static struct TN_Timer _cost_probe_timer;
+static struct _Cost _cost_timer_start;
+static struct _Cost _cost_timer_cancel;
+
+static struct TN_Task _wait_cost_probe_task;
+static struct TN_Task _wait_cost_waiter_tasks[ _WAIT_COST_WAITERS_MAX ];
+static TN_ARCH_STK_ATTR_BEFORE TN_UWord _wait_cost_waiter_stacks
+   [ _WAIT_COST_WAITERS_MAX ][ _WAIT_COST_STACK_SIZE ]
+   TN_ARCH_STK_ATTR_AFTER;
+static struct _Cost _cost_wait_enqueue;
+static volatile TN_UWord _wait_cost_start;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void _print_str(const char *str)
+{
+   while (*str != '\0'){
+      tm_arch_putc(*str++);
+   }
+}
+
+static void _print_ulong(unsigned long val)
+{
+   char buf[24];
+   int i = sizeof(buf);
+
+   buf[--i] = '\0';
+   do {
+      buf[--i] = '0' + (val % 10);
+      val /= 10;
+   } while (val != 0);
+
+   _print_str(&buf[i]);
+}
+
+static void _task_create(int idx, TN_TaskBody *task_body, int priority)
+{
+   tn_task_create(
+         &_tasks[idx],
+         task_body,
+         priority,
+         _task_stacks[idx],
+         TM_TASK_STACK_SIZE,
+         (void *)(TN_UIntPtr)idx,
+         TN_TASK_CREATE_OPT_START
+         );
+
+   if (idx >= _tasks_cnt){
+      _tasks_cnt = idx + 1;
+   }
+}
+
+static void _tasks_delete(void)
+{
+   int i;
+
+   for (i = 0; i < _tasks_cnt; i++){
+      //-- it fails with TN_RC_WSTATE if the task is already dormant,
+      //   which is fine
+      tn_task_terminate(&_tasks[i]);
+      tn_task_delete(&_tasks[i]);
+      _ops_cnt[i] = 0;
+   }
+
+   _tasks_cnt = 0;
+}
+
+static unsigned long _ops_total_get(void)
+{
+   unsigned long ret = 0;
+   int i;
+
+   for (i = 0; i < TM_TASKS_MAX; i++){
+      ret += _ops_cnt[i];
+   }
+
+   return ret;
+}
+
+
+
+//-- Cooperative context switch {{{
+//
+//   Tasks of the same priority pass control to each other in a round:
+//   each task resumes the next one and suspends itself. Each operation is
+//   one context switch.
+
+static void _coop_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+
+   for (;;){
+      _ops_cnt[idx]++;
+      tn_task_resume(&_tasks[(idx + 1) % _SWITCH_TASKS_CNT]);
+      tn_task_suspend(&_tasks[idx]);
+   }
+}
+
+static void _coop_init(void)
+{
+   int i;
+
+   for (i = 0; i < _SWITCH_TASKS_CNT; i++){
+      _task_create(i, _coop_task_body, _TASK_PRIORITY(2));
+   }
+}
+
+// }}}
+
+//-- Preemptive context switch {{{
+//
+//   Tasks of different priorities: the lowest one resumes the next higher
+//   one, which preempts it and resumes the next higher one, and so on; the
+//   highest task suspends itself, then the next lower one does the same, etc.
+//   Each operation is one context switch.
+
+static void _preempt_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+
+   for (;;){
+      _ops_cnt[idx]++;
+
+      if (idx > 0){
+         tn_task_resume(&_tasks[idx - 1]);
+      }
+
+      if (idx < _SWITCH_TASKS_CNT - 1){
+         tn_task_suspend(&_tasks[idx]);
+      }
+   }
+}
+
+static void _preempt_init(void)
+{
+   int i;
+
+   for (i = 0; i < _SWITCH_TASKS_CNT; i++){
+      _task_create(i, _preempt_task_body, _TASK_PRIORITY(i));
+   }
+}
+
+// }}}
+
+//-- Interrupt processing {{{
+//
+//   The task triggers the interrupt, ISR signals the semaphore, and the task
+//   takes it without waiting.
+
+static void _int_isr(void)
+{
+   tn_sem_isignal(&_sem_a);
+}
+
+static void _int_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+
+   for (;;){
+      tm_arch_int_trigger();
+
+      if (tn_sem_wait_polling(&_sem_a) == TN_RC_OK){
+         _ops_cnt[idx]++;
+      }
+   }
+}
+
+static void _int_init(void)
+{
+   tn_sem_create(&_sem_a, 0, 1);
+   _task_create(0, _int_task_body, _TASK_PRIORITY(0));
+}
+
+static void _sem_deinit(void)
+{
+   tn_sem_delete(&_sem_a);
+   tn_sem_delete(&_sem_b);
+}
+
+// }}}
+
+//-- Interrupt preemption processing {{{
+//
+//   The low-priority task triggers the interrupt, ISR signals the semaphore
+//   which the high-priority task waits for, so the high-priority task
+//   preempts the low-priority one right after the ISR.
+
+static void _int_preempt_hi_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+
+   for (;;){
+      if (tn_sem_wait(&_sem_a, TN_WAIT_INFINITE) == TN_RC_OK){
+         _ops_cnt[idx]++;
+      }
+   }
+}
+
+static void _int_preempt_lo_task_body(void *par)
+{
+   (void)par;
+
+   for (;;){
+      tm_arch_int_trigger();
+   }
+}
+
+static void _int_preempt_init(void)
+{
+   tn_sem_create(&_sem_a, 0, 1);
+   _task_create(0, _int_preempt_hi_task_body, _TASK_PRIORITY(0));
+   _task_create(1, _int_preempt_lo_task_body, _TASK_PRIORITY(1));
+}
+
+// }}}
+
+#if TN_TASK_NOTIFY
+//-- Interrupt processing / preemption by task notification {{{
+//
+//   The same as the two tests above, but ISR notifies the task directly
+//   instead of signalling the semaphore, so the cost of the two mechanisms
+//   can be compared.
+
+static void _int_notify_isr(void)
+{
+   tn_task_inotify(&_tasks[0], TN_TASK_NOTIFY_INCREMENT, 0);
+}
+
+static void _int_notify_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+
+   for (;;){
+      tm_arch_int_trigger();
+
+      if (tn_task_notify_wait(
+               TN_NULL, TN_TASK_NOTIFY_WAIT_DEC, 0
+               ) == TN_RC_OK)
+      {
+         _ops_cnt[idx]++;
+      }
+   }
+}
+
+static void _int_notify_init(void)
+{
+   _task_create(0, _int_notify_task_body, _TASK_PRIORITY(0));
+}
+
+static void _int_notify_preempt_hi_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+
+   for (;;){
+      if (tn_task_notify_wait(
+               TN_NULL, TN_TASK_NOTIFY_WAIT_DEC, TN_WAIT_INFINITE
+               ) == TN_RC_OK)
+      {
+         _ops_cnt[idx]++;
+      }
+   }
+}
+
+static void _int_notify_preempt_init(void)
+{
+   _task_create(0, _int_notify_preempt_hi_task_body, _TASK_PRIORITY(0));
+   _task_create(1, _int_preempt_lo_task_body, _TASK_PRIORITY(1));
+}
+
+// }}}
+#endif
+
+//-- Message processing {{{
+//
+//   The task sends the 16-byte message (well, the pointer to it, which is
+//   how data queues are used along with the memory pool) to the queue, and
+//   receives it back.
+
+static void _msg_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+   void *p_msg;
+
+   for (;;){
+      _msg.data[0]++;
+      tn_queue_send(&_queue, &_msg, TN_WAIT_INFINITE);
+
+      if (
+            tn_queue_receive(&_queue, &p_msg, TN_WAIT_INFINITE) == TN_RC_OK
+            && p_msg == &_msg
+         )
+      {
+         _ops_cnt[idx]++;
+      }
+   }
+}
+
+static void _msg_init(void)
+{
+   tn_queue_create(&_queue, _queue_buf, _OBJ_ITEMS_CNT);
+   _task_create(0, _msg_task_body, _TASK_PRIORITY(0));
+}
+
+static void _msg_deinit(void)
+{
+   tn_queue_delete(&_queue);
+}
+
+// }}}
+
+//-- Burst message processing {{{
+//
+//   The task sends the burst of 16 pointers to the queue, and receives them
+//   back: by one item per call, and by `tn_queue_send_multi()` /
+//   `tn_queue_receive_multi()`, which handle the whole burst in one
+//   critical section. One operation is one item sent and received.
+
+static void _burst_single_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+   void *p_msg;
+   int i;
+
+   for (;;){
+      for (i = 0; i < _BURST_ITEMS_CNT; i++){
+         tn_queue_send(&_queue, &_msg, TN_WAIT_INFINITE);
+      }
+
+      for (i = 0; i < _BURST_ITEMS_CNT; i++){
+         if (
+               tn_queue_receive(&_queue, &p_msg, TN_WAIT_INFINITE) == TN_RC_OK
+               && p_msg == &_msg
+            )
+         {
+            _ops_cnt[idx]++;
+         }
+      }
+   }
+}
+
+static void _burst_multi_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+   void *burst[ _BURST_ITEMS_CNT ];
+   int received_cnt;
+   int i;
+
+   for (i = 0; i < _BURST_ITEMS_CNT; i++){
+      burst[i] = &_msg;
+   }
+
+   for (;;){
+      tn_queue_send_multi(
+            &_queue, burst, _BURST_ITEMS_CNT, TN_NULL, TN_WAIT_INFINITE
+            );
+
+      if (
+            tn_queue_receive_multi(
+               &_queue, burst, _BURST_ITEMS_CNT, &received_cnt,
+               TN_WAIT_INFINITE
+               ) == TN_RC_OK
+            && burst[ _BURST_ITEMS_CNT - 1 ] == &_msg
+         )
+      {
+         _ops_cnt[idx] += received_cnt;
+      }
+   }
+}
+
+static void _burst_single_init(void)
+{
+   tn_queue_create(&_queue, _burst_queue_buf, _BURST_ITEMS_CNT);
+   _task_create(0, _burst_single_task_body, _TASK_PRIORITY(0));
+}
+
+static void _burst_multi_init(void)
+{
+   tn_queue_create(&_queue, _burst_queue_buf, _BURST_ITEMS_CNT);
+   _task_create(0, _burst_multi_task_body, _TASK_PRIORITY(0));
+}
+
+// }}}
+
+//-- Semaphore ping-pong {{{
+//
+//   Two tasks signal semaphores to each other; each operation is a round
+//   trip, i.e. two context switches.
+
+static void _sem_pong_task_body(void *par)
+{
+   (void)par;
+
+   for (;;){
+      tn_sem_wait(&_sem_b, TN_WAIT_INFINITE);
+      tn_sem_signal(&_sem_a);
+   }
+}
+
+static void _sem_ping_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+
+   for (;;){
+      tn_sem_signal(&_sem_b);
+
+      if (tn_sem_wait(&_sem_a, TN_WAIT_INFINITE) == TN_RC_OK){
+         _ops_cnt[idx]++;
+      }
+   }
+}
+
+static void _sem_init(void)
+{
+   tn_sem_create(&_sem_a, 0, 1);
+   tn_sem_create(&_sem_b, 0, 1);
+   _task_create(0, _sem_pong_task_body, _TASK_PRIORITY(0));
+   _task_create(1, _sem_ping_task_body, _TASK_PRIORITY(1));
+}
+
+// }}}
+
+//-- Memory allocation {{{
+//
+//   The task gets the block from the fixed memory pool and releases it back.
+
+static void _fmem_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+   void *p_block;
+
+   for (;;){
+      if (tn_fmem_get(&_fmem, &p_block, TN_WAIT_INFINITE) == TN_RC_OK){
+         tn_fmem_release(&_fmem, p_block);
+         _ops_cnt[idx]++;
+      }
+   }
+}
+
+static void _fmem_init(void)
+{
+   tn_fmem_create(
+         &_fmem,
+         _fmem_buf,
+         TN_MAKE_ALIG_SIZE(sizeof(struct _Msg)),
+         _OBJ_ITEMS_CNT
+         );
+   _task_create(0, _fmem_task_body, _TASK_PRIORITY(0));
+}
+
+static void _fmem_deinit(void)
+{
+   tn_fmem_delete(&_fmem);
+}
+
+// }}}
+
+//-- Mutex contention {{{
+//
+//   The low-priority task locks the mutex and resumes the high-priority
+//   one, which tries to lock the mutex and blocks, so the low-priority task
+//   inherits its priority; then, the low-priority task unlocks the mutex,
+//   and the high-priority one gets it and runs.
+
+static void _mutex_hi_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+
+   for (;;){
+      tn_task_suspend(&_tasks[idx]);
+
+      if (tn_mutex_lock(&_mutex, TN_WAIT_INFINITE) == TN_RC_OK){
+         _ops_cnt[idx]++;
+         tn_mutex_unlock(&_mutex);
+      }
+   }
+}
+
+static void _mutex_lo_task_body(void *par)
+{
+   (void)par;
+
+   for (;;){
+      tn_mutex_lock(&_mutex, TN_WAIT_INFINITE);
+      tn_task_resume(&_tasks[0]);
+      tn_mutex_unlock(&_mutex);
+   }
+}
+
+static void _mutex_init(void)
+{
+   tn_mutex_create(&_mutex, TN_MUTEX_PROT_INHERIT, 0);
+   _task_create(0, _mutex_hi_task_body, _TASK_PRIORITY(0));
+   _task_create(1, _mutex_lo_task_body, _TASK_PRIORITY(1));
+}
+
+static void _mutex_deinit(void)
+{
+   tn_mutex_delete(&_mutex);
+}
+
+// }}}
+
+//-- Exchange read {{{
+//
+//   Readers of the same priority (with round-robin) read the exchange
+//   object in a loop, while the higher-priority writer writes it each tick,
+//   so some reads are interrupted by writes and repeated. Each operation is
+//   one read; since readers never take a lock, the total number of reads
+//   shouldn't depend on the number of readers.
+
+static void _exch_writer_task_body(void *par)
+{
+   struct _ExchData data;
+   TN_UWord cnt = 0;
+   unsigned int i;
+
+   (void)par;
+
+   for (;;){
+      cnt++;
+      for (i = 0; i < _EXCH_WORDS_CNT; i++){
+         data.data[i] = cnt;
+      }
+      tn_exch_write(&_exch, &data);
+      tn_task_sleep(1);
+   }
+}
+
+static void _exch_reader_task_body(void *par)
+{
+   int idx = _TASK_IDX(par);
+   struct _ExchData data;
+
+   for (;;){
+      if (tn_exch_read(&_exch, &data) == TN_RC_OK){
+         _ops_cnt[idx]++;
+      }
+   }
+}
+
+static void _exch_init(int readers_cnt)
+{
+   int i;
+
+   tn_exch_create(&_exch, _exch_buf, sizeof(_exch_buf));
+   tn_sys_tslice_set(_TASK_PRIORITY(1), 1);
+
+   _task_create(0, _exch_writer_task_body, _TASK_PRIORITY(0));
+   for (i = 1; i <= readers_cnt; i++){
+      _task_create(i, _exch_reader_task_body, _TASK_PRIORITY(1));
+   }
+}
+
+static void _exch_1_init(void)
+{
+   _exch_init(1);
+}
+
+static void _exch_2_init(void)
+{
+   _exch_init(2);
+}
+
+static void _exch_4_init(void)
+{
+   _exch_init(4);
+}
+
+static void _exch_deinit(void)
+{
+   tn_sys_tslice_set(_TASK_PRIORITY(1), TN_NO_TIME_SLICE);
+   tn_exch_delete(&_exch);
+}
+
+// }}}
+
+
+//-- Periodic release jitter {{{
+//
+//   It is not a throughput test: the task with the period of
+//   `_JITTER_PERIOD` ticks does some pseudo-random amount of work in each
+//   period, and it's preempted by the higher-priority task from time to
+//   time. The test is run twice: first, the task waits for the next period
+//   by `tn_task_sleep()`, then by `tn_task_period_wait()`. Min and max
+//   intervals between releases are reported, as well as the drift: how
+//   late the last release is, comparing to the ideal schedule.
+
+static void _ticks_spin(TN_TickCnt ticks)
+{
+   TN_TickCnt start = tn_sys_time_get();
+
+   while (tn_sys_time_get() - start < ticks){
+      //-- just spin
+   }
+}
+
+static void _jitter_disturb_task_body(void *par)
+{
+   (void)par;
+
+   for (;;){
+      tn_task_sleep(_JITTER_DISTURB_PERIOD);
+      _ticks_spin(_JITTER_DISTURB_WORK);
+   }
+}
+
+static void _jitter_task_body(void *par)
+{
+   struct TN_TaskPeriod per;
+   unsigned long rand = 1;
+   TN_TickCnt start;
+   TN_TickCnt prev;
+   TN_TickCnt cur;
+   unsigned long i;
+
+   (void)par;
+
+   tn_task_period_start(&per, _JITTER_PERIOD);
+   start = per.next_release - _JITTER_PERIOD;
+   prev = start;
+   cur = start;
+
+   _jitter_interval_min = TN_WAIT_INFINITE;
+   _jitter_interval_max = 0;
+
+   for (i = 0; i < _JITTER_RELEASES_CNT; i++){
+      //-- do some work
+      rand = rand * 1103515245UL + 12345UL;
+      _ticks_spin((rand >> 16) % (_JITTER_WORK_MAX + 1));
+
+      //-- wait for the next period
+      if (_jitter_periodic){
+         tn_task_period_wait(&per);
+      } else {
+         tn_task_sleep(_JITTER_PERIOD);
+      }
+
+      cur = tn_sys_time_get();
+      if (cur - prev < _jitter_interval_min){
+         _jitter_interval_min = cur - prev;
+      }
+      if (cur - prev > _jitter_interval_max){
+         _jitter_interval_max = cur - prev;
+      }
+      prev = cur;
+   }
+
+   _jitter_drift = cur - (start + _JITTER_RELEASES_CNT * _JITTER_PERIOD);
+   _jitter_overruns = per.overruns_cnt;
+
+   //-- tell the reporter we're done
+   tn_sem_signal(&_sem_a);
+
+   for (;;){
+      tn_task_sleep(TN_WAIT_INFINITE);
+   }
+}
+
+static void _jitter_run(TN_BOOL periodic)
+{
+   _jitter_periodic = periodic;
+
+   tn_sem_create(&_sem_a, 0, 1);
+   _task_create(0, _jitter_disturb_task_body, _TASK_PRIORITY(0));
+   _task_create(1, _jitter_task_body, _TASK_PRIORITY(1));
+
+   tn_sem_wait(&_sem_a, TN_WAIT_INFINITE);
+
+   _tasks_delete();
+   tn_sem_delete(&_sem_a);
+
+   _print_str("tm: periodic release, ");
+   _print_str(periodic ? "tn_task_period_wait()" : "tn_task_sleep()");
+   _print_str(": interval min ");
+   _print_ulong(_jitter_interval_min);
+   _print_str(" max ");
+   _print_ulong(_jitter_interval_max);
+   _print_str(" ticks, drift ");
+   _print_ulong(_jitter_drift);
+   _print_str(" ticks per ");
+   _print_ulong(_JITTER_RELEASES_CNT);
+   _print_str(" releases, overruns ");
+   _print_ulong(_jitter_overruns);
+   _print_str("\n");
+}
+
+// }}}
+
+//-- Uncontended semaphore cost {{{
+//
+//   It is not a throughput test either: the reporter task signals the
+//   semaphore nobody waits for and takes it back, then triggers the
+//   interrupt whose ISR signals it by `tn_sem_isignal()`, and so on. Each
+//   call is timed by the kernel's cycle counter `_TN_CYCLE_CNT_GET()`, so
+//   the test is run if only the port provides it. Min and average number of
+//   cycles per call are reported for each service. With `TN_FAST_PATH`,
+//   these calls don't disable interrupts on the architectures which have
+//   exclusive access instructions.
+
+#if defined(_TN_CYCLE_CNT_GET)
+
+static void _cost_reset(struct _Cost *cost)
+{
+   cost->min = (TN_UWord)-1;
+   cost->total = 0;
+}
+
+static void _cost_add(struct _Cost *cost, TN_UWord start)
+{
+   TN_UWord cycles = _TN_CYCLE_CNT_GET() - start;
+
+   if (cycles < cost->min){
+      cost->min = cycles;
+   }
+   cost->total += cycles;
+}
+
+static void _cost_values_print(
+      const struct _Cost *cost,
+      unsigned long calls_cnt
+      )
+{
+   _print_str(": min ");
+   _print_ulong(cost->min);
+   _print_str(" avg ");
+   _print_ulong(cost->total / calls_cnt);
+   _print_str(" cycles\n");
+}
+
+static void _cost_print(const char *name, const struct _Cost *cost)
+{
+   _print_str("tm: uncontended ");
+   _print_str(name);
+   _cost_values_print(cost, _SEM_COST_CALLS_CNT);
+}
+
+static void _sem_cost_isr(void)
+{
+   TN_UWord start = _TN_CYCLE_CNT_GET();
+
+   tn_sem_isignal(&_sem_a);
+   _cost_add(&_cost_isignal, start);
+}
+
+static const struct TmTest _sem_cost_test =
+   { "uncontended semaphore", TN_NULL, TN_NULL, _sem_cost_isr };
+
+static void _sem_cost_run(void)
+{
+   TN_UWord start;
+   int i;
+
+   _TN_CYCLE_CNT_INIT();
+
+   _cost_reset(&_cost_signal);
+   _cost_reset(&_cost_isignal);
+   _cost_reset(&_cost_wait);
+
+   tn_sem_create(&_sem_a, 0, 1);
+   _cur_test = &_sem_cost_test;
+
+   for (i = 0; i < _SEM_COST_CALLS_CNT; i++){
+      start = _TN_CYCLE_CNT_GET();
+      tn_sem_signal(&_sem_a);
+      _cost_add(&_cost_signal, start);
+
+      start = _TN_CYCLE_CNT_GET();
+      tn_sem_wait_polling(&_sem_a);
+      _cost_add(&_cost_wait, start);
+
+      tm_arch_int_trigger();
+      tn_sem_wait_polling(&_sem_a);
+   }
+
+   _cur_test = TN_NULL;
+   tn_sem_delete(&_sem_a);
+
+   _cost_print("tn_sem_signal()", &_cost_signal);
+   _cost_print("tn_sem_isignal()", &_cost_isignal);
+   _cost_print("tn_sem_wait_polling()", &_cost_wait);
+}
+
+#endif
+
+// }}}
+
+//-- Timer start cost {{{
+//
+//   The reporter task starts the given number of timers with timeouts
+//   spread over `_TIMER_COST_TIMEOUT_MIN .. _TIMER_COST_TIMEOUT_MAX`, and
+//   then starts and cancels the probe timer with pseudo-random timeout from
+//   1 to `_TIMER_COST_TIMEOUT_MAX`, timing each call by `_TN_CYCLE_CNT_GET()`.
+//   The cost depends on the way the kernel keeps active timers (see
+//   `TM_TIMERS` in the Makefile): with the static tick, timers with short
+//   timeouts go to the tick lists and other ones to the unsorted generic
+//   list; with the dynamic tick, the sorted list is walked on each start,
+//   while the timing wheel (`TN_DYNAMIC_TICK_WHEEL`) takes the same time
+//   regardless of the number of active timers.
+
+#if defined(_TN_CYCLE_CNT_GET)
+
+static void _timer_cost_func(struct TN_Timer *timer, void *p_user_data)
+{
+   (void)timer;
+   (void)p_user_data;
+}
+
+static void _timer_cost_run_cnt(int active_cnt)
+{
+   static const char *const storage =
+#if !TN_DYNAMIC_TICK
+      "tick lists";
+#elif TN_DYNAMIC_TICK_WHEEL
+      "timing wheel";
+#else
+      "sorted list";
+#endif
+
+   //-- linear congruential generator, for the probe timeout
+   unsigned long rand = 12345;
+   TN_UWord start;
+   int i;
+
+   _cost_reset(&_cost_timer_start);
+   _cost_reset(&_cost_timer_cancel);
+
+   for (i = 0; i < active_cnt; i++){
+      tn_timer_create(&_cost_timers[i], _timer_cost_func, TN_NULL);
+      tn_timer_start(
+            &_cost_timers[i],
+            _TIMER_COST_TIMEOUT_MIN
+            + (_TIMER_COST_TIMEOUT_MAX - _TIMER_COST_TIMEOUT_MIN)
+            * i / active_cnt
+            );
+   }
+
+   tn_timer_create(&_cost_probe_timer, _timer_cost_func, TN_NULL);
+
+   for (i = 0; i < _TIMER_COST_CALLS_CNT; i++){
+      rand = rand * 1103515245UL + 12345UL;
+
+      start = _TN_CYCLE_CNT_GET();
+      tn_timer_start(
+            &_cost_probe_timer,
+            1 + (TN_TickCnt)((rand >> 8) % _TIMER_COST_TIMEOUT_MAX)
+            );
+      _cost_add(&_cost_timer_start, start);
+
+      start = _TN_CYCLE_CNT_GET();
+      tn_timer_cancel(&_cost_probe_timer);
+      _cost_add(&_cost_timer_cancel, start);
+   }
+
+   tn_timer_delete(&_cost_probe_timer);
+   for (i = 0; i < active_cnt; i++){
+      tn_timer_delete(&_cost_timers[i]);
+   }
+
+   _print_str("tm: timer start, ");
+   _print_ulong(active_cnt);
+   _print_str(" active timers (");
+   _print_str(storage);
+   _print_str(")");
+   _cost_values_print(&_cost_timer_start, _TIMER_COST_CALLS_CNT);
+
+   _print_str("tm: timer cancel, ");
+   _print_ulong(active_cnt);
+   _print_str(" active timers (");
+   _print_str(storage);
+   _print_str(")");
+   _cost_values_print(&_cost_timer_cancel, _TIMER_COST_CALLS_CNT);
+}
+
+static void _timer_cost_run(void)
+{
+   int active_cnt;
+
+   _TN_CYCLE_CNT_INIT();
+
+   for (
+         active_cnt = 1;
+         active_cnt <= TM_TIMERS_MAX;
+         active_cnt *= 4
+       )
+   {
+      _timer_cost_run_cnt(active_cnt);
+   }
+}
+
+#endif
+
+// }}}
+
+//-- Wait enqueue cost {{{
+//
+//   The given number of lower-priority tasks wait for the semaphore, and
+//   then the probe task of the highest priority starts waiting for it as
+//   well, 1000 times (the reporter releases it by `tn_task_release_wait()`
+//   each time). The time since the probe task calls `tn_sem_wait()` until
+//   the reporter gets the CPU is measured, i.e. the cost of putting the task
+//   to wait plus the context switch. With `TN_WAIT_ORDER_FIFO`, the task is
+//   appended to the wait queue, so the cost doesn't depend on the number of
+//   waiters; with `TN_WAIT_ORDER_PRIO`, the wait queue is walked from the
+//   tail past all the lower-priority waiters.
+
+#if defined(_TN_CYCLE_CNT_GET)
+
+static void _wait_cost_probe_task_body(void *par)
+{
+   (void)par;
+
+   for (;;){
+      _wait_cost_start = _TN_CYCLE_CNT_GET();
+      tn_sem_wait(&_sem_a, TN_WAIT_INFINITE);
+   }
+}
+
+static void _wait_cost_waiter_task_body(void *par)
+{
+   (void)par;
+
+   for (;;){
+      tn_sem_wait(&_sem_a, TN_WAIT_INFINITE);
+   }
+}
+
+static void _wait_cost_run_cnt(enum TN_WaitOrder wait_order, int waiters_cnt)
+{
+   int i;
+
+   _cost_reset(&_cost_wait_enqueue);
+
+   tn_sem_create_wattr(&_sem_a, 0, 1, wait_order);
+
+   for (i = 0; i < waiters_cnt; i++){
+      tn_task_create(
+            &_wait_cost_waiter_tasks[i],
+            _wait_cost_waiter_task_body,
+            _TASK_PRIORITY(i % TM_TASKS_MAX),
+            _wait_cost_waiter_stacks[i],
+            _WAIT_COST_STACK_SIZE,
+            TN_NULL,
+            TN_TASK_CREATE_OPT_START
+            );
+   }
+
+   //-- let the waiters start waiting
+   tn_task_sleep(1);
+
+   //-- the probe task runs right away, and starts waiting
+   tn_task_create(
+         &_wait_cost_probe_task,
+         _wait_cost_probe_task_body,
+         0,
+         _task_stacks[0],
+         TM_TASK_STACK_SIZE,
+         TN_NULL,
+         TN_TASK_CREATE_OPT_START
+         );
+   _cost_add(&_cost_wait_enqueue, _wait_cost_start);
+
+   for (i = 1; i < _WAIT_COST_CALLS_CNT; i++){
+      tn_task_release_wait(&_wait_cost_probe_task);
+      _cost_add(&_cost_wait_enqueue, _wait_cost_start);
+   }
+
+   tn_task_terminate(&_wait_cost_probe_task);
+   tn_task_delete(&_wait_cost_probe_task);
+   for (i = 0; i < waiters_cnt; i++){
+      tn_task_terminate(&_wait_cost_waiter_tasks[i]);
+      tn_task_delete(&_wait_cost_waiter_tasks[i]);
+   }
+   tn_sem_delete(&_sem_a);
+
+   _print_str("tm: sem wait, ");
+   _print_ulong(waiters_cnt);
+   _print_str(" lower-priority waiters (");
+   _print_str(wait_order == TN_WAIT_ORDER_PRIO ? "prio" : "fifo");
+   _print_str(" order)");
+   _cost_values_print(&_cost_wait_enqueue, _WAIT_COST_CALLS_CNT);
+}
+
+static void _wait_cost_run(void)
+{
+   int waiters_cnt;
+
+   _TN_CYCLE_CNT_INIT();
+
+   for (
+         waiters_cnt = 1;
+         waiters_cnt <= _WAIT_COST_WAITERS_MAX;
+         waiters_cnt *= 4
+       )
+   {
+      _wait_cost_run_cnt(TN_WAIT_ORDER_FIFO, waiters_cnt);
+      _wait_cost_run_cnt(TN_WAIT_ORDER_PRIO, waiters_cnt);
+   }
+}
+
+#endif
+
+// }}}
+
+
+
+static const struct TmTest _tests[] = {
+   { "cooperative context switch",  _coop_init,        TN_NULL,       TN_NULL },
+   { "preemptive context switch",   _preempt_init,     TN_NULL,       TN_NULL },
+   { "interrupt processing",        _int_init,         _sem_deinit,   _int_isr },
+   { "interrupt preemption",        _int_preempt_init, _sem_deinit,   _int_isr },
+#if TN_TASK_NOTIFY
+   { "interrupt processing (notification)",
+                                    _int_notify_init,  TN_NULL,    _int_notify_isr },
+   { "interrupt preemption (notification)",
+                           _int_notify_preempt_init,  TN_NULL,    _int_notify_isr },
+#endif
+   { "message processing",          _msg_init,         _msg_deinit,   TN_NULL },
+   { "burst of 16 messages, single",
+                                    _burst_single_init, _msg_deinit,  TN_NULL },
+   { "burst of 16 messages, multi",
+                                    _burst_multi_init, _msg_deinit,   TN_NULL },
+   { "semaphore ping-pong",         _sem_init,         _sem_deinit,   TN_NULL },
+   { "memory allocation",           _fmem_init,        _fmem_deinit,  TN_NULL },
+   { "mutex contention",            _mutex_init,       _mutex_deinit, TN_NULL },
+   { "exchange read, 1 reader",     _exch_1_init,      _exch_deinit,  TN_NULL },
+   { "exchange read, 2 readers",    _exch_2_init,      _exch_deinit,  TN_NULL },
+   { "exchange read, 4 readers",    _exch_4_init,      _exch_deinit,  TN_NULL },
+};
+
+static void _test_run(const struct TmTest *test)
+{
+   unsigned long total = 0;
+   unsigned long prev;
+   unsigned long cur;
+   int i;
+
+   _cur_test = test;
+   test->init();
+
+   prev = _ops_total_get();
+
+   for (i = 0; i < TM_INTERVALS_CNT; i++){
+      tn_task_sleep(TM_INTERVAL_SEC * TM_TICK_FREQ);
+      cur = _ops_total_get();
+
+      _print_str("tm: ");
+      _print_str(test->name);
+      _print_str(": interval ");
+      _print_ulong(i + 1);
+      _print_str(": ");
+      _print_ulong(cur - prev);
+      _print_str(" ops\n");
+
+      total += cur - prev;
+      prev = cur;
+   }
+
+   _tasks_delete();
+   if (test->deinit != TN_NULL){
+      test->deinit();
+   }
+   _cur_test = TN_NULL;
+
+   _print_str("tm: ");
+   _print_str(test->name);
+   _print_str(": average: ");
+   _print_ulong(total / TM_INTERVALS_CNT);
+   _print_str(" ops per ");
+   _print_ulong(TM_INTERVAL_SEC);
+   _print_str(" s\n");
+}
+
+static void _reporter_task_body(void *par)
+{
+   unsigned int i;
+
+   (void)par;
+
+   _print_str("tm: TNeo Thread-Metric style benchmark, interval: ");
+   _print_ulong(TM_INTERVAL_SEC);
+   _print_str(" s\n");
+
+   for (i = 0; i < sizeof(_tests) / sizeof(_tests[0]); i++){
+      _test_run(&_tests[i]);
+   }
+
+   _jitter_run(TN_FALSE);
+   _jitter_run(TN_TRUE);
+
+#if defined(_TN_CYCLE_CNT_GET)
+   _sem_cost_run();
+   _timer_cost_run();
+   _wait_cost_run();
+#endif
+
+   _print_str("tm: done\n");
+   tm_arch_exit();
+
+   for (;;){
+      tn_task_sleep(TN_WAIT_INFINITE);
+   }
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file
+ */
+void tm_bench_isr(void)
+{
+   const struct TmTest *test = _cur_test;
+
+   if (test != TN_NULL && test->isr != TN_NULL){
+      test->isr();
+   }
+}
+
+/*
+ * See comments in the header file
+ */
+void tm_bench_init_task_create(void)
+{
+   tn_task_create(
+         &_reporter_task,
+         _reporter_task_body,
+         _REPORTER_PRIORITY,
+         _reporter_stack,
+         TM_TASK_STACK_SIZE,
+         TN_NULL,
+         TN_TASK_CREATE_OPT_START
+         );
+}
+
+
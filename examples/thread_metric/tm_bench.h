@@ -0,0 +1,92 @@
+/**
+ * \file
+ *
+ * Thread-Metric style benchmark suite for TNeo: the interface between the
+ * portable benchmark code (tm_bench.c) and the architecture-dependent one
+ * (arch/...).
+ *
+ * Each test runs for a number of intervals, and the result of each interval
+ * is the number of operations performed during it (the more, the better).
+ * See readme.txt for the list of tests.
+ */
+
+#ifndef _TM_BENCH_H
+#define _TM_BENCH_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn.h"
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- length of the single interval, in seconds
+#ifndef TM_INTERVAL_SEC
+#  define TM_INTERVAL_SEC        5
+#endif
+
+//-- number of intervals each test runs for
+#ifndef TM_INTERVALS_CNT
+#  define TM_INTERVALS_CNT       3
+#endif
+
+//-- max number of active timers in the timer start test
+#ifndef TM_TIMERS_MAX
+#  define TM_TIMERS_MAX          256
+#endif
+
+//-- kernel ticks (system timer) frequency: the arch code should set up
+//   the system timer accordingly
+#define TM_TICK_FREQ             1000
+
+//-- max number of tasks used by a single test
+#define TM_TASKS_MAX             5
+
+//-- stack size of each benchmark task, in words
+#define TM_TASK_STACK_SIZE       (TN_MIN_STACK_SIZE + 256)
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Implemented by the arch code: output one character of the report.
+ */
+void tm_arch_putc(char c);
+
+/**
+ * Implemented by the arch code: trigger the benchmark interrupt. The
+ * interrupt should be handled before this function returns (if only
+ * interrupts are enabled), and its ISR should call `tm_bench_isr()`.
+ */
+void tm_arch_int_trigger(void);
+
+/**
+ * Implemented by the arch code: called when all the tests are done. On
+ * simulators, it should stop the simulation; on real hardware, it may
+ * just do nothing.
+ */
+void tm_arch_exit(void);
+
+/**
+ * Implemented by the portable code: should be called from the ISR of the
+ * benchmark interrupt.
+ */
+void tm_bench_isr(void);
+
+/**
+ * Implemented by the portable code: creates the first application task,
+ * it should be given to `tn_sys_start()`.
+ */
+void tm_bench_init_task_create(void);
+
+
+#endif // _TM_BENCH_H
+
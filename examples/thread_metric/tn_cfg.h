@@ -0,0 +1,31 @@
+/*******************************************************************************
+ *    TNeo configuration for the Thread-Metric style benchmark
+ *
+ *    The benchmark Makefile puts this directory to the include path before
+ *    the TNeo's `src`, so, this file is used instead of `src/tn_cfg.h`.
+ *    Everything not defined here is taken from `src/tn_cfg_default.h`.
+ *
+ ******************************************************************************/
+
+#ifndef _TN_CFG_H
+#define _TN_CFG_H
+
+//-- release configuration: no debug checks, but parameters are checked,
+//   as most applications do
+#define TN_CHECK_PARAM                 1
+#define TN_DEBUG                       0
+
+#define TN_USE_MUTEXES                 1
+#define TN_MUTEX_REC                   0
+#define TN_MUTEX_DEADLOCK_DETECT       0
+
+//-- for the notification tests
+#define TN_TASK_NOTIFY                 1
+
+//-- for the uncontended calls test
+#define TN_FAST_PATH                   1
+
+#define TN_API_MAKE_ALIG_ARG           TN_API_MAKE_ALIG_ARG__SIZE
+
+#endif // _TN_CFG_H
+
@@ -86,6 +86,31 @@ extern "C"  {     /*}*/
 #  define   _TN_CORTEX_INTSAVE_CHECK()  /* nothing */
 #endif
 
+#if TN_CORTEX_M_SYS_BASEPRI
+/*
+ * Returns priority of the currently active exception, see comments in
+ * `tn_arch_cortex_m.S` for details.
+ */
+unsigned int _tn_arch_cortex_m_exc_prio_get(void);
+#endif
+
+#if TN_CORTEX_M_SYS_BASEPRI && TN_CHECK_PARAM
+/*
+ * Check whether priority of the current ISR is too high. If
+ * `#TN_CORTEX_M_SYS_BASEPRI` is non-zero, interrupts with priority higher than
+ * that are never disabled by the kernel, so they must not call kernel
+ * services. If they do, halt the debugger here.
+ */
+#  define   _TN_CORTEX_ISR_PRIO_CHECK()                                       \
+{                                                                             \
+   if (_tn_arch_cortex_m_exc_prio_get() < TN_CORTEX_M_SYS_BASEPRI){           \
+      _TN_FATAL_ERROR("kernel service called from non-system ISR");           \
+   }                                                                          \
+}
+#else
+#  define   _TN_CORTEX_ISR_PRIO_CHECK()  /* nothing */
+#endif
+
 #if defined(__TN_ARCHFEAT_CORTEX_M_ARMv7M_ISA__)
 /**
  * FFS - find first set bit. Used in `_find_next_task_to_run()` function.
@@ -95,6 +120,41 @@ extern "C"  {     /*}*/
  */
 #define  _TN_FFS(x)     ffs_asm(x)
 int ffs_asm(int x);
+
+/**
+ * Cycle counter, used by the profiler if `#TN_PROFILER_CYCLES` is non-zero:
+ * `_TN_CYCLE_CNT_GET()` returns current value of DWT CYCCNT, which counts
+ * CPU cycles up and wraps at 32 bits. `_TN_CYCLE_CNT_INIT()` enables the
+ * counter; it is called from `tn_sys_start()`.
+ *
+ * May be not defined: in this case, `#TN_PROFILER_CYCLES` can't be used.
+ */
+#define  _TN_CYCLE_CNT_INIT()                                           \
+{                                                                       \
+   /* DEMCR: set TRCENA to enable DWT */                                \
+   *(volatile TN_UWord *)0xE000EDFC |= (1 << 24);                       \
+   /* DWT_LAR: unlock DWT (needed on Cortex-M7, ignored elsewhere) */   \
+   *(volatile TN_UWord *)0xE0001FB0 = 0xC5ACCE55;                       \
+   /* DWT_CTRL: set CYCCNTENA */                                        \
+   *(volatile TN_UWord *)0xE0001000 |= (1 << 0);                        \
+}
+#define  _TN_CYCLE_CNT_GET()     (*(volatile TN_UWord *)0xE0001004)
+#endif
+
+#if defined(__TN_ARCHFEAT_CORTEX_M_FPU__)
+/**
+ * Returns non-zero if the task context saved at `stack_pt` (i.e. value of
+ * `stack_cur_pt` of the task which isn't running) contains FPU registers,
+ * that is, if the task has used FPU. EXC_RETURN is saved right after
+ * R4-R11 (see `tn_arch_cortex_m_c.c`), and its bit 4 is cleared if there
+ * are FPU registers in the context.
+ *
+ * Used by the profiler to count `fpu_ctx_switch_cnt`.
+ *
+ * May be not defined: in this case, `fpu_ctx_switch_cnt` isn't available.
+ */
+#define  _TN_FPU_CTX_SAVED(stack_pt)                                    \
+   ((((TN_UWord *)(stack_pt))[8] & 0x10) == 0)
 #endif
 
 /**
@@ -113,6 +173,21 @@ int ffs_asm(int x);
       {__asm__ volatile("bkpt #0");}
 #endif
 
+/**
+ * Memory barrier: the compiler must not move memory accesses across it, and
+ * the CPU must complete all the preceding memory accesses before the
+ * following ones. Used by the lock-free parts of the kernel, such as the
+ * producer side of the \ref tn_ring.h "ring buffer", which don't disable
+ * interrupts.
+ */
+#if defined(__TN_COMPILER_ARMCC__)
+#  define  _TN_MEMORY_BARRIER()   {__schedule_barrier(); __dmb(0xf);}
+#elif defined(__TN_COMPILER_IAR__)
+#  define  _TN_MEMORY_BARRIER()   {asm volatile("dmb" ::: "memory");}
+#else
+#  define  _TN_MEMORY_BARRIER()   {__asm__ volatile("dmb" ::: "memory");}
+#endif
+
 
 
 /**
@@ -230,7 +305,8 @@ typedef  unsigned int               TN_UIntPtr;
  * @see `TN_INT_RESTORE()`
  */
 #define  TN_INTSAVE_DATA            \
-   TN_UWord TN_INTSAVE_VAR = _TN_CORTEX_INTSAVE_DATA_INVALID;
+   TN_UWord TN_INTSAVE_VAR = _TN_CORTEX_INTSAVE_DATA_INVALID;  \
+   _TN_INT_DIS_MEASURE_DATA
 
 /**
  * The same as `#TN_INTSAVE_DATA` but for using in ISR together with
@@ -267,18 +343,25 @@ typedef  unsigned int               TN_UIntPtr;
  * @see `tn_arch_sr_save_int_dis()`
  */
 
-#define TN_INT_DIS_SAVE()   TN_INTSAVE_VAR = tn_arch_sr_save_int_dis()
+#define TN_INT_DIS_SAVE()   _TN_INT_DIS_MEASURE_PRE();                      \
+                            TN_INTSAVE_VAR = tn_arch_sr_save_int_dis();     \
+                            _TN_INT_DIS_MEASURE_START()
 #define TN_INT_RESTORE()    _TN_CORTEX_INTSAVE_CHECK();                     \
+                            _TN_INT_DIS_MEASURE_STOP();                     \
                             tn_arch_sr_restore(TN_INTSAVE_VAR)
 
 /**
  * The same as `TN_INT_DIS_SAVE()` but for using in ISR.
  *
+ * If `#TN_CORTEX_M_SYS_BASEPRI` and `#TN_CHECK_PARAM` are non-zero, it also
+ * checks that ISR priority isn't higher than `#TN_CORTEX_M_SYS_BASEPRI`.
+ *
  * Uses `#TN_INTSAVE_DATA_INT` as a temporary storage.
  *
  * @see `#TN_INTSAVE_DATA_INT`
  */
-#define TN_INT_IDIS_SAVE()       TN_INT_DIS_SAVE()
+#define TN_INT_IDIS_SAVE()       _TN_CORTEX_ISR_PRIO_CHECK();                \
+                                 TN_INT_DIS_SAVE()
 
 /**
  * The same as `TN_INT_RESTORE()` but for using in ISR.
@@ -341,6 +424,83 @@ typedef  unsigned int               TN_UIntPtr;
 #  error unknown Cortex compiler
 #endif
 
+#if defined(__TN_ARCHFEAT_CORTEX_M_ARMv7M_ISA__)
+/**
+ * Exclusive access to the memory word, used by the lock-free fast paths of
+ * the kernel services (see `#TN_FAST_PATH`):
+ *
+ * - `_TN_EXCL_LOAD(p)` loads the word at `p` (it points to `int`, pointer
+ *   or `#TN_UWord`, which are all of the same size) and marks it for
+ *   exclusive access (LDREX);
+ * - `_TN_EXCL_STORE(p, val)` stores `val` at `p` if only nothing has broken
+ *   the exclusive access since `_TN_EXCL_LOAD()` (STREX). Returns 0 if the
+ *   value is stored, non-zero otherwise. Exception entry and return clear
+ *   the exclusive monitor, so if the code between load and store was
+ *   preempted by anything, the store fails;
+ * - `_TN_EXCL_CLEAR()` drops the exclusive access if the caller decided not
+ *   to store anything (CLREX).
+ *
+ * May be not defined: in this case, fast paths aren't used.
+ */
+#define  _TN_EXCL_LOAD(p)           _tn_arch_excl_load(p)
+#define  _TN_EXCL_STORE(p, val)     _tn_arch_excl_store(p, val)
+#define  _TN_EXCL_CLEAR()           _tn_arch_excl_clear()
+
+#if defined(__TN_COMPILER_ARMCC__)
+
+_TN_STATIC_INLINE TN_UWord _tn_arch_excl_load(volatile void *p)
+{
+   TN_UWord val = __ldrex((volatile TN_UWord *)p);
+   __schedule_barrier();
+   return val;
+}
+
+_TN_STATIC_INLINE int _tn_arch_excl_store(volatile void *p, TN_UWord val)
+{
+   int failed;
+   __schedule_barrier();
+   failed = __strex(val, (volatile TN_UWord *)p);
+   __schedule_barrier();
+   return failed;
+}
+
+_TN_STATIC_INLINE void _tn_arch_excl_clear(void)
+{
+   __clrex();
+}
+
+#else
+
+#if defined(__TN_COMPILER_IAR__)
+#  define _TN_EXCL_ASM     asm
+#else
+#  define _TN_EXCL_ASM     __asm__
+#endif
+
+_TN_STATIC_INLINE TN_UWord _tn_arch_excl_load(volatile void *p)
+{
+   TN_UWord val;
+   _TN_EXCL_ASM volatile("ldrex %0, [%1]" : "=r" (val) : "r" (p) : "memory");
+   return val;
+}
+
+_TN_STATIC_INLINE int _tn_arch_excl_store(volatile void *p, TN_UWord val)
+{
+   int failed;
+   _TN_EXCL_ASM volatile(
+         "strex %0, %2, [%1]" : "=&r" (failed) : "r" (p), "r" (val) : "memory"
+         );
+   return failed;
+}
+
+_TN_STATIC_INLINE void _tn_arch_excl_clear(void)
+{
+   _TN_EXCL_ASM volatile("clrex" ::: "memory");
+}
+
+#endif
+#endif
+
 #define _TN_ARCH_STACK_PT_TYPE   _TN_ARCH_STACK_PT_TYPE__FULL
 #define _TN_ARCH_STACK_DIR       _TN_ARCH_STACK_DIR__DESC
 
@@ -52,6 +52,18 @@
  */
 #define  _TN_FFS(x) (32 - __builtin_clz((x) & (0 - (x))))
 
+/**
+ * Cycle counter, used by the profiler if `#TN_PROFILER_CYCLES` is non-zero.
+ * `_TN_CYCLE_CNT_GET()` should return current value of some free-running
+ * hardware counter (typically, CPU cycle counter) which counts up and wraps
+ * at the full width of `#TN_UWord`; `_TN_CYCLE_CNT_INIT()` should start it,
+ * it is called from `tn_sys_start()`.
+ *
+ * May be not defined: in this case, `#TN_PROFILER_CYCLES` can't be used.
+ */
+#define  _TN_CYCLE_CNT_INIT()    /* nothing */
+#define  _TN_CYCLE_CNT_GET()     ((TN_UWord)__builtin_mfc0(9, 0))
+
 /**
  * Used by the kernel as a signal that something really bad happened.
  * Indicates TNeo bugs as well as illegal kernel usage, e.g. sleeping in
@@ -63,6 +75,15 @@
 #define  _TN_FATAL_ERRORF(error_msg, ...)         \
    {__asm__ volatile(" sdbbp 0"); __asm__ volatile ("nop");}
 
+/**
+ * Memory barrier: the compiler must not move memory accesses across it, and
+ * the CPU must complete all the preceding memory accesses before the
+ * following ones. Used by the lock-free parts of the kernel, such as the
+ * producer side of the \ref tn_ring.h "ring buffer", which don't disable
+ * interrupts.
+ */
+#define  _TN_MEMORY_BARRIER()      {__asm__ volatile("sync" ::: "memory");}
+
 
 
 
@@ -140,7 +161,9 @@ typedef  unsigned int               TN_UIntPtr;
  * @see `TN_INT_DIS_SAVE()`
  * @see `TN_INT_RESTORE()`
  */
-#define  TN_INTSAVE_DATA            int tn_save_status_reg = 0;
+#define  TN_INTSAVE_DATA            \
+   int tn_save_status_reg = 0;                                 \
+   _TN_INT_DIS_MEASURE_DATA
 
 /**
  * The same as `#TN_INTSAVE_DATA` but for using in ISR together with
@@ -161,7 +184,10 @@ typedef  unsigned int               TN_UIntPtr;
  * @see `#TN_INTSAVE_DATA`
  * @see `tn_arch_sr_save_int_dis()`
  */
-#define TN_INT_DIS_SAVE()        tn_save_status_reg = tn_arch_sr_save_int_dis()
+#define TN_INT_DIS_SAVE()        _TN_INT_DIS_MEASURE_PRE();                 \
+                                 tn_save_status_reg =                       \
+                                    tn_arch_sr_save_int_dis();              \
+                                 _TN_INT_DIS_MEASURE_START()
 
 /**
  * Restore previously saved status register.
@@ -173,7 +199,8 @@ typedef  unsigned int               TN_UIntPtr;
  * @see `#TN_INTSAVE_DATA`
  * @see `tn_arch_sr_save_int_dis()`
  */
-#define TN_INT_RESTORE()         tn_arch_sr_restore(tn_save_status_reg)
+#define TN_INT_RESTORE()         _TN_INT_DIS_MEASURE_STOP();                \
+                                 tn_arch_sr_restore(tn_save_status_reg)
 
 /**
  * The same as `TN_INT_DIS_SAVE()` but for using in ISR.
@@ -237,5 +264,19 @@ typedef  unsigned int               TN_UIntPtr;
  */
 #define _TN_VOLATILE_WORKAROUND   /* nothing */
 
+/**
+ * Exclusive access to the memory word, used by the lock-free fast paths of
+ * the kernel services (see `#TN_FAST_PATH`): `_TN_EXCL_LOAD(p)` should load
+ * the value at `p` (it points to `int`, pointer or `#TN_UWord`) and mark
+ * it for exclusive access, `_TN_EXCL_STORE(p, val)` should store `val` at
+ * `p` if only nothing (including any interrupt) has broken the exclusive
+ * access since then, and return 0 if the value is stored;
+ * `_TN_EXCL_CLEAR()` should drop the exclusive access. See PIC32 and
+ * Cortex-M ports for the implementation by LL/SC and LDREX/STREX, and POSIX
+ * port for the emulation.
+ *
+ * May be not defined: in this case, fast paths aren't used.
+ */
+
 
 #endif   // _TN_ARCH_EXAMPLE_H
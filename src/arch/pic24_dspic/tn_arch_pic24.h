@@ -103,6 +103,18 @@ int _tn_p24_ffs_asm(int x);
 #define  _TN_FATAL_ERRORF(error_msg, ...)         \
    {__asm__ volatile(".pword 0xDA4000"); __asm__ volatile ("nop");}
 
+/**
+ * Memory barrier: the compiler must not move memory accesses across it, and
+ * the CPU must complete all the preceding memory accesses before the
+ * following ones. Used by the lock-free parts of the kernel, such as the
+ * producer side of the \ref tn_ring.h "ring buffer", which don't disable
+ * interrupts.
+ *
+ * PIC24/dsPIC core doesn't reorder memory accesses, so, just the compiler
+ * barrier is needed.
+ */
+#define  _TN_MEMORY_BARRIER()      {__asm__ volatile("" ::: "memory");}
+
 
 
 /**
@@ -214,7 +226,8 @@ typedef  unsigned int               TN_UIntPtr;
  * @see `TN_INT_RESTORE()`
  */
 #define  TN_INTSAVE_DATA            \
-   TN_UWord TN_INTSAVE_VAR = _TN_PIC24_INTSAVE_DATA_INVALID;
+   TN_UWord TN_INTSAVE_VAR = _TN_PIC24_INTSAVE_DATA_INVALID;   \
+   _TN_INT_DIS_MEASURE_DATA
 
 /**
  * The same as `#TN_INTSAVE_DATA` but for using in ISR together with
@@ -251,8 +264,11 @@ typedef  unsigned int               TN_UIntPtr;
  * @see `tn_arch_sr_save_int_dis()`
  */
 
-#  define TN_INT_DIS_SAVE()   TN_INTSAVE_VAR = tn_arch_sr_save_int_dis()
+#  define TN_INT_DIS_SAVE()   _TN_INT_DIS_MEASURE_PRE();                      \
+                              TN_INTSAVE_VAR = tn_arch_sr_save_int_dis();     \
+                              _TN_INT_DIS_MEASURE_START()
 #  define TN_INT_RESTORE()    _TN_PIC24_INTSAVE_CHECK();                      \
+                              _TN_INT_DIS_MEASURE_STOP();                     \
                               tn_arch_sr_restore(TN_INTSAVE_VAR)
 
 /**
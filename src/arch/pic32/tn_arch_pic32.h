@@ -109,6 +109,18 @@ extern void *tn_p32_int_sp;
  */
 #define  _TN_FFS(x) (32 - __builtin_clz((x) & (0 - (x))))
 
+/**
+ * Cycle counter, used by the profiler if `#TN_PROFILER_CYCLES` is non-zero:
+ * `_TN_CYCLE_CNT_GET()` returns current value of the Core Timer (CP0 Count
+ * register), which counts up at half of the system clock and wraps at 32
+ * bits. The Core Timer always runs, so `_TN_CYCLE_CNT_INIT()` does nothing;
+ * the application must not write to the Count register, though.
+ *
+ * May be not defined: in this case, `#TN_PROFILER_CYCLES` can't be used.
+ */
+#define  _TN_CYCLE_CNT_INIT()    /* nothing */
+#define  _TN_CYCLE_CNT_GET()     ((TN_UWord)__builtin_mfc0(9, 0))
+
 /**
  * Used by the kernel as a signal that something really bad happened.
  * Indicates TNeo bugs as well as illegal kernel usage
@@ -119,6 +131,15 @@ extern void *tn_p32_int_sp;
 #define  _TN_FATAL_ERRORF(error_msg, ...)         \
    {__asm__ volatile(" sdbbp 0"); __asm__ volatile ("nop");}
 
+/**
+ * Memory barrier: the compiler must not move memory accesses across it, and
+ * the CPU must complete all the preceding memory accesses before the
+ * following ones. Used by the lock-free parts of the kernel, such as the
+ * producer side of the \ref tn_ring.h "ring buffer", which don't disable
+ * interrupts.
+ */
+#define  _TN_MEMORY_BARRIER()      {__asm__ volatile("sync" ::: "memory");}
+
 /**
  * \def TN_ARCH_STK_ATTR_BEFORE
  *
@@ -213,7 +234,8 @@ typedef  unsigned int               TN_UIntPtr;
  * @see `TN_INT_RESTORE()`
  */
 #define  TN_INTSAVE_DATA            \
-   TN_UWord TN_INTSAVE_VAR = _TN_PIC32_INTSAVE_DATA_INVALID;
+   TN_UWord TN_INTSAVE_VAR = _TN_PIC32_INTSAVE_DATA_INVALID;   \
+   _TN_INT_DIS_MEASURE_DATA
 
 /**
  * The same as `#TN_INTSAVE_DATA` but for using in ISR together with
@@ -251,15 +273,21 @@ typedef  unsigned int               TN_UIntPtr;
  */
 
 #ifdef __mips16
-#  define TN_INT_DIS_SAVE()   TN_INTSAVE_VAR = tn_arch_sr_save_int_dis()
+#  define TN_INT_DIS_SAVE()   _TN_INT_DIS_MEASURE_PRE();                      \
+                              TN_INTSAVE_VAR = tn_arch_sr_save_int_dis();     \
+                              _TN_INT_DIS_MEASURE_START()
 #  define TN_INT_RESTORE()    _TN_PIC32_INTSAVE_CHECK();                      \
+                              _TN_INT_DIS_MEASURE_STOP();                     \
                               tn_arch_sr_restore(TN_INTSAVE_VAR)
 #else
-#  define TN_INT_DIS_SAVE()   __asm__ __volatile__(                           \
+#  define TN_INT_DIS_SAVE()   _TN_INT_DIS_MEASURE_PRE();                      \
+                              __asm__ __volatile__(                           \
                                     "di %0; ehb"                              \
                                     : "=d" (TN_INTSAVE_VAR)                   \
-                                    )
+                                    );                                        \
+                              _TN_INT_DIS_MEASURE_START()
 #  define TN_INT_RESTORE()    _TN_PIC32_INTSAVE_CHECK();                      \
+                              _TN_INT_DIS_MEASURE_STOP();                     \
                               __builtin_mtc0(12, 0, TN_INTSAVE_VAR)
 #endif
 
@@ -309,6 +337,39 @@ typedef  unsigned int               TN_UIntPtr;
 
 #define _TN_VOLATILE_WORKAROUND   /* nothing */
 
+/**
+ * Exclusive access to the memory word, used by the lock-free fast paths of
+ * the kernel services (see `#TN_FAST_PATH`):
+ *
+ * - `_TN_EXCL_LOAD(p)` loads the word at `p` and marks it for exclusive
+ *   access (LL);
+ * - `_TN_EXCL_STORE(p, val)` stores `val` at `p` if only nothing has broken
+ *   the exclusive access since `_TN_EXCL_LOAD()` (SC). Returns 0 if the
+ *   value is stored, non-zero otherwise. ERET clears the LLbit, so if the
+ *   code between load and store was preempted by anything, the store fails;
+ * - `_TN_EXCL_CLEAR()` drops the exclusive access if the caller decided not
+ *   to store anything: nothing to do on MIPS.
+ *
+ * May be not defined: in this case, fast paths aren't used.
+ */
+#define  _TN_EXCL_LOAD(p)           _tn_arch_excl_load(p)
+#define  _TN_EXCL_STORE(p, val)     _tn_arch_excl_store(p, val)
+#define  _TN_EXCL_CLEAR()           /* nothing */
+
+_TN_STATIC_INLINE TN_UWord _tn_arch_excl_load(volatile void *p)
+{
+   TN_UWord val;
+   __asm__ volatile("ll %0, 0(%1)" : "=r" (val) : "r" (p) : "memory");
+   return val;
+}
+
+_TN_STATIC_INLINE int _tn_arch_excl_store(volatile void *p, TN_UWord val)
+{
+   //-- SC writes 1 to the register if the value is stored, 0 otherwise
+   __asm__ volatile("sc %0, 0(%1)" : "+r" (val) : "r" (p) : "memory");
+   return (val == 0);
+}
+
 #define _TN_ARCH_STACK_PT_TYPE   _TN_ARCH_STACK_PT_TYPE__FULL
 #define _TN_ARCH_STACK_DIR       _TN_ARCH_STACK_DIR__DESC
 
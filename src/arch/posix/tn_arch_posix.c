@@ -0,0 +1,684 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*
+ * POSIX (Linux host) port.
+ *
+ * Model of the hardware:
+ *
+ *  - Task context is `ucontext_t`, which lives at the top of the task stack
+ *    (right below the highest address); `stack_cur_pt` of the task points to
+ *    it. Task stack itself grows down right below the context.
+ *
+ *  - Interrupts are signals. Disabling interrupts is blocking all the
+ *    signals except synchronous ones (`SIGSEGV` and friends), which are
+ *    never deferrable anyway.
+ *
+ *  - Context switch is performed by the `SIGUSR2` handler (we call it PendSV
+ *    here, after the Cortex-M exception which serves the same purpose): it
+ *    just does `swapcontext()` between the current task and the next one.
+ *    `SIGUSR2` is blocked in all ISRs, so that context switch is performed
+ *    when the outermost ISR returns.
+ *
+ *  - ISRs are executed on the interrupt stack given to `tn_sys_start()`
+ *    (installed as an alternate signal stack), PendSV is executed on the
+ *    stack of the preempted task.
+ *
+ *  - Exclusive access (`_TN_EXCL_LOAD()` and friends) is emulated by the
+ *    reserved address, which is dropped by each signal handler on entry and
+ *    on return, like the exclusive monitor of Cortex-M is cleared by
+ *    exception entry and return.
+ *
+ *  - `SIGRTMIN` is never raised, it merely serves as a marker: if it is
+ *    blocked, interrupts are disabled. This way, we can tell whether
+ *    interrupts are disabled just by looking at the signal mask, and the
+ *    status register value returned by `tn_arch_sr_save_int_dis()` is just
+ *    one bit.
+ */
+
+//-- needed for sigaltstack() and friends
+#define _GNU_SOURCE
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "_tn_tasks.h"
+#include "_tn_sys.h"
+
+#include <signal.h>
+#include <ucontext.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+//-- signal used for context switching
+#define _PENDSV_SIG        SIGUSR2
+
+//-- signal which is never raised: when it is blocked, interrupts are disabled
+#define _MARKER_SIG        SIGRTMIN
+
+//-- number of signals (signal numbers are in the range [1 .. NSIG - 1])
+#define _ISR_TABLE_SIZE    NSIG
+
+//-- alignment of the task context in the task stack
+#define _CTX_ALIGN         16
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/**
+ * Task context: it is placed at the top of the task stack by
+ * `_tn_arch_stack_init()`, and task's `stack_cur_pt` points to it.
+ */
+struct _TaskCtx {
+   ///
+   /// Saved context of the task
+   ucontext_t     uc;
+   ///
+   /// Task body function and its parameter, to be called by
+   /// `_task_trampoline()` when the task runs for the first time
+   TN_TaskBody   *task_func;
+   void          *param;
+};
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+//-- signals which are blocked when interrupts are disabled
+static sigset_t _int_sigset;
+
+//-- signals which are unblocked when interrupts are enabled: at the task
+//   level, it is the same as `_int_sigset`, but inside ISR it excludes
+//   signals of all the active ISRs, and the PendSV signal.
+static sigset_t _unblock_sigset;
+
+//-- just the PendSV signal
+static sigset_t _pendsv_sigset;
+
+//-- user ISRs, indexed by signal number
+static TN_PosixIsr *_isr_table[_ISR_TABLE_SIZE];
+
+//-- interrupt nesting count
+static volatile int _isr_nest_cnt = 0;
+
+//-- address reserved by the last `_TN_EXCL_LOAD()`, or NULL if there is no
+//   reservation
+static volatile void *volatile _excl_addr = NULL;
+
+//-- hook called by `_TN_EXCL_STORE()`, see `tn_posix_excl_store_hook_set()`
+static TN_PosixExclHook *volatile _excl_store_hook = NULL;
+
+//-- hook called by `tn_arch_sr_save_int_dis()`, see
+//   `tn_posix_int_dis_hook_set()`
+static TN_PosixIntDisHook *volatile _int_dis_hook = NULL;
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * Called before `main()`: init signal sets, so that interrupts can be
+ * disabled / enabled before the kernel is started.
+ */
+__attribute__((constructor))
+static void _sigsets_init(void)
+{
+   sigfillset(&_int_sigset);
+
+   //-- synchronous signals can't be deferred, so don't touch them
+   sigdelset(&_int_sigset, SIGSEGV);
+   sigdelset(&_int_sigset, SIGBUS);
+   sigdelset(&_int_sigset, SIGFPE);
+   sigdelset(&_int_sigset, SIGILL);
+   sigdelset(&_int_sigset, SIGTRAP);
+   sigdelset(&_int_sigset, SIGABRT);
+   sigdelset(&_int_sigset, SIGSYS);
+
+   _unblock_sigset = _int_sigset;
+
+   sigemptyset(&_pendsv_sigset);
+   sigaddset(&_pendsv_sigset, _PENDSV_SIG);
+}
+
+_TN_STATIC_INLINE struct _TaskCtx *_task_ctx_get(struct TN_Task *task)
+{
+   return (struct _TaskCtx *)task->stack_cur_pt;
+}
+
+/**
+ * Entry point of each task: `makecontext()` can only pass `int` arguments,
+ * so the pointer to the task context is split into two halves.
+ */
+static void _task_trampoline(unsigned int ctx_hi, unsigned int ctx_lo)
+{
+   struct _TaskCtx *ctx = (struct _TaskCtx *)(
+         ((uintptr_t)ctx_hi << 16 << 16) | (uintptr_t)ctx_lo
+         );
+
+   ctx->task_func(ctx->param);
+
+   //-- task body function returned: exit the task
+   _tn_task_exit_nodelete();
+}
+
+/**
+ * Handler of all the signals attached by `tn_posix_isr_set()`.
+ */
+static void _isr_wrapper(int signum)
+{
+   int saved_errno = errno;
+   sigset_t saved_unblock_sigset = _unblock_sigset;
+
+   //-- while this ISR is running, enabling interrupts should neither enable
+   //   the signal of this ISR, nor allow context switch
+   sigdelset(&_unblock_sigset, signum);
+   sigdelset(&_unblock_sigset, _PENDSV_SIG);
+
+   //-- exception entry clears exclusive access
+   _excl_addr = NULL;
+
+   _isr_nest_cnt++;
+   _isr_table[signum]();
+   _isr_nest_cnt--;
+
+   //-- and so does exception return
+   _excl_addr = NULL;
+
+   _unblock_sigset = saved_unblock_sigset;
+   errno = saved_errno;
+}
+
+/**
+ * Context switch routine: called with interrupts disabled (they are blocked
+ * by `sa_mask`), on the stack of the preempted task.
+ */
+static void _pendsv_handler(int signum)
+{
+   int saved_errno = errno;
+   struct TN_Task *task_prev = _tn_curr_run_task;
+
+   (void)signum;
+
+   _excl_addr = NULL;
+
+   if (task_prev != _tn_next_task_to_run){
+#if _TN_ON_CONTEXT_SWITCH_HANDLER
+      _tn_sys_on_context_switch(_tn_curr_run_task, _tn_next_task_to_run);
+#endif
+
+      _tn_curr_run_task = _tn_next_task_to_run;
+
+      //-- save context of the preempted task and restore the new one: we'll
+      //   get back here when the preempted task is scheduled again
+      swapcontext(
+            &_task_ctx_get(task_prev)->uc,
+            &_task_ctx_get(_tn_curr_run_task)->uc
+            );
+
+      //-- the task is scheduled again: whatever it had reserved before it
+      //   was preempted, is not reserved anymore
+      _excl_addr = NULL;
+   }
+
+   errno = saved_errno;
+}
+
+static void _sigaction_set(int signum, void (*handler)(int), int flags)
+{
+   struct sigaction sa;
+
+   memset(&sa, 0, sizeof(sa));
+   sa.sa_handler = handler;
+   sa.sa_flags = flags;
+
+   if (handler == _pendsv_handler){
+      //-- context switch is performed with interrupts disabled
+      sa.sa_mask = _int_sigset;
+   } else {
+      //-- no context switch until the outermost ISR returns
+      sa.sa_mask = _pendsv_sigset;
+   }
+
+   if (sigaction(signum, &sa, NULL) != 0){
+      _TN_FATAL_ERRORF("sigaction(%d) failed", signum);
+   }
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+void tn_posix_isr_set(int signum, TN_PosixIsr *isr)
+{
+   if (
+         signum <= 0 || signum >= _ISR_TABLE_SIZE
+         || signum == _PENDSV_SIG
+         || signum == _MARKER_SIG
+         || !sigismember(&_int_sigset, signum)
+      )
+   {
+      _TN_FATAL_ERRORF("signal %d can't be used as an interrupt", signum);
+   }
+
+   _isr_table[signum] = isr;
+   _sigaction_set(signum, _isr_wrapper, SA_RESTART | SA_ONSTACK);
+}
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+void tn_posix_timer_start(unsigned long period_us)
+{
+   struct itimerval itv;
+
+   itv.it_interval.tv_sec  = period_us / 1000000;
+   itv.it_interval.tv_usec = period_us % 1000000;
+   itv.it_value = itv.it_interval;
+
+   if (setitimer(ITIMER_REAL, &itv, NULL) != 0){
+      _TN_FATAL_ERRORF("setitimer() failed, errno=%d", errno);
+   }
+}
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+void tn_posix_excl_store_hook_set(TN_PosixExclHook *hook)
+{
+   _excl_store_hook = hook;
+}
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+void tn_posix_int_dis_hook_set(TN_PosixIntDisHook *hook)
+{
+   _int_dis_hook = hook;
+}
+
+
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+void _tn_arch_posix_fatal_error(
+      const char *file,
+      int line,
+      const char *fmt,
+      ...
+      )
+{
+   va_list args;
+
+   tn_arch_int_dis();
+
+   fprintf(stderr, "TNeo fatal error at %s:%d", file, line);
+   if (fmt[0] != '\0'){
+      fprintf(stderr, ": ");
+      va_start(args, fmt);
+      vfprintf(stderr, fmt, args);
+      va_end(args);
+   }
+   fprintf(stderr, "\n");
+
+   abort();
+}
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+unsigned long _tn_arch_posix_cycle_cnt_get(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (unsigned long)ts.tv_sec * 1000000000UL
+      + (unsigned long)ts.tv_nsec;
+}
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+unsigned long _tn_arch_posix_excl_load(volatile void *p, int size)
+{
+   unsigned long val;
+   TN_UWord sr = tn_arch_sr_save_int_dis();
+
+   if (size == sizeof(unsigned int)){
+      val = *(volatile unsigned int *)p;
+   } else {
+      val = *(volatile unsigned long *)p;
+   }
+
+   _excl_addr = p;
+
+   tn_arch_sr_restore(sr);
+
+   return val;
+}
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+int _tn_arch_posix_excl_store(
+      volatile void *p,
+      int size,
+      unsigned long val
+      )
+{
+   int failed;
+   TN_UWord sr;
+   TN_PosixExclHook *hook = _excl_store_hook;
+
+   if (hook != NULL){
+      hook();
+   }
+
+   sr = tn_arch_sr_save_int_dis();
+
+   failed = (_excl_addr != p);
+   if (!failed){
+      if (size == sizeof(unsigned int)){
+         *(volatile unsigned int *)p = (unsigned int)val;
+      } else {
+         *(volatile unsigned long *)p = val;
+      }
+   }
+
+   _excl_addr = NULL;
+
+   tn_arch_sr_restore(sr);
+
+   return failed;
+}
+
+/*
+ * See comments in the header file (tn_arch_posix.h)
+ */
+void _tn_arch_posix_excl_clear(void)
+{
+   _excl_addr = NULL;
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void tn_arch_int_dis(void)
+{
+   sigprocmask(SIG_BLOCK, &_int_sigset, NULL);
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void tn_arch_int_en(void)
+{
+   sigprocmask(SIG_UNBLOCK, &_unblock_sigset, NULL);
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+TN_UWord tn_arch_sr_save_int_dis(void)
+{
+   sigset_t old;
+   TN_PosixIntDisHook *hook = _int_dis_hook;
+
+   if (hook != NULL){
+      //-- call the hook if only interrupts are enabled now
+      sigprocmask(SIG_BLOCK, NULL, &old);
+      if (!sigismember(&old, _MARKER_SIG)){
+         hook();
+      }
+   }
+
+   sigprocmask(SIG_BLOCK, &_int_sigset, &old);
+
+   return (TN_UWord)sigismember(&old, _MARKER_SIG);
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void tn_arch_sr_restore(TN_UWord sr)
+{
+   if (!sr){
+      sigprocmask(SIG_UNBLOCK, &_unblock_sigset, NULL);
+   }
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+TN_UWord tn_arch_sched_dis_save(void)
+{
+   sigset_t old;
+
+   sigprocmask(SIG_BLOCK, &_pendsv_sigset, &old);
+
+   return (TN_UWord)sigismember(&old, _PENDSV_SIG);
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void tn_arch_sched_restore(TN_UWord sched_state)
+{
+   if (!sched_state){
+      sigprocmask(SIG_UNBLOCK, &_pendsv_sigset, NULL);
+   }
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+TN_UWord *_tn_arch_stack_init(
+      TN_TaskBody   *task_func,
+      TN_UWord      *stack_low_addr,
+      TN_UWord      *stack_high_addr,
+      void          *param
+      )
+{
+   struct _TaskCtx *ctx;
+   uintptr_t ctx_addr;
+
+   //-- place the context at the top of the stack, aligned
+   ctx_addr = (uintptr_t)(stack_high_addr + 1) - sizeof(struct _TaskCtx);
+   ctx_addr &= ~(uintptr_t)(_CTX_ALIGN - 1);
+   ctx = (struct _TaskCtx *)ctx_addr;
+
+   ctx->task_func = task_func;
+   ctx->param     = param;
+
+   if (getcontext(&ctx->uc) != 0){
+      _TN_FATAL_ERRORF("getcontext() failed, errno=%d", errno);
+   }
+
+   //-- the rest of the stack (below the context) is the stack of the task
+   ctx->uc.uc_stack.ss_sp     = stack_low_addr;
+   ctx->uc.uc_stack.ss_size   = ctx_addr - (uintptr_t)stack_low_addr;
+   ctx->uc.uc_stack.ss_flags  = 0;
+   ctx->uc.uc_link            = NULL;
+
+   //-- task starts with interrupts enabled
+   sigprocmask(SIG_SETMASK, NULL, &ctx->uc.uc_sigmask);
+   {
+      int signum;
+      for (signum = 1; signum < _ISR_TABLE_SIZE; signum++){
+         if (sigismember(&_int_sigset, signum)){
+            sigdelset(&ctx->uc.uc_sigmask, signum);
+         }
+      }
+   }
+
+   makecontext(
+         &ctx->uc, (void (*)(void))_task_trampoline, 2,
+         (unsigned int)((uintptr_t)ctx >> 16 >> 16),
+         (unsigned int)((uintptr_t)ctx & 0xffffffffu)
+         );
+
+   return (TN_UWord *)ctx;
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+int _tn_arch_inside_isr(void)
+{
+   return (_isr_nest_cnt > 0);
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+int _tn_arch_is_int_disabled(void)
+{
+   sigset_t cur;
+
+   sigprocmask(SIG_SETMASK, NULL, &cur);
+
+   return sigismember(&cur, _MARKER_SIG);
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void _tn_arch_context_switch_pend(void)
+{
+   raise(_PENDSV_SIG);
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void _tn_arch_context_switch_now_nosave(void)
+{
+   tn_arch_int_dis();
+
+#if _TN_ON_CONTEXT_SWITCH_HANDLER
+   _tn_sys_on_context_switch(_tn_curr_run_task, _tn_next_task_to_run);
+#endif
+
+   _tn_curr_run_task = _tn_next_task_to_run;
+
+   setcontext(&_task_ctx_get(_tn_curr_run_task)->uc);
+
+   //-- should never be here
+   _TN_FATAL_ERROR("setcontext() failed");
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void _tn_arch_sys_start(
+      TN_UWord      *int_stack,
+      TN_UWord       int_stack_size
+      )
+{
+   stack_t ss;
+   unsigned long min_size;
+
+   //-- minimum size of the signal stack depends on the CPU features (say,
+   //   AVX-512 state is large), so ask the system if possible
+#if defined(_SC_MINSIGSTKSZ)
+   min_size = (unsigned long)sysconf(_SC_MINSIGSTKSZ);
+#else
+   min_size = (unsigned long)MINSIGSTKSZ;
+#endif
+
+   //-- ISRs are executed on the interrupt stack
+   ss.ss_sp    = int_stack;
+   ss.ss_size  = int_stack_size * sizeof(TN_UWord);
+   ss.ss_flags = 0;
+
+   if (ss.ss_size < min_size){
+      _TN_FATAL_ERRORF(
+            "interrupt stack is too small: %lu bytes, at least %lu needed",
+            (unsigned long)ss.ss_size, min_size
+            );
+   }
+
+   if (sigaltstack(&ss, NULL) != 0){
+      _TN_FATAL_ERRORF("sigaltstack() failed, errno=%d", errno);
+   }
+
+   //-- install context switch handler: it runs on the stack of the
+   //   preempted task, not on the interrupt stack
+   _sigaction_set(_PENDSV_SIG, _pendsv_handler, SA_RESTART);
+
+   //-- perform first context switch
+   _tn_arch_context_switch_now_nosave();
+}
+
+
+
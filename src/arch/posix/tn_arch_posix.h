@@ -0,0 +1,467 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ *
+ * \file
+ *
+ * POSIX (Linux host) architecture-dependent routines: the kernel runs as an
+ * ordinary Linux process, which is handy for load tests, profiling with the
+ * host tools and reproducing scheduling issues without a board.
+ *
+ * Tasks are `ucontext_t` contexts living in the task stacks, interrupts are
+ * modelled by signals, and the system tick is usually `SIGALRM` from an
+ * interval timer. For details, refer to the section \ref posix_details.
+ *
+ */
+
+#ifndef  _TN_ARCH_POSIX_H
+#define  _TN_ARCH_POSIX_H
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "../tn_arch_detect.h"
+#include "../../core/tn_cfg_dispatch.h"
+
+//-- for NULL passed by `_TN_FATAL_ERROR()`
+#include <stddef.h>
+
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * ISR: the function which is called by the kernel when the signal it is
+ * attached to (by `tn_posix_isr_set()`) is delivered.
+ */
+typedef void (TN_PosixIsr)(void);
+
+/**
+ * Hook which is called by the emulated exclusive store, see
+ * `tn_posix_excl_store_hook_set()`.
+ */
+typedef void (TN_PosixExclHook)(void);
+
+/**
+ * Hook which is called when interrupts are about to be disabled, see
+ * `tn_posix_int_dis_hook_set()`.
+ */
+typedef void (TN_PosixIntDisHook)(void);
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Attach ISR to the signal: from now on, the signal `signum` is a <i>system
+ * interrupt</i>. Kernel services which are allowed to call from ISR can be
+ * called from `isr`.
+ *
+ * ISRs run on the interrupt stack given to `tn_sys_start()`. Interrupts may
+ * nest (an ISR is never interrupted by itself, though), and context switch
+ * is performed after the outermost ISR returns.
+ *
+ * May be called before `tn_sys_start()`, typically it is called from
+ * `main()`.
+ *
+ * @param signum
+ *    Signal number; it must not be `SIGUSR2`, which is used by the kernel for
+ *    context switching, or one of the synchronous signals (`SIGSEGV`,
+ *    `SIGBUS`, `SIGFPE`, `SIGILL`, `SIGTRAP`, `SIGABRT`, `SIGSYS`).
+ * @param isr
+ *    ISR to call when signal is delivered.
+ */
+void tn_posix_isr_set(int signum, TN_PosixIsr *isr);
+
+/**
+ * Start the interval timer which generates `SIGALRM` each `period_us`
+ * microseconds. Typically, it is used as a system timer: attach the ISR which
+ * calls `tn_tick_int_processing()` to `SIGALRM` by `tn_posix_isr_set()`, and
+ * start the timer.
+ *
+ * @param period_us
+ *    Timer period, in microseconds. If it is 0, the timer is stopped.
+ */
+void tn_posix_timer_start(unsigned long period_us);
+
+/**
+ * Set the hook which is called by each emulated exclusive store (see
+ * `#TN_FAST_PATH`) right before it checks whether the exclusive access is
+ * still there, with interrupts enabled. It is intended for tests: the hook
+ * may raise the signal of some ISR to preempt the lock-free fast path
+ * exactly between the exclusive load and store, so that the store fails
+ * and the fast path has to deal with whatever the ISR (and tasks woken up
+ * by it) have done in between.
+ *
+ * The hook is called for the stores performed by the preempting tasks as
+ * well, so it typically disarms itself by `tn_posix_excl_store_hook_set(
+ * TN_NULL)`.
+ *
+ * @param hook
+ *    Function to call, or `TN_NULL` to remove the hook.
+ */
+void tn_posix_excl_store_hook_set(TN_PosixExclHook *hook);
+
+/**
+ * Set the hook which is called by `tn_arch_sr_save_int_dis()` (and so, by
+ * `TN_INT_DIS_SAVE()`) right before interrupts are disabled, if only they
+ * are enabled at the moment. It is intended for tests: the hook may raise
+ * the signal of some ISR to interrupt the kernel service exactly before it
+ * enters the critical section, e.g. when the lock-free part of the service
+ * is already done.
+ *
+ * Just like the hook of the exclusive store, it is called for every
+ * critical section (including the ones of the ISR, after it enables
+ * interrupts), so it typically disarms itself by
+ * `tn_posix_int_dis_hook_set(TN_NULL)`.
+ *
+ * @param hook
+ *    Function to call, or `TN_NULL` to remove the hook.
+ */
+void tn_posix_int_dis_hook_set(TN_PosixIntDisHook *hook);
+
+
+
+
+/*******************************************************************************
+ *    ARCH-DEPENDENT DEFINITIONS
+ ******************************************************************************/
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*
+ * Used by `_TN_FATAL_ERRORF()`: prints the message to `stderr` and aborts.
+ */
+void _tn_arch_posix_fatal_error(
+      const char *file,
+      int line,
+      const char *fmt,
+      ...
+      );
+
+/*
+ * Used by `_TN_CYCLE_CNT_GET()`: returns monotonic time in nanoseconds.
+ */
+unsigned long _tn_arch_posix_cycle_cnt_get(void);
+
+/*
+ * Used by `_TN_EXCL_LOAD()` and friends: emulation of exclusive access to
+ * the object of `size` bytes (`int` or `#TN_UWord`) at `p`.
+ */
+unsigned long _tn_arch_posix_excl_load(volatile void *p, int size);
+int _tn_arch_posix_excl_store(
+      volatile void *p,
+      int size,
+      unsigned long val
+      );
+void _tn_arch_posix_excl_clear(void);
+
+/**
+ * FFS - find first set bit. Used in `_find_next_task_to_run()` function.
+ * Say, for `0xa8` it should return `3`. It takes the whole `#TN_UWord`, since
+ * the bitmaps are `#TN_UWord`s (see `#TN_INT_WIDTH`).
+ *
+ * May be not defined: in this case, naive algorithm will be used.
+ */
+#define  _TN_FFS(x)     __builtin_ffsl(x)
+
+/**
+ * Cycle counter, used by the profiler if `#TN_PROFILER_CYCLES` is non-zero:
+ * there are no CPU cycles to count for the host process, so
+ * `_TN_CYCLE_CNT_GET()` returns `CLOCK_MONOTONIC` time in nanoseconds, which
+ * wraps at the full width of `#TN_UWord`.
+ *
+ * May be not defined: in this case, `#TN_PROFILER_CYCLES` can't be used.
+ */
+#define  _TN_CYCLE_CNT_INIT()    /* nothing */
+#define  _TN_CYCLE_CNT_GET()     ((TN_UWord)_tn_arch_posix_cycle_cnt_get())
+
+/**
+ * Used by the kernel as a signal that something really bad happened.
+ * Indicates TNeo bugs as well as illegal kernel usage
+ * (e.g. sleeping in the idle task callback)
+ *
+ * On host, the message is printed to `stderr`, and the process is aborted,
+ * so that the debugger (or core dump) points right to the problem.
+ */
+#define  _TN_FATAL_ERRORF(error_msg, ...)                               \
+   _tn_arch_posix_fatal_error(__FILE__, __LINE__, "" error_msg, __VA_ARGS__)
+
+/**
+ * Memory barrier: the compiler must not move memory accesses across it, and
+ * the CPU must complete all the preceding memory accesses before the
+ * following ones. Used by the lock-free parts of the kernel, such as the
+ * producer side of the \ref tn_ring.h "ring buffer", which don't disable
+ * interrupts.
+ */
+#define  _TN_MEMORY_BARRIER()   {__sync_synchronize();}
+
+/**
+ * Exclusive access to the memory word, used by the lock-free fast paths of
+ * the kernel services (see `#TN_FAST_PATH`). There are no exclusive access
+ * instructions for the host process, so they are emulated:
+ *
+ * - `_TN_EXCL_LOAD(p)` loads the value at `p` and remembers `p` as the
+ *   reserved address;
+ * - `_TN_EXCL_STORE(p, val)` stores `val` at `p` if only `p` is still
+ *   reserved, and drops the reservation. Returns 0 if the value is stored,
+ *   non-zero otherwise. Each signal handler (ISR or context switch) drops
+ *   the reservation on entry and on return, just like exception entry and
+ *   return clear the exclusive monitor of Cortex-M, so if the code between
+ *   load and store was preempted by anything, the store fails;
+ * - `_TN_EXCL_CLEAR()` drops the reservation.
+ *
+ * Load and store themselves are performed with interrupts disabled. Unlike
+ * the hardware instructions, they work with the objects of `int` size as
+ * well (the semaphore counter), since `#TN_UWord` is wider than `int` on
+ * 64-bit hosts.
+ *
+ * May be not defined: in this case, fast paths aren't used.
+ */
+#define  _TN_EXCL_LOAD(p)                                               \
+   _tn_arch_posix_excl_load((p), (int)sizeof(*(p)))
+#define  _TN_EXCL_STORE(p, val)                                         \
+   _tn_arch_posix_excl_store((p), (int)sizeof(*(p)), (val))
+#define  _TN_EXCL_CLEAR()        _tn_arch_posix_excl_clear()
+
+#endif   //-- DOXYGEN_SHOULD_SKIP_THIS
+
+
+
+/**
+ * \def TN_ARCH_STK_ATTR_BEFORE
+ *
+ * Compiler-specific attribute that should be placed **before** declaration of
+ * array used for stack. It is needed because there are often additional 
+ * restrictions applied to alignment of stack, so, to meet them, stack arrays
+ * need to be declared with these macros.
+ *
+ * @see TN_ARCH_STK_ATTR_AFTER
+ */
+
+/**
+ * \def TN_ARCH_STK_ATTR_AFTER
+ *
+ * Compiler-specific attribute that should be placed **after** declaration of
+ * array used for stack. It is needed because there are often additional 
+ * restrictions applied to alignment of stack, so, to meet them, stack arrays
+ * need to be declared with these macros.
+ *
+ * @see TN_ARCH_STK_ATTR_BEFORE
+ */
+
+#define TN_ARCH_STK_ATTR_BEFORE
+#define TN_ARCH_STK_ATTR_AFTER      __attribute__((aligned(0x10)))
+
+
+/**
+ * Minimum task's stack size, in words, not in bytes. On host, it should
+ * accommodate the task context (`ucontext_t`, which is placed at the top of
+ * the task stack) and the signal frame of the context switch signal (which
+ * includes the whole FPU/vector state), so, it is quite large.
+ */
+#define  TN_MIN_STACK_SIZE          (4096 + _TN_STACK_OVERFLOW_SIZE_ADD)
+
+/**
+ * Width of `#TN_UWord` type. The kernel keeps its bitmaps (of priorities,
+ * event flags, etc) in words of `#TN_UWord`, so, unlike other ports, on
+ * 64-bit hosts it is wider than `int`: 64 bits.
+ */
+#define  TN_INT_WIDTH               (__SIZEOF_LONG__ * 8)
+
+/**
+ * Unsigned integer type whose size is equal to the size of CPU register.
+ * On host, it's `unsigned long`, so that it can store pointers on both 32-
+ * and 64-bit systems.
+ */
+typedef  unsigned long              TN_UWord;
+
+/**
+ * Unsigned integer type that is able to store pointers.
+ * We need it because some platforms don't define `uintptr_t`.
+ */
+typedef  unsigned long              TN_UIntPtr;
+
+/**
+ * Maximum number of priorities available, this value usually matches
+ * `#TN_INT_WIDTH`.
+ *
+ * @see TN_PRIORITIES_CNT
+ */
+#define  TN_PRIORITIES_MAX_CNT      TN_INT_WIDTH
+
+/**
+ * Value for infinite waiting, usually matches `ULONG_MAX`,
+ * because `#TN_TickCnt` is declared as `unsigned long`.
+ */
+#define  TN_WAIT_INFINITE           ((TN_TickCnt)(~0UL))
+
+/**
+ * Value for initializing the task's stack
+ */
+#define  TN_FILL_STACK_VAL          0xFEEDFACE
+
+
+
+
+/**
+ * Variable name that is used for storing interrupts state
+ * by macros TN_INTSAVE_DATA and friends
+ */
+#define TN_INTSAVE_VAR              tn_save_status_reg
+
+/**
+ * Declares variable that is used by macros `TN_INT_DIS_SAVE()` and
+ * `TN_INT_RESTORE()` for storing status register value.
+ *
+ * @see `TN_INT_DIS_SAVE()`
+ * @see `TN_INT_RESTORE()`
+ */
+#define  TN_INTSAVE_DATA            \
+   TN_UWord TN_INTSAVE_VAR = 0;                                \
+   _TN_INT_DIS_MEASURE_DATA
+
+/**
+ * The same as `#TN_INTSAVE_DATA` but for using in ISR together with
+ * `TN_INT_IDIS_SAVE()`, `TN_INT_IRESTORE()`.
+ *
+ * @see `TN_INT_IDIS_SAVE()`
+ * @see `TN_INT_IRESTORE()`
+ */
+#define  TN_INTSAVE_DATA_INT        TN_INTSAVE_DATA
+
+/**
+ * Disable interrupts and return previous value of status register,
+ * atomically. Similar `tn_arch_sr_save_int_dis()`, but implemented
+ * as a macro, so it is potentially faster.
+ *
+ * Uses `#TN_INTSAVE_DATA` as a temporary storage.
+ *
+ * @see `#TN_INTSAVE_DATA`
+ * @see `tn_arch_sr_save_int_dis()`
+ */
+#define TN_INT_DIS_SAVE()        _TN_INT_DIS_MEASURE_PRE();                 \
+                                 TN_INTSAVE_VAR = tn_arch_sr_save_int_dis();\
+                                 _TN_INT_DIS_MEASURE_START()
+
+/**
+ * Restore previously saved status register.
+ * Similar to `tn_arch_sr_restore()`, but implemented as a macro,
+ * so it is potentially faster.
+ *
+ * Uses `#TN_INTSAVE_DATA` as a temporary storage.
+ *
+ * @see `#TN_INTSAVE_DATA`
+ * @see `tn_arch_sr_save_int_dis()`
+ */
+#define TN_INT_RESTORE()         _TN_INT_DIS_MEASURE_STOP();                \
+                                 tn_arch_sr_restore(TN_INTSAVE_VAR)
+
+/**
+ * The same as `TN_INT_DIS_SAVE()` but for using in ISR.
+ *
+ * Uses `#TN_INTSAVE_DATA_INT` as a temporary storage.
+ *
+ * @see `#TN_INTSAVE_DATA_INT`
+ */
+#define TN_INT_IDIS_SAVE()       TN_INT_DIS_SAVE()
+
+/**
+ * The same as `TN_INT_RESTORE()` but for using in ISR.
+ *
+ * Uses `#TN_INTSAVE_DATA_INT` as a temporary storage.
+ *
+ * @see `#TN_INTSAVE_DATA_INT`
+ */
+#define TN_INT_IRESTORE()        TN_INT_RESTORE()
+
+/**
+ * Returns nonzero if interrupts are disabled, zero otherwise.
+ */
+#define TN_IS_INT_DISABLED()     (_tn_arch_is_int_disabled())
+
+/**
+ * Pend context switch from interrupt.
+ */
+#define _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED()          \
+   _tn_context_switch_pend_if_needed()
+
+/**
+ * Converts size in bytes to size in `#TN_UWord`.
+ */
+#define _TN_SIZE_BYTES_TO_UWORDS(size_in_bytes)    \
+   ((size_in_bytes) / sizeof(TN_UWord))
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#if TN_FORCED_INLINE
+#  define _TN_INLINE             inline __attribute__ ((always_inline))
+#else
+#  define _TN_INLINE             inline
+#endif
+
+#define _TN_STATIC_INLINE        static _TN_INLINE
+
+#define _TN_VOLATILE_WORKAROUND   /* nothing */
+
+#define _TN_ARCH_STACK_PT_TYPE   _TN_ARCH_STACK_PT_TYPE__FULL
+#define _TN_ARCH_STACK_DIR       _TN_ARCH_STACK_DIR__DESC
+
+#endif   //-- DOXYGEN_SHOULD_SKIP_THIS
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif   // _TN_ARCH_POSIX_H
+
+
+
@@ -97,6 +97,8 @@
 #  include "pic24_dspic/tn_arch_pic24.h"
 #elif defined(__TN_ARCH_CORTEX_M__)
 #  include "cortex_m/tn_arch_cortex_m.h"
+#elif defined(__TN_ARCH_POSIX__)
+#  include "posix/tn_arch_posix.h"
 #else
 #  error "unknown platform"
 #endif
@@ -141,6 +143,70 @@
 
 
 
+//-- Hooks for measuring the duration of critical sections (see
+//   `#TN_INT_DIS_MEASURE`). They are used by `#TN_INTSAVE_DATA`,
+//   `TN_INT_DIS_SAVE()` and `TN_INT_RESTORE()` of each port:
+//
+//   - `_TN_INT_DIS_MEASURE_DATA` declares a static descriptor of the
+//     function (one per function, since `#TN_INTSAVE_DATA` is declared once
+//     per function) and a local flag telling whether the section is the
+//     outermost one;
+//   - `_TN_INT_DIS_MEASURE_PRE()` should be called right before interrupts
+//     are disabled: it sets the flag;
+//   - `_TN_INT_DIS_MEASURE_START()` should be called right after interrupts
+//     are disabled;
+//   - `_TN_INT_DIS_MEASURE_STOP()` should be called right before interrupts
+//     are restored.
+//
+//   Only the outermost critical section is measured: nested ones are
+//   included in it anyway. The flag is initially set, so that the function
+//   which gets the saved status from its caller (see
+//   `_tn_timer_callback_call()`) ends the caller's section when it
+//   restores interrupts.
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#if TN_INT_DIS_MEASURE
+#  define _TN_INT_DIS_MEASURE_DATA                                      \
+   static struct TN_IntDisSite tn_int_dis_site =                        \
+      { __func__, 0, TN_NULL, TN_FALSE };                               \
+   int tn_int_dis_outer = 1;
+
+#  define _TN_INT_DIS_MEASURE_PRE()                                     \
+   tn_int_dis_outer = !TN_IS_INT_DISABLED()
+
+#  define _TN_INT_DIS_MEASURE_START()                                   \
+   if (tn_int_dis_outer){ _tn_int_dis_measure_start(); }
+
+#  define _TN_INT_DIS_MEASURE_STOP()                                    \
+   if (tn_int_dis_outer){ _tn_int_dis_measure_stop(&tn_int_dis_site); }
+#else
+#  define _TN_INT_DIS_MEASURE_DATA         /* nothing */
+#  define _TN_INT_DIS_MEASURE_PRE()        /* nothing */
+#  define _TN_INT_DIS_MEASURE_START()      /* nothing */
+#  define _TN_INT_DIS_MEASURE_STOP()       /* nothing */
+#endif
+
+#endif
+
+
+
+//-- Lock-free fast paths (see `#TN_FAST_PATH`) are used if only the port
+//   provides exclusive access to the memory word: `_TN_EXCL_LOAD()`,
+//   `_TN_EXCL_STORE()` and `_TN_EXCL_CLEAR()`.
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#if TN_FAST_PATH && defined(_TN_EXCL_LOAD)
+#  define _TN_FAST_PATH_ENABLED     1
+#else
+#  define _TN_FAST_PATH_ENABLED     0
+#endif
+
+#endif
+
+
+
 #ifdef __cplusplus
 extern "C"  {  /*}*/
 #endif
@@ -322,6 +388,28 @@ void _tn_arch_sys_start(
       TN_UWord       int_stack_size
       );
 
+#if TN_INT_DIS_MEASURE
+struct TN_IntDisSite;
+
+/**
+ * Called by `_TN_INT_DIS_MEASURE_START()` with interrupts disabled, when
+ * the outermost critical section begins: remembers current value of the
+ * cycle counter. Implemented in the kernel core (`tn_sys.c`).
+ */
+void _tn_int_dis_measure_start(void);
+
+/**
+ * Called by `_TN_INT_DIS_MEASURE_STOP()` with interrupts disabled, when
+ * the outermost critical section is about to end: updates worst-case
+ * duration of the critical sections in the function described by `site`.
+ * Implemented in the kernel core (`tn_sys.c`).
+ *
+ * @param site
+ *    Descriptor of the function which contains the critical section
+ */
+void _tn_int_dis_measure_stop(struct TN_IntDisSite *site);
+#endif
+
 
 #ifdef __cplusplus
 }  /* extern "C" */
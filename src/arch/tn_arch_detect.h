@@ -57,6 +57,7 @@
 #undef __TN_ARCH_CORTEX_M3__
 #undef __TN_ARCH_CORTEX_M4__
 #undef __TN_ARCH_CORTEX_M4_FP__
+#undef __TN_ARCH_POSIX__
 
 #undef __TN_ARCHFEAT_CORTEX_M_FPU__
 #undef __TN_ARCHFEAT_CORTEX_M_ARMv6M_ISA__
@@ -185,7 +186,7 @@
 #     define __TN_COMPILER_GCC__
 #  endif
 
-#  if defined(__ARM_ARCH)
+#  if defined(__ARM_ARCH) && !defined(__unix__)
 
 #     define __TN_ARCH_CORTEX_M__
 
@@ -212,6 +213,15 @@
 #     else
 #        error unknown ARM architecture for GCC compiler
 #     endif
+
+/*
+ * Hosted Unix-like system (Linux, typically): the kernel runs as an ordinary
+ * process, see src/arch/posix
+ */
+#  elif defined(__unix__)
+
+#     define __TN_ARCH_POSIX__
+
 #  else
 #     error unknown architecture for GCC compiler
 #  endif
@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright © 2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright © 2013, 2014 Anders Montonen.
- *    TNeo:                      copyright © 2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -34,25 +34,15 @@
  *
  ******************************************************************************/
 
-/**
- * \file
- *
- * Exchange link: queue (in terms of OOP, it's an "class, inherited from
- * `#TN_ExchLink`").
- *
- * For internal kernel usage only.
- *
- */
-
-
-#ifndef _TN_EXCH_LINK_QUEUE_H
-#define _TN_EXCH_LINK_QUEUE_H
+#ifndef __TN_DEFER_H
+#define __TN_DEFER_H
 
 /*******************************************************************************
  *    INCLUDED FILES
  ******************************************************************************/
 
-#include "tn_exch_link.h"
+#include "_tn_sys.h"
+#include "tn_defer.h"
 
 
 
@@ -62,59 +52,38 @@ extern "C"  {     /*}*/
 #endif
 
 /*******************************************************************************
- *    PUBLIC TYPES
+ *    EXTERNAL TYPES
  ******************************************************************************/
 
-struct TN_ExchLinkQueue;
-
-
-/**
- * Base structure for \ref tn_exch.h "exchange" link.
- *
- * For internal kernel usage only.
- */
-struct TN_ExchLinkQueue {
-   ///
-   /// Exchange link: in terms of OOP, it's a superclass (or base class)
-   struct TN_ExchLink super;
-   ///
-   /// A pointer to queue to send messages to.
-   struct TN_DQueue *queue;
-   ///
-   /// A pointer to fixed-memory pool to get memory from.
-   /// Note: if data size is <= `sizeof(#TN_UWord)`, `fmem` might be `TN_NULL`.
-   struct TN_FMem *fmem;
-};
-
 
 
 /*******************************************************************************
- *    GLOBAL VARIABLES
+ *    PUBLIC TYPES
  ******************************************************************************/
 
 /*******************************************************************************
- *    DEFINITIONS
+ *    PROTECTED GLOBAL DATA
  ******************************************************************************/
 
+
 /*******************************************************************************
- *    PUBLIC FUNCTION PROTOTYPES
+ *    DEFINITIONS
  ******************************************************************************/
 
-enum TN_RCode tn_exch_link_queue_create(
-      struct TN_ExchLinkQueue   *exch_link_queue,
-      struct TN_DQueue          *queue,
-      struct TN_FMem            *fmem
-      );
 
-enum TN_RCode tn_exch_link_queue_delete(
-      struct TN_ExchLinkQueue   *exch_link_queue
-      );
+/*******************************************************************************
+ *    PROTECTED INLINE FUNCTIONS
+ ******************************************************************************/
 
-static inline struct TN_ExchLink *tn_exch_link_queue_base_get(
-      struct TN_ExchLinkQueue   *exch_link_queue
+/**
+ * Checks whether given deferred call queue is valid 
+ * (actually, just checks against `id_defer` field, see `enum #TN_ObjId`)
+ */
+_TN_STATIC_INLINE TN_BOOL _tn_defer_is_valid(
+      const struct TN_Defer     *defer
       )
 {
-   return &exch_link_queue->super;
+   return (defer->id_defer == TN_ID_DEFER);
 }
 
 
@@ -123,7 +92,9 @@ static inline struct TN_ExchLink *tn_exch_link_queue_base_get(
 }  /* extern "C" */
 #endif
 
-#endif // _TN_EXCH_LINK_QUEUE_H
+
+#endif // __TN_DEFER_H
+
 
 /*******************************************************************************
  *    end of file
@@ -71,6 +71,28 @@ extern "C"  {     /*}*/
  ******************************************************************************/
 
 
+/*******************************************************************************
+ *    PROTECTED FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+#if TN_MULTI_WAIT
+
+/**
+ * Try to receive data from the queue without waiting, for the multi-wait
+ * (see \ref tn_multi_wait.h).
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @return
+ *    - `#TN_RC_OK` if data was received, it is stored to `pp_data`;
+ *    - `#TN_RC_TIMEOUT` if there is nothing to receive.
+ */
+enum TN_RCode _tn_dqueue_try_receive(struct TN_DQueue *dque, void **pp_data);
+
+#endif
+
+
+
 /*******************************************************************************
  *    PROTECTED INLINE FUNCTIONS
  ******************************************************************************/
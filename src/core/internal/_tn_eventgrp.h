@@ -92,6 +92,31 @@ enum TN_RCode _tn_eventgrp_link_set(
       TN_UWord             pattern
       );
 
+#if TN_EVENTGRP_WIDE
+/**
+ * The same as `#_tn_eventgrp_link_set()`, but establishes link to the single
+ * flag with the given number, which may be in any word of the pattern of the
+ * wide event group (see \ref eventgrp_wide).
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @param eventgrp_link    
+ *    eventgrp_link object which should be modified.
+ *
+ * @param eventgrp
+ *    Event group object to connect
+ *
+ * @param bit_num
+ *    Number of flag that should be maintained by object to which
+ *    event group is being connected.
+ */
+enum TN_RCode _tn_eventgrp_link_set_bit(
+      struct TN_EGrpLink  *eventgrp_link,
+      struct TN_EventGrp  *eventgrp,
+      int                  bit_num
+      );
+#endif
+
 /**
  * Reset link to the event group, i.e. make it non connected to any event
  * group. (no matter whether it is already established).
@@ -124,6 +149,29 @@ enum TN_RCode _tn_eventgrp_link_manage(
       TN_BOOL              set
       );
 
+#if TN_MULTI_WAIT
+
+/**
+ * Check the condition of the event group without waiting, for the
+ * multi-wait (see \ref tn_multi_wait.h). Params are the same as for
+ * `tn_eventgrp_wait()`.
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @return
+ *    - `#TN_RC_OK` if condition is met;
+ *    - `#TN_RC_TIMEOUT` if condition isn't met;
+ *    - `#TN_RC_WPARAM` if `wait_pattern` or `wait_mode` is wrong.
+ */
+enum TN_RCode _tn_eventgrp_try_wait(
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord             wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      );
+
+#endif
+
 
 
 /*******************************************************************************
@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright © 2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright © 2013, 2014 Anders Montonen.
- *    TNeo:                      copyright © 2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -73,22 +73,6 @@ struct TN_Exch;
  ******************************************************************************/
 
 
-/*******************************************************************************
- *    PROTECTED FUNCTION PROTOTYPES
- ******************************************************************************/
-
-void _tn_exch_write(
-      struct TN_Exch   *exch,
-      const void       *data
-      );
-
-enum TN_RCode _tn_exch_read(
-      struct TN_Exch   *exch,
-      void             *data_tgt
-      );
-
-
-
 /*******************************************************************************
  *    PROTECTED INLINE FUNCTIONS
  ******************************************************************************/
@@ -97,8 +81,8 @@ enum TN_RCode _tn_exch_read(
  * Checks whether given exchange object is valid 
  * (actually, just checks against `id_exch` field, see `enum #TN_ObjId`)
  */
-static inline TN_BOOL _tn_exch_is_valid(
-      struct TN_Exch   *exch
+_TN_STATIC_INLINE TN_BOOL _tn_exch_is_valid(
+      const struct TN_Exch   *exch
       )
 {
    return (exch->id_exch == TN_ID_EXCHANGE);
@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright © 2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright © 2013, 2014 Anders Montonen.
- *    TNeo:                      copyright © 2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -77,16 +77,33 @@ struct TN_ExchLink;
  *    PROTECTED FUNCTION PROTOTYPES
  ******************************************************************************/
 
+/**
+ * Returns virtual methods table of the base class `#TN_ExchLink`, so that
+ * subclasses can call methods of the superclass.
+ */
 const struct TN_ExchLink_VTable *_tn_exch_link_vtable(void);
 
+/**
+ * Constructor of the base class: should be called by constructors of
+ * subclasses, and then, subclass should set its own virtual methods table.
+ */
 enum TN_RCode _tn_exch_link_create(
       struct TN_ExchLink     *exch_link
       );
 
+/**
+ * Notify the link that exchange data is written: calls the `notify` virtual
+ * method. Should be called with interrupts disabled.
+ */
 enum TN_RCode _tn_exch_link_notify(
       struct TN_ExchLink     *exch_link
       );
 
+/**
+ * Destructor: disconnects the link from the exchange object (if
+ * connected), and calls the `dtor` virtual method. Should be called by
+ * destructors of subclasses.
+ */
 enum TN_RCode _tn_exch_link_delete(
       struct TN_ExchLink     *exch_link
       );
@@ -102,8 +119,8 @@ enum TN_RCode _tn_exch_link_delete(
  * Checks whether given exchange link object is valid 
  * (actually, just checks against `id_exch_link` field, see `enum #TN_ObjId`)
  */
-static inline TN_BOOL _tn_exch_link_is_valid(
-      struct TN_ExchLink   *exch_link
+_TN_STATIC_INLINE TN_BOOL _tn_exch_link_is_valid(
+      const struct TN_ExchLink   *exch_link
       )
 {
    return (exch_link->id_exch_link == TN_ID_EXCHANGE_LINK);
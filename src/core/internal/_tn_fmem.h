@@ -71,6 +71,28 @@ extern "C"  {     /*}*/
  ******************************************************************************/
 
 
+/*******************************************************************************
+ *    PROTECTED FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+#if TN_MULTI_WAIT
+
+/**
+ * Try to get memory block from the pool without waiting, for the multi-wait
+ * (see \ref tn_multi_wait.h).
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @return
+ *    - `#TN_RC_OK` if block was taken, its address is stored to `p_data`;
+ *    - `#TN_RC_TIMEOUT` if there are no free blocks.
+ */
+enum TN_RCode _tn_fmem_try_get(struct TN_FMem *fmem, void **p_data);
+
+#endif
+
+
+
 /*******************************************************************************
  *    PROTECTED INLINE FUNCTIONS
  ******************************************************************************/
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+#ifndef __TN_MULTI_WAIT_H
+#define __TN_MULTI_WAIT_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "_tn_sys.h"
+#include "_tn_list.h"
+#include "tn_multi_wait.h"
+
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    EXTERNAL TYPES
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+#if TN_MULTI_WAIT
+
+/**
+ * Reset the list of multi-wait items of some object (say, `multi_wait_list`
+ * of `struct #TN_Sem`). Should be called when the object is created.
+ *
+ * If `#TN_MULTI_WAIT` is zero, this is a no-op macro, so that the caller
+ * doesn't need to care about the option.
+ */
+#define  _tn_multi_wait_list_reset(multi_wait_list)                     \
+   _tn_list_reset(multi_wait_list)
+
+/**
+ * Returns whether the given list of multi-wait items is empty, i.e. no
+ * task multi-waits for the object. If `#TN_MULTI_WAIT` is zero, it is always
+ * `TN_TRUE`.
+ */
+#define  _tn_multi_wait_list_is_empty(multi_wait_list)                  \
+   _tn_list_is_empty(multi_wait_list)
+
+/**
+ * If there are items in the given list of multi-wait items, take the first
+ * one, store `p_data` in it and wake its task up with `#TN_RC_OK`: so, the
+ * object has handed its item (memory block, etc) over to the task directly.
+ * All the items of this task are removed from the lists of their objects.
+ *
+ * It is called by the objects when they are about to store the item
+ * (semaphore count, queue item, etc) because there are no waiting tasks;
+ * it is the multi-wait counterpart of `_tn_task_first_wait_complete()`.
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @param multi_wait_list
+ *    List of multi-wait items of some object
+ * @param p_data
+ *    Data to store in the `p_data` field of the item
+ *
+ * @return
+ *    - `TN_TRUE` if some item was found and its task was woken up;
+ *    - `TN_FALSE` if the list is empty.
+ */
+TN_BOOL _tn_multi_wait_first_complete(
+      struct TN_ListItem *multi_wait_list,
+      void *p_data
+      );
+
+/**
+ * Wake up the task that waits for the given multi-wait item with the given
+ * wait result. The item becomes the fired one, and all the items of the task
+ * are removed from the lists of their objects.
+ *
+ * \attention Caller must disable interrupts.
+ */
+void _tn_multi_wait_item_complete(
+      struct TN_MultiWaitItem *item,
+      enum TN_RCode wait_rc
+      );
+
+/**
+ * Wake up the tasks of all the items in the given list of multi-wait items,
+ * with the `#TN_RC_DELETED` wait result. Called when the object is deleted,
+ * just like `_tn_wait_queue_notify_deleted()`.
+ *
+ * \attention Caller must disable interrupts.
+ */
+void _tn_multi_wait_notify_deleted(struct TN_ListItem *multi_wait_list);
+
+/**
+ * Should be called when the task that waits with the reason
+ * `#TN_WAIT_REASON_MULTI` finishes waiting (by any reason): removes all its
+ * items from the lists of their objects.
+ *
+ * \attention Caller must disable interrupts.
+ */
+void _tn_multi_wait_on_task_wait_complete(struct TN_Task *task);
+
+#else
+
+#  define  _tn_multi_wait_list_reset(multi_wait_list)                /* nothing */
+#  define  _tn_multi_wait_list_is_empty(multi_wait_list)             (TN_TRUE)
+#  define  _tn_multi_wait_first_complete(multi_wait_list, p_data)    (TN_FALSE)
+#  define  _tn_multi_wait_notify_deleted(multi_wait_list)            /* nothing */
+
+#endif   // TN_MULTI_WAIT
+
+
+
+/*******************************************************************************
+ *    PROTECTED INLINE FUNCTIONS
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+
+#endif // __TN_MULTI_WAIT_H
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -71,6 +71,28 @@ extern "C"  {     /*}*/
  ******************************************************************************/
 
 
+/*******************************************************************************
+ *    PROTECTED FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+#if TN_MULTI_WAIT
+
+/**
+ * Try to acquire the semaphore without waiting, for the multi-wait (see
+ * \ref tn_multi_wait.h).
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @return
+ *    - `#TN_RC_OK` if semaphore was acquired;
+ *    - `#TN_RC_TIMEOUT` if semaphore count is zero.
+ */
+enum TN_RCode _tn_sem_try_wait(struct TN_Sem *sem);
+
+#endif
+
+
+
 /*******************************************************************************
  *    PROTECTED INLINE FUNCTIONS
  ******************************************************************************/
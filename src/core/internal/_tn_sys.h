@@ -80,11 +80,28 @@ extern struct TN_Task *_tn_curr_run_task;
 /// _tn_curr_run_task, context switch is needed)
 extern struct TN_Task *_tn_next_task_to_run;
 
+#if TN_PRIORITIES_2LEVEL_BMP
+/// number of words in the array `#_tn_ready_to_run_bmp`
+#define _TN_READY_BMP_GROUPS_CNT                                        \
+   ((TN_PRIORITIES_CNT + TN_INT_WIDTH - 1) / TN_INT_WIDTH)
+
+/// bitmask of priorities with runnable tasks, each word holds bits for the
+/// group of `#TN_INT_WIDTH` priorities: bit for the priority `prio` is
+/// `((TN_UWord)1 << (prio % TN_INT_WIDTH))` in the word `(prio / TN_INT_WIDTH)`.
+/// lowest priority bit should always be set, since this priority is used by
+/// idle task which should be always runnable, by design.
+extern volatile TN_UWord _tn_ready_to_run_bmp[ _TN_READY_BMP_GROUPS_CNT ];
+
+/// bitmask of non-empty groups in the `#_tn_ready_to_run_bmp`: bit `n` is
+/// set if `_tn_ready_to_run_bmp[n]` is non-zero.
+extern volatile TN_UWord _tn_ready_to_run_grp_bmp;
+#else
 /// bitmask of priorities with runnable tasks.
 /// lowest priority bit (1 << (TN_PRIORITIES_CNT - 1)) should always be set,
 /// since this priority is used by idle task which should be always runnable,
 /// by design.
-extern volatile unsigned int _tn_ready_to_run_bmp;
+extern volatile TN_UWord _tn_ready_to_run_bmp;
+#endif
 
 /// idle task structure
 extern struct TN_Task _tn_idle_task;
@@ -129,6 +146,29 @@ extern struct TN_Task _tn_idle_task;
  *    PROTECTED FUNCTION PROTOTYPES
  ******************************************************************************/
 
+#if TN_DYNAMIC_TICK
+/**
+ * With `#TN_DYNAMIC_TICK`, round-robin is driven by the internal timer,
+ * which is started if only there is more than one runnable task with the
+ * priority of `#_tn_next_task_to_run`, and round-robin is on for this
+ * priority (see `tn_sys_tslice_set()`). So, if round-robin isn't actually
+ * needed, the system stays tickless.
+ *
+ * This function starts or stops the timer accordingly; it should be called
+ * with interrupts disabled whenever `#_tn_next_task_to_run` or ready queue
+ * is changed. When the timer is started for some task, it is started for the
+ * whole time slice; if the task gets preempted by higher-priority one, the
+ * timer is stopped, and the task gets the whole time slice again when it
+ * runs next time.
+ *
+ * With static tick, this function does nothing: round-robin is managed
+ * by `tn_tick_int_processing()` directly.
+ */
+void _tn_round_robin_update(void);
+#else
+_TN_STATIC_INLINE void _tn_round_robin_update(void) {}
+#endif
+
 /**
  * Remove all tasks from wait queue, returning the TN_RC_DELETED code.
  */
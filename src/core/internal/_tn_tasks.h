@@ -143,6 +143,18 @@ void _tn_task_set_waiting(
       TN_TickCnt           timeout
       );
 
+/**
+ * Move the waiting task to its place in the wait queue ordered by priority,
+ * see `#TN_WAIT_ORDER_PRIO`: after all the tasks with the same or higher
+ * priority. Task is marked as the one queued by priority, so its place is
+ * updated further if its priority changes (see
+ * `#_tn_change_task_priority()`).
+ *
+ * Task must be in the $(TN_TASK_STATE_WAIT) state, with non-null
+ * `pwait_queue`.
+ */
+void _tn_task_wait_prio_insert(struct TN_Task *task);
+
 /**
  * Bring task out from the $(TN_TASK_STATE_WAIT) state.
  * Task must be already in the $(TN_TASK_STATE_WAIT) state. It may additionally
@@ -297,9 +309,40 @@ _TN_STATIC_INLINE void _tn_task_curr_to_wait_action(
    _tn_task_set_waiting(_tn_curr_run_task, wait_que, wait_reason, timeout);
 }
 
+/**
+ * Checks whether given wait order is one of `enum #TN_WaitOrder` values;
+ * used by the objects when checking params of `..._create_wattr()`.
+ */
+_TN_STATIC_INLINE TN_BOOL _tn_wait_order_is_valid(enum TN_WaitOrder wait_order)
+{
+   return (     wait_order == TN_WAIT_ORDER_FIFO
+            ||  wait_order == TN_WAIT_ORDER_PRIO);
+}
+
+/**
+ * The same as `#_tn_task_curr_to_wait_action()`, but the task is queued
+ * in the wait queue in the given order, see `enum #TN_WaitOrder`.
+ * `wait_que` must not be `#TN_NULL`.
+ */
+_TN_STATIC_INLINE void _tn_task_curr_to_wait_action_ord(
+      struct TN_ListItem *wait_que,
+      enum TN_WaitReason wait_reason,
+      TN_TickCnt timeout,
+      enum TN_WaitOrder wait_order
+      )
+{
+   _tn_task_curr_to_wait_action(wait_que, wait_reason, timeout);
+
+   if (wait_order == TN_WAIT_ORDER_PRIO){
+      _tn_task_wait_prio_insert(_tn_curr_run_task);
+   }
+}
+
 
 /**
- * Change priority of any task (either runnable or non-runnable)
+ * Change priority of any task (either runnable or non-runnable). If the task
+ * waits in the wait queue ordered by priority, its place in the queue is
+ * updated.
  */
 void _tn_change_task_priority(struct TN_Task *task, int new_priority);
 
@@ -156,6 +156,25 @@ _TN_STATIC_INLINE TN_BOOL _tn_timer_is_valid(
    return (timer->id_timer == TN_ID_TIMER);
 }
 
+/**
+ * Returns timeout from `cur_tick_cnt` until the absolute time `deadline`,
+ * or 0 if the deadline is already reached. Since tick counter wraps around,
+ * deadline is considered reached if it is not more than half of the
+ * `#TN_TickCnt` range behind `cur_tick_cnt`.
+ */
+_TN_STATIC_INLINE TN_TickCnt _tn_timeout_until(
+      TN_TickCnt deadline,
+      TN_TickCnt cur_tick_cnt
+      )
+{
+   //-- unsigned subtraction takes care of counter overflow
+   TN_TickCnt timeout = deadline - cur_tick_cnt;
+
+   return (timeout > (TN_WAIT_INFINITE / 2))
+      ? 0
+      : timeout;
+}
+
 /**
  * Called by `_tn_timers_tick_proceed()`, which is implemented differently
  * depending on `TN_DYNAMIC_TICK` option.
@@ -177,6 +196,11 @@ _TN_STATIC_INLINE void _tn_timer_callback_call(
    //   might be changed by interrupt
    void *p_user_data = timer->p_user_data;
 
+   //-- the status is given by the caller, so declare just the data used
+   //   for measuring critical sections (see `#TN_INT_DIS_MEASURE`): the
+   //   caller's section ends here, and the new one starts after callback
+   _TN_INT_DIS_MEASURE_DATA
+
    //-- before calling callback function, enable interrupts, so that
    //   they aren't disabled for too long
    TN_INT_IRESTORE();
@@ -70,6 +70,14 @@ extern struct TN_ListItem _tn_timer_list__gen;
 /// "tick" lists of timers, for details, refer to \ref 
 /// timers_static_implementation
 extern struct TN_ListItem _tn_timer_list__tick[ TN_TICK_LISTS_CNT ];
+
+#if (TN_TICK_WHEEL_LEVELS > 1)
+///
+/// higher-level lists of timers (used if only `#TN_TICK_WHEEL_LEVELS` is
+/// more than 1), for details, refer to \ref timers_static_implementation
+extern struct TN_ListItem _tn_timer_list__wheel
+   [ TN_TICK_WHEEL_LEVELS - 1 ][ TN_TICK_LISTS_CNT ];
+#endif
 ///
 /// system time that can be returned by `tn_sys_time_get()`; it is also used
 /// by tn_timer.h subsystem.
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+#ifndef __TN_TRACE_H
+#define __TN_TRACE_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "_tn_sys.h"
+#include "_tn_timer.h"
+#include "tn_trace.h"
+
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    EXTERNAL TYPES
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+#if TN_TRACE
+/// Header of the current trace buffer, or `TN_NULL` if tracing is stopped.
+extern struct TN_TraceHdr *_tn_trace_hdr;
+#endif
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+#if defined(_TN_CYCLE_CNT_GET)
+/**
+ * Get timestamp for the trace record: value of the hardware cycle counter,
+ * if the architecture has it, or system tick count otherwise.
+ */
+#  define _TN_TRACE_TS_GET()     ((TN_UWord)_TN_CYCLE_CNT_GET())
+#  define _TN_TRACE_TS_FLAGS     TN_TRACE_FLAG_TS_CYCLES
+#else
+#  define _TN_TRACE_TS_GET()     ((TN_UWord)_tn_timer_sys_time_get())
+#  define _TN_TRACE_TS_FLAGS     0
+#endif
+
+
+/*******************************************************************************
+ *    PROTECTED INLINE FUNCTIONS
+ ******************************************************************************/
+
+#if TN_TRACE
+
+/**
+ * Write the record to the trace buffer, if tracing is started. If
+ * `#TN_TRACE` is zero, this is a no-op macro, so that the caller doesn't
+ * need to care about the option.
+ *
+ * \attention Caller must disable interrupts (unless the system isn't
+ * started yet).
+ *
+ * @param ev
+ *    Event type
+ * @param arg
+ *    Argument of the event, only 8 bits are stored
+ * @param obj
+ *    Object the event is related to (typically a pointer to it)
+ */
+_TN_STATIC_INLINE void _tn_trace_put(
+      enum TN_TraceEv ev,
+      int arg,
+      TN_UWord obj
+      )
+{
+   struct TN_TraceHdr *hdr = _tn_trace_hdr;
+
+   if (hdr != TN_NULL){
+      TN_UWord *rec = (TN_UWord *)(hdr + 1)
+         + (hdr->wr_idx & (hdr->recs_cnt - 1)) * TN_TRACE_REC_WORDS;
+
+      rec[0] = _TN_TRACE_TS_GET();
+      rec[1] = (TN_UWord)ev | ((TN_UWord)(arg & 0xff) << 8);
+      rec[2] = obj;
+
+      hdr->wr_idx++;
+   }
+}
+
+/**
+ * Returns whether tracing is started. Lock-free fast paths (see
+ * `#TN_FAST_PATH`) don't write trace records, so they aren't used while it
+ * returns `TN_TRUE`. If `#TN_TRACE` is zero, it is always `TN_FALSE`.
+ */
+_TN_STATIC_INLINE TN_BOOL _tn_trace_is_started(void)
+{
+   return (_tn_trace_hdr != TN_NULL);
+}
+
+#else
+
+#  define  _tn_trace_put(ev, arg, obj)                               /* nothing */
+#  define  _tn_trace_is_started()                                    (TN_FALSE)
+
+#endif   // TN_TRACE
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+
+#endif // __TN_TRACE_H
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
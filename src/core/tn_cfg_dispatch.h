@@ -91,6 +91,10 @@
 #  error TN_PRIORITIES_CNT is not defined
 #endif
 
+#if !defined(TN_PRIORITIES_2LEVEL_BMP)
+#  error TN_PRIORITIES_2LEVEL_BMP is not defined
+#endif
+
 
 #if !defined(TN_CHECK_PARAM)
 #  error TN_CHECK_PARAM is not defined
@@ -121,6 +125,14 @@
 #  error TN_TICK_LISTS_CNT is not defined
 #endif
 
+#if !defined(TN_TICK_WHEEL_LEVELS)
+#  error TN_TICK_WHEEL_LEVELS is not defined
+#endif
+
+#if !defined(TN_TICK_INT_MEASURE)
+#  error TN_TICK_INT_MEASURE is not defined
+#endif
+
 #if !defined(TN_API_MAKE_ALIG_ARG)
 #  error TN_API_MAKE_ALIG_ARG is not defined
 #endif
@@ -133,6 +145,18 @@
 #  error TN_PROFILER_WAIT_TIME is not defined
 #endif
 
+#if !defined(TN_PROFILER_CYCLES)
+#  error TN_PROFILER_CYCLES is not defined
+#endif
+
+#if !defined(TN_TRACE)
+#  error TN_TRACE is not defined
+#endif
+
+#if !defined(TN_INT_DIS_MEASURE)
+#  error TN_INT_DIS_MEASURE is not defined
+#endif
+
 #if !defined(TN_INIT_INTERRUPT_STACK_SPACE)
 #  error TN_INIT_INTERRUPT_STACK_SPACE is not defined
 #endif
@@ -147,14 +171,51 @@
 #  endif
 #endif
 
+#if defined (__TN_ARCH_CORTEX_M__)
+#  if !defined(TN_CORTEX_M_SYS_BASEPRI)
+#     error TN_CORTEX_M_SYS_BASEPRI is not defined
+#  endif
+#  if !defined(TN_CORTEX_M_FPU_LAZY)
+#     error TN_CORTEX_M_FPU_LAZY is not defined
+#  endif
+#endif
+
 #if !defined(TN_DYNAMIC_TICK)
 #  error TN_DYNAMIC_TICK is not defined
 #endif
 
+#if !defined(TN_DYNAMIC_TICK_WHEEL)
+#  error TN_DYNAMIC_TICK_WHEEL is not defined
+#endif
+
+#if !defined(TN_DYNAMIC_TICK_WHEEL_LEVELS)
+#  error TN_DYNAMIC_TICK_WHEEL_LEVELS is not defined
+#endif
+
 #if !defined(TN_OLD_EVENT_API)
 #  error TN_OLD_EVENT_API is not defined
 #endif
 
+#if !defined(TN_MULTI_WAIT)
+#  error TN_MULTI_WAIT is not defined
+#endif
+
+#if !defined(TN_TASK_NOTIFY)
+#  error TN_TASK_NOTIFY is not defined
+#endif
+
+#if !defined(TN_EVENTGRP_WAIT_INDEX)
+#  error TN_EVENTGRP_WAIT_INDEX is not defined
+#endif
+
+#if !defined(TN_EVENTGRP_WIDE)
+#  error TN_EVENTGRP_WIDE is not defined
+#endif
+
+#if !defined(TN_FAST_PATH)
+#  error TN_FAST_PATH is not defined
+#endif
+
 #if !defined(TN_FORCED_INLINE)
 #  error TN_FORCED_INLINE is not defined
 #endif
@@ -178,7 +239,20 @@
 #  endif
 #endif
 
+//-- check TN_CORTEX_M_SYS_BASEPRI: should be 0 .. 0xff, and can't be used
+//   on Cortex-M0/M0+, which don't have BASEPRI.
+#if defined (__TN_ARCH_CORTEX_M__)
+#  if TN_CORTEX_M_SYS_BASEPRI < 0 || TN_CORTEX_M_SYS_BASEPRI > 0xff
+#     error TN_CORTEX_M_SYS_BASEPRI must be in the range 0 .. 0xff
+#  endif
+#  if TN_CORTEX_M_SYS_BASEPRI && !defined(__TN_ARCHFEAT_CORTEX_M_ARMv7M_ISA__)
+#     error TN_CORTEX_M_SYS_BASEPRI is not supported on Cortex-M0/M0+
+#  endif
+#endif
+
 //-- NOTE: TN_TICK_LISTS_CNT is checked in tn_timer_static.c
+//-- NOTE: TN_TICK_WHEEL_LEVELS is checked in tn_timer_static.c
+//-- NOTE: TN_DYNAMIC_TICK_WHEEL_LEVELS is checked in tn_timer_dyn.c
 //-- NOTE: TN_PRIORITIES_CNT is checked in tn_sys.c
 //-- NOTE: TN_API_MAKE_ALIG_ARG is checked in tn_common.h
 
@@ -187,7 +261,7 @@
  * Internal kernel definition: set to non-zero if `_tn_sys_on_context_switch()`
  * should be called on context switch. 
  */
-#if TN_PROFILER || TN_STACK_OVERFLOW_CHECK
+#if TN_PROFILER || TN_STACK_OVERFLOW_CHECK || TN_TRACE
 #  define   _TN_ON_CONTEXT_SWITCH_HANDLER  1
 #else
 #  define   _TN_ON_CONTEXT_SWITCH_HANDLER  0
@@ -73,6 +73,9 @@ enum TN_ObjId {
    TN_ID_TIMER          = (int)0x1A937FBC,  //!< id for timers
    TN_ID_EXCHANGE       = (int)0x32b7c072,  //!< id for exchange objects
    TN_ID_EXCHANGE_LINK  = (int)0x24d36f35,  //!< id for exchange link
+   TN_ID_MSGQUEUE       = (int)0x5D3B91C6,  //!< id for message queues
+   TN_ID_RING           = (int)0x3C6E1B57,  //!< id for SPSC ring buffers
+   TN_ID_DEFER          = (int)0x4A1D7E93,  //!< id for deferred call queues
 };
 
 /**
@@ -132,13 +135,34 @@ enum TN_RCode {
    /// Object for whose event task was waiting is deleted.
    TN_RC_DELETED              =  -8,
    /// Task was released from waiting forcibly because some other task 
-   /// called `tn_task_release_wait()`
+   /// called `tn_task_release_wait()` (or, for `tn_task_period_wait()`,
+   /// `tn_task_wakeup()`)
    TN_RC_FORCED               =  -9,
    /// Internal kernel error, should never be returned by kernel services.
    /// If it is returned, it's a bug in the kernel.
    TN_RC_INTERNAL             = -10,
 };
 
+/**
+ * Order in which tasks waiting for the kernel object are queued, and,
+ * therefore, woken up. Given to the `..._create_wattr()` functions of the
+ * objects, like `tn_sem_create_wattr()`.
+ */
+enum TN_WaitOrder {
+   ///
+   /// Tasks are queued in the order they start waiting (FIFO). This is the
+   /// default, and the cheapest one.
+   TN_WAIT_ORDER_FIFO,
+   ///
+   /// Tasks are queued by priority, so the highest-priority waiter is woken
+   /// up first; tasks of the same priority are queued in FIFO order. The
+   /// order is maintained when the priority of the waiting task is changed
+   /// (by `tn_task_change_priority()` or by the mutex priority
+   /// inheritance). Putting the task to wait costs O(n), where n is the
+   /// number of tasks already waiting.
+   TN_WAIT_ORDER_PRIO,
+};
+
 /**
  * Prototype for task body function.
  */
@@ -0,0 +1,519 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_tasks.h"
+#include "_tn_timer.h"
+
+
+#include "tn_defer.h"
+#include "_tn_defer.h"
+
+#include "tn_tasks.h"
+
+//-- for memcpy(), memset()
+#include <string.h>
+
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Timestamp for latency statistics: CPU cycles if the architecture provides
+ * the cycle counter, system ticks otherwise.
+ */
+#if defined(_TN_CYCLE_CNT_GET)
+#  define _DEFER_TS_GET()     ((TN_UWord)_TN_CYCLE_CNT_GET())
+#else
+#  define _DEFER_TS_GET()     ((TN_UWord)_tn_timer_sys_time_get())
+#endif
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_Defer *defer
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (defer == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_defer_is_valid(defer)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_Defer *defer,
+      struct TN_DeferItem *items_buf,
+      int items_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (defer == TN_NULL || items_buf == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (items_cnt <= 0 || _tn_defer_is_valid(defer)){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_func(
+      TN_DeferFunc *func
+      )
+{
+   return (func == TN_NULL) ? TN_RC_WPARAM : TN_RC_OK;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_stat(
+      const struct TN_DeferStat *p_stat
+      )
+{
+   return (p_stat == TN_NULL) ? TN_RC_WPARAM : TN_RC_OK;
+}
+
+#else
+#  define _check_param_generic(defer)                                  \
+   (TN_RC_OK)
+#  define _check_param_create(defer, items_buf, items_cnt)             \
+   (TN_RC_OK)
+#  define _check_param_func(func)                                      \
+   (TN_RC_OK)
+#  define _check_param_stat(p_stat)                                    \
+   (TN_RC_OK)
+#endif
+// }}}
+
+//-- Queue indexes processing {{{
+
+/**
+ * Returns number of pending calls, given the values of `head_idx` and
+ * `tail_idx`. Both of them take values from 0 to `(2 * items_cnt - 1)`,
+ * so, the difference is from 0 to `items_cnt`, once wrapped around.
+ */
+_TN_STATIC_INLINE int _used_items_cnt(
+      const struct TN_Defer *defer,
+      int head_idx,
+      int tail_idx
+      )
+{
+   int ret = head_idx - tail_idx;
+   if (ret < 0){
+      ret += (defer->items_cnt << 1);
+   }
+   return ret;
+}
+
+/**
+ * Returns pointer to the item in `items_buf` for the given index (either
+ * `head_idx` or `tail_idx`).
+ */
+_TN_STATIC_INLINE struct TN_DeferItem *_item_ptr_get(
+      const struct TN_Defer *defer,
+      int idx
+      )
+{
+   if (idx >= defer->items_cnt){
+      idx -= defer->items_cnt;
+   }
+   return &defer->items_buf[idx];
+}
+
+/**
+ * Returns the index next to the given one (either `head_idx` or
+ * `tail_idx`), wrapped around at `(2 * items_cnt)`.
+ */
+_TN_STATIC_INLINE int _idx_next(
+      const struct TN_Defer *defer,
+      int idx
+      )
+{
+   idx++;
+   if (idx >= (defer->items_cnt << 1)){
+      idx = 0;
+   }
+   return idx;
+}
+
+// }}}
+
+/**
+ * Producer side: queue the call. Should be called with interrupts disabled,
+ * since there may be several producers.
+ *
+ * If the service task waits for new calls, it is woken up.
+ */
+static enum TN_RCode _defer_put(
+      struct TN_Defer *defer,
+      TN_DeferFunc *func,
+      void *arg
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   int head_idx = defer->head_idx;
+   int used_cnt = _used_items_cnt(defer, head_idx, defer->tail_idx);
+
+   if (used_cnt >= defer->items_cnt){
+      //-- no space for new call
+      defer->stat.overflows_cnt++;
+      rc = TN_RC_OVERFLOW;
+   } else {
+      struct TN_DeferItem *item = _item_ptr_get(defer, head_idx);
+
+      //-- make sure the slot is released by the service task (`tail_idx`
+      //   is read) before we overwrite it
+      _TN_MEMORY_BARRIER();
+
+      item->func        = func;
+      item->arg         = arg;
+      item->timestamp   = _DEFER_TS_GET();
+
+      //-- make sure the item is written before it is published
+      _TN_MEMORY_BARRIER();
+
+      defer->head_idx = _idx_next(defer, head_idx);
+
+      used_cnt++;
+      if (used_cnt > defer->stat.max_depth){
+         defer->stat.max_depth = used_cnt;
+      }
+
+      if (     _tn_task_is_waiting(&defer->task)
+            && defer->task.task_wait_reason == TN_WAIT_REASON_DEFER
+         )
+      {
+         //-- service task waits for new calls: wake it up.
+         _tn_task_wait_complete(&defer->task, TN_RC_OK);
+      }
+   }
+
+   return rc;
+}
+
+/**
+ * Consumer side (i.e. the service task): take the next pending call without
+ * disabling interrupts.
+ *
+ * If there is some call in the queue, it is copied to `p_item`, and
+ * `#TN_RC_OK` is returned; otherwise, `#TN_RC_TIMEOUT` is returned.
+ */
+static enum TN_RCode _defer_take(
+      struct TN_Defer *defer,
+      struct TN_DeferItem *p_item
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   //-- `tail_idx` is modified by the service task only, i.e. by us
+   int tail_idx = defer->tail_idx;
+
+   if (defer->head_idx == tail_idx){
+      //-- nothing to call
+      rc = TN_RC_TIMEOUT;
+   } else {
+      //-- make sure `head_idx` is read before the item
+      _TN_MEMORY_BARRIER();
+
+      *p_item = *_item_ptr_get(defer, tail_idx);
+
+      //-- make sure the item is read before the slot is released
+      _TN_MEMORY_BARRIER();
+
+      defer->tail_idx = _idx_next(defer, tail_idx);
+   }
+
+   return rc;
+}
+
+/**
+ * Account latency of the call which is about to be executed
+ */
+_TN_STATIC_INLINE void _latency_account(
+      struct TN_Defer *defer,
+      TN_UWord timestamp
+      )
+{
+   //-- unsigned subtraction takes care of counter overflow
+   TN_UWord latency = _DEFER_TS_GET() - timestamp;
+   TN_UWord total = defer->stat.total_latency + latency;
+
+   if (total < latency){
+      //-- saturate
+      total = (TN_UWord)(-1);
+   }
+
+   defer->stat.total_latency = total;
+   if (latency > defer->stat.max_latency){
+      defer->stat.max_latency = latency;
+   }
+}
+
+/**
+ * Body of the service task: execute pending calls as long as there are
+ * some, and wait for new ones when the queue becomes empty.
+ */
+static void _defer_task_body(void *param)
+{
+   struct TN_Defer *defer = (struct TN_Defer *)param;
+   struct TN_DeferItem item;
+
+   for (;;){
+      if (_defer_take(defer, &item) == TN_RC_OK){
+         _latency_account(defer, item.timestamp);
+         item.func(item.arg);
+         defer->stat.calls_cnt++;
+      } else {
+         TN_INTSAVE_DATA;
+
+         TN_INT_DIS_SAVE();
+
+         //-- check the queue again with interrupts disabled: some ISR
+         //   might have queued the call after we've found the queue empty.
+         //   Producers wake us up with interrupts disabled as well, so,
+         //   the wakeup can't be missed.
+         if (defer->head_idx == defer->tail_idx){
+            _tn_task_curr_to_wait_action(
+                  TN_NULL, TN_WAIT_REASON_DEFER, TN_WAIT_INFINITE
+                  );
+         }
+
+         TN_INT_RESTORE();
+         _tn_context_switch_pend_if_needed();
+      }
+   }
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_defer.h)
+ */
+enum TN_RCode tn_defer_create(
+      struct TN_Defer        *defer,
+      struct TN_DeferItem    *items_buf,
+      int                     items_cnt,
+      TN_UWord               *task_stack_low_addr,
+      int                     task_stack_size,
+      int                     task_priority
+      )
+{
+   enum TN_RCode rc = _check_param_create(defer, items_buf, items_cnt);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      defer->items_buf  = items_buf;
+      defer->items_cnt  = items_cnt;
+      defer->head_idx   = 0;
+      defer->tail_idx   = 0;
+      memset(&defer->stat, 0x00, sizeof(defer->stat));
+
+#if defined(_TN_CYCLE_CNT_INIT)
+      //-- enable hardware cycle counter used for latency statistics
+      _TN_CYCLE_CNT_INIT();
+#endif
+
+      //-- the object should be valid before the service task is started,
+      //   since it may start running right away
+      defer->id_defer = TN_ID_DEFER;
+
+      rc = tn_task_create_wname(
+            &defer->task,
+            _defer_task_body,
+            task_priority,
+            task_stack_low_addr,
+            task_stack_size,
+            defer,
+            TN_TASK_CREATE_OPT_START,
+            "tn_defer"
+            );
+
+      if (rc != TN_RC_OK){
+         defer->id_defer = TN_ID_NONE;
+      }
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_defer.h)
+ */
+enum TN_RCode tn_defer_delete(struct TN_Defer *defer)
+{
+   enum TN_RCode rc = _check_param_generic(defer);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context() || tn_cur_task_get() == &defer->task){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      //-- from now on, producers get TN_RC_INVALID_OBJ (if param checking
+      //   is on)
+      TN_INT_DIS_SAVE();
+      defer->id_defer = TN_ID_NONE;
+      TN_INT_RESTORE();
+
+      //-- terminate the service task and delete it; pending calls are
+      //   just discarded
+      rc = tn_task_terminate(&defer->task);
+      if (rc == TN_RC_OK){
+         rc = tn_task_delete(&defer->task);
+      }
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_defer.h)
+ */
+enum TN_RCode tn_defer_icall(
+      struct TN_Defer *defer,
+      TN_DeferFunc *func,
+      void *arg
+      )
+{
+   enum TN_RCode rc = _check_param_generic(defer);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_func(func)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      rc = _defer_put(defer, func, arg);
+      TN_INT_IRESTORE();
+
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_defer.h)
+ */
+enum TN_RCode tn_defer_call(
+      struct TN_Defer *defer,
+      TN_DeferFunc *func,
+      void *arg
+      )
+{
+   enum TN_RCode rc = _check_param_generic(defer);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_func(func)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      rc = _defer_put(defer, func, arg);
+      TN_INT_RESTORE();
+
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_defer.h)
+ */
+enum TN_RCode tn_defer_stat_get(
+      struct TN_Defer *defer,
+      struct TN_DeferStat *p_stat,
+      TN_BOOL reset
+      )
+{
+   enum TN_RCode rc = _check_param_generic(defer);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_stat(p_stat)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      memcpy(p_stat, &defer->stat, sizeof(*p_stat));
+      if (reset){
+         memset(&defer->stat, 0x00, sizeof(defer->stat));
+      }
+
+      TN_INT_RESTORE();
+   }
+
+   return rc;
+}
+
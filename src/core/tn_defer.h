@@ -0,0 +1,388 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Deferred calls (a.k.a. "bottom halves"): an ISR queues a call of some
+ * function with an argument by `tn_defer_icall()`, and the function is
+ * called later by the service task of the deferred call queue, with
+ * interrupts enabled. This keeps ISRs short, and, contrary to the common
+ * approach when each ISR signals its own dedicated task, it needs a single
+ * task (with its stack) for all the interrupts that share the queue.
+ *
+ * Deferred call queue, `struct #TN_Defer`, contains the service task and
+ * the ring of pending calls; the buffer for the ring and the stack for the
+ * task are provided by the application, see `tn_defer_create()`. The
+ * application may create several queues, with different service task
+ * priorities: say, one for urgent jobs, and another one for the lengthy
+ * ones.
+ *
+ * Queueing a call (`tn_defer_icall()`) takes a very short critical section
+ * which is needed since there may be several producers (nested ISRs);
+ * the service task enters the kernel only to wait when the queue becomes
+ * empty, so the calls queued by ISRs while the service task is busy are
+ * executed as a batch. The producer enters the kernel to wake the service
+ * task up if only the task waits for new calls.
+ *
+ * Each queue maintains statistics, see `struct #TN_DeferStat`: number of
+ * calls executed and dropped, maximum number of pending calls, and maximum
+ * latency, i.e. the time since the call was queued until the function is
+ * called.
+ *
+ * Restrictions:
+ *
+ * - The producer never waits: if the queue is full, the call is dropped,
+ *   and `#TN_RC_OVERFLOW` is returned.
+ * - Deferred functions are called from the service task, so they may call
+ *   any kernel service allowed from the task context, but they should not
+ *   sleep for long (say, wait for some object with `#TN_WAIT_INFINITE`),
+ *   since all the other calls in the same queue wait for them.
+ */
+
+#ifndef _TN_DEFER_H
+#define _TN_DEFER_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_tasks.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Prototype of the function that can be called by the deferred call queue,
+ * see `tn_defer_icall()`.
+ *
+ * @param arg
+ *    Argument given to `tn_defer_icall()` / `tn_defer_call()`
+ */
+typedef void (TN_DeferFunc)(void *arg);
+
+/**
+ * Pending deferred call; the application should allocate an array of them
+ * for each queue, see `TN_DEFER_BUF_DEF()`.
+ */
+struct TN_DeferItem {
+   ///
+   /// Function to call
+   TN_DeferFunc  *func;
+   ///
+   /// Argument for the function
+   void          *arg;
+   ///
+   /// Timestamp of when the call is queued, used for latency statistics
+   TN_UWord       timestamp;
+};
+
+/**
+ * Statistics of the deferred call queue, see `tn_defer_stat_get()`.
+ *
+ * Latency is measured in CPU cycles if the architecture provides the cycle
+ * counter (the same one used by `#TN_PROFILER_CYCLES`), or in system ticks
+ * otherwise.
+ */
+struct TN_DeferStat {
+   ///
+   /// Number of calls executed
+   unsigned long  calls_cnt;
+   ///
+   /// Number of calls dropped because the queue was full
+   unsigned long  overflows_cnt;
+   ///
+   /// Maximum number of pending calls, including the one being queued
+   int            max_depth;
+   ///
+   /// Maximum time since the call was queued until the function was called
+   TN_UWord       max_latency;
+   ///
+   /// Total latency of all the executed calls; together with `calls_cnt`,
+   /// it gives the average latency (saturated at the max value of
+   /// `#TN_UWord`).
+   TN_UWord       total_latency;
+};
+
+/**
+ * Deferred call queue
+ */
+struct TN_Defer {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_defer;
+   ///
+   /// Service task that executes the calls
+   struct TN_Task task;
+   ///
+   /// Buffer for pending calls, `items_cnt` items
+   struct TN_DeferItem *items_buf;
+   ///
+   /// Capacity (total items count)
+   int items_cnt;
+   ///
+   /// Index of the item which will be written next time. Modified by the
+   /// producers with interrupts disabled. Takes values from 0 to
+   /// `(2 * items_cnt - 1)`, the same way as in \ref tn_ring.h
+   /// "ring buffer".
+   volatile int head_idx;
+   ///
+   /// Index of the item which will be called next time. Modified by the
+   /// service task only, without disabling interrupts.
+   volatile int tail_idx;
+   ///
+   /// Statistics, see `tn_defer_stat_get()`
+   struct TN_DeferStat stat;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Convenience macro for the definition of buffer for the deferred call
+ * queue. See `tn_defer_create()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_defer_create()` function as the `items_buf` argument)
+ * @param size
+ *    Max number of pending calls.
+ */
+#define TN_DEFER_BUF_DEF(name, size)                              \
+   struct TN_DeferItem name[ (size) ]
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct deferred call queue and start its service task. `id_defer`
+ * member should not contain `#TN_ID_DEFER`, otherwise, `#TN_RC_WPARAM` is
+ * returned.
+ *
+ * Typical definition looks as follows:
+ *
+ * \code{.c}
+ *     //-- max number of pending calls
+ *     #define MY_DEFER_SIZE         16
+ *     #define MY_DEFER_STACK_SIZE   (TN_MIN_STACK_SIZE + 64)
+ *
+ *     TN_DEFER_BUF_DEF(my_defer_buf, MY_DEFER_SIZE);
+ *     TN_STACK_ARR_DEF(my_defer_stack, MY_DEFER_STACK_SIZE);
+ *
+ *     struct TN_Defer my_defer;
+ * \endcode
+ *
+ * And then, construct your `my_defer` as follows:
+ *
+ * \code{.c}
+ *     tn_defer_create(
+ *           &my_defer, my_defer_buf, MY_DEFER_SIZE,
+ *           my_defer_stack, MY_DEFER_STACK_SIZE, MY_DEFER_PRIORITY
+ *           );
+ * \endcode
+ *
+ * And queue the calls from ISRs as follows:
+ *
+ * \code{.c}
+ *     static void my_rx_job(void *arg)
+ *     {
+ *        //-- lengthy processing of the data received,
+ *        //   interrupts are enabled here
+ *     }
+ *
+ *     void my_rx_isr(void)
+ *     {
+ *        //-- acknowledge the interrupt, and defer the rest
+ *        tn_defer_icall(&my_defer, my_rx_job, &my_rx_data);
+ *     }
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param defer
+ *    Pointer to already allocated `struct #TN_Defer`
+ * @param items_buf
+ *    Buffer for pending calls, see `TN_DEFER_BUF_DEF()`
+ * @param items_cnt
+ *    Max number of pending calls
+ * @param task_stack_low_addr
+ *    Pointer to the stack of the service task, see `tn_task_create()`
+ * @param task_stack_size
+ *    Size of the stack of the service task, in words
+ * @param task_priority
+ *    Priority of the service task
+ *
+ * @return
+ *    * `#TN_RC_OK` if queue was successfully created;
+ *    * Otherwise, the code returned by `tn_task_create()` for the service
+ *      task; it includes `#TN_RC_WPARAM` if `task_priority` is wrong.
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_defer_create(
+      struct TN_Defer        *defer,
+      struct TN_DeferItem    *items_buf,
+      int                     items_cnt,
+      TN_UWord               *task_stack_low_addr,
+      int                     task_stack_size,
+      int                     task_priority
+      );
+
+/**
+ * Destruct deferred call queue: the service task is terminated and deleted,
+ * and pending calls (if any) are discarded.
+ *
+ * Must not be called from the deferred function of the same queue.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param defer      deferred call queue to destruct
+ *
+ * @return
+ *    * `#TN_RC_OK` if queue was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_defer_delete(struct TN_Defer *defer);
+
+/**
+ * Queue the call of `func(arg)` to be executed by the service task of the
+ * queue. Never waits.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param defer
+ *    Deferred call queue
+ * @param func
+ *    Function to call, can't be `TN_NULL`
+ * @param arg
+ *    Argument for the function
+ *
+ * @return
+ *    * `#TN_RC_OK` if the call is queued;
+ *    * `#TN_RC_OVERFLOW` if the queue is full, so the call is dropped;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_defer_icall(
+      struct TN_Defer *defer,
+      TN_DeferFunc *func,
+      void *arg
+      );
+
+/**
+ * The same as `tn_defer_icall()`, but for using from the task: it is
+ * useful to pass some job to the lower- or higher-priority service task.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_defer_call(
+      struct TN_Defer *defer,
+      TN_DeferFunc *func,
+      void *arg
+      );
+
+/**
+ * Get statistics of the deferred call queue, see `struct #TN_DeferStat`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param defer
+ *    Deferred call queue
+ * @param p_stat
+ *    Pointer to the location at which statistics should be copied
+ * @param reset
+ *    If `TN_TRUE`, statistics is reset after it is copied
+ *
+ * @return
+ *    * `#TN_RC_OK` on success;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_defer_stat_get(
+      struct TN_Defer *defer,
+      struct TN_DeferStat *p_stat,
+      TN_BOOL reset
+      );
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+
+#endif // _TN_DEFER_H
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
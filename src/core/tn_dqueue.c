@@ -46,6 +46,8 @@
 #include "_tn_eventgrp.h"
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_multi_wait.h"
+#include "_tn_trace.h"
 
 
 #include "tn_dqueue.h"
@@ -95,14 +97,20 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
 _TN_STATIC_INLINE enum TN_RCode _check_param_create(
       const struct TN_DQueue *dque,
       void **data_fifo,
-      int items_cnt
+      int items_cnt,
+      enum TN_WaitOrder wait_order
       )
 {
    enum TN_RCode rc = TN_RC_OK;
 
    if (dque == TN_NULL){
       rc = TN_RC_WPARAM;
-   } else if (items_cnt < 0 || _tn_dqueue_is_valid(dque)){
+   } else if (0
+         || items_cnt < 0
+         || _tn_dqueue_is_valid(dque)
+         || !_tn_wait_order_is_valid(wait_order)
+         )
+   {
       rc = TN_RC_WPARAM;
    }
 
@@ -118,15 +126,58 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_read(
    return (pp_data == TN_NULL) ? TN_RC_WPARAM : TN_RC_OK;
 }
 
+_TN_STATIC_INLINE enum TN_RCode _check_param_multi(
+      void **p_data_arr,
+      int items_cnt
+      )
+{
+   return (p_data_arr == TN_NULL || items_cnt <= 0)
+      ? TN_RC_WPARAM
+      : TN_RC_OK;
+}
+
 #else
 #  define _check_param_generic(dque)                        (TN_RC_OK)
-#  define _check_param_create(dque, data_fifo, items_cnt)   (TN_RC_OK)
+#  define _check_param_create(dque, data_fifo, items_cnt, wait_order)   \
+   (TN_RC_OK)
 #  define _check_param_read(pp_data)                        (TN_RC_OK)
+#  define _check_param_multi(p_data_arr, items_cnt)         (TN_RC_OK)
 #endif
 // }}}
 
 //-- Data queue storage FIFO processing {{{
 
+/**
+ * Put data to the FIFO, which must have a room for it. Connected event group
+ * is not managed here, it's up to the caller.
+ */
+_TN_STATIC_INLINE void _fifo_item_put(struct TN_DQueue *dque, void *p_data)
+{
+   dque->data_fifo[dque->head_idx] = p_data;
+   dque->filled_items_cnt++;
+   dque->head_idx++;
+   if (dque->head_idx >= dque->items_cnt){
+      dque->head_idx = 0;
+   }
+}
+
+/**
+ * Get data from the FIFO, which must be non-empty. Connected event group
+ * is not managed here, it's up to the caller.
+ */
+_TN_STATIC_INLINE void *_fifo_item_get(struct TN_DQueue *dque)
+{
+   void *p_data = dque->data_fifo[dque->tail_idx];
+
+   dque->filled_items_cnt--;
+   dque->tail_idx++;
+   if (dque->tail_idx >= dque->items_cnt){
+      dque->tail_idx = 0;
+   }
+
+   return p_data;
+}
+
 /**
  * Try to put data to the FIFO.
  *
@@ -150,12 +201,7 @@ static enum TN_RCode _fifo_write(struct TN_DQueue *dque, void *p_data)
    } else {
 
       //-- write data
-      dque->data_fifo[dque->head_idx] = p_data;
-      dque->filled_items_cnt++;
-      dque->head_idx++;
-      if (dque->head_idx >= dque->items_cnt){
-         dque->head_idx = 0;
-      }
+      _fifo_item_put(dque, p_data);
 
       //-- set flag in the connected event group (if any),
       //   indicating that there are messages in the queue
@@ -190,12 +236,7 @@ static enum TN_RCode _fifo_read(struct TN_DQueue *dque, void **pp_data)
    } else {
 
       //-- read data
-      *pp_data = dque->data_fifo[dque->tail_idx];
-      dque->filled_items_cnt--;
-      dque->tail_idx++;
-      if (dque->tail_idx >= dque->items_cnt){
-         dque->tail_idx = 0;
-      }
+      *pp_data = _fifo_item_get(dque);
 
       if (dque->filled_items_cnt == 0){
          //-- clear flag in the connected event group (if any),
@@ -267,6 +308,30 @@ static void _cb_before_task_wait_complete__receive_timeout(
    _TN_UNUSED(user_data_2);
 }
 
+/**
+ * Callback function that is given to `_tn_task_first_wait_complete()`
+ * by `_queue_receive_multi()` when task finishes waiting for free item in the
+ * queue. Unlike `_cb_before_task_wait_complete__receive_ok()`, it doesn't
+ * manage connected event group: it's done once by `_queue_receive_multi()`.
+ *
+ * See `#_TN_CBBeforeTaskWaitComplete` for details on function signature.
+ */
+static void _cb_before_task_wait_complete__receive_multi(
+      struct TN_Task   *task,
+      void             *user_data_1,
+      void             *user_data_2
+      )
+{
+   struct TN_DQueue *dque = (struct TN_DQueue *)user_data_1;
+
+   //-- put to data FIFO (there's always a room, since we've just read
+   //   an item from it)
+   _TN_BUG_ON(dque->filled_items_cnt >= dque->items_cnt);
+   _fifo_item_put(dque, task->subsys_wait.dqueue.data_elem);
+
+   _TN_UNUSED(user_data_2);
+}
+
 
 /**
  * Actual worker function that sends new data through the queue. Eventually
@@ -305,7 +370,8 @@ static enum TN_RCode _queue_send(
    //
    //   If yes, we just pass new message to the first task
    //   from the waiting tasks list, and don't modify messages
-   //   fifo at all.
+   //   fifo at all. If there are no such tasks, the same is done for
+   //   the first multi-waiting task (if any).
    //
    //   Otherwise (no waiting tasks), we add new message to the fifo.
 
@@ -313,12 +379,15 @@ static enum TN_RCode _queue_send(
             &dque->wait_receive_list, TN_RC_OK,
             _cb_before_task_wait_complete__send, p_data, TN_NULL
             )
+      && !_tn_multi_wait_first_complete(&dque->multi_wait_list, p_data)
       )
    {
       //-- the data queue's wait_receive list is empty
       rc = _fifo_write(dque, p_data);
    }
 
+   _tn_trace_put(TN_TRACE_EV_QUEUE_SEND, rc, (TN_UWord)dque);
+
    return rc;
 }
 
@@ -395,10 +464,156 @@ static enum TN_RCode _queue_receive(
          break;
    }
 
+   _tn_trace_put(TN_TRACE_EV_QUEUE_RECEIVE, rc, (TN_UWord)dque);
+
    return rc;
 }
 
 
+/**
+ * Actual worker function that sends a number of items through the queue.
+ * Eventually called when user calls one of these functions:
+ *
+ * - `tn_queue_send_multi()`
+ * - `tn_queue_isend_multi_polling()`
+ *
+ * It does the same as `_queue_send()` does for each item, but the connected
+ * event group is managed just once.
+ *
+ * @param dque
+ *    Data queue in which data should be written
+ * @param p_data_arr
+ *    Array of items to write
+ * @param items_cnt
+ *    Number of items in `p_data_arr`
+ *
+ * @return
+ *    Number of items actually sent: it might be less than `items_cnt` if
+ *    there's no more room in the queue.
+ */
+static int _queue_send_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt
+      )
+{
+   int sent_cnt = 0;
+
+   //-- first of all, pass items to the tasks that wait for them (if any),
+   //   including multi-waiting ones. If there are such tasks, then the FIFO
+   //   is empty, so the order of items is preserved.
+   while (
+         sent_cnt < items_cnt
+         && (  _tn_task_first_wait_complete(
+                  &dque->wait_receive_list, TN_RC_OK,
+                  _cb_before_task_wait_complete__send,
+                  p_data_arr[sent_cnt], TN_NULL
+                  )
+            || _tn_multi_wait_first_complete(
+                  &dque->multi_wait_list, p_data_arr[sent_cnt]
+                  )
+            )
+         )
+   {
+      sent_cnt++;
+   }
+
+   //-- put the rest to the FIFO, while there is a room for them
+   if (sent_cnt < items_cnt && dque->filled_items_cnt < dque->items_cnt){
+      do {
+         _fifo_item_put(dque, p_data_arr[sent_cnt]);
+         sent_cnt++;
+      } while (
+            sent_cnt < items_cnt
+            && dque->filled_items_cnt < dque->items_cnt
+            );
+
+      //-- set flag in the connected event group (if any),
+      //   indicating that there are messages in the queue
+      _tn_eventgrp_link_manage(&dque->eventgrp_link, TN_TRUE);
+   }
+
+   _tn_trace_put(
+         TN_TRACE_EV_QUEUE_SEND,
+         (sent_cnt > 0) ? TN_RC_OK : TN_RC_TIMEOUT,
+         (TN_UWord)dque
+         );
+
+   return sent_cnt;
+}
+
+/**
+ * Actual worker function that receives a number of items from the queue.
+ * Eventually called when user calls one of these functions:
+ *
+ * - `tn_queue_receive_multi()`
+ * - `tn_queue_ireceive_multi_polling()`
+ *
+ * It does the same as `_queue_receive()` does for each item, but the
+ * connected event group is managed just once.
+ *
+ * @param dque
+ *    Data queue from which data should be read
+ * @param p_data_arr
+ *    Array to store received items
+ * @param items_cnt
+ *    Max number of items to receive
+ *
+ * @return
+ *    Number of items actually received, might be 0 if the queue is empty.
+ */
+static int _queue_receive_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt
+      )
+{
+   int received_cnt = 0;
+
+   if (dque->filled_items_cnt > 0){
+      do {
+         p_data_arr[received_cnt] = _fifo_item_get(dque);
+         received_cnt++;
+
+         //-- there is a room in the queue now, so if there are tasks that
+         //   wait to send data to the queue, let the first one do that.
+         _tn_task_first_wait_complete(
+               &dque->wait_send_list, TN_RC_OK,
+               _cb_before_task_wait_complete__receive_multi, dque, TN_NULL
+               );
+      } while (received_cnt < items_cnt && dque->filled_items_cnt > 0);
+
+      if (dque->filled_items_cnt == 0){
+         //-- clear flag in the connected event group (if any),
+         //   indicating that there are no messages in the queue
+         _tn_eventgrp_link_manage(&dque->eventgrp_link, TN_FALSE);
+      }
+   }
+
+   //-- if the FIFO is empty, there still might be tasks that wait to send
+   //   data (that might happen if only dque->items_cnt is 0)
+   while (
+         received_cnt < items_cnt
+         && _tn_task_first_wait_complete(
+            &dque->wait_send_list, TN_RC_OK,
+            _cb_before_task_wait_complete__receive_timeout,
+            &p_data_arr[received_cnt], TN_NULL
+            )
+         )
+   {
+      received_cnt++;
+   }
+
+   _tn_trace_put(
+         TN_TRACE_EV_QUEUE_RECEIVE,
+         (received_cnt > 0) ? TN_RC_OK : TN_RC_TIMEOUT,
+         (TN_UWord)dque
+         );
+
+   return received_cnt;
+}
+
+
 /**
  * Intermediary function that is called by queue-related services
  * (`tn_queue_send()`, `tn_queue_receive()`, etc), which performs all necessary
@@ -457,10 +672,11 @@ static enum TN_RCode _dqueue_job_perform(
                //   field, and put current task to wait until there's room in
                //   the queue.
                _tn_curr_run_task->subsys_wait.dqueue.data_elem = p_data;
-               _tn_task_curr_to_wait_action(
+               _tn_task_curr_to_wait_action_ord(
                      &(dque->wait_send_list),
                      TN_WAIT_REASON_DQUE_WSEND,
-                     timeout
+                     timeout,
+                     dque->wait_order
                      );
 
                waited = TN_TRUE;
@@ -476,10 +692,11 @@ static enum TN_RCode _dqueue_job_perform(
                //   happens.
                //
                //   Put current task to wait until new data comes.
-               _tn_task_curr_to_wait_action(
+               _tn_task_curr_to_wait_action_ord(
                      &(dque->wait_receive_list),
                      TN_WAIT_REASON_DQUE_WRECEIVE,
-                     timeout
+                     timeout,
+                     dque->wait_order
                      );
 
                waited = TN_TRUE;
@@ -575,6 +792,217 @@ static enum TN_RCode _dqueue_job_iperform(
 
 
 
+/**
+ * The same as `_dqueue_job_perform()`, but for a number of items: called by
+ * `tn_queue_send_multi()` and `tn_queue_receive_multi()`.
+ *
+ * - `_JOB_TYPE__SEND`: send all the items; if there's no room in the queue,
+ *   wait (depending on `timeout`) until all the items are sent.
+ * - `_JOB_TYPE__RECEIVE`: receive as many items as available, up to
+ *   `items_cnt`; if the queue is empty, wait (depending on `timeout`) for at
+ *   least one item.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param dque
+ *    Data queue on which job should be performed.
+ * @param job_type
+ *    Type of job to perform.
+ * @param p_data_arr
+ *    Array of items to send, or to store received items.
+ * @param items_cnt
+ *    Number of items in `p_data_arr`.
+ * @param p_done_cnt
+ *    Pointer to location to store number of items actually sent or received.
+ *    Can be `TN_NULL`.
+ * @param timeout
+ *    Refer to `#TN_TickCnt`. Note that when sending, task might have to wait
+ *    several times; `timeout` is the total time for all of them.
+ */
+static enum TN_RCode _dqueue_multi_job_perform(
+      struct TN_DQueue *dque,
+      enum _JobType job_type,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_done_cnt,
+      TN_TickCnt timeout
+      )
+{
+   int done_cnt = 0;
+   enum TN_RCode rc = _check_param_generic(dque);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_multi(p_data_arr, items_cnt)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_TickCnt start_tick_cnt = tn_sys_time_get();
+      TN_TickCnt cur_timeout = timeout;
+      TN_BOOL waited;
+
+      do {
+         TN_INTSAVE_DATA;
+
+         waited = TN_FALSE;
+
+         TN_INT_DIS_SAVE();
+
+         switch (job_type){
+
+            case _JOB_TYPE__SEND:
+               //-- try to put all remaining items to the queue
+               done_cnt += _queue_send_multi(
+                     dque, &p_data_arr[done_cnt], items_cnt - done_cnt
+                     );
+
+               if (done_cnt < items_cnt && cur_timeout != 0){
+                  //-- There's no more room in the queue, and user asked to
+                  //   wait if that happens. Wait until the next item is
+                  //   taken by the receiver.
+                  _tn_curr_run_task->subsys_wait.dqueue.data_elem
+                     = p_data_arr[done_cnt];
+                  _tn_task_curr_to_wait_action_ord(
+                        &(dque->wait_send_list),
+                        TN_WAIT_REASON_DQUE_WSEND,
+                        cur_timeout,
+                        dque->wait_order
+                        );
+
+                  waited = TN_TRUE;
+               }
+               break;
+
+            case _JOB_TYPE__RECEIVE:
+               //-- try to get available items from the queue
+               done_cnt = _queue_receive_multi(dque, p_data_arr, items_cnt);
+
+               if (done_cnt == 0 && cur_timeout != 0){
+                  //-- Queue is empty right now, and user asked to wait if
+                  //   that happens: wait for the first item.
+                  _tn_task_curr_to_wait_action_ord(
+                        &(dque->wait_receive_list),
+                        TN_WAIT_REASON_DQUE_WRECEIVE,
+                        cur_timeout,
+                        dque->wait_order
+                        );
+
+                  waited = TN_TRUE;
+               }
+               break;
+         }
+
+         TN_INT_RESTORE();
+         _tn_context_switch_pend_if_needed();
+
+         if (waited){
+            //-- get wait result
+            rc = _tn_curr_run_task->task_wait_rc;
+
+            if (rc == TN_RC_OK){
+               //-- the item is sent or received. If we were receiving, get
+               //   the item from the task's `dqueue.data_elem` field, and
+               //   we're done; if we were sending, we need to continue with
+               //   remaining items (if any).
+               switch (job_type){
+                  case _JOB_TYPE__SEND:
+                     done_cnt++;
+                     break;
+                  case _JOB_TYPE__RECEIVE:
+                     p_data_arr[0]
+                        = _tn_curr_run_task->subsys_wait.dqueue.data_elem;
+                     done_cnt = 1;
+                     break;
+               }
+
+               //-- calculate how much time is left to wait
+               if (done_cnt < items_cnt && timeout != TN_WAIT_INFINITE){
+                  TN_TickCnt elapsed = tn_sys_time_get() - start_tick_cnt;
+                  cur_timeout = (elapsed < timeout) ? (timeout - elapsed) : 0;
+               }
+            }
+         } else if (job_type == _JOB_TYPE__SEND){
+            rc = (done_cnt == items_cnt) ? TN_RC_OK : TN_RC_TIMEOUT;
+         } else {
+            rc = (done_cnt > 0) ? TN_RC_OK : TN_RC_TIMEOUT;
+         }
+
+         //-- if we were sending and there are remaining items, try again
+         //   (if timeout has expired, remaining items will be just polled,
+         //   and then `#TN_RC_TIMEOUT` will be returned)
+      } while (
+            waited && rc == TN_RC_OK
+            && job_type == _JOB_TYPE__SEND && done_cnt < items_cnt
+            );
+   }
+
+   if (p_done_cnt != TN_NULL){
+      *p_done_cnt = done_cnt;
+   }
+
+   return rc;
+}
+
+/**
+ * The same as `_dqueue_multi_job_perform()` with zero timeout, but for using
+ * in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+static enum TN_RCode _dqueue_multi_job_iperform(
+      struct TN_DQueue *dque,
+      enum _JobType job_type,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_done_cnt
+      )
+{
+   int done_cnt = 0;
+   enum TN_RCode rc = _check_param_generic(dque);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_multi(p_data_arr, items_cnt)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      //-- wrong context
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      //-- depending on the job type, call appropriate function
+      switch (job_type){
+
+         case _JOB_TYPE__SEND:
+            done_cnt = _queue_send_multi(dque, p_data_arr, items_cnt);
+            rc = (done_cnt == items_cnt) ? TN_RC_OK : TN_RC_TIMEOUT;
+            break;
+
+         case _JOB_TYPE__RECEIVE:
+            done_cnt = _queue_receive_multi(dque, p_data_arr, items_cnt);
+            rc = (done_cnt > 0) ? TN_RC_OK : TN_RC_TIMEOUT;
+            break;
+      }
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   if (p_done_cnt != TN_NULL){
+      *p_done_cnt = done_cnt;
+   }
+
+   return rc;
+}
+
+
 
 /*******************************************************************************
  *    PUBLIC FUNCTIONS
@@ -588,18 +1016,35 @@ enum TN_RCode tn_queue_create(
       void **data_fifo,
       int items_cnt
       )
+{
+   return tn_queue_create_wattr(
+         dque, data_fifo, items_cnt, TN_WAIT_ORDER_FIFO
+         );
+}
+
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_create_wattr(
+      struct TN_DQueue *dque,
+      void **data_fifo,
+      int items_cnt,
+      enum TN_WaitOrder wait_order
+      )
 {
    enum TN_RCode rc = TN_RC_OK;
 
-   rc = _check_param_create(dque, data_fifo, items_cnt);
+   rc = _check_param_create(dque, data_fifo, items_cnt, wait_order);
    if (rc != TN_RC_OK){
       //-- just return rc as it is
    } else {
       _tn_list_reset(&(dque->wait_send_list));
       _tn_list_reset(&(dque->wait_receive_list));
+      _tn_multi_wait_list_reset(&(dque->multi_wait_list));
 
       dque->data_fifo         = data_fifo;
       dque->items_cnt         = items_cnt;
+      dque->wait_order        = wait_order;
 
       _tn_eventgrp_link_reset(&dque->eventgrp_link);
 
@@ -639,6 +1084,7 @@ enum TN_RCode tn_queue_delete(struct TN_DQueue * dque)
       //   (TN_RC_DELETED is returned)
       _tn_wait_queue_notify_deleted(&(dque->wait_send_list));
       _tn_wait_queue_notify_deleted(&(dque->wait_receive_list));
+      _tn_multi_wait_notify_deleted(&(dque->multi_wait_list));
 
       dque->id_dque = TN_ID_NONE; //-- data queue does not exist now
 
@@ -716,6 +1162,69 @@ enum TN_RCode tn_queue_ireceive_polling(struct TN_DQueue *dque, void **pp_data)
    return _dqueue_job_iperform(dque, _JOB_TYPE__RECEIVE, pp_data);
 }
 
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_send_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_sent_cnt,
+      TN_TickCnt timeout
+      )
+{
+   return _dqueue_multi_job_perform(
+         dque, _JOB_TYPE__SEND, p_data_arr, items_cnt, p_sent_cnt, timeout
+         );
+}
+
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_isend_multi_polling(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_sent_cnt
+      )
+{
+   return _dqueue_multi_job_iperform(
+         dque, _JOB_TYPE__SEND, p_data_arr, items_cnt, p_sent_cnt
+         );
+}
+
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_receive_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_received_cnt,
+      TN_TickCnt timeout
+      )
+{
+   return _dqueue_multi_job_perform(
+         dque, _JOB_TYPE__RECEIVE, p_data_arr, items_cnt, p_received_cnt,
+         timeout
+         );
+}
+
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_ireceive_multi_polling(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_received_cnt
+      )
+{
+   return _dqueue_multi_job_iperform(
+         dque, _JOB_TYPE__RECEIVE, p_data_arr, items_cnt, p_received_cnt
+         );
+}
+
 /*
  * See comments in the header file (tn_dqueue.h)
  */
@@ -776,6 +1285,29 @@ enum TN_RCode tn_queue_eventgrp_connect(
    return rc;
 }
 
+#if TN_EVENTGRP_WIDE
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_eventgrp_connect_bit(
+      struct TN_DQueue    *dque,
+      struct TN_EventGrp  *eventgrp,
+      int                  bit_num
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_generic(dque);
+
+   if (rc == TN_RC_OK){
+      sr_saved = tn_arch_sr_save_int_dis();
+      rc = _tn_eventgrp_link_set_bit(&dque->eventgrp_link, eventgrp, bit_num);
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+#endif
+
 /*
  * See comments in the header file (tn_dqueue.h)
  */
@@ -796,3 +1328,22 @@ enum TN_RCode tn_queue_eventgrp_disconnect(
 }
 
 
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+#if TN_MULTI_WAIT
+
+/*
+ * See comments in the file _tn_dqueue.h
+ */
+enum TN_RCode _tn_dqueue_try_receive(struct TN_DQueue *dque, void **pp_data)
+{
+   return _queue_receive(dque, pp_data);
+}
+
+#endif
+
+
@@ -64,6 +64,7 @@
  * queue services:
  *
  * - `tn_queue_eventgrp_connect()`
+ * - `tn_queue_eventgrp_connect_bit()`
  * - `tn_queue_eventgrp_disconnect()`
  *
  * There is an example project available that demonstrates event group
@@ -131,8 +132,20 @@ struct TN_DQueue {
    /// index of the item which will be read next time
    int            tail_idx;
    ///
+   /// Order of tasks in `wait_send_list` and `wait_receive_list`, see
+   /// `tn_queue_create_wattr()`
+   enum TN_WaitOrder wait_order;
+   ///
    /// connected event group
    struct TN_EGrpLink eventgrp_link;
+
+#if TN_MULTI_WAIT || defined(DOXYGEN_ACTIVE)
+   ///
+   /// list of multi-wait items waiting to receive data (see
+   /// \ref tn_multi_wait.h), available if only `#TN_MULTI_WAIT` option is
+   /// non-zero.
+   struct TN_ListItem  multi_wait_list;
+#endif
 };
 
 /**
@@ -185,6 +198,27 @@ enum TN_RCode tn_queue_create(
       int items_cnt
       );
 
+/**
+ * The same as `tn_queue_create()`, but takes additional argument: the order
+ * of waiting tasks (both senders and receivers). `tn_queue_create()` uses
+ * `#TN_WAIT_ORDER_FIFO`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param wait_order
+ *    Order in which waiting tasks are served, see `enum #TN_WaitOrder`
+ *
+ * For the rest of params and return codes, see `tn_queue_create()`.
+ */
+enum TN_RCode tn_queue_create_wattr(
+      struct TN_DQueue *dque,
+      void **data_fifo,
+      int items_cnt,
+      enum TN_WaitOrder wait_order
+      );
+
 
 /**
  * Destruct data queue.
@@ -330,6 +364,120 @@ enum TN_RCode tn_queue_ireceive_polling(
       void **pp_data
       );
 
+/**
+ * Send a number of data elements to the queue, in order. It is equivalent to
+ * calling `tn_queue_send()` for each element, but much cheaper: all the
+ * elements are handled in just one critical section, tasks that wait for data
+ * get their elements and become runnable in a bulk, and connected event group
+ * (if any) is updated just once.
+ *
+ * If there's no room in the queue for all the elements, behavior depends on
+ * the `timeout` value: refer to `#TN_TickCnt`. The task might have to wait
+ * several times until all the elements are sent; `timeout` limits the total
+ * time of these waits.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param dque          pointer to data queue to send data to
+ * @param p_data_arr    array of values to send
+ * @param items_cnt     number of elements in `p_data_arr`, must be > 0
+ * @param p_sent_cnt    pointer to location to store number of elements
+ *                      actually sent (in case of timeout, it is less than
+ *                      `items_cnt`). Can be `#TN_NULL`.
+ * @param timeout       refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if all the elements were successfully sent;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_queue_send_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_sent_cnt,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_queue_send_multi()` with zero timeout, but for using in the
+ * ISR: elements are sent while there is a room in the queue. If not all the
+ * elements were sent, `#TN_RC_TIMEOUT` is returned.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_queue_isend_multi_polling(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_sent_cnt
+      );
+
+/**
+ * Receive up to `items_cnt` data elements from the queue, in order. It is
+ * equivalent to calling `tn_queue_receive()` repeatedly while there is some
+ * data in the queue, but much cheaper: all the elements are handled in just
+ * one critical section, tasks that wait for free space in the queue become
+ * runnable in a bulk, and connected event group (if any) is updated just
+ * once.
+ *
+ * Function doesn't wait for all `items_cnt` elements: it receives as many
+ * elements as available. If the queue is empty, behavior depends on the
+ * `timeout` value (refer to `#TN_TickCnt`): the task waits for the first
+ * element.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param dque             pointer to data queue to receive data from
+ * @param p_data_arr       array to store received values
+ * @param items_cnt        max number of elements to receive (capacity of
+ *                         `p_data_arr`), must be > 0
+ * @param p_received_cnt   pointer to location to store number of elements
+ *                         actually received. Can be `#TN_NULL`.
+ * @param timeout          refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if at least one element was successfully received;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_queue_receive_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_received_cnt,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_queue_receive_multi()` with zero timeout, but for using in
+ * the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_queue_ireceive_multi_polling(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int items_cnt,
+      int *p_received_cnt
+      );
+
 
 /**
  * Returns number of free items in the queue
@@ -394,6 +542,32 @@ enum TN_RCode tn_queue_eventgrp_connect(
       TN_UWord             pattern
       );
 
+#if TN_EVENTGRP_WIDE || defined(DOXYGEN_ACTIVE)
+/**
+ * The same as `tn_queue_eventgrp_connect()`, but the queue manages the single flag
+ * with the given number, which may be any flag of the wide event group (see
+ * \ref eventgrp_wide). Available if only `#TN_EVENTGRP_WIDE` option is
+ * non-zero.
+ *
+ * @param dque
+ *    queue to which event group should be connected
+ * @param eventgrp 
+ *    event groupt to connect
+ * @param bit_num
+ *    number of flag that should be managed by the queue automatically:
+ *    from 0 to `(words_cnt * #TN_INT_WIDTH - 1)`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_queue_eventgrp_connect_bit(
+      struct TN_DQueue    *dque,
+      struct TN_EventGrp  *eventgrp,
+      int                  bit_num
+      );
+#endif
+
 
 /**
  * Disconnect a connected event group from the queue.
@@ -45,6 +45,8 @@
 #include "_tn_eventgrp.h"
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_multi_wait.h"
+#include "_tn_trace.h"
 
 
 //-- header of current module
@@ -86,14 +88,22 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
 _TN_STATIC_INLINE enum TN_RCode _check_param_job_perform(
       const struct TN_EventGrp  *eventgrp,
       enum TN_EGrpWaitMode       wait_mode,
-      TN_UWord                   pattern
+      const TN_UWord            *pattern,
+      int                        words_cnt
       )
 {
-   enum TN_RCode rc = TN_RC_OK;
+   enum TN_RCode rc = TN_RC_WPARAM;
+   int i;
 
-   if (pattern == 0){
-      rc = TN_RC_WPARAM;
-   } else {
+   //-- at least one bit should be set in the pattern
+   for (i = 0; i < words_cnt; i++){
+      if (pattern[i] != 0){
+         rc = TN_RC_OK;
+         break;
+      }
+   }
+
+   if (rc == TN_RC_OK){
       wait_mode &= (TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AND);
       if (     wait_mode != TN_EVENTGRP_WMODE_OR
             && wait_mode != TN_EVENTGRP_WMODE_AND)
@@ -135,17 +145,153 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
    return rc;
 }
 
+#if TN_EVENTGRP_WIDE
+_TN_STATIC_INLINE enum TN_RCode _check_param_wide_create(
+      const struct TN_EventGrp  *eventgrp,
+      TN_UWord                  *pattern_buf,
+      int                        words_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (     eventgrp == TN_NULL
+         || _tn_eventgrp_is_valid(eventgrp)
+         || pattern_buf == TN_NULL
+         || words_cnt < 1
+      )
+   {
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_wide_generic(
+      const struct TN_EventGrp  *eventgrp,
+      const TN_UWord            *pattern
+      )
+{
+   enum TN_RCode rc = _check_param_generic(eventgrp);
+
+   if (rc == TN_RC_OK && pattern == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+#endif
+
 #else
 #  define _check_param_generic(eventgrp)                          (TN_RC_OK)
-#  define _check_param_job_perform(eventgrp, wait_mode, pattern)  (TN_RC_OK)
+#  define _check_param_job_perform(eventgrp, wait_mode, pattern, words_cnt) \
+                                                                  (TN_RC_OK)
 #  define _check_param_create(eventgrp, attr)                     (TN_RC_OK)
+#  define _check_param_wide_create(eventgrp, pattern_buf, words_cnt) \
+                                                                  (TN_RC_OK)
+#  define _check_param_wide_generic(eventgrp, pattern)            (TN_RC_OK)
 #endif
 // }}}
 
 
+/**
+ * Returns pointer to the current flags pattern of the event group: with
+ * `#TN_EVENTGRP_WIDE`, it may consist of several words.
+ */
+_TN_STATIC_INLINE TN_UWord *_pattern_get(struct TN_EventGrp *eventgrp)
+{
+#if TN_EVENTGRP_WIDE
+   return eventgrp->p_pattern;
+#else
+   return &(eventgrp->pattern);
+#endif
+}
+
+/**
+ * Returns pointer to the pattern the given task waits for.
+ */
+_TN_STATIC_INLINE const TN_UWord *_task_wait_pattern_get(struct TN_Task *task)
+{
+#if TN_EVENTGRP_WIDE
+   return task->subsys_wait.eventgrp.p_wait_pattern;
+#else
+   return &(task->subsys_wait.eventgrp.wait_pattern);
+#endif
+}
+
+/**
+ * Returns number of words in the pattern the given task waits for.
+ */
+_TN_STATIC_INLINE int _task_wait_words_cnt_get(struct TN_Task *task)
+{
+#if TN_EVENTGRP_WIDE
+   return task->subsys_wait.eventgrp.wait_words_cnt;
+#else
+   _TN_UNUSED(task);
+   return 1;
+#endif
+}
+
+#if TN_EVENTGRP_WAIT_INDEX
+/**
+ * Returns index of the least significant set bit in the given bitmask,
+ * counting from 0.
+ *
+ * @param bmp
+ *    Bitmask, must be non-zero.
+ */
+_TN_STATIC_INLINE int _bit_num_get(TN_UWord bmp)
+{
+   int ret;
+
+   _TN_BUG_ON(bmp == 0);
+
+#ifdef _TN_FFS
+   ret = _TN_FFS(bmp) - 1;
+#else
+   //-- there is no architecture-dependent way to find-first-set-bit available
+   //   (e.g. Cortex-M0/M0+), so, use generic (somewhat naive) algorithm.
+   ret = 0;
+
+   while (!(bmp & 1)){
+      bmp >>= 1;
+      ret++;
+   }
+#endif
+
+   //-- there is a list in `bit_wait_queue` for each bit of the word, so
+   //   `TN_INT_WIDTH` must match the width of `TN_UWord`, and `_TN_FFS()`
+   //   must take the whole word
+   _TN_BUG_ON(ret < 0 || ret >= TN_INT_WIDTH);
+
+   return ret;
+}
+#endif
+
+/**
+ * Copy first `words_cnt` words of the current flags pattern of the event
+ * group to the given array.
+ */
+static void _pattern_copy(
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord            *dst,
+      int                  words_cnt
+      )
+{
+   const TN_UWord *p_pattern = _pattern_get(eventgrp);
+   int i;
+
+   for (i = 0; i < words_cnt; i++){
+      dst[i] = p_pattern[i];
+   }
+}
+
 /**
  * Check if condition is satisfied: check events mask against given pattern.
  *
+ * The pattern consists of `words_cnt` words, and it is checked against the
+ * same number of first words of the event group's pattern: for usual
+ * event groups, it's always 1.
+ *
  * @param eventgrp
  *    Event group to check for condition
  * @param wait_mode
@@ -153,26 +299,42 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
  *    #TN_EGrpWaitMode`
  * @param wait_pattern
  *    Pattern to check against
+ * @param words_cnt
+ *    Number of words in `wait_pattern`
  */
 static TN_BOOL _cond_check(
       struct TN_EventGrp  *eventgrp,
       enum TN_EGrpWaitMode wait_mode,
-      TN_UWord             wait_pattern
+      const TN_UWord      *wait_pattern,
+      int                  words_cnt
       )
 {
    //-- interrupts should be disabled here
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
+   const TN_UWord *p_pattern = _pattern_get(eventgrp);
    TN_BOOL cond = TN_FALSE;
+   int i;
 
    switch (wait_mode & (TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AND)){
       case TN_EVENTGRP_WMODE_OR:
          //-- any bit set is enough for release condition
-         cond = ((eventgrp->pattern & wait_pattern) != 0);
+         for (i = 0; i < words_cnt; i++){
+            if ((p_pattern[i] & wait_pattern[i]) != 0){
+               cond = TN_TRUE;
+               break;
+            }
+         }
          break;
       case TN_EVENTGRP_WMODE_AND:
          //-- all bits should be set for release condition
-         cond = ((eventgrp->pattern & wait_pattern) == wait_pattern);
+         cond = TN_TRUE;
+         for (i = 0; i < words_cnt; i++){
+            if ((p_pattern[i] & wait_pattern[i]) != wait_pattern[i]){
+               cond = TN_FALSE;
+               break;
+            }
+         }
          break;
 #if TN_DEBUG
       default:
@@ -195,22 +357,27 @@ static TN_BOOL _cond_check(
  *    Wait mode, see `enum #TN_EGrpWaitMode`
  * @param pattern
  *    Pattern to clear if we need to.
+ * @param words_cnt
+ *    Number of words in `pattern`
  */
 static void _clear_pattern_if_needed(
       struct TN_EventGrp     *eventgrp,
       enum TN_EGrpWaitMode    wait_mode,
-      TN_UWord                pattern
+      const TN_UWord         *pattern,
+      int                     words_cnt
       )
 {
+   TN_UWord *p_pattern = _pattern_get(eventgrp);
+   int i;
 
 #if TN_OLD_EVENT_API
    //-- Old TNKernel behavior: there is a flag `TN_EVENTGRP_ATTR_CLR`
    //   belonging to the whole eventgrp object
    if (eventgrp->attr & TN_EVENTGRP_ATTR_CLR){
 #if _X96_HACKS
-      eventgrp->pattern &= ~pattern;
+      p_pattern[0] &= ~pattern[0];
 #else
-      eventgrp->pattern = 0;
+      p_pattern[0] = 0;
 #endif
    }
 #endif
@@ -219,55 +386,299 @@ static void _clear_pattern_if_needed(
    //   belonging to the particular wait call, so it is specified in
    //   `wait_mode`. See `tnum TN_EGrpWaitMode`.
    if (wait_mode & TN_EVENTGRP_WMODE_AUTOCLR){
-      eventgrp->pattern &= ~pattern;
+      for (i = 0; i < words_cnt; i++){
+         p_pattern[i] &= ~pattern[i];
+      }
+   }
+}
+
+/**
+ * Wake up the task whose waiting condition is satisfied: remember actual
+ * pattern that caused task to wake up, and clear flag(s) if needed.
+ */
+static void _task_wait_complete(
+      struct TN_EventGrp  *eventgrp,
+      struct TN_Task      *task
+      )
+{
+#if TN_EVENTGRP_WIDE
+   if (task->subsys_wait.eventgrp.p_actual_pattern != TN_NULL){
+      _pattern_copy(
+            eventgrp,
+            task->subsys_wait.eventgrp.p_actual_pattern,
+            task->subsys_wait.eventgrp.wait_words_cnt
+            );
+   }
+#else
+   task->subsys_wait.eventgrp.actual_pattern = eventgrp->pattern;
+#endif
+
+   _tn_task_wait_complete(task, TN_RC_OK);
+
+   //-- Atomically clear flag(s) if we need to.
+   _clear_pattern_if_needed(
+         eventgrp,
+         task->subsys_wait.eventgrp.wait_mode,
+         _task_wait_pattern_get(task),
+         _task_wait_words_cnt_get(task)
+         );
+}
+
+
+/**
+ * Returns the list in which the task that starts (or keeps on) waiting for
+ * the event group with given condition should be kept. Without
+ * `#TN_EVENTGRP_WAIT_INDEX`, it is always the `wait_queue` of the event group.
+ *
+ * With `#TN_EVENTGRP_WAIT_INDEX`, the task waiting for any of several flags
+ * goes to the `wait_queue`, and the task waiting for all the flags (or for
+ * a single flag) goes to the list of the lowest flag which isn't set yet:
+ * the task can't be woken up until this flag is set. For wide event groups,
+ * lists are shared by flags with the same bit number in different words.
+ *
+ * The condition should not be satisfied at the moment.
+ *
+ * @param eventgrp
+ *    Event group object
+ * @param wait_mode
+ *    Wait mode, see `enum #TN_EGrpWaitMode`
+ * @param wait_pattern
+ *    Pattern the task waits for
+ * @param words_cnt
+ *    Number of words in `wait_pattern`
+ */
+static struct TN_ListItem *_wait_queue_select(
+      struct TN_EventGrp     *eventgrp,
+      enum TN_EGrpWaitMode    wait_mode,
+      const TN_UWord         *wait_pattern,
+      int                     words_cnt
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   struct TN_ListItem *ret = &(eventgrp->wait_queue);
+
+#if TN_EVENTGRP_WAIT_INDEX
+   const TN_UWord *p_pattern = _pattern_get(eventgrp);
+   TN_UWord folded = (0);
+   TN_BOOL several = TN_FALSE;
+   int i;
+
+   for (i = 0; i < words_cnt; i++){
+      TN_UWord word = wait_pattern[i];
+      if (word != 0){
+         if (folded != 0 || (word & (word - 1)) != 0){
+            several = TN_TRUE;
+         }
+         folded |= word;
+      }
+   }
+
+   if ((wait_mode & TN_EVENTGRP_WMODE_OR) && several){
+      //-- waiting for any of several flags: use common list
+      eventgrp->any_wait_mask |= folded;
+   } else {
+      //-- waiting for all flags (or just for a single one): use the list
+      //   of the lowest flag that isn't set yet
+      TN_UWord not_set = (0);
+      int bit_num;
+
+      for (i = 0; not_set == 0 && i < words_cnt; i++){
+         not_set = wait_pattern[i] & ~p_pattern[i];
+      }
+
+      _TN_BUG_ON(not_set == 0);
+
+      bit_num = _bit_num_get(not_set);
+      eventgrp->bit_wait_mask |= ((TN_UWord)1 << bit_num);
+      ret = &(eventgrp->bit_wait_queue[ bit_num ]);
    }
+#else
+   _TN_UNUSED(wait_mode);
+   _TN_UNUSED(wait_pattern);
+   _TN_UNUSED(words_cnt);
+#endif
+
+   return ret;
 }
 
+#if TN_OLD_EVENT_API
+/**
+ * Check whether there are tasks waiting for the event group (not counting
+ * multi-wait items).
+ */
+static TN_BOOL _waiting_tasks_exist(struct TN_EventGrp *eventgrp)
+{
+   TN_BOOL ret = !_tn_list_is_empty(&(eventgrp->wait_queue));
+
+#if TN_EVENTGRP_WAIT_INDEX
+   int i;
+
+   for (i = 0; !ret && i < TN_INT_WIDTH; i++){
+      ret = !_tn_list_is_empty(&(eventgrp->bit_wait_queue[ i ]));
+   }
+#endif
+
+   return ret;
+}
+#endif
 
 /**
- * Walk through all tasks waiting for some event, wake up tasks whose waiting
+ * Walk through tasks in the given list, wake up tasks whose waiting
  * condition is already satisfied.
  *
+ * With `#TN_EVENTGRP_WAIT_INDEX`, the tasks which stay waiting are moved to
+ * the list of another flag if needed (see `_wait_queue_select()`), and the
+ * pattern of flags they wait for (folded into a single word) is returned.
+ * Otherwise, 0 is returned.
+ *
  * @param eventgrp
  *    Event group to handle.
+ * @param wait_queue
+ *    List of tasks to walk through.
  */
-static void _scan_event_waitqueue(struct TN_EventGrp *eventgrp)
+static TN_UWord _scan_wait_list(
+      struct TN_EventGrp  *eventgrp,
+      struct TN_ListItem  *wait_queue
+      )
 {
    //-- interrupts should be disabled here
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
    struct TN_Task *task;
    struct TN_Task *tmp_task;
+   TN_UWord waiting_pattern = (0);
 
-   //-- Walk through all tasks waiting for some event, checking
+   //-- Walk through all tasks in the list, checking
    //   if each particular condition is satisfied
    _tn_list_for_each_entry_safe(
-         task, struct TN_Task, tmp_task, &(eventgrp->wait_queue), task_queue
+         task, struct TN_Task, tmp_task, wait_queue, task_queue
          )
    {
 
       if ( _cond_check(
                eventgrp,
                task->subsys_wait.eventgrp.wait_mode,
-               task->subsys_wait.eventgrp.wait_pattern
+               _task_wait_pattern_get(task),
+               _task_wait_words_cnt_get(task)
                )
          )
       {
          //-- Condition is satisfied, so, wake the task up.
-         //   We should also remember actual pattern that caused
-         //   task to wake up.
+         _task_wait_complete(eventgrp, task);
+      }
+#if TN_EVENTGRP_WAIT_INDEX
+      else {
+         //-- The task stays waiting: it might need to be moved to the list
+         //   of another flag which isn't set yet. Note that if the new list
+         //   is the same, we should leave the task in place, otherwise
+         //   we'd walk through it again.
+         const TN_UWord *wait_pattern = _task_wait_pattern_get(task);
+         int words_cnt = _task_wait_words_cnt_get(task);
+         int i;
+
+         struct TN_ListItem *new_queue = _wait_queue_select(
+               eventgrp,
+               task->subsys_wait.eventgrp.wait_mode,
+               wait_pattern,
+               words_cnt
+               );
+
+         if (new_queue != wait_queue){
+            _tn_list_remove_entry(&(task->task_queue));
+            _tn_list_add_tail(new_queue, &(task->task_queue));
+         }
+
+         for (i = 0; i < words_cnt; i++){
+            waiting_pattern |= wait_pattern[i];
+         }
+      }
+#endif
+   }
 
-         task->subsys_wait.eventgrp.actual_pattern = eventgrp->pattern;
-         _tn_task_wait_complete(task, TN_RC_OK);
+   return waiting_pattern;
+}
+
+/**
+ * Wake up tasks whose waiting condition is satisfied after some flags
+ * were set.
+ *
+ * Without `#TN_EVENTGRP_WAIT_INDEX`, all the waiting tasks are checked.
+ * With it, only the tasks from the lists of the flags that have just become
+ * set, and the tasks waiting for any of several flags, if some of their flags
+ * have become set.
+ *
+ * @param eventgrp
+ *    Event group to handle.
+ * @param set_pattern
+ *    Flags that have just become set. For wide event groups, all the words
+ *    are folded into a single one.
+ */
+static void _scan_event_waitqueue(
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord             set_pattern
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+#if TN_EVENTGRP_WAIT_INDEX
+   TN_UWord bits = set_pattern & eventgrp->bit_wait_mask;
+
+   //-- Walk through lists of the flags that have just become set
+   while (bits != 0){
+      int bit_num = _bit_num_get(bits);
+      TN_UWord bit = ((TN_UWord)1 << bit_num);
+      struct TN_ListItem *wait_queue = &(eventgrp->bit_wait_queue[ bit_num ]);
+
+      bits &= ~bit;
+
+      _scan_wait_list(eventgrp, wait_queue);
+
+      if (_tn_list_is_empty(wait_queue)){
+         eventgrp->bit_wait_mask &= ~bit;
+      }
+   }
+
+   //-- Walk through tasks waiting for any of several flags, if only some
+   //   of these flags have become set. While walking, the mask of flags
+   //   is recalculated, so extra bits of tasks which don't wait anymore
+   //   are dropped.
+   if (set_pattern & eventgrp->any_wait_mask){
+      eventgrp->any_wait_mask = _scan_wait_list(
+            eventgrp, &(eventgrp->wait_queue)
+            );
+   }
+#else
+   _TN_UNUSED(set_pattern);
+   _scan_wait_list(eventgrp, &(eventgrp->wait_queue));
+#endif
+
+#if TN_MULTI_WAIT
+   struct TN_MultiWaitItem *item;
+   struct TN_MultiWaitItem *tmp_item;
+
+   //-- Do the same for multi-waiting tasks. When the task is woken up,
+   //   all its items are removed from the lists, but since each object
+   //   may appear in the task's items at most once, only the current item
+   //   is removed from this list, so `tmp_item` stays valid.
+   _tn_list_for_each_entry_safe(
+         item, struct TN_MultiWaitItem, tmp_item,
+         &(eventgrp->multi_wait_list), wait_queue
+         )
+   {
+      if (_cond_check(eventgrp, item->wait_mode, &item->wait_pattern, 1)){
+         item->actual_pattern = _pattern_get(eventgrp)[0];
+         _tn_multi_wait_item_complete(item, TN_RC_OK);
 
          //-- Atomically clear flag(s) if we need to.
          _clear_pattern_if_needed(
-               eventgrp,
-               task->subsys_wait.eventgrp.wait_mode,
-               task->subsys_wait.eventgrp.wait_pattern
+               eventgrp, item->wait_mode, &item->wait_pattern, 1
                );
       }
    }
+#endif
 }
 
 
@@ -279,11 +690,15 @@ static void _scan_event_waitqueue(struct TN_EventGrp *eventgrp)
  *
  * If condition is met, `#TN_RC_OK` is returned, and the caller will not sleep.
  *
- * For params documentation, refer to the `tn_eventgrp_wait()`.
+ * Patterns consist of `words_cnt` words: 1 for `tn_eventgrp_wait()` and
+ * friends, or the number of words of the wide event group for
+ * `tn_eventgrp_wide_wait()` and friends. For other params documentation,
+ * refer to the `tn_eventgrp_wait()`.
  */
 static enum TN_RCode _eventgrp_wait(
       struct TN_EventGrp  *eventgrp,
-      TN_UWord             wait_pattern,
+      const TN_UWord      *wait_pattern,
+      int                  words_cnt,
       enum TN_EGrpWaitMode wait_mode,
       TN_UWord            *p_flags_pattern
       )
@@ -292,7 +707,7 @@ static enum TN_RCode _eventgrp_wait(
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
    enum TN_RCode rc = _check_param_job_perform(
-         eventgrp, wait_mode, wait_pattern
+         eventgrp, wait_mode, wait_pattern, words_cnt
          );
 
    if (rc != TN_RC_OK){
@@ -305,7 +720,7 @@ static enum TN_RCode _eventgrp_wait(
       if (
             (eventgrp->attr & TN_EVENTGRP_ATTR_SINGLE) 
             &&
-            !_tn_list_is_empty(&(eventgrp->wait_queue))
+            _waiting_tasks_exist(eventgrp)
          )
       {
          rc = TN_RC_ILLEGAL_USE;
@@ -314,20 +729,22 @@ static enum TN_RCode _eventgrp_wait(
 
       //-- Check release condition
 
-      if (_cond_check(eventgrp, wait_mode, wait_pattern)){
+      if (_cond_check(eventgrp, wait_mode, wait_pattern, words_cnt)){
          //-- condition is met, so, return `#TN_RC_OK`, and we don't need to
          //   wait.
 
          if (p_flags_pattern != TN_NULL){
-            *p_flags_pattern = eventgrp->pattern;
+            _pattern_copy(eventgrp, p_flags_pattern, words_cnt);
 
 #if _X96_HACKS
-            *p_flags_pattern = eventgrp->pattern & wait_pattern;
+            *p_flags_pattern &= *wait_pattern;
 #endif
          }
 
          //-- Atomically clear flag(s) if we need to.
-         _clear_pattern_if_needed(eventgrp, wait_mode, wait_pattern);
+         _clear_pattern_if_needed(
+               eventgrp, wait_mode, wait_pattern, words_cnt
+               );
          rc = TN_RC_OK;
       } else {
          //-- The condition isn't met, so, return appropriate code,
@@ -336,59 +753,252 @@ static enum TN_RCode _eventgrp_wait(
       }
 
    }
+
+   _tn_trace_put(TN_TRACE_EV_EVENTGRP_WAIT, rc, (TN_UWord)eventgrp);
+
    return rc;
 }
 
 /**
  * Actual worker function that is eventually called when user calls
- * `tn_eventgrp_modify()` or `tn_eventgrp_imodify()`.
+ * `tn_eventgrp_wait()` or `tn_eventgrp_wide_wait()`: checks the condition
+ * and puts current task to wait if needed.
+ *
+ * For params documentation, refer to `_eventgrp_wait()`.
+ */
+static enum TN_RCode _eventgrp_wait_task(
+      struct TN_EventGrp  *eventgrp,
+      const TN_UWord      *wait_pattern,
+      int                  words_cnt,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern,
+      TN_TickCnt           timeout
+      )
+{
+   TN_BOOL waited_for_event = TN_FALSE;
+   enum TN_RCode rc;
+   TN_INTSAVE_DATA;
+
+   TN_INT_DIS_SAVE();
+
+   //-- call worker function that actually performs needed check
+   //   and return result
+   rc = _eventgrp_wait(
+         eventgrp, wait_pattern, words_cnt, wait_mode, p_flags_pattern
+         );
+
+   if (rc == TN_RC_TIMEOUT && timeout != 0){
+      //-- condition isn't met, and user wants to wait in this case.
+      //   So, remember waiting parameters (mode, pattern), and put
+      //   current task to wait.
+      struct TN_EGrpTaskWait *wait = &_tn_curr_run_task->subsys_wait.eventgrp;
+
+      wait->wait_mode = wait_mode;
+#if TN_EVENTGRP_WIDE
+      //-- The pattern and the array for the actual pattern belong to the
+      //   caller, which doesn't return until the waiting is finished, so
+      //   they are used right away.
+      wait->p_wait_pattern    = wait_pattern;
+      wait->wait_words_cnt    = words_cnt;
+      wait->p_actual_pattern  = p_flags_pattern;
+#else
+      wait->wait_pattern      = *wait_pattern;
+#endif
+
+      _tn_task_curr_to_wait_action(
+            _wait_queue_select(eventgrp, wait_mode, wait_pattern, words_cnt),
+            TN_WAIT_REASON_EVENT,
+            timeout
+            );
+      waited_for_event = TN_TRUE;
+   }
+
+   _TN_BUG_ON(!_tn_need_context_switch() && waited_for_event);
+
+   TN_INT_RESTORE();
+   _tn_context_switch_pend_if_needed();
+
+   if (waited_for_event){
+      //-- task was waiting for event, and now it has just woke up.
+      //-- get wait result
+      rc = _tn_curr_run_task->task_wait_rc;
+
+#if !TN_EVENTGRP_WIDE
+      //-- if wait result is TN_RC_OK, and p_flags_pattern is provided,
+      //   copy actual_pattern there
+      if (rc == TN_RC_OK && p_flags_pattern != TN_NULL ){
+         *p_flags_pattern = 
+            _tn_curr_run_task->subsys_wait.eventgrp.actual_pattern;
+      }
+#endif
+
+#if _X96_HACKS
+      if (rc == TN_RC_OK && p_flags_pattern != TN_NULL ){
+         *p_flags_pattern &= *wait_pattern;
+      }
+#endif
+   }
+
+   return rc;
+}
+
+/**
+ * Actual worker function that is eventually called when user calls
+ * `tn_eventgrp_modify()`, `tn_eventgrp_imodify()` or their wide
+ * counterparts.
  *
  * Modify current events pattern: set, clear or toggle flags. 
  *
  * If flags are cleared, there aren't any side effects: flags are just got
- * cleared. If, however, flags are set or toggled, then all the tasks waiting
+ * cleared. If, however, some flags become set, then the tasks waiting
  * for some particular event are checked whether the condition is met now. It
  * is done by `_scan_event_waitqueue()`.
  *
- * For params documentation, refer to `tn_eventgrp_modify()`.
+ * `pattern` consists of `words_cnt` words, and it is applied to the words
+ * of the event group's pattern starting from `first_word`. For other params
+ * documentation, refer to `tn_eventgrp_modify()`.
  */
 static enum TN_RCode _eventgrp_modify(
       struct TN_EventGrp  *eventgrp,
       enum TN_EGrpOp       operation,
-      TN_UWord             pattern
+      const TN_UWord      *pattern,
+      int                  first_word,
+      int                  words_cnt
       )
 {
    //-- interrupts should be disabled here
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
-   switch (operation){
-      case TN_EVENTGRP_OP_CLEAR:
-         //-- clear flags: there aren't any side effects: just clear flags.
-         eventgrp->pattern &= ~pattern;
-         break;
+   TN_UWord *p_pattern = _pattern_get(eventgrp) + first_word;
+   TN_UWord set_pattern = (0);
+   int i;
 
-      case TN_EVENTGRP_OP_SET:
-         //-- set flags: do that if only given flags aren't already set.
-         //   (otherwise, there's no need to spend time walking through
-         //   all the waiting tasks)
-         if ((eventgrp->pattern & pattern) != pattern){
-            //-- flags aren't already set: so, set flags and check all tasks.
+   _tn_trace_put(TN_TRACE_EV_EVENTGRP_MODIFY, operation, (TN_UWord)eventgrp);
 
-            eventgrp->pattern |= pattern;
-            _scan_event_waitqueue(eventgrp);
-         }
-         break;
+   for (i = 0; i < words_cnt; i++){
+      TN_UWord old_word = p_pattern[i];
 
-      case TN_EVENTGRP_OP_TOGGLE:
-         //-- toggle flags: after flags are toggled, check all waiting tasks.
-         eventgrp->pattern ^= pattern;
-         _scan_event_waitqueue(eventgrp);
-         break;
+      switch (operation){
+         case TN_EVENTGRP_OP_CLEAR:
+            //-- clear flags: there aren't any side effects: just clear flags.
+            p_pattern[i] &= ~pattern[i];
+            break;
+
+         case TN_EVENTGRP_OP_SET:
+            p_pattern[i] |= pattern[i];
+            break;
+
+         case TN_EVENTGRP_OP_TOGGLE:
+            p_pattern[i] ^= pattern[i];
+            break;
+      }
+
+      //-- remember which flags have just become set (for wide event groups,
+      //   folded into a single word)
+      set_pattern |= (p_pattern[i] & ~old_word);
+   }
+
+   //-- If some flags have become set, check waiting tasks. (otherwise,
+   //   nobody can be woken up, so there's no need to spend time walking
+   //   through the waiting tasks)
+   if (set_pattern != 0){
+      _scan_event_waitqueue(eventgrp, set_pattern);
    }
 
    return TN_RC_OK;
 }
 
+#if _TN_FAST_PATH_ENABLED
+/**
+ * Fast path of `tn_eventgrp_modify()` and `tn_eventgrp_imodify()` (see
+ * `#TN_FAST_PATH`): clearing flags never wakes anybody up, and neither does
+ * setting or toggling them if nobody waits for the event group; in these
+ * cases, the first word of the pattern is modified without disabling
+ * interrupts.
+ *
+ * Waiters are checked between the exclusive load and store of the pattern
+ * word: if anything has happened in between (say, some task has started
+ * waiting), the store fails, and we just try again.
+ *
+ * @return `TN_TRUE` if the pattern is modified, `TN_FALSE` if
+ * `_eventgrp_modify()` should be called instead.
+ */
+static TN_BOOL _eventgrp_modify_fast(
+      struct TN_EventGrp  *eventgrp,
+      enum TN_EGrpOp       operation,
+      TN_UWord             pattern
+      )
+{
+   volatile TN_UWord *p_pattern = _pattern_get(eventgrp);
+   TN_BOOL done;
+
+   for (;;){
+      TN_UWord old_word = _TN_EXCL_LOAD(p_pattern);
+      TN_UWord new_word = old_word;
+      TN_BOOL waiters_may_exist = (0
+            || !_tn_list_is_empty(&(eventgrp->wait_queue))
+#if TN_EVENTGRP_WAIT_INDEX
+            || eventgrp->bit_wait_mask != 0
+#endif
+            || !_tn_multi_wait_list_is_empty(&(eventgrp->multi_wait_list))
+            );
+
+      done = !_tn_trace_is_started();
+
+      switch (operation){
+         case TN_EVENTGRP_OP_CLEAR:
+            new_word &= ~pattern;
+            break;
+
+         case TN_EVENTGRP_OP_SET:
+            new_word |= pattern;
+            done = done && !waiters_may_exist;
+            break;
+
+         case TN_EVENTGRP_OP_TOGGLE:
+            new_word ^= pattern;
+            done = done && !waiters_may_exist;
+            break;
+
+         default:
+            done = TN_FALSE;
+            break;
+      }
+
+      if (!done){
+         _TN_EXCL_CLEAR();
+         break;
+      } else if (_TN_EXCL_STORE(p_pattern, new_word) == 0){
+         break;
+      }
+   }
+
+   return done;
+}
+#else
+#  define _eventgrp_modify_fast(eventgrp, operation, pattern)  (TN_FALSE)
+#endif
+
+
+/**
+ * Initialize lists of the event group which is being created.
+ */
+static void _eventgrp_lists_reset(struct TN_EventGrp *eventgrp)
+{
+   _tn_list_reset(&(eventgrp->wait_queue));
+   _tn_multi_wait_list_reset(&(eventgrp->multi_wait_list));
+
+#if TN_EVENTGRP_WAIT_INDEX
+   {
+      int i;
+      for (i = 0; i < TN_INT_WIDTH; i++){
+         _tn_list_reset(&(eventgrp->bit_wait_queue[ i ]));
+      }
+      eventgrp->bit_wait_mask = (0);
+      eventgrp->any_wait_mask = (0);
+   }
+#endif
+}
 
 
 
@@ -413,9 +1023,13 @@ enum TN_RCode tn_eventgrp_create_wattr(
       //-- just return rc as it is
    } else {
 
-      _tn_list_reset(&(eventgrp->wait_queue));
+      _eventgrp_lists_reset(eventgrp);
 
       eventgrp->pattern    = initial_pattern;
+#if TN_EVENTGRP_WIDE
+      eventgrp->p_pattern  = &(eventgrp->pattern);
+      eventgrp->words_cnt  = 1;
+#endif
       eventgrp->id_event   = TN_ID_EVENTGRP;
 #if TN_OLD_EVENT_API
       eventgrp->attr       = attr;
@@ -445,6 +1059,16 @@ enum TN_RCode tn_eventgrp_delete(struct TN_EventGrp *eventgrp)
       // remove all waiting tasks from wait list (if any), returning the
       // TN_RC_DELETED code.
       _tn_wait_queue_notify_deleted(&(eventgrp->wait_queue));
+      _tn_multi_wait_notify_deleted(&(eventgrp->multi_wait_list));
+
+#if TN_EVENTGRP_WAIT_INDEX
+      {
+         int i;
+         for (i = 0; i < TN_INT_WIDTH; i++){
+            _tn_wait_queue_notify_deleted(&(eventgrp->bit_wait_queue[ i ]));
+         }
+      }
+#endif
 
       eventgrp->id_event = TN_ID_NONE; //-- event does not exist now
 
@@ -470,7 +1094,6 @@ enum TN_RCode tn_eventgrp_wait(
       TN_TickCnt           timeout
       )
 {
-   TN_BOOL waited_for_event = TN_FALSE;
    enum TN_RCode rc = _check_param_generic(eventgrp);
 
    if (rc != TN_RC_OK){
@@ -478,54 +1101,11 @@ enum TN_RCode tn_eventgrp_wait(
    } else if (!tn_is_task_context()){
       rc = TN_RC_WCONTEXT;
    } else {
-      TN_INTSAVE_DATA;
-
-      TN_INT_DIS_SAVE();
-
-      //-- call worker function that actually performs needed check
-      //   and return result
-      rc = _eventgrp_wait(eventgrp, wait_pattern, wait_mode, p_flags_pattern);
-
-      if (rc == TN_RC_TIMEOUT && timeout != 0){
-         //-- condition isn't met, and user wants to wait in this case.
-         //   So, remember waiting parameters (mode, pattern), and put
-         //   current task to wait.
-
-         _tn_curr_run_task->subsys_wait.eventgrp.wait_mode = wait_mode;
-         _tn_curr_run_task->subsys_wait.eventgrp.wait_pattern = wait_pattern;
-         _tn_task_curr_to_wait_action(
-               &(eventgrp->wait_queue),
-               TN_WAIT_REASON_EVENT,
-               timeout
-               );
-         waited_for_event = TN_TRUE;
-      }
-
-      _TN_BUG_ON(!_tn_need_context_switch() && waited_for_event);
-
-      TN_INT_RESTORE();
-      _tn_context_switch_pend_if_needed();
-
-      if (waited_for_event){
-         //-- task was waiting for event, and now it has just woke up.
-         //-- get wait result
-         rc = _tn_curr_run_task->task_wait_rc;
-
-         //-- if wait result is TN_RC_OK, and p_flags_pattern is provided,
-         //   copy actual_pattern there
-         if (rc == TN_RC_OK && p_flags_pattern != TN_NULL ){
-            *p_flags_pattern = 
-               _tn_curr_run_task->subsys_wait.eventgrp.actual_pattern;
-
-#if _X96_HACKS
-            *p_flags_pattern = 
-               _tn_curr_run_task->subsys_wait.eventgrp.actual_pattern
-               & wait_pattern
-               ;
-#endif
-         }
-      }
-
+      //-- call worker function that checks the condition and puts current
+      //   task to wait if needed
+      rc = _eventgrp_wait_task(
+            eventgrp, &wait_pattern, 1, wait_mode, p_flags_pattern, timeout
+            );
    }
    return rc;
 }
@@ -554,7 +1134,9 @@ enum TN_RCode tn_eventgrp_wait_polling(
 
       //-- call worker function that actually performs needed check
       //   and return result
-      rc = _eventgrp_wait(eventgrp, wait_pattern, wait_mode, p_flags_pattern);
+      rc = _eventgrp_wait(
+            eventgrp, &wait_pattern, 1, wait_mode, p_flags_pattern
+            );
 
       TN_INT_RESTORE();
    }
@@ -585,7 +1167,9 @@ enum TN_RCode tn_eventgrp_iwait_polling(
 
       //-- call worker function that actually performs needed check
       //   and return result
-      rc = _eventgrp_wait(eventgrp, wait_pattern, wait_mode, p_flags_pattern);
+      rc = _eventgrp_wait(
+            eventgrp, &wait_pattern, 1, wait_mode, p_flags_pattern
+            );
 
       TN_INT_IRESTORE();
       _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
@@ -610,13 +1194,15 @@ enum TN_RCode tn_eventgrp_modify(
       //-- just return rc as it is
    } else if (!tn_is_task_context()){
       rc = TN_RC_WCONTEXT;
+   } else if (_eventgrp_modify_fast(eventgrp, operation, pattern)){
+      //-- done without disabling interrupts, rc is TN_RC_OK
    } else {
       TN_INTSAVE_DATA;
 
       TN_INT_DIS_SAVE();
 
       //-- call worker function that actually modifies the events pattern
-      rc = _eventgrp_modify(eventgrp, operation, pattern);
+      rc = _eventgrp_modify(eventgrp, operation, &pattern, 0, 1);
 
       TN_INT_RESTORE();
       _tn_context_switch_pend_if_needed();
@@ -641,13 +1227,211 @@ enum TN_RCode tn_eventgrp_imodify(
       //-- just return rc as it is
    } else if (!tn_is_isr_context()){
       rc = TN_RC_WCONTEXT;
+   } else if (_eventgrp_modify_fast(eventgrp, operation, pattern)){
+      //-- done without disabling interrupts, rc is TN_RC_OK
    } else {
       TN_INTSAVE_DATA_INT;
 
       TN_INT_IDIS_SAVE();
 
       //-- call worker function that actually modifies the events pattern
-      rc = _eventgrp_modify(eventgrp, operation, pattern);
+      rc = _eventgrp_modify(eventgrp, operation, &pattern, 0, 1);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+   return rc;
+}
+
+
+#if TN_EVENTGRP_WIDE
+
+/*
+ * See comments in the header file (tn_eventgrp.h)
+ */
+enum TN_RCode tn_eventgrp_wide_create(
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord            *pattern_buf,
+      int                  words_cnt,
+      const TN_UWord      *initial_pattern
+      )
+{
+   enum TN_RCode rc = _check_param_wide_create(
+         eventgrp, pattern_buf, words_cnt
+         );
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      int i;
+
+      _eventgrp_lists_reset(eventgrp);
+
+      for (i = 0; i < words_cnt; i++){
+         pattern_buf[i] = (initial_pattern != TN_NULL) ? initial_pattern[i] : 0;
+      }
+
+      eventgrp->pattern    = (0);
+      eventgrp->p_pattern  = pattern_buf;
+      eventgrp->words_cnt  = words_cnt;
+      eventgrp->id_event   = TN_ID_EVENTGRP;
+#if TN_OLD_EVENT_API
+      eventgrp->attr       = TN_EVENTGRP_ATTR_MULTI;
+#endif
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_eventgrp.h)
+ */
+enum TN_RCode tn_eventgrp_wide_wait(
+      struct TN_EventGrp  *eventgrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern,
+      TN_TickCnt           timeout
+      )
+{
+   enum TN_RCode rc = _check_param_wide_generic(eventgrp, wait_pattern);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      rc = _eventgrp_wait_task(
+            eventgrp, wait_pattern, eventgrp->words_cnt,
+            wait_mode, p_flags_pattern, timeout
+            );
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_eventgrp.h)
+ */
+enum TN_RCode tn_eventgrp_wide_wait_polling(
+      struct TN_EventGrp  *eventgrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      )
+{
+   enum TN_RCode rc = _check_param_wide_generic(eventgrp, wait_pattern);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _eventgrp_wait(
+            eventgrp, wait_pattern, eventgrp->words_cnt,
+            wait_mode, p_flags_pattern
+            );
+
+      TN_INT_RESTORE();
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_eventgrp.h)
+ */
+enum TN_RCode tn_eventgrp_wide_iwait_polling(
+      struct TN_EventGrp  *eventgrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      )
+{
+   enum TN_RCode rc = _check_param_wide_generic(eventgrp, wait_pattern);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      rc = _eventgrp_wait(
+            eventgrp, wait_pattern, eventgrp->words_cnt,
+            wait_mode, p_flags_pattern
+            );
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_eventgrp.h)
+ */
+enum TN_RCode tn_eventgrp_wide_modify(
+      struct TN_EventGrp  *eventgrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      )
+{
+   enum TN_RCode rc = _check_param_wide_generic(eventgrp, pattern);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _eventgrp_modify(
+            eventgrp, operation, pattern, 0, eventgrp->words_cnt
+            );
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_eventgrp.h)
+ */
+enum TN_RCode tn_eventgrp_wide_imodify(
+      struct TN_EventGrp  *eventgrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      )
+{
+   enum TN_RCode rc = _check_param_wide_generic(eventgrp, pattern);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      rc = _eventgrp_modify(
+            eventgrp, operation, pattern, 0, eventgrp->words_cnt
+            );
 
       TN_INT_IRESTORE();
       _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
@@ -655,6 +1439,8 @@ enum TN_RCode tn_eventgrp_imodify(
    return rc;
 }
 
+#endif // TN_EVENTGRP_WIDE
+
 
 
 
@@ -683,12 +1469,45 @@ enum TN_RCode _tn_eventgrp_link_set(
    } else {
       eventgrp_link->eventgrp = eventgrp;
       eventgrp_link->pattern  = pattern;
+#if TN_EVENTGRP_WIDE
+      eventgrp_link->word_idx = 0;
+#endif
    }
 
    return rc;
 }
 
 
+#if TN_EVENTGRP_WIDE
+/**
+ * See comments in the file _tn_eventgrp.h
+ */
+enum TN_RCode _tn_eventgrp_link_set_bit(
+      struct TN_EGrpLink  *eventgrp_link,
+      struct TN_EventGrp  *eventgrp,
+      int                  bit_num
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   enum TN_RCode rc = _check_param_generic(eventgrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (bit_num < 0 || bit_num >= eventgrp->words_cnt * TN_INT_WIDTH){
+      rc = TN_RC_WPARAM;
+   } else {
+      eventgrp_link->eventgrp = eventgrp;
+      eventgrp_link->pattern  = ((TN_UWord)1 << (bit_num % TN_INT_WIDTH));
+      eventgrp_link->word_idx = bit_num / TN_INT_WIDTH;
+   }
+
+   return rc;
+}
+#endif
+
+
 /**
  * See comments in the file _tn_eventgrp.h
  */
@@ -700,6 +1519,9 @@ enum TN_RCode _tn_eventgrp_link_reset(
 
    eventgrp_link->eventgrp = TN_NULL;
    eventgrp_link->pattern  = (0);
+#if TN_EVENTGRP_WIDE
+   eventgrp_link->word_idx = 0;
+#endif
 
    return rc;
 }
@@ -722,7 +1544,13 @@ enum TN_RCode _tn_eventgrp_link_manage(
       _eventgrp_modify(
             eventgrp_link->eventgrp,
             (set ? TN_EVENTGRP_OP_SET : TN_EVENTGRP_OP_CLEAR),
-            eventgrp_link->pattern
+            &eventgrp_link->pattern,
+#if TN_EVENTGRP_WIDE
+            eventgrp_link->word_idx,
+#else
+            0,
+#endif
+            1
             );
    }
 
@@ -730,3 +1558,21 @@ enum TN_RCode _tn_eventgrp_link_manage(
 }
 
 
+#if TN_MULTI_WAIT
+
+/**
+ * See comments in the file _tn_eventgrp.h
+ */
+enum TN_RCode _tn_eventgrp_try_wait(
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord             wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      )
+{
+   return _eventgrp_wait(eventgrp, &wait_pattern, 1, wait_mode, p_flags_pattern);
+}
+
+#endif
+
+
@@ -88,12 +88,39 @@
  * non-empty, the flag is set. If the queue becomes empty, the flag is cleared.
  * 
  * For the information on system services related to queue, refer to the \ref 
- * tn_dqueue.h "queue reference".
+ * tn_dqueue.h "queue reference". \ref tn_mqueue.h "Message queues" can be
+ * connected to the event group in the same way.
  *
  * There is an example project available that demonstrates event group
  * connection technique: `examples/queue_eventgrp_conn`. Be sure to examine the
  * readme there.
  *
+ * \section eventgrp_wide Wide event groups
+ *
+ * If `#TN_INT_WIDTH` flags aren't enough, and `#TN_EVENTGRP_WIDE` option is
+ * non-zero, an event group can be created by `tn_eventgrp_wide_create()` with
+ * the pattern of several words, provided by the application. Such event
+ * group is used with `tn_eventgrp_wide_wait()`, `tn_eventgrp_wide_modify()`
+ * and friends, which take arrays of words instead of single words, and have
+ * exactly the same semantics: AND/OR conditions and
+ * `#TN_EVENTGRP_WMODE_AUTOCLR` are applied to the whole pattern at once, in
+ * a single critical section. Flag number `n` is bit `(n % #TN_INT_WIDTH)` of
+ * word `(n / #TN_INT_WIDTH)`.
+ *
+ * Usual services (`tn_eventgrp_wait()`, `tn_eventgrp_modify()` and friends)
+ * can be used with wide event groups as well: they handle the first word
+ * only.
+ *
+ * Queues can be connected to any flag of the wide event group with
+ * `tn_queue_eventgrp_connect_bit()` and
+ * `tn_mqueue_eventgrp_connect_bit()`.
+ *
+ * Note that if several tasks wait for the same flag, all of them are woken up
+ * when the flag is set, but only one of them gets the message; the others
+ * find the queue empty. If this matters, consider the \ref tn_multi_wait.h
+ * "multi-object wait" instead: the queue hands the message over to exactly
+ * one waiting task directly.
+ *
  */
 
 #ifndef _TN_EVENTGRP_H
@@ -229,6 +256,44 @@ struct TN_EventGrp {
    enum TN_EGrpAttr     attr;
 #endif
 
+#if TN_MULTI_WAIT || defined(DOXYGEN_ACTIVE)
+   ///
+   /// list of multi-wait items waiting for some event (see
+   /// \ref tn_multi_wait.h), available if only `#TN_MULTI_WAIT` option is
+   /// non-zero.
+   struct TN_ListItem   multi_wait_list;
+#endif
+
+#if TN_EVENTGRP_WAIT_INDEX || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Lists of waiting tasks indexed by bit number: each task is kept in the
+   /// list of the bit which isn't set yet and without which the task can't
+   /// be woken up. There is a list for each bit of `#TN_UWord`, whose width
+   /// is `#TN_INT_WIDTH`. Tasks waiting for any of several flags are kept in
+   /// `wait_queue`. Available if only `#TN_EVENTGRP_WAIT_INDEX` option is
+   /// non-zero.
+   struct TN_ListItem   bit_wait_queue[ TN_INT_WIDTH ];
+   ///
+   /// Bits whose lists in `bit_wait_queue` might be non-empty
+   TN_UWord             bit_wait_mask;
+   ///
+   /// Flags that tasks in `wait_queue` might wait for: it may contain extra
+   /// bits (of tasks that have already stopped waiting), but never misses
+   /// any.
+   TN_UWord             any_wait_mask;
+#endif
+
+#if TN_EVENTGRP_WIDE || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Current flags pattern: points to `pattern` for usual event group, or
+   /// to the array given to `tn_eventgrp_wide_create()`. Available if only
+   /// `#TN_EVENTGRP_WIDE` option is non-zero.
+   TN_UWord            *p_pattern;
+   ///
+   /// Number of words in the pattern: 1 for usual event group.
+   int                  words_cnt;
+#endif
+
 };
 
 /**
@@ -245,6 +310,21 @@ struct TN_EGrpTaskWait {
    ///
    /// pattern that caused task to finish waiting
    TN_UWord actual_pattern;
+
+#if TN_EVENTGRP_WIDE || defined(DOXYGEN_ACTIVE)
+   ///
+   /// event wait pattern: points to `wait_pattern` or to the array given to
+   /// `tn_eventgrp_wide_wait()`
+   const TN_UWord *p_wait_pattern;
+   ///
+   /// number of words in the wait pattern
+   int wait_words_cnt;
+   ///
+   /// where to store pattern that caused task to finish waiting: points to
+   /// `actual_pattern` or to the array given to `tn_eventgrp_wide_wait()`
+   /// (may be `TN_NULL`)
+   TN_UWord *p_actual_pattern;
+#endif
 };
 
 /**
@@ -258,6 +338,13 @@ struct TN_EGrpLink {
    ///
    /// event pattern to manage
    TN_UWord pattern;
+
+#if TN_EVENTGRP_WIDE || defined(DOXYGEN_ACTIVE)
+   ///
+   /// index of the word in the pattern of the event group which `pattern`
+   /// applies to
+   int word_idx;
+#endif
 };
 
 
@@ -269,6 +356,13 @@ struct TN_EGrpLink {
  *    DEFINITIONS
  ******************************************************************************/
 
+/**
+ * Number of words needed for the pattern of the wide event group with given
+ * number of flags, see `tn_eventgrp_wide_create()`.
+ */
+#define  TN_EVENTGRP_WORDS(flags_cnt)                                   \
+   (((flags_cnt) + TN_INT_WIDTH - 1) / TN_INT_WIDTH)
+
 
 
 /*******************************************************************************
@@ -459,6 +553,140 @@ enum TN_RCode tn_eventgrp_imodify(
       );
 
 
+#if TN_EVENTGRP_WIDE || defined(DOXYGEN_ACTIVE)
+
+/**
+ * Construct wide event group, whose pattern consists of `words_cnt` words,
+ * see \ref eventgrp_wide. Available if only `#TN_EVENTGRP_WIDE` option is
+ * non-zero.
+ *
+ * `id_event` field should not contain `#TN_ID_EVENTGRP`, otherwise,
+ * `#TN_RC_WPARAM` is returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param eventgrp
+ *    Pointer to already allocated struct TN_EventGrp
+ * @param pattern_buf
+ *    Array of `words_cnt` words for the pattern, it should exist as long as
+ *    the event group exists. Use `#TN_EVENTGRP_WORDS()` macro to get the
+ *    number of words for the needed number of flags.
+ * @param words_cnt
+ *    Number of words in the pattern, should be at least 1.
+ * @param initial_pattern
+ *    Array of `words_cnt` words with initial events pattern, or `TN_NULL`
+ *    if all the flags should be initially cleared.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if event group was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_eventgrp_wide_create(
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord            *pattern_buf,
+      int                  words_cnt,
+      const TN_UWord      *initial_pattern
+      );
+
+/**
+ * The same as `tn_eventgrp_wait()`, but for wide event group: both
+ * `wait_pattern` and `p_flags_pattern` are arrays of as many words as
+ * there are in the pattern of the event group. It can be used with usual
+ * event groups as well, then arrays are of 1 word. Available if only
+ * `#TN_EVENTGRP_WIDE` option is non-zero.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param eventgrp
+ *    Pointer to event group to wait events from
+ * @param wait_pattern
+ *    Events bit pattern for which task should wait; at least one bit should
+ *    be set.
+ * @param wait_mode
+ *    See `tn_eventgrp_wait()`
+ * @param p_flags_pattern
+ *    Array in which actual event pattern that caused task to stop waiting
+ *    will be stored. May be `TN_NULL`.
+ * @param timeout
+ *    refer to `#TN_TickCnt`
+ *
+ * @return
+ *    See `tn_eventgrp_wait()`
+ */
+enum TN_RCode tn_eventgrp_wide_wait(
+      struct TN_EventGrp  *eventgrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern,
+      TN_TickCnt           timeout
+      );
+
+/**
+ * The same as `tn_eventgrp_wide_wait()` with zero timeout.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_eventgrp_wide_wait_polling(
+      struct TN_EventGrp  *eventgrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      );
+
+/**
+ * The same as `tn_eventgrp_wide_wait()` with zero timeout, but for using in
+ * the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_eventgrp_wide_iwait_polling(
+      struct TN_EventGrp  *eventgrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      );
+
+/**
+ * The same as `tn_eventgrp_modify()`, but for wide event group: `pattern`
+ * is an array of as many words as there are in the pattern of the event
+ * group. Available if only `#TN_EVENTGRP_WIDE` option is non-zero.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_eventgrp_wide_modify(
+      struct TN_EventGrp  *eventgrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      );
+
+/**
+ * The same as `tn_eventgrp_wide_modify()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_eventgrp_wide_imodify(
+      struct TN_EventGrp  *eventgrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      );
+
+#endif
+
+
 #ifdef __cplusplus
 }  /* extern "C" */
 #endif
@@ -0,0 +1,388 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+//-- common tnkernel headers
+#include "tn_common.h"
+#include "tn_sys.h"
+#include "tn_exch_link.h"
+
+//-- internal tnkernel headers
+#include "_tn_sys.h"
+#include "_tn_exch.h"
+#include "_tn_exch_link.h"
+#include "_tn_list.h"
+
+
+//-- header of current module
+#include "tn_exch.h"
+
+//-- for memcpy()
+#include <string.h>
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_Exch *exch
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (exch == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_exch_is_valid(exch)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_Exch  *exch,
+      void                  *data,
+      unsigned int           size
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (exch == TN_NULL || data == TN_NULL || size == 0){
+      rc = TN_RC_WPARAM;
+   } else if (_tn_exch_is_valid(exch)){
+      rc = TN_RC_WPARAM;
+   } else if (TN_MAKE_ALIG_SIZE((TN_UIntPtr)data) != (TN_UIntPtr)data){
+      //-- `data` isn't aligned properly
+      rc = TN_RC_WPARAM;
+   } else if (TN_MAKE_ALIG_SIZE(size) != size){
+      //-- `size` isn't aligned properly
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_data(
+      const void *data
+      )
+{
+   return (data == TN_NULL) ? TN_RC_WPARAM : TN_RC_OK;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_link(
+      const struct TN_ExchLink *exch_link
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (exch_link == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_exch_link_is_valid(exch_link)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(exch)                  (TN_RC_OK)
+#  define _check_param_create(exch, data, size)       (TN_RC_OK)
+#  define _check_param_data(data)                     (TN_RC_OK)
+#  define _check_param_link(exch_link)                (TN_RC_OK)
+#endif
+// }}}
+
+/**
+ * Notify all the links connected to the exchange object. Should be called
+ * with interrupts disabled.
+ *
+ * Each link is notified even if some of the previous ones have failed, so
+ * that, say, the full queue doesn't prevent event group from being
+ * notified.
+ *
+ * @return
+ *    `#TN_RC_OK` if all the links were notified successfully, or the code
+ *    returned by the first failed link.
+ */
+static enum TN_RCode _notify_all(
+      struct TN_Exch   *exch
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   enum TN_RCode link_rc;
+   struct TN_ExchLink *exch_link;
+   
+   _tn_list_for_each_entry(
+         exch_link, struct TN_ExchLink, &(exch->links_list), links_list_item
+         )
+   {
+      link_rc = _tn_exch_link_notify(exch_link);
+      if (link_rc != TN_RC_OK && rc == TN_RC_OK){
+         rc = link_rc;
+      }
+   }
+
+   return rc;
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_create(
+      struct TN_Exch   *exch,
+      void             *data,
+      unsigned int      size
+      )
+{
+   enum TN_RCode rc = _check_param_create(exch, data, size);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      exch->data     = data;
+      exch->size     = size;
+      exch->seq_cnt  = 0;
+
+      //-- reset links_list
+      _tn_list_reset(&(exch->links_list));
+
+      //-- set id
+      exch->id_exch = TN_ID_EXCHANGE;
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_delete(struct TN_Exch *exch)
+{
+   TN_UWord sr_saved;
+   struct TN_ExchLink *exch_link;
+   enum TN_RCode rc = _check_param_generic(exch);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      sr_saved = tn_arch_sr_save_int_dis();
+
+      //-- disconnect all the links
+      while (!_tn_list_is_empty(&(exch->links_list))){
+         exch_link = _tn_list_first_entry_remove(
+               &(exch->links_list), struct TN_ExchLink, links_list_item
+               );
+         _tn_list_reset(&(exch_link->links_list_item));
+         exch_link->exch = TN_NULL;
+      }
+
+      exch->id_exch = TN_ID_NONE;   //-- Exchange object does not exist now
+
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_read(
+      struct TN_Exch   *exch,
+      void             *data_tgt
+      )
+{
+   TN_UWord seq_cnt;
+   enum TN_RCode rc = _check_param_generic(exch);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_data(data_tgt)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      for (;;){
+         seq_cnt = exch->seq_cnt;
+
+         //-- make sure the counter is read before the data
+         _TN_MEMORY_BARRIER();
+
+         //-- if the counter is odd, the data is being written right now.
+         //   Note that it can't happen if we're called from task or
+         //   kernel-aware ISR, since the data is written with interrupts
+         //   disabled; but it could happen on a multi-core system.
+         if ((seq_cnt & 1) == 0){
+            memcpy(data_tgt, exch->data, exch->size);
+
+            //-- make sure the data is read before the counter is checked
+            //   again
+            _TN_MEMORY_BARRIER();
+
+            if (exch->seq_cnt == seq_cnt){
+               //-- the data wasn't modified while we were copying it
+               break;
+            }
+         }
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_write(
+      struct TN_Exch   *exch,
+      const void       *data
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_generic(exch);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_data(data)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      sr_saved = tn_arch_sr_save_int_dis();
+
+      //-- counter becomes odd: the data is being written
+      exch->seq_cnt++;
+      _TN_MEMORY_BARRIER();
+
+      memcpy(exch->data, data, exch->size);
+
+      //-- counter becomes even again: the data is consistent
+      _TN_MEMORY_BARRIER();
+      exch->seq_cnt++;
+
+      rc = _notify_all(exch);
+
+      tn_arch_sr_restore(sr_saved);
+
+      //-- links might have woken up some high-priority task
+      //   (context switch is pended by the services called by links,
+      //   and it actually happens when interrupts are enabled)
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_link_add(
+      struct TN_Exch      *exch,
+      struct TN_ExchLink  *exch_link
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_generic(exch);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_link(exch_link)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      sr_saved = tn_arch_sr_save_int_dis();
+
+      if (exch_link->exch != TN_NULL){
+         //-- the link is already connected to some exchange object
+         rc = TN_RC_ILLEGAL_USE;
+      } else {
+         _tn_list_add_tail(&(exch->links_list), &(exch_link->links_list_item));
+         exch_link->exch = exch;
+      }
+
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_link_remove(
+      struct TN_Exch      *exch,
+      struct TN_ExchLink  *exch_link
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_generic(exch);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_link(exch_link)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      sr_saved = tn_arch_sr_save_int_dis();
+
+      if (exch_link->exch != exch){
+         //-- the link isn't connected to the given exchange object
+         rc = TN_RC_ILLEGAL_USE;
+      } else {
+         _tn_list_remove_entry(&(exch_link->links_list_item));
+         _tn_list_reset(&(exch_link->links_list_item));
+         exch_link->exch = TN_NULL;
+      }
+
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+
+
@@ -0,0 +1,385 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Exchange object: a piece of shared data (say, the latest measurement or
+ * the current configuration) which is written by one or more writers and
+ * read by any number of readers, plus a set of links which are notified
+ * each time the data is written.
+ *
+ * Instead of mutex-protected data plus the event group, readers of the
+ * exchange object don't take any lock at all: the data is protected by the
+ * sequence counter (the "seqlock" technique). Writer increments the counter
+ * before and after the data is copied, so the counter is odd while the data
+ * is being modified. Reader remembers the counter, copies the data to its
+ * own buffer, and checks the counter again: if it has changed, the copy
+ * might be inconsistent, and reader just retries. Since the write is
+ * performed with interrupts disabled, reader retries if only it was
+ * preempted by the writer, so the cost of reading doesn't depend on the
+ * number of readers at all.
+ *
+ * When the data is written, all the links connected to the exchange object
+ * are notified, so that interested tasks don't have to poll the data.
+ * Available links:
+ *
+ * - \ref tn_exch_link_queue.h "Queue link": a copy of the data is allocated
+ *   from the fixed memory pool and sent to the data queue;
+ * - \ref tn_exch_link_eventgrp.h "Event group link": the given flags are set
+ *   in the event group;
+ * - \ref tn_exch_link_callback.h "Callback link": arbitrary user function is
+ *   called.
+ *
+ * Links are notified in the same critical section in which the data is
+ * written, so, all the readers which are woken up by the link get the
+ * fresh data. Related services:
+ *
+ * - `tn_exch_link_add()`
+ * - `tn_exch_link_remove()`
+ */
+
+
+#ifndef _TN_EXCH_H
+#define _TN_EXCH_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+#include "tn_sys.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+struct TN_ExchLink;
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+struct TN_Exch;
+
+/**
+ * Prototype for the function which is called by the
+ * \ref tn_exch_link_callback.h "callback link" when the exchange data is
+ * written.
+ *
+ * The function is called with interrupts disabled, so, it should be as
+ * short as possible. It is called from the same context in which the
+ * exchange data is written (task or ISR), so, only the services which can
+ * be called from that context and don't sleep are allowed.
+ *
+ * @param exch
+ *    Exchange object whose data was written
+ * @param data
+ *    Pointer to the exchange data
+ * @param size
+ *    Size of the exchange data, in bytes
+ * @param p_user_data
+ *    User data given to `tn_exch_link_callback_create()`
+ */
+typedef void (TN_ExchCallbackFunc)(
+      struct TN_Exch   *exch,
+      void             *data,
+      unsigned int      size,
+      void             *p_user_data
+      );
+
+
+/**
+ * Exchange
+ */
+struct TN_Exch {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_exch;
+   ///
+   /// List of all connected links (`struct TN_ExchLinkQueue`, etc)
+   struct TN_ListItem links_list;
+   ///
+   /// Pointer to actual exchange data
+   void *data;
+   ///
+   /// Size of the exchange data in bytes, should be a multiple of
+   /// `sizeof(#TN_UWord)`
+   unsigned int size;
+   ///
+   /// Sequence counter: it is odd while the data is being written, and it
+   /// is changed by each write. Used by readers to detect that the data
+   /// was modified while it was being copied.
+   volatile TN_UWord seq_cnt;
+};
+
+
+
+/*******************************************************************************
+ *    GLOBAL VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Convenience macro for the definition of buffer for data. See
+ * `tn_exch_create()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_exch_create()` function as the `data` argument)
+ * @param item_type
+ *    Type of exchange data, like `struct MyExchangeData`.
+ */
+#define TN_EXCH_DATA_BUF_DEF(name, item_type)                     \
+   TN_UWord name[                                                 \
+      (TN_MAKE_ALIG_SIZE(sizeof(item_type)) / sizeof(TN_UWord))   \
+   ]
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the exchange object. `id_exch` field should not contain
+ * `#TN_ID_EXCHANGE`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * Note that `data` and `size` should be a multiple of `sizeof(#TN_UWord)`.
+ *
+ * For the definition of buffer, convenience macro `TN_EXCH_DATA_BUF_DEF()`
+ * was invented.
+ *
+ * Typical definition looks as follows:
+ *
+ * \code{.c}
+ *     //-- type of data that exchange object stores
+ *     struct MyExchangeData {
+ *        // ... arbitrary fields ...
+ *     };
+ *     
+ *     //-- define buffer for exchange data
+ *     TN_EXCH_DATA_BUF_DEF(my_exch_buf, struct MyExchangeData);
+ *
+ *     //-- define exchange structure
+ *     struct TN_Exch my_exch;
+ * \endcode
+ *
+ * And then, construct your `my_exch` as follows:
+ *
+ * \code{.c}
+ *     enum TN_RCode rc;
+ *     rc = tn_exch_create( &my_exch,
+ *                          my_exch_buf,
+ *                          TN_MAKE_ALIG_SIZE(sizeof(struct MyExchangeData))
+ *                        );
+ *     if (rc != TN_RC_OK){
+ *        //-- handle error
+ *     }
+ * \endcode
+ *
+ * Initial contents of the buffer become the initial exchange data.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch
+ *    Pointer to already allocated `struct TN_Exch`
+ * @param data
+ *    Pointer to already allocated exchange data buffer, it must be aligned
+ *    to `sizeof(#TN_UWord)`
+ * @param size
+ *    Size of the exchange data buffer in bytes, must be a multiple of
+ *    `sizeof(#TN_UWord)`
+ *
+ * @return 
+ *    * `#TN_RC_OK` if exchange object was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM` (in particular, if given `data` and/or
+ *      `size` aren't aligned properly).
+ */
+enum TN_RCode tn_exch_create(
+      struct TN_Exch   *exch,
+      void             *data,
+      unsigned int      size
+      );
+
+/**
+ * Destruct the exchange object. All connected links are disconnected
+ * (but not deleted).
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch     exchange object to destruct
+ *
+ * @return 
+ *    * `#TN_RC_OK` if object was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_delete(struct TN_Exch *exch);
+
+/**
+ * Copy the exchange data to the location pointed to by `data_tgt` (`size`
+ * bytes are written there).
+ *
+ * No lock is taken and interrupts are not disabled: if the data is written
+ * while it is being copied, the copying is just repeated. So, the function
+ * never waits for other readers.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch       exchange object to read data from
+ * @param data_tgt   pointer to the location to copy data to
+ *
+ * @return 
+ *    * `#TN_RC_OK` if data was successfully read;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_read(
+      struct TN_Exch   *exch,
+      void             *data_tgt
+      );
+
+/**
+ * Write new exchange data (`size` bytes are copied from `data`), and notify
+ * all the connected links.
+ *
+ * The data is copied and links are notified with interrupts disabled. Links
+ * never wait: if, say, the queue connected by the
+ * \ref tn_exch_link_queue.h "queue link" is full, the rest of the links
+ * are notified anyway, and the error code is returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch       exchange object to write data to
+ * @param data       pointer to new data
+ *
+ * @return 
+ *    * `#TN_RC_OK` if data was successfully written and all links were
+ *      successfully notified;
+ *    * If data was written, but some link failed to notify, the return code
+ *      of the first failed link is returned (say, `#TN_RC_TIMEOUT` if
+ *      the queue or the memory pool is full);
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_write(
+      struct TN_Exch   *exch,
+      const void       *data
+      );
+
+/**
+ * Connect the link to the exchange object: after that, the link is
+ * notified each time the data is written. The link should be constructed
+ * already (by, say, `tn_exch_link_queue_create()`), and it should not be
+ * connected to another exchange object.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch       exchange object to connect link to
+ * @param exch_link  link to connect: for example, use
+ *                   `tn_exch_link_queue_base_get()` to get it from the
+ *                   queue link.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully connected;
+ *    * `#TN_RC_ILLEGAL_USE` if link is already connected to some exchange;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_link_add(
+      struct TN_Exch      *exch,
+      struct TN_ExchLink  *exch_link
+      );
+
+/**
+ * Disconnect the link from the exchange object.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch       exchange object to disconnect link from
+ * @param exch_link  link to disconnect
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully disconnected;
+ *    * `#TN_RC_ILLEGAL_USE` if link isn't connected to the given exchange;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_link_remove(
+      struct TN_Exch      *exch,
+      struct TN_ExchLink  *exch_link
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_EXCH_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
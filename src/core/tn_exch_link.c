@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright  2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright  2013, 2014 Anders Montonen.
- *    TNeo:                      copyright  2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -34,6 +34,7 @@
  *
  ******************************************************************************/
 
+
 /*******************************************************************************
  *    INCLUDED FILES
  ******************************************************************************/
@@ -52,11 +53,6 @@
 
 
 
-/*******************************************************************************
- *    PUBLIC DATA
- ******************************************************************************/
-
-
 /*******************************************************************************
  *    PRIVATE FUNCTION PROTOTYPES
  ******************************************************************************/
@@ -74,18 +70,9 @@ static enum TN_RCode _dtor(struct TN_ExchLink *exch_link);
  * Virtual methods table of "abstract class" `#TN_ExchLink`.
  */
 static const struct TN_ExchLink_VTable _vtable = {
-   .notify     = _notify_error,
-   .dtor       = _dtor,
+   _notify_error,    //-- notify
+   _dtor,            //-- dtor
 };
-//static TN_BOOL _vtable_initialized = TN_FALSE;
-
-
-
-
-/*******************************************************************************
- *    DEFINITIONS
- ******************************************************************************/
-
 
 
 
@@ -96,8 +83,8 @@ static const struct TN_ExchLink_VTable _vtable = {
 
 //-- Additional param checking {{{
 #if TN_CHECK_PARAM
-static inline enum TN_RCode _check_param_generic(
-      struct TN_ExchLink *exch_link
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_ExchLink *exch_link
       )
 {
    enum TN_RCode rc = TN_RC_OK;
@@ -111,8 +98,8 @@ static inline enum TN_RCode _check_param_generic(
    return rc;
 }
 
-static inline enum TN_RCode _check_param_create(
-      struct TN_ExchLink  *exch_link
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_ExchLink  *exch_link
       )
 {
    enum TN_RCode rc = TN_RC_OK;
@@ -136,30 +123,16 @@ static enum TN_RCode _notify_error(struct TN_ExchLink *exch_link)
 {
    //-- should never be here
    _TN_FATAL_ERROR("called notify() of base TN_ExchLink");
+   _TN_UNUSED(exch_link);
    return TN_RC_INTERNAL;
 }
 
 static enum TN_RCode _dtor(struct TN_ExchLink *exch_link)
 {
-   exch_link->id_exch_link = 0;  //-- exchange link does not exist now
+   exch_link->id_exch_link = TN_ID_NONE;  //-- exchange link does not exist now
    return TN_RC_OK;
 }
 
-#if 0
-static void _vtable_init()
-{
-   if (!_vtable_initialized){
-      _vtable.notify    = _notify_error;
-      _vtable.dtor      = _dtor;
-
-      _vtable_initialized = TN_TRUE;
-   }
-}
-#endif
-
-
-
-
 
 
 
@@ -167,18 +140,17 @@ static void _vtable_init()
  *    PROTECTED FUNCTIONS
  ******************************************************************************/
 
-/**
- * See comments in the _tn_exch_link.h file
+/*
+ * See comments in the internal header file (_tn_exch_link.h)
  */
 const struct TN_ExchLink_VTable *_tn_exch_link_vtable(void)
 {
-   //_vtable_init();
    return &_vtable;
 }
 
 
-/**
- * See comments in the _tn_exch_link.h file
+/*
+ * See comments in the internal header file (_tn_exch_link.h)
  */
 enum TN_RCode _tn_exch_link_create(
       struct TN_ExchLink     *exch_link
@@ -189,8 +161,8 @@ enum TN_RCode _tn_exch_link_create(
    if (rc != TN_RC_OK){
       //-- just return rc as it is
    } else {
-      //_vtable_init();
       exch_link->vtable = &_vtable;
+      exch_link->exch   = TN_NULL;
 
       _tn_list_reset(&(exch_link->links_list_item));
 
@@ -201,43 +173,47 @@ enum TN_RCode _tn_exch_link_create(
 }
 
 
-/**
- * See comments in the _tn_exch_link.h file
+/*
+ * See comments in the internal header file (_tn_exch_link.h)
  */
 enum TN_RCode _tn_exch_link_notify(
       struct TN_ExchLink     *exch_link
       )
 {
-   enum TN_RCode rc = _check_param_generic(exch_link);
-
-   if (rc != TN_RC_OK){
-      //-- just return rc as it is
-   } else {
-      rc = exch_link->vtable->notify(exch_link);
-   }
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
-   return rc;
+   return exch_link->vtable->notify(exch_link);
 }
 
 
-
-/**
- * See comments in the _tn_exch_link.h file
+/*
+ * See comments in the internal header file (_tn_exch_link.h)
  */
 enum TN_RCode _tn_exch_link_delete(
       struct TN_ExchLink     *exch_link
       )
 {
+   TN_UWord sr_saved;
    enum TN_RCode rc = _check_param_generic(exch_link);
 
    if (rc != TN_RC_OK){
       //-- just return rc as it is
    } else {
+      sr_saved = tn_arch_sr_save_int_dis();
+
+      //-- if link is connected to some exchange object, disconnect it
+      if (exch_link->exch != TN_NULL){
+         _tn_list_remove_entry(&(exch_link->links_list_item));
+         exch_link->exch = TN_NULL;
+      }
+
       rc = exch_link->vtable->dtor(exch_link);
+
+      tn_arch_sr_restore(sr_saved);
    }
 
    return rc;
 }
 
 
-
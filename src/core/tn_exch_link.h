@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright © 2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright © 2013, 2014 Anders Montonen.
- *    TNeo:                      copyright © 2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -37,11 +37,14 @@
 /**
  * \file
  *
- * Exchange link (in terms of OOP, it's an "abstract class" of any exchange
- * link).
- *
- * For internal kernel usage only.
+ * Exchange link (in terms of OOP, it's an "abstract class" of any
+ * \ref tn_exch.h "exchange" link).
  *
+ * Application never creates the base link directly: instead, it creates
+ * one of the particular links (\ref tn_exch_link_queue.h "queue link",
+ * \ref tn_exch_link_eventgrp.h "event group link" or
+ * \ref tn_exch_link_callback.h "callback link"), and gives the pointer to
+ * its base link to `tn_exch_link_add()`.
  */
 
 
@@ -57,6 +60,13 @@
 
 
 
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+struct TN_Exch;
+
+
 
 #ifdef __cplusplus
 extern "C"  {     /*}*/
@@ -70,18 +80,19 @@ struct TN_ExchLink;
 
 
 /**
- * Virtual method prototype: notify.
+ * Virtual method prototype: notify. Called with interrupts disabled, from
+ * the context in which the exchange data is written.
  *
  * For internal kernel usage only.
  */
-typedef enum TN_RCode (TN_ExchLink_Notify)(struct TN_ExchLink *exch);
+typedef enum TN_RCode (TN_ExchLink_Notify)(struct TN_ExchLink *exch_link);
 
 /**
  * Virtual method prototype: destructor.
  *
  * For internal kernel usage only.
  */
-typedef enum TN_RCode (TN_ExchLink_Dtor)  (struct TN_ExchLink *exch);
+typedef enum TN_RCode (TN_ExchLink_Dtor)  (struct TN_ExchLink *exch_link);
 
 /**
  * Virtual methods table for each type of \ref tn_exch.h "exchange" link. 
@@ -99,6 +110,11 @@ struct TN_ExchLink_VTable {
  * For internal kernel usage only.
  */
 struct TN_ExchLink {
+   ///
+   /// Id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId              id_exch_link;
    ///
    /// A list item to be included in the exchange links list
    struct TN_ListItem links_list_item;
@@ -109,9 +125,6 @@ struct TN_ExchLink {
    ///
    /// Pointer to the virtual methods table
    const struct TN_ExchLink_VTable *vtable;
-   ///
-   /// Id for object validity verification
-   enum TN_ObjId              id_exch_link;
 };
 
 
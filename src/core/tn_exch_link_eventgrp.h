@@ -0,0 +1,176 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Exchange link: event group (in terms of OOP, it's a "class, inherited
+ * from `#TN_ExchLink`").
+ *
+ * When the \ref tn_exch.h "exchange" data is written, the link sets the
+ * given flags in the \ref tn_eventgrp.h "event group". Flags are never
+ * cleared by the link: the task which waits for them typically clears them
+ * automatically (by `#TN_EVENTGRP_WMODE_AUTOCLR`) and then reads the data
+ * by `tn_exch_read()`.
+ */
+
+
+#ifndef _TN_EXCH_LINK_EVENTGRP_H
+#define _TN_EXCH_LINK_EVENTGRP_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_exch_link.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+struct TN_EventGrp;
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Exchange link which sets flags in the event group.
+ */
+struct TN_ExchLinkEventGrp {
+   ///
+   /// Exchange link: in terms of OOP, it's a superclass (or base class)
+   struct TN_ExchLink super;
+   ///
+   /// A pointer to event group to set flags in.
+   struct TN_EventGrp *eventgrp;
+   ///
+   /// Flags pattern to set in the event group.
+   TN_UWord pattern;
+};
+
+
+
+/*******************************************************************************
+ *    GLOBAL VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the event group link. After that, get the base link by
+ * `tn_exch_link_eventgrp_base_get()` and connect it to the exchange object
+ * by `tn_exch_link_add()`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch_link_eventgrp
+ *    Pointer to already allocated `struct TN_ExchLinkEventGrp`
+ * @param eventgrp
+ *    Event group to set flags in
+ * @param pattern
+ *    Flags pattern to set, must be non-zero
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_exch_link_eventgrp_create(
+      struct TN_ExchLinkEventGrp   *exch_link_eventgrp,
+      struct TN_EventGrp           *eventgrp,
+      TN_UWord                      pattern
+      );
+
+/**
+ * Destruct the event group link. If it is connected to some exchange
+ * object, it is disconnected first.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch_link_eventgrp  link to destruct
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully deleted;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_link_eventgrp_delete(
+      struct TN_ExchLinkEventGrp   *exch_link_eventgrp
+      );
+
+/**
+ * Returns pointer to the base link, to be given to `tn_exch_link_add()` or
+ * `tn_exch_link_remove()`.
+ */
+_TN_STATIC_INLINE struct TN_ExchLink *tn_exch_link_eventgrp_base_get(
+      struct TN_ExchLinkEventGrp   *exch_link_eventgrp
+      )
+{
+   return &exch_link_eventgrp->super;
+}
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_EXCH_LINK_EVENTGRP_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
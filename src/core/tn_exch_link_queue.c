@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright  2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright  2013, 2014 Anders Montonen.
- *    TNeo:                      copyright  2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -34,6 +34,7 @@
  *
  ******************************************************************************/
 
+
 /*******************************************************************************
  *    INCLUDED FILES
  ******************************************************************************/
@@ -43,6 +44,8 @@
 #include "tn_sys.h"
 
 #include "tn_exch.h"
+#include "tn_dqueue.h"
+#include "tn_fmem.h"
 
 //-- internal tnkernel headers
 #include "_tn_exch_link.h"
@@ -53,12 +56,10 @@
 //-- header of current module
 #include "tn_exch_link_queue.h"
 
+//-- for memcpy()
+#include <string.h>
 
 
-/*******************************************************************************
- *    PUBLIC DATA
- ******************************************************************************/
-
 
 /*******************************************************************************
  *    PRIVATE FUNCTION PROTOTYPES
@@ -77,8 +78,8 @@ static enum TN_RCode _dtor(struct TN_ExchLink *exch_link);
  * Virtual methods table
  */
 static const struct TN_ExchLink_VTable _vtable = {
-   .notify     = _notify,
-   .dtor       = _dtor,
+   _notify,          //-- notify
+   _dtor,            //-- dtor
 };
 
 
@@ -89,7 +90,7 @@ static const struct TN_ExchLink_VTable _vtable = {
  ******************************************************************************/
 
 #define _tn_get_exch_link_queue_by_exch_link(exch_link)                       \
-   (exch_link ? container_of(exch_link, struct TN_ExchLinkQueue, super) : 0)
+   container_of(exch_link, struct TN_ExchLinkQueue, super)
 
 
 
@@ -101,7 +102,7 @@ static const struct TN_ExchLink_VTable _vtable = {
 
 //-- Additional param checking {{{
 #if TN_CHECK_PARAM
-static inline enum TN_RCode _check_param_create(
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
       struct TN_ExchLinkQueue   *exch_link_queue,
       struct TN_DQueue          *queue,
       struct TN_FMem            *fmem
@@ -109,11 +110,11 @@ static inline enum TN_RCode _check_param_create(
 {
    enum TN_RCode rc = TN_RC_OK;
 
-   if (exch_link_queue == TN_NULL){
+   if (exch_link_queue == TN_NULL || queue == TN_NULL){
       rc = TN_RC_WPARAM;
    } else if (!_tn_dqueue_is_valid(queue)){
       rc = TN_RC_WPARAM;
-   } else if (!_tn_fmem_is_valid(fmem)){
+   } else if (fmem != TN_NULL && !_tn_fmem_is_valid(fmem)){
       rc = TN_RC_WPARAM;
    }
 
@@ -121,7 +122,7 @@ static inline enum TN_RCode _check_param_create(
 }
 
 #else
-#  define _check_param_create(exch_link)        (TN_RC_OK)
+#  define _check_param_create(exch_link_queue, queue, fmem)  (TN_RC_OK)
 #endif
 // }}}
 
@@ -133,36 +134,48 @@ static enum TN_RCode _notify(struct TN_ExchLink *exch_link)
    struct TN_ExchLinkQueue *exch_link_queue = 
       _tn_get_exch_link_queue_by_exch_link(exch_link);
 
+   struct TN_Exch *exch = exch_link->exch;
+   TN_BOOL task_context = tn_is_task_context();
    void *p_msg = TN_NULL;
 
-   rc = tn_is_task_context()
-      ? tn_fmem_get(exch_link_queue->fmem, &p_msg, TN_WAIT_INFINITE)
-      : tn_fmem_iget_polling(exch_link_queue->fmem, &p_msg);
-
-   if (rc != TN_RC_OK){
-      //-- there was some error: just return rc as it is
+   if (exch_link_queue->fmem == TN_NULL){
+      //-- no memory pool: the data should fit in a pointer, and it is sent
+      //   through the queue by value
+      if (exch->size > sizeof(p_msg)){
+         rc = TN_RC_WPARAM;
+      } else {
+         memcpy(&p_msg, exch->data, exch->size);
+         rc = task_context
+            ? tn_queue_send_polling(exch_link_queue->queue, p_msg)
+            : tn_queue_isend_polling(exch_link_queue->queue, p_msg);
+      }
    } else {
-      //-- memory was received from fixed-memory pool, copy data there
-      _tn_memcpy_uword(
-            p_msg,
-            exch_link->exch->data,
-            _TN_SIZE_BYTES_TO_UWORDS(exch_link->exch->size)
-            );
-
-      //-- put it to the queue
-      rc = tn_is_task_context()
-         ? tn_queue_send(exch_link_queue->queue, p_msg, TN_WAIT_INFINITE)
-         : tn_queue_isend_polling(exch_link_queue->queue, p_msg);
+      rc = task_context
+         ? tn_fmem_get_polling(exch_link_queue->fmem, &p_msg)
+         : tn_fmem_iget_polling(exch_link_queue->fmem, &p_msg);
+
       if (rc != TN_RC_OK){
-         //-- there was some error while sending the message,
-         //   so before we return, we should free buffer that we've allocated
-         rc = tn_is_task_context()
-            ? tn_fmem_release(exch_link_queue->fmem, p_msg)
-            : tn_fmem_irelease(exch_link_queue->fmem, p_msg);
+         //-- there was some error: just return rc as it is
       } else {
-         //-- everything is fine, so, leave rc = TN_RC_OK
+         //-- memory was received from fixed-memory pool, copy data there
+         memcpy(p_msg, exch->data, exch->size);
+
+         //-- put it to the queue
+         rc = task_context
+            ? tn_queue_send_polling(exch_link_queue->queue, p_msg)
+            : tn_queue_isend_polling(exch_link_queue->queue, p_msg);
+
+         if (rc != TN_RC_OK){
+            //-- there was some error while sending the message,
+            //   so before we return, we should free buffer that we've
+            //   allocated (rc from the queue is returned to the caller)
+            if (task_context){
+               tn_fmem_release(exch_link_queue->fmem, p_msg);
+            } else {
+               tn_fmem_irelease(exch_link_queue->fmem, p_msg);
+            }
+         }
       }
-
    }
 
    return rc;
@@ -170,20 +183,20 @@ static enum TN_RCode _notify(struct TN_ExchLink *exch_link)
 
 static enum TN_RCode _dtor(struct TN_ExchLink *exch_link)
 {
-   //-- just call desctructor of superclass
+   //-- just call destructor of superclass
    return _tn_exch_link_vtable()->dtor(exch_link);
 }
 
 
 
 
-
-
-
 /*******************************************************************************
  *    PUBLIC FUNCTIONS
  ******************************************************************************/
 
+/*
+ * See comments in the header file (tn_exch_link_queue.h)
+ */
 enum TN_RCode tn_exch_link_queue_create(
       struct TN_ExchLinkQueue   *exch_link_queue,
       struct TN_DQueue          *queue,
@@ -210,6 +223,9 @@ enum TN_RCode tn_exch_link_queue_create(
    return rc;
 }
 
+/*
+ * See comments in the header file (tn_exch_link_queue.h)
+ */
 enum TN_RCode tn_exch_link_queue_delete(
       struct TN_ExchLinkQueue   *exch_link_queue
       )
@@ -218,4 +234,3 @@ enum TN_RCode tn_exch_link_queue_delete(
 }
 
 
-
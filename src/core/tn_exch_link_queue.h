@@ -0,0 +1,189 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Exchange link: queue (in terms of OOP, it's a "class, inherited from
+ * `#TN_ExchLink`").
+ *
+ * When the \ref tn_exch.h "exchange" data is written, the link allocates a
+ * memory block from the \ref tn_fmem.h "fixed memory pool", copies the data
+ * there and sends the pointer to the block to the
+ * \ref tn_dqueue.h "data queue". The receiver should release the block back
+ * to the pool when it's done with the data.
+ *
+ * If the exchange data fits in a pointer (i.e. its size is not greater than
+ * `sizeof(void *)`), the memory pool is not needed: give `TN_NULL` as
+ * `fmem`, and the data itself will be sent through the queue instead of the
+ * pointer.
+ *
+ * Neither the memory allocation nor the sending ever waits: if there is no
+ * free memory or there is no room in the queue, the notification is lost,
+ * and `tn_exch_write()` returns `#TN_RC_TIMEOUT`.
+ */
+
+
+#ifndef _TN_EXCH_LINK_QUEUE_H
+#define _TN_EXCH_LINK_QUEUE_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_exch_link.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+struct TN_DQueue;
+struct TN_FMem;
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Exchange link which sends the data to the queue.
+ */
+struct TN_ExchLinkQueue {
+   ///
+   /// Exchange link: in terms of OOP, it's a superclass (or base class)
+   struct TN_ExchLink super;
+   ///
+   /// A pointer to queue to send messages to.
+   struct TN_DQueue *queue;
+   ///
+   /// A pointer to fixed-memory pool to get memory from.
+   /// Note: if data size is <= `sizeof(void *)`, `fmem` might be `TN_NULL`.
+   struct TN_FMem *fmem;
+};
+
+
+
+/*******************************************************************************
+ *    GLOBAL VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the queue link. After that, get the base link by
+ * `tn_exch_link_queue_base_get()` and connect it to the exchange object by
+ * `tn_exch_link_add()`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch_link_queue
+ *    Pointer to already allocated `struct TN_ExchLinkQueue`
+ * @param queue
+ *    Queue to send messages to
+ * @param fmem
+ *    Memory pool to allocate messages from, its block size should be not
+ *    less than the size of the exchange data. Might be `TN_NULL` if the
+ *    exchange data fits in a pointer.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_exch_link_queue_create(
+      struct TN_ExchLinkQueue   *exch_link_queue,
+      struct TN_DQueue          *queue,
+      struct TN_FMem            *fmem
+      );
+
+/**
+ * Destruct the queue link. If it is connected to some exchange object,
+ * it is disconnected first.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch_link_queue  link to destruct
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully deleted;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_link_queue_delete(
+      struct TN_ExchLinkQueue   *exch_link_queue
+      );
+
+/**
+ * Returns pointer to the base link, to be given to `tn_exch_link_add()` or
+ * `tn_exch_link_remove()`.
+ */
+_TN_STATIC_INLINE struct TN_ExchLink *tn_exch_link_queue_base_get(
+      struct TN_ExchLinkQueue   *exch_link_queue
+      )
+{
+   return &exch_link_queue->super;
+}
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_EXCH_LINK_QUEUE_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -46,6 +46,8 @@
 //-- internal tnkernel headers
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_multi_wait.h"
+#include "_tn_trace.h"
 
 
 //-- header of current module
@@ -71,14 +73,15 @@
 //-- Additional param checking {{{
 #if TN_CHECK_PARAM
 _TN_STATIC_INLINE enum TN_RCode _check_param_fmem_create(
-      const struct TN_FMem *fmem
+      const struct TN_FMem *fmem,
+      enum TN_WaitOrder wait_order
       )
 {
    enum TN_RCode rc = TN_RC_OK;
 
    if (fmem == TN_NULL){
       rc = TN_RC_WPARAM;
-   } else if (_tn_fmem_is_valid(fmem)){
+   } else if (_tn_fmem_is_valid(fmem) || !_tn_wait_order_is_valid(wait_order)){
       rc = TN_RC_WPARAM;
    }
 
@@ -131,7 +134,7 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
    return rc;
 }
 #else
-#  define _check_param_fmem_create(fmem)               (TN_RC_OK)
+#  define _check_param_fmem_create(fmem, wait_order)   (TN_RC_OK)
 #  define _check_param_fmem_delete(fmem)               (TN_RC_OK)
 #  define _check_param_job_perform(fmem, p_data)       (TN_RC_OK)
 #  define _check_param_generic(fmem)                   (TN_RC_OK)
@@ -198,6 +201,8 @@ _TN_STATIC_INLINE enum TN_RCode _fmem_get(struct TN_FMem *fmem, void **p_data)
       rc = TN_RC_TIMEOUT;
    }
 
+   _tn_trace_put(TN_TRACE_EV_FMEM_GET, rc, (TN_UWord)fmem);
+
    return rc;
 }
 
@@ -226,11 +231,13 @@ _TN_STATIC_INLINE enum TN_RCode _fmem_release(struct TN_FMem *fmem, void *p_data
    enum TN_RCode rc = TN_RC_OK;
 
    //-- Check if there are tasks waiting for memory block. If there is,
-   //   give the block to the first task from the queue.
+   //   give the block to the first task from the queue. Otherwise, give it
+   //   to the first multi-waiting task (if any).
    if (  !_tn_task_first_wait_complete(
             &fmem->wait_queue, TN_RC_OK,
             _cb_before_task_wait_complete, p_data, TN_NULL
             )
+      && !_tn_multi_wait_first_complete(&fmem->multi_wait_list, p_data)
       )
    {
       //-- no task is waiting for free memory block, so,
@@ -256,6 +263,8 @@ _TN_STATIC_INLINE enum TN_RCode _fmem_release(struct TN_FMem *fmem, void *p_data
       }
    }
 
+   _tn_trace_put(TN_TRACE_EV_FMEM_RELEASE, rc, (TN_UWord)fmem);
+
    return rc;
 }
 
@@ -276,10 +285,26 @@ enum TN_RCode tn_fmem_create(
       unsigned int      block_size,
       int               blocks_cnt
       )
+{
+   return tn_fmem_create_wattr(
+         fmem, start_addr, block_size, blocks_cnt, TN_WAIT_ORDER_FIFO
+         );
+}
+
+/*
+ * See comments in the header file (tn_fmem.h)
+ */
+enum TN_RCode tn_fmem_create_wattr(
+      struct TN_FMem   *fmem,
+      void             *start_addr,
+      unsigned int      block_size,
+      int               blocks_cnt,
+      enum TN_WaitOrder wait_order
+      )
 {
    enum TN_RCode rc;
 
-   rc = _check_param_fmem_create(fmem);
+   rc = _check_param_fmem_create(fmem, wait_order);
    if (rc != TN_RC_OK){
       goto out;
    }
@@ -316,9 +341,11 @@ enum TN_RCode tn_fmem_create(
    fmem->start_addr = start_addr;
    fmem->block_size = block_size;
    fmem->blocks_cnt = blocks_cnt;
+   fmem->wait_order = wait_order;
 
    //-- reset wait_queue
    _tn_list_reset(&(fmem->wait_queue));
+   _tn_multi_wait_list_reset(&(fmem->multi_wait_list));
 
    //-- init block pointers
    {
@@ -365,6 +392,7 @@ enum TN_RCode tn_fmem_delete(struct TN_FMem *fmem)
 
       //-- remove all tasks (if any) from fmem's wait queue
       _tn_wait_queue_notify_deleted(&(fmem->wait_queue));
+      _tn_multi_wait_notify_deleted(&(fmem->multi_wait_list));
 
       fmem->id_fmp = TN_ID_NONE;   //-- Fixed-size memory pool does not exist now
 
@@ -403,10 +431,11 @@ enum TN_RCode tn_fmem_get(
       rc = _fmem_get(fmem, p_data);
 
       if (rc == TN_RC_TIMEOUT && timeout > 0){
-         _tn_task_curr_to_wait_action(
+         _tn_task_curr_to_wait_action_ord(
                &(fmem->wait_queue),
                TN_WAIT_REASON_WFIXMEM,
-               timeout
+               timeout,
+               fmem->wait_order
                );
          waited_for_data = TN_TRUE;
       }
@@ -564,3 +593,23 @@ int tn_fmem_used_blocks_cnt_get(struct TN_FMem *fmem)
    return ret;
 }
 
+
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+#if TN_MULTI_WAIT
+
+/*
+ * See comments in the file _tn_fmem.h
+ */
+enum TN_RCode _tn_fmem_try_get(struct TN_FMem *fmem, void **p_data)
+{
+   return _fmem_get(fmem, p_data);
+}
+
+#endif
+
+
@@ -108,6 +108,17 @@ struct TN_FMem {
    /// pointer to the next free memory block as the first word, or `NULL` if
    /// this is the last block.
    void                *free_list;
+   ///
+   /// Order of tasks in `wait_queue`, see `tn_fmem_create_wattr()`
+   enum TN_WaitOrder    wait_order;
+
+#if TN_MULTI_WAIT || defined(DOXYGEN_ACTIVE)
+   ///
+   /// list of multi-wait items waiting for free memory block (see
+   /// \ref tn_multi_wait.h), available if only `#TN_MULTI_WAIT` option is
+   /// non-zero.
+   struct TN_ListItem   multi_wait_list;
+#endif
 };
 
 
@@ -225,6 +236,28 @@ enum TN_RCode tn_fmem_create(
       int               blocks_cnt
       );
 
+/**
+ * The same as `tn_fmem_create()`, but takes additional argument: the order
+ * of waiting tasks. `tn_fmem_create()` uses `#TN_WAIT_ORDER_FIFO`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param wait_order
+ *    Order in which waiting tasks get free blocks, see
+ *    `enum #TN_WaitOrder`
+ *
+ * For the rest of params and return codes, see `tn_fmem_create()`.
+ */
+enum TN_RCode tn_fmem_create_wattr(
+      struct TN_FMem   *fmem,
+      void             *start_addr,
+      unsigned int      block_size,
+      int               blocks_cnt,
+      enum TN_WaitOrder wait_order
+      );
+
 /**
  * Destruct fixed memory blocks pool.
  *
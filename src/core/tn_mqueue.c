@@ -0,0 +1,859 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_eventgrp.h"
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+
+#include "tn_mqueue.h"
+#include "_tn_mqueue.h"
+
+#include "tn_tasks.h"
+
+//-- for memcpy()
+#include <string.h>
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/**
+ * Type of job: send item or receive item. Given to `_mqueue_job_perform()`
+ * and `_mqueue_job_iperform()`.
+ */
+enum _JobType {
+   _JOB_TYPE__SEND,
+   _JOB_TYPE__RECEIVE,
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_MQueue *mque
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (mque == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_mqueue_is_valid(mque)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_MQueue *mque,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt,
+      enum TN_WaitOrder wait_order
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (mque == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (0
+         || item_size == 0
+         || items_cnt < 0
+         || _tn_mqueue_is_valid(mque)
+         || !_tn_wait_order_is_valid(wait_order)
+         )
+   {
+      rc = TN_RC_WPARAM;
+   }
+
+   _TN_UNUSED(data_buf);
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_item(
+      const void *p_item
+      )
+{
+   return (p_item == TN_NULL) ? TN_RC_WPARAM : TN_RC_OK;
+}
+
+#else
+#  define _check_param_generic(mque)                                   \
+   (TN_RC_OK)
+#  define _check_param_create(mque, data_buf, item_size, items_cnt, wait_order) \
+   (TN_RC_OK)
+#  define _check_param_item(p_item)                                    \
+   (TN_RC_OK)
+#endif
+// }}}
+
+//-- Message queue storage FIFO processing {{{
+
+/**
+ * Try to copy the item to the FIFO.
+ *
+ * If there is a room in the FIFO, item is copied, and `#TN_RC_OK` is
+ * returned; otherwise, `#TN_RC_TIMEOUT` is returned, and this case can 
+ * be handled by the caller.
+ *
+ * @param mque
+ *    Message queue in which item should be written
+ * @param p_item
+ *    Pointer to the item to write (`item_size` bytes are copied)
+ */
+static enum TN_RCode _fifo_write(struct TN_MQueue *mque, const void *p_item)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (mque->filled_items_cnt >= mque->items_cnt){
+      //-- no space for new item
+      rc = TN_RC_TIMEOUT;
+   } else {
+
+      //-- write item
+      memcpy(
+            mque->data_buf + (mque->head_idx * mque->item_size),
+            p_item,
+            mque->item_size
+            );
+      mque->filled_items_cnt++;
+      mque->head_idx++;
+      if (mque->head_idx >= mque->items_cnt){
+         mque->head_idx = 0;
+      }
+
+      //-- set flag in the connected event group (if any),
+      //   indicating that there are messages in the queue
+      _tn_eventgrp_link_manage(&mque->eventgrp_link, TN_TRUE);
+   }
+
+   return rc;
+}
+
+
+/**
+ * Try to copy the item from the FIFO.
+ *
+ * If there is some item in the FIFO, it is copied, and `#TN_RC_OK` is
+ * returned; otherwise, `#TN_RC_TIMEOUT` is returned, and this case can 
+ * be handled by the caller.
+ *
+ * @param mque
+ *    Message queue from which item should be read
+ * @param p_item
+ *    Pointer to the location at which the item should be copied
+ */
+static enum TN_RCode _fifo_read(struct TN_MQueue *mque, void *p_item)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (mque->filled_items_cnt == 0){
+      //-- nothing to read
+      rc = TN_RC_TIMEOUT;
+   } else {
+
+      //-- read item
+      memcpy(
+            p_item,
+            mque->data_buf + (mque->tail_idx * mque->item_size),
+            mque->item_size
+            );
+      mque->filled_items_cnt--;
+      mque->tail_idx++;
+      if (mque->tail_idx >= mque->items_cnt){
+         mque->tail_idx = 0;
+      }
+
+      if (mque->filled_items_cnt == 0){
+         //-- clear flag in the connected event group (if any),
+         //   indicating that there are no messages in the queue
+         _tn_eventgrp_link_manage(&mque->eventgrp_link, TN_FALSE);
+      }
+   }
+
+   return rc;
+}
+// }}}
+
+/**
+ * Callback function that is given to `_tn_task_first_wait_complete()`
+ * when task finishes waiting for new messages in the queue.
+ *
+ * See `#_TN_CBBeforeTaskWaitComplete` for details on function signature.
+ */
+static void _cb_before_task_wait_complete__send(
+      struct TN_Task   *task,
+      void             *user_data_1,
+      void             *user_data_2
+      )
+{
+   struct TN_MQueue *mque = (struct TN_MQueue *)user_data_1;
+
+   //-- before task is woken up, copy the item directly to the location
+   //   provided by the receiver
+   memcpy(task->subsys_wait.mqueue.p_item, user_data_2, mque->item_size);
+}
+
+/**
+ * Callback function that is given to `_tn_task_first_wait_complete()`
+ * when task finishes waiting for free item in the queue.
+ *
+ * See `#_TN_CBBeforeTaskWaitComplete` for details on function signature.
+ */
+static void _cb_before_task_wait_complete__receive_ok(
+      struct TN_Task   *task,
+      void             *user_data_1,
+      void             *user_data_2
+      )
+{
+   struct TN_MQueue *mque = (struct TN_MQueue *)user_data_1;
+
+   //-- put to FIFO the item provided by the sender
+   enum TN_RCode rc = _fifo_write(mque, task->subsys_wait.mqueue.p_item); 
+   if (rc != TN_RC_OK){
+      _TN_FATAL_ERROR("rc should always be TN_RC_OK here");
+   }
+   _TN_UNUSED(user_data_2);
+}
+
+/**
+ * Callback function that is given to `_tn_task_first_wait_complete()`
+ * when `items_cnt` is 0.
+ *
+ * See `#_TN_CBBeforeTaskWaitComplete` for details on function signature.
+ */
+static void _cb_before_task_wait_complete__receive_timeout(
+      struct TN_Task   *task,
+      void             *user_data_1,
+      void             *user_data_2
+      )
+{
+   // (that might happen if only mque->items_cnt is 0)
+
+   struct TN_MQueue *mque = (struct TN_MQueue *)user_data_1;
+
+   //-- copy the item directly from the sender to the caller
+   memcpy(user_data_2, task->subsys_wait.mqueue.p_item, mque->item_size);
+}
+
+
+/**
+ * Actual worker function that sends new item through the queue. Eventually
+ * called when user calls one of these functions:
+ *
+ * - `tn_mqueue_send()`
+ * - `tn_mqueue_send_polling()`
+ * - `tn_mqueue_isend_polling()`
+ *
+ *
+ * First of all, it checks whether there are tasks that wait for new items. If
+ * so, the item is copied to the location provided by that task, and task is
+ * woken up. FIFO stays untouched.
+ *
+ * Otherwise, it calls `_fifo_write()` which tries to put item to the FIFO.
+ * If there is a room in the FIFO, item is written, and `#TN_RC_OK` is
+ * returned; otherwise, `#TN_RC_TIMEOUT` is returned, and this case is 
+ * probably handled by the caller (`_mqueue_job_perform()` or
+ * `_mqueue_job_iperform()`) depending on requested `timeout` value.
+ *
+ * @param mque
+ *    Message queue in which item should be written
+ * @param p_item
+ *    Pointer to the item to write
+ */
+static enum TN_RCode _queue_send(
+      struct TN_MQueue *mque,
+      const void *p_item
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   //-- first of all, we check whether there are task(s) that
+   //   waits for receive message from the queue.
+   //
+   //   If yes, we just copy new message to the first task
+   //   from the waiting tasks list, and don't modify messages
+   //   fifo at all.
+   //
+   //   Otherwise (no waiting tasks), we add new message to the fifo.
+
+   if (  !_tn_task_first_wait_complete(
+            &mque->wait_receive_list, TN_RC_OK,
+            _cb_before_task_wait_complete__send, mque, (void *)p_item
+            )
+      )
+   {
+      //-- the message queue's wait_receive list is empty
+      rc = _fifo_write(mque, p_item);
+   }
+
+   return rc;
+}
+
+/**
+ * Actual worker function that receives item from the queue. 
+ * Eventually called when user calls one of these functions:
+ *
+ * - `tn_mqueue_receive()`
+ * - `tn_mqueue_receive_polling()`
+ * - `tn_mqueue_ireceive_polling()`
+ *
+ * First of all, it tries to read item from the queue by calling
+ * `_fifo_read()`. In case of success, it checks whether there are tasks that
+ * wait for the free space in the queue, and wakes up the first task, if any.
+ *
+ * Otherwise (queue is empty, so, read is failed), it checks for the rare case
+ * if there are tasks that wait to write to the queue. It may happen if only
+ * `items_cnt` is 0. If there are such tasks, item is received from the first
+ * task from the queue. Otherwise, `#TN_RC_TIMEOUT` is returned, and this can
+ * be handled by the caller (`_mqueue_job_perform()` or
+ * `_mqueue_job_iperform()`) depending on requested `timeout` value.
+ *
+ * @param mque
+ *    Message queue from which item should be read
+ * @param p_item
+ *    Pointer to the location at which the item should be copied
+ */
+static enum TN_RCode _queue_receive(
+      struct TN_MQueue *mque,
+      void *p_item
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   //-- try to read item from the queue
+   rc = _fifo_read(mque, p_item);
+
+   switch (rc){
+      case TN_RC_OK:
+         //-- successfully read item from the queue.
+         //   if there are tasks that wait to send items to the queue,
+         //   wake the first one up, since there is room now.
+         _tn_task_first_wait_complete(
+               &mque->wait_send_list, TN_RC_OK,
+               _cb_before_task_wait_complete__receive_ok, mque, TN_NULL
+               );
+         break;
+
+      case TN_RC_TIMEOUT:
+         //-- nothing to read from the queue.
+         //   Let's check whether some task wants to send item
+         //   (that might happen if only mque->items_cnt is 0)
+         if (  _tn_task_first_wait_complete(
+                  &mque->wait_send_list, TN_RC_OK,
+                  _cb_before_task_wait_complete__receive_timeout,
+                  mque, p_item
+                  )
+            )
+         {
+            //-- that might happen if only mque->items_cnt is 0:
+            //   item was copied to `p_item` in the 
+            //   `_cb_before_task_wait_complete__receive_timeout()`
+            rc = TN_RC_OK;
+         }
+         break;
+
+      default:
+         _TN_FATAL_ERROR(
+               "rc should be TN_RC_OK or TN_RC_TIMEOUT here"
+               );
+         break;
+   }
+
+   return rc;
+}
+
+
+/**
+ * Intermediary function that is called by queue-related services
+ * (`tn_mqueue_send()`, `tn_mqueue_receive()`, etc), which performs all
+ * necessary housekeeping and eventually calls actual worker function
+ * depending on given `job_type`.
+ *
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param mque
+ *    Message queue on which job should be performed.
+ * @param job_type
+ *    Type of job to perform, depending on it, appropriate worker function
+ *    will be called (`_queue_send()` or `_queue_receive()`).
+ * @param p_item
+ *    Depends on given job_type:
+ *
+ *    - `_JOB_TYPE__SEND`: pointer to the item to send;
+ *    - `_JOB_TYPE__RECEIVE`: pointer at which item should be received.
+ * @param timeout
+ *    Refer to `#TN_TickCnt`.
+ */
+static enum TN_RCode _mqueue_job_perform(
+      struct TN_MQueue *mque,
+      enum _JobType job_type,
+      void *p_item,
+      TN_TickCnt timeout
+      )
+{
+   TN_BOOL waited = TN_FALSE;
+   enum TN_RCode rc = _check_param_generic(mque);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_item(p_item)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      switch (job_type){
+
+         case _JOB_TYPE__SEND:
+            //-- try to put new item to the queue
+            rc = _queue_send(mque, p_item);
+
+            if (rc == TN_RC_TIMEOUT && timeout != 0){
+               //-- We can't put new item to the queue right now (queue is
+               //   full), and user asked to wait if that happens.
+               //
+               //   Save pointer to the user-provided item in the
+               //   `mqueue.p_item` task field, and put current task to wait
+               //   until there's room in the queue.
+               _tn_curr_run_task->subsys_wait.mqueue.p_item = p_item;
+               _tn_task_curr_to_wait_action_ord(
+                     &(mque->wait_send_list),
+                     TN_WAIT_REASON_MQUE_WSEND,
+                     timeout,
+                     mque->wait_order
+                     );
+
+               waited = TN_TRUE;
+            }
+            break;
+
+         case _JOB_TYPE__RECEIVE:
+            //-- try to get the item from the queue
+            rc = _queue_receive(mque, p_item);
+
+            if (rc == TN_RC_TIMEOUT && timeout != 0){
+               //-- Queue is empty right now, and user asked to wait if that
+               //   happens.
+               //
+               //   Save pointer to the user-provided location in the
+               //   `mqueue.p_item` task field (the sender will copy the item
+               //   right there), and put current task to wait until new item
+               //   comes.
+               _tn_curr_run_task->subsys_wait.mqueue.p_item = p_item;
+               _tn_task_curr_to_wait_action_ord(
+                     &(mque->wait_receive_list),
+                     TN_WAIT_REASON_MQUE_WRECEIVE,
+                     timeout,
+                     mque->wait_order
+                     );
+
+               waited = TN_TRUE;
+            }
+            break;
+      }
+
+#if TN_DEBUG
+      if (!_tn_need_context_switch() && waited){
+         _TN_FATAL_ERROR("");
+      }
+#endif
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+      if (waited){
+         //-- get wait result. Note that if the task waited for the item,
+         //   it is already copied to the user's location by the sender.
+         rc = _tn_curr_run_task->task_wait_rc;
+      }
+
+   }
+   return rc;
+}
+
+/**
+ * The same as `_mqueue_job_perform()` with zero timeout, but for using in the
+ * ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+static enum TN_RCode _mqueue_job_iperform(
+      struct TN_MQueue *mque,
+      enum _JobType job_type,
+      void *p_item
+      )
+{
+   enum TN_RCode rc = _check_param_generic(mque);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_item(p_item)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      //-- wrong context
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      //-- depending on the job type, call appropriate function
+      switch (job_type){
+
+         case _JOB_TYPE__SEND:
+            //-- Try to put new item to the queue. We don't handle returned
+            //   value here, since we can't wait in interrupt, so, just return
+            //   the value to the caller.
+            rc = _queue_send(mque, p_item);
+            break;
+
+         case _JOB_TYPE__RECEIVE:
+            //-- try to get the item from the queue. We don't handle returned
+            //   value here, since we can't wait in interrupt, so, just return
+            //   the value to the caller.
+            rc = _queue_receive(mque, p_item);
+            break;
+      }
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_create(
+      struct TN_MQueue *mque,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt
+      )
+{
+   return tn_mqueue_create_wattr(
+         mque, data_buf, item_size, items_cnt, TN_WAIT_ORDER_FIFO
+         );
+}
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_create_wattr(
+      struct TN_MQueue *mque,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt,
+      enum TN_WaitOrder wait_order
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_create(
+         mque, data_buf, item_size, items_cnt, wait_order
+         );
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      _tn_list_reset(&(mque->wait_send_list));
+      _tn_list_reset(&(mque->wait_receive_list));
+
+      mque->data_buf          = (unsigned char *)data_buf;
+      mque->item_size         = item_size;
+      mque->items_cnt         = items_cnt;
+      mque->wait_order        = wait_order;
+
+      _tn_eventgrp_link_reset(&mque->eventgrp_link);
+
+      if (mque->data_buf == TN_NULL){
+         mque->items_cnt = 0;
+      }
+
+      mque->filled_items_cnt  = 0;
+      mque->tail_idx          = 0;
+      mque->head_idx          = 0;
+
+      mque->id_mque = TN_ID_MSGQUEUE;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_delete(struct TN_MQueue *mque)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_generic(mque);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- notify waiting tasks that the object is deleted
+      //   (TN_RC_DELETED is returned)
+      _tn_wait_queue_notify_deleted(&(mque->wait_send_list));
+      _tn_wait_queue_notify_deleted(&(mque->wait_receive_list));
+
+      mque->id_mque = TN_ID_NONE; //-- message queue does not exist now
+
+      TN_INT_RESTORE();
+
+      //-- we might need to switch context if _tn_wait_queue_notify_deleted()
+      //   has woken up some high-priority task
+      _tn_context_switch_pend_if_needed();
+
+   }
+
+   return rc;
+
+}
+
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_send(
+      struct TN_MQueue *mque,
+      const void *p_item,
+      TN_TickCnt timeout
+      )
+{
+   return _mqueue_job_perform(
+         mque, _JOB_TYPE__SEND, (void *)p_item, timeout
+         );
+}
+
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_send_polling(
+      struct TN_MQueue *mque,
+      const void *p_item
+      )
+{
+   return _mqueue_job_perform(mque, _JOB_TYPE__SEND, (void *)p_item, 0);
+}
+
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_isend_polling(
+      struct TN_MQueue *mque,
+      const void *p_item
+      )
+{
+   return _mqueue_job_iperform(mque, _JOB_TYPE__SEND, (void *)p_item);
+}
+
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_receive(
+      struct TN_MQueue *mque,
+      void *p_item,
+      TN_TickCnt timeout
+      )
+{
+   return _mqueue_job_perform(mque, _JOB_TYPE__RECEIVE, p_item, timeout);
+}
+
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_receive_polling(struct TN_MQueue *mque, void *p_item)
+{
+   return _mqueue_job_perform(mque, _JOB_TYPE__RECEIVE, p_item, 0);
+}
+
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_ireceive_polling(struct TN_MQueue *mque, void *p_item)
+{
+   return _mqueue_job_iperform(mque, _JOB_TYPE__RECEIVE, p_item);
+}
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+int tn_mqueue_free_items_cnt_get(
+      struct TN_MQueue    *mque
+      )
+{
+   int ret = -1;
+   enum TN_RCode rc = _check_param_generic(mque);
+
+   if (rc == TN_RC_OK){
+      //-- It's not needed to disable interrupts here, since `filled_items_cnt`
+      //   is read by just one assembler instruction, and `items_cnt` never
+      //   changes.
+      ret = mque->items_cnt - mque->filled_items_cnt;
+   }
+
+   return ret;
+}
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+int tn_mqueue_used_items_cnt_get(
+      struct TN_MQueue    *mque
+      )
+{
+   int ret = -1;
+   enum TN_RCode rc = _check_param_generic(mque);
+
+   if (rc == TN_RC_OK){
+      //-- It's not needed to disable interrupts here, since `filled_items_cnt`
+      //   is read by just one assembler instruction.
+      ret = mque->filled_items_cnt;
+   }
+
+   return ret;
+}
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_eventgrp_connect(
+      struct TN_MQueue    *mque,
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord             pattern
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_generic(mque);
+
+   if (rc == TN_RC_OK){
+      sr_saved = tn_arch_sr_save_int_dis();
+      rc = _tn_eventgrp_link_set(&mque->eventgrp_link, eventgrp, pattern);
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+
+#if TN_EVENTGRP_WIDE
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_eventgrp_connect_bit(
+      struct TN_MQueue    *mque,
+      struct TN_EventGrp  *eventgrp,
+      int                  bit_num
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_generic(mque);
+
+   if (rc == TN_RC_OK){
+      sr_saved = tn_arch_sr_save_int_dis();
+      rc = _tn_eventgrp_link_set_bit(&mque->eventgrp_link, eventgrp, bit_num);
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+#endif
+
+/*
+ * See comments in the header file (tn_mqueue.h)
+ */
+enum TN_RCode tn_mqueue_eventgrp_disconnect(
+      struct TN_MQueue    *mque
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_generic(mque);
+
+   if (rc == TN_RC_OK){
+      sr_saved = tn_arch_sr_save_int_dis();
+      rc = _tn_eventgrp_link_reset(&mque->eventgrp_link);
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+
@@ -0,0 +1,545 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * A message queue is a FIFO that stores fixed-size items by value: unlike
+ * \ref tn_dqueue.h "data queue" which stores just a pointer (of type `void *`)
+ * in each cell, message queue copies the whole item to its own buffer on
+ * send, and copies it to the receiver's location on receive. So, there's no
+ * need to pair queue with the \ref tn_fmem.h "fixed memory pool" to pass
+ * messages which don't fit in a pointer: the data is sent and received in
+ * just one call each.
+ *
+ * A message queue has an associated wait queue each for sending (`wait_send`
+ * queue) and for receiving (`wait_receive` queue). A task that sends an item
+ * tries to put it into the FIFO. If there is no space left in the FIFO, the
+ * task is switched to the waiting state and placed in the message queue's
+ * `wait_send` queue until space appears (another task gets an item from the
+ * queue).
+ *
+ * A task that receives an item tries to get an item from the FIFO. If the
+ * FIFO is empty, the task is switched to the waiting state and placed in the
+ * message queue's `wait_receive` queue until an item arrives.
+ *
+ * If the sender finds a task that waits for an item in the `wait_receive`
+ * queue, the item is copied directly to the location provided by that task,
+ * bypassing the FIFO; so, each item is copied at most twice (in and out of
+ * the FIFO), and just once if receiver is already waiting. To use message
+ * queue just for the synchronous message passing, set size of the FIFO to 0.
+ *
+ * Items are copied with interrupts disabled, so, message queue is intended
+ * for rather small items (a few machine words); for large blocks of data, a
+ * data queue together with the fixed memory pool is still the way to go.
+ *
+ * Just like data queue, message queue can be connected to the event group,
+ * refer to the section \ref eventgrp_connect for details. Related services:
+ *
+ * - `tn_mqueue_eventgrp_connect()`
+ * - `tn_mqueue_eventgrp_connect_bit()`
+ * - `tn_mqueue_eventgrp_disconnect()`
+ */
+
+#ifndef _TN_MQUEUE_H
+#define _TN_MQUEUE_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+#include "tn_eventgrp.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Structure representing message queue object
+ */
+struct TN_MQueue {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_mque;
+   ///
+   /// list of tasks waiting to send data
+   struct TN_ListItem  wait_send_list;
+   ///
+   /// list of tasks waiting to receive data
+   struct TN_ListItem  wait_receive_list;
+
+   ///
+   /// buffer to store message queue items, its size should be
+   /// `(item_size * items_cnt)` bytes. Can be `TN_NULL`.
+   unsigned char *data_buf;
+   ///
+   /// size of each item (in bytes)
+   unsigned int   item_size;
+   ///
+   /// capacity (total items count). Can be 0.
+   int            items_cnt;
+   ///
+   /// count of non-free items in `data_buf`
+   int            filled_items_cnt;
+   ///
+   /// Order of tasks in `wait_send_list` and `wait_receive_list`, see
+   /// `tn_mqueue_create_wattr()`
+   enum TN_WaitOrder wait_order;
+   ///
+   /// index of the item which will be written next time
+   int            head_idx;
+   ///
+   /// index of the item which will be read next time
+   int            tail_idx;
+   ///
+   /// connected event group
+   struct TN_EGrpLink eventgrp_link;
+};
+
+/**
+ * MQueue-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_MQueueTaskWait {
+   /// if task tries to send the item to the message queue, and there's no
+   /// space in the queue, pointer to the item to send is stored in this
+   /// field; if task tries to receive the item, and there are no items in
+   /// the queue, pointer to the location to store the item is stored here.
+   void *p_item;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Convenience macro for the definition of buffer for message queue. See
+ * `tn_mqueue_create()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_mqueue_create()` function as the `data_buf` argument)
+ * @param item_type
+ *    Type of item in the message queue, like `struct MyMessage`.
+ * @param size
+ *    Number of items in the message queue.
+ */
+#define TN_MQUEUE_BUF_DEF(name, item_type, size)                  \
+   TN_UWord name[                                                 \
+        (size)                                                    \
+      * (TN_MAKE_ALIG_SIZE(sizeof(item_type)) / sizeof(TN_UWord)) \
+      ]
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct message queue. `id_mque` member should not contain
+ * `#TN_ID_MSGQUEUE`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * For the definition of buffer, convenience macro `TN_MQUEUE_BUF_DEF()` is
+ * available. Typical definition looks as follows:
+ *
+ * \code{.c}
+ *     //-- number of items in the queue
+ *     #define MY_QUEUE_SIZE    8
+ *
+ *     //-- type of queue item
+ *     struct MyMessage {
+ *        // ... arbitrary fields ...
+ *     };
+ *     
+ *     //-- define buffer for message queue
+ *     TN_MQUEUE_BUF_DEF(my_mqueue_buf, struct MyMessage, MY_QUEUE_SIZE);
+ *
+ *     //-- define message queue structure
+ *     struct TN_MQueue my_mqueue;
+ * \endcode
+ *
+ * And then, construct your `my_mqueue` as follows:
+ *
+ * \code{.c}
+ *     enum TN_RCode rc;
+ *     rc = tn_mqueue_create( &my_mqueue,
+ *                            my_mqueue_buf,
+ *                            TN_MAKE_ALIG_SIZE(sizeof(struct MyMessage)),
+ *                            MY_QUEUE_SIZE
+ *                          );
+ *     if (rc != TN_RC_OK){
+ *        //-- handle error
+ *     }
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param mque       pointer to already allocated `struct TN_MQueue`.
+ * @param data_buf   pointer to already allocated buffer to store items,
+ *                   its size should be at least `(item_size * items_cnt)`
+ *                   bytes. Can be `#TN_NULL`.
+ * @param item_size  size of each item, in bytes. Must be non-zero.
+ * @param items_cnt  capacity of queue (count of items that `data_buf` can
+ *                   hold). Can be 0.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if queue was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_mqueue_create(
+      struct TN_MQueue *mque,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt
+      );
+
+/**
+ * The same as `tn_mqueue_create()`, but takes additional argument: the
+ * order of waiting tasks (both senders and receivers).
+ * `tn_mqueue_create()` uses `#TN_WAIT_ORDER_FIFO`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param wait_order
+ *    Order in which waiting tasks are served, see `enum #TN_WaitOrder`
+ *
+ * For the rest of params and return codes, see `tn_mqueue_create()`.
+ */
+enum TN_RCode tn_mqueue_create_wattr(
+      struct TN_MQueue *mque,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt,
+      enum TN_WaitOrder wait_order
+      );
+
+
+/**
+ * Destruct message queue.
+ *
+ * All tasks that wait for writing to or reading from the queue become
+ * runnable with `#TN_RC_DELETED` code returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param mque       pointer to message queue to be deleted
+ *
+ * @return 
+ *    * `#TN_RC_OK` if queue was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_mqueue_delete(struct TN_MQueue *mque);
+
+
+/**
+ * Send the item pointed to by `p_item` to the message queue specified by the
+ * `mque`: `item_size` bytes are copied from `p_item`.
+ *
+ * If there are tasks in the message queue's `wait_receive` list already, the
+ * function releases the task from the head of the `wait_receive` list, copies
+ * the item directly to the location provided by that task, and makes the task
+ * runnable.
+ *
+ * If there are no tasks in the message queue's `wait_receive` list, the item
+ * is copied to the tail of FIFO. If the FIFO is full, behavior depends on the
+ * `timeout` value: refer to `#TN_TickCnt`. While the task waits, the item
+ * is not copied anywhere, so the memory pointed to by `p_item` should not be
+ * modified by other tasks.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param mque       pointer to message queue to send item to
+ * @param p_item     pointer to the item to send
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if item was successfully sent;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_mqueue_send(
+      struct TN_MQueue *mque,
+      const void *p_item,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_mqueue_send()` with zero timeout
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_mqueue_send_polling(
+      struct TN_MQueue *mque,
+      const void *p_item
+      );
+
+/**
+ * The same as `tn_mqueue_send()` with zero timeout, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_mqueue_isend_polling(
+      struct TN_MQueue *mque,
+      const void *p_item
+      );
+
+/**
+ * Receive the item from the message queue specified by the `mque` and copy
+ * it to the location specified by the `p_item` (`item_size` bytes are
+ * written there).
+ *
+ * If the FIFO already has items, function removes an item from the FIFO and
+ * copies it to `p_item`. If there are task(s) in the message queue's
+ * `wait_send` list, first one gets removed from the head of `wait_send` list,
+ * becomes runnable and its item is copied to the tail of FIFO.
+ *
+ * If there are no items in the FIFO and there are no tasks in the
+ * `wait_send` list, behavior depends on the `timeout` value: refer to
+ * `#TN_TickCnt`. If the task waits, the item will be copied to `p_item`
+ * directly by the sender.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param mque       pointer to message queue to receive item from
+ * @param p_item     pointer to location to store the item
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if item was successfully received;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_mqueue_receive(
+      struct TN_MQueue *mque,
+      void *p_item,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_mqueue_receive()` with zero timeout
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_mqueue_receive_polling(
+      struct TN_MQueue *mque,
+      void *p_item
+      );
+
+/**
+ * The same as `tn_mqueue_receive()` with zero timeout, but for using in the
+ * ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_mqueue_ireceive_polling(
+      struct TN_MQueue *mque,
+      void *p_item
+      );
+
+
+/**
+ * Returns number of free items in the queue
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param mque
+ *    Pointer to queue.
+ *
+ * @return
+ *    Number of free items in the queue, or -1 if wrong params were given (the
+ *    check is performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_mqueue_free_items_cnt_get(
+      struct TN_MQueue    *mque
+      );
+
+
+/**
+ * Returns number of used (non-free) items in the queue
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param mque
+ *    Pointer to queue.
+ *
+ * @return
+ *    Number of used (non-free) items in the queue, or -1 if wrong params were
+ *    given (the check is performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_mqueue_used_items_cnt_get(
+      struct TN_MQueue    *mque
+      );
+
+
+/**
+ * Connect an event group to the queue. 
+ * Refer to the section \ref eventgrp_connect for details.
+ *
+ * Only one event group can be connected to the queue at a time. If you
+ * connect event group while another event group is already connected,
+ * the old link is discarded.
+ *
+ * @param mque
+ *    queue to which event group should be connected
+ * @param eventgrp 
+ *    event groupt to connect
+ * @param pattern
+ *    flags pattern that should be managed by the queue automatically
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_mqueue_eventgrp_connect(
+      struct TN_MQueue    *mque,
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord             pattern
+      );
+
+#if TN_EVENTGRP_WIDE || defined(DOXYGEN_ACTIVE)
+/**
+ * The same as `tn_mqueue_eventgrp_connect()`, but the queue manages the single flag
+ * with the given number, which may be any flag of the wide event group (see
+ * \ref eventgrp_wide). Available if only `#TN_EVENTGRP_WIDE` option is
+ * non-zero.
+ *
+ * @param mque
+ *    queue to which event group should be connected
+ * @param eventgrp 
+ *    event groupt to connect
+ * @param bit_num
+ *    number of flag that should be managed by the queue automatically:
+ *    from 0 to `(words_cnt * #TN_INT_WIDTH - 1)`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_mqueue_eventgrp_connect_bit(
+      struct TN_MQueue    *mque,
+      struct TN_EventGrp  *eventgrp,
+      int                  bit_num
+      );
+#endif
+
+
+/**
+ * Disconnect a connected event group from the queue.
+ * Refer to the section \ref eventgrp_connect for details.
+ *
+ * If there is no event group connected, nothing is changed.
+ *
+ * @param mque    queue from which event group should be disconnected
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_mqueue_eventgrp_disconnect(
+      struct TN_MQueue    *mque
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_MQUEUE_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
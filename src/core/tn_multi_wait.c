@@ -0,0 +1,470 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+#include "_tn_sem.h"
+#include "_tn_dqueue.h"
+#include "_tn_fmem.h"
+#include "_tn_eventgrp.h"
+
+
+#include "tn_multi_wait.h"
+#include "_tn_multi_wait.h"
+
+#include "tn_tasks.h"
+
+
+
+#if TN_MULTI_WAIT
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+/**
+ * Check the object of the single item
+ */
+static enum TN_RCode _check_param_item(const struct TN_MultiWaitItem *item)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (item->p_obj == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else {
+      switch (item->obj_type){
+         case TN_MULTI_WAIT_OBJ_SEM:
+            if (!_tn_sem_is_valid((const struct TN_Sem *)item->p_obj)){
+               rc = TN_RC_INVALID_OBJ;
+            }
+            break;
+
+         case TN_MULTI_WAIT_OBJ_DQUEUE:
+            if (!_tn_dqueue_is_valid((const struct TN_DQueue *)item->p_obj)){
+               rc = TN_RC_INVALID_OBJ;
+            }
+            break;
+
+         case TN_MULTI_WAIT_OBJ_FMEM:
+            if (!_tn_fmem_is_valid((const struct TN_FMem *)item->p_obj)){
+               rc = TN_RC_INVALID_OBJ;
+            }
+            break;
+
+         case TN_MULTI_WAIT_OBJ_EVENTGRP:
+            if (!_tn_eventgrp_is_valid(
+                     (const struct TN_EventGrp *)item->p_obj
+                     )
+               )
+            {
+               rc = TN_RC_INVALID_OBJ;
+            }
+            break;
+
+         default:
+            rc = TN_RC_WPARAM;
+            break;
+      }
+   }
+
+   return rc;
+}
+
+static enum TN_RCode _check_param_generic(
+      const struct TN_MultiWaitItem *items,
+      int items_cnt,
+      const int *p_fired_idx
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   int i;
+   int j;
+
+   if (items == TN_NULL || items_cnt <= 0 || p_fired_idx == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else {
+      for (i = 0; rc == TN_RC_OK && i < items_cnt; i++){
+         rc = _check_param_item(&items[i]);
+
+         //-- each object may appear at most once
+         for (j = 0; rc == TN_RC_OK && j < i; j++){
+            if (items[j].p_obj == items[i].p_obj){
+               rc = TN_RC_WPARAM;
+            }
+         }
+      }
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(items, items_cnt, p_fired_idx)  (TN_RC_OK)
+#endif
+// }}}
+
+
+/**
+ * Returns pointer to the list of multi-wait items of the object of the given
+ * item.
+ */
+static struct TN_ListItem *_multi_wait_list_get(
+      struct TN_MultiWaitItem *item
+      )
+{
+   struct TN_ListItem *ret = TN_NULL;
+
+   switch (item->obj_type){
+      case TN_MULTI_WAIT_OBJ_SEM:
+         ret = &((struct TN_Sem *)item->p_obj)->multi_wait_list;
+         break;
+
+      case TN_MULTI_WAIT_OBJ_DQUEUE:
+         ret = &((struct TN_DQueue *)item->p_obj)->multi_wait_list;
+         break;
+
+      case TN_MULTI_WAIT_OBJ_FMEM:
+         ret = &((struct TN_FMem *)item->p_obj)->multi_wait_list;
+         break;
+
+      case TN_MULTI_WAIT_OBJ_EVENTGRP:
+         ret = &((struct TN_EventGrp *)item->p_obj)->multi_wait_list;
+         break;
+
+      default:
+         _TN_FATAL_ERROR("wrong obj_type");
+         break;
+   }
+
+   return ret;
+}
+
+/**
+ * Try to satisfy the given item without waiting: acquire the semaphore,
+ * receive from the queue, etc. The result (if any) is stored in the item.
+ *
+ * @return
+ *    - `#TN_RC_OK` if item is satisfied;
+ *    - `#TN_RC_TIMEOUT` if item can't be satisfied right now;
+ *    - other code if the item is wrong.
+ */
+static enum TN_RCode _item_try(struct TN_MultiWaitItem *item)
+{
+   enum TN_RCode rc = TN_RC_WPARAM;
+
+   switch (item->obj_type){
+      case TN_MULTI_WAIT_OBJ_SEM:
+         rc = _tn_sem_try_wait((struct TN_Sem *)item->p_obj);
+         break;
+
+      case TN_MULTI_WAIT_OBJ_DQUEUE:
+         rc = _tn_dqueue_try_receive(
+               (struct TN_DQueue *)item->p_obj, &item->p_data
+               );
+         break;
+
+      case TN_MULTI_WAIT_OBJ_FMEM:
+         rc = _tn_fmem_try_get((struct TN_FMem *)item->p_obj, &item->p_data);
+         break;
+
+      case TN_MULTI_WAIT_OBJ_EVENTGRP:
+         rc = _tn_eventgrp_try_wait(
+               (struct TN_EventGrp *)item->p_obj,
+               item->wait_pattern, item->wait_mode,
+               &item->actual_pattern
+               );
+         break;
+   }
+
+   return rc;
+}
+
+/**
+ * Actual worker function that checks items in order and satisfies the first
+ * one that can be satisfied. It never sleeps; if no item can be satisfied,
+ * `#TN_RC_TIMEOUT` is returned, and the caller may sleep then.
+ *
+ * For params documentation, refer to the `tn_multi_wait()`.
+ */
+static enum TN_RCode _multi_wait(
+      struct TN_MultiWaitItem *items,
+      int items_cnt,
+      int *p_fired_idx
+      )
+{
+   enum TN_RCode rc = TN_RC_TIMEOUT;
+   int i;
+
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   *p_fired_idx = -1;
+
+   for (i = 0; rc == TN_RC_TIMEOUT && i < items_cnt; i++){
+      rc = _item_try(&items[i]);
+      if (rc != TN_RC_TIMEOUT){
+         *p_fired_idx = i;
+      }
+   }
+
+   return rc;
+}
+
+/**
+ * Put all the items of the current task to the lists of multi-wait items of
+ * their objects, and remember them in the task.
+ */
+static void _items_add(
+      struct TN_Task *task,
+      struct TN_MultiWaitItem *items,
+      int items_cnt
+      )
+{
+   int i;
+
+   task->subsys_wait.multi.items       = items;
+   task->subsys_wait.multi.items_cnt   = items_cnt;
+   task->subsys_wait.multi.fired_idx   = -1;
+
+   for (i = 0; i < items_cnt; i++){
+      items[i].task = task;
+      _tn_list_add_tail(_multi_wait_list_get(&items[i]), &items[i].wait_queue);
+   }
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_multi_wait.h)
+ */
+enum TN_RCode tn_multi_wait(
+      struct TN_MultiWaitItem *items,
+      int items_cnt,
+      int *p_fired_idx,
+      TN_TickCnt timeout
+      )
+{
+   TN_BOOL waited = TN_FALSE;
+   enum TN_RCode rc = _check_param_generic(items, items_cnt, p_fired_idx);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _multi_wait(items, items_cnt, p_fired_idx);
+
+      if (rc == TN_RC_TIMEOUT && timeout != 0){
+         //-- No item can be satisfied right now, and user asked to wait if
+         //   that happens. Put items to the lists of their objects, and put
+         //   current task to wait (it isn't included in any wait queue by
+         //   itself).
+         _items_add(_tn_curr_run_task, items, items_cnt);
+         _tn_task_curr_to_wait_action(
+               TN_NULL, TN_WAIT_REASON_MULTI, timeout
+               );
+
+         waited = TN_TRUE;
+      }
+
+#if TN_DEBUG
+      if (!_tn_need_context_switch() && waited){
+         _TN_FATAL_ERROR("");
+      }
+#endif
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited){
+         //-- get wait result and the item that has fired (if any): the
+         //   result of the item is already stored in it by the object
+         rc = _tn_curr_run_task->task_wait_rc;
+         *p_fired_idx = _tn_curr_run_task->subsys_wait.multi.fired_idx;
+      }
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_multi_wait.h)
+ */
+enum TN_RCode tn_multi_wait_polling(
+      struct TN_MultiWaitItem *items,
+      int items_cnt,
+      int *p_fired_idx
+      )
+{
+   return tn_multi_wait(items, items_cnt, p_fired_idx, 0);
+}
+
+/*
+ * See comments in the header file (tn_multi_wait.h)
+ */
+enum TN_RCode tn_multi_iwait_polling(
+      struct TN_MultiWaitItem *items,
+      int items_cnt,
+      int *p_fired_idx
+      )
+{
+   enum TN_RCode rc = _check_param_generic(items, items_cnt, p_fired_idx);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      rc = _multi_wait(items, items_cnt, p_fired_idx);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
+
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the file _tn_multi_wait.h
+ */
+TN_BOOL _tn_multi_wait_first_complete(
+      struct TN_ListItem *multi_wait_list,
+      void *p_data
+      )
+{
+   TN_BOOL ret = TN_FALSE;
+
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   if (!_tn_list_is_empty(multi_wait_list)){
+      struct TN_MultiWaitItem *item = _tn_list_first_entry(
+            multi_wait_list, struct TN_MultiWaitItem, wait_queue
+            );
+
+      item->p_data = p_data;
+      _tn_multi_wait_item_complete(item, TN_RC_OK);
+
+      ret = TN_TRUE;
+   }
+
+   return ret;
+}
+
+/*
+ * See comments in the file _tn_multi_wait.h
+ */
+void _tn_multi_wait_item_complete(
+      struct TN_MultiWaitItem *item,
+      enum TN_RCode wait_rc
+      )
+{
+   struct TN_Task *task = item->task;
+
+   task->subsys_wait.multi.fired_idx
+      = (int)(item - task->subsys_wait.multi.items);
+
+   //-- items are removed from the lists in
+   //   `_tn_multi_wait_on_task_wait_complete()`, which is eventually called
+   //   from `_tn_task_wait_complete()`
+   _tn_task_wait_complete(task, wait_rc);
+}
+
+/*
+ * See comments in the file _tn_multi_wait.h
+ */
+void _tn_multi_wait_notify_deleted(struct TN_ListItem *multi_wait_list)
+{
+   //-- each task is woken up once, and all its items are removed from the
+   //   lists, so just take the first item while the list isn't empty
+   while (!_tn_list_is_empty(multi_wait_list)){
+      _tn_multi_wait_item_complete(
+            _tn_list_first_entry(
+               multi_wait_list, struct TN_MultiWaitItem, wait_queue
+               ),
+            TN_RC_DELETED
+            );
+   }
+}
+
+/*
+ * See comments in the file _tn_multi_wait.h
+ */
+void _tn_multi_wait_on_task_wait_complete(struct TN_Task *task)
+{
+   struct TN_MultiWaitItem *items = task->subsys_wait.multi.items;
+   int i;
+
+   for (i = 0; i < task->subsys_wait.multi.items_cnt; i++){
+      _tn_list_remove_entry(&items[i].wait_queue);
+      _tn_list_reset(&items[i].wait_queue);
+   }
+}
+
+
+#endif   // TN_MULTI_WAIT
+
+
@@ -0,0 +1,336 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Multi-object wait: a task may wait for any of several kernel objects at
+ * once, and it is woken up by exactly one of them. Available if only
+ * `#TN_MULTI_WAIT` option is non-zero.
+ *
+ * The following objects may be waited for:
+ *
+ * - \ref tn_sem.h "semaphore": wait to acquire it (decrement its count);
+ * - \ref tn_dqueue.h "data queue": wait to receive an item from it;
+ * - \ref tn_fmem.h "fixed memory pool": wait to get a memory block from it;
+ * - \ref tn_eventgrp.h "event group": wait for some condition of its flags.
+ *
+ * The set of objects to wait for is given as an array of `struct
+ * #TN_MultiWaitItem`, one item for each object. When the task calls
+ * `tn_multi_wait()`, items are checked in the order they appear in the array,
+ * and the first one that can be satisfied immediately (say, semaphore count
+ * is non-zero) is satisfied, just like if the corresponding polling service
+ * (say, `tn_sem_wait_polling()`) was called. If none of them can be
+ * satisfied, the task goes to sleep, and each item is put in the list of
+ * multi-wait items of its object.
+ *
+ * When some object becomes ready while the task waits (semaphore is signaled,
+ * item is sent to the queue, memory block is released, or the event group
+ * condition is met), the object hands the result over to the first waiting
+ * item directly, just like it does for the tasks that wait for this object
+ * alone: the semaphore count is not incremented, the queue item is not put to
+ * the FIFO, etc. Then, the task is woken up, and all its items are removed
+ * from the lists of their objects, so that no other object can consider it
+ * as a waiter anymore. The index of the item that fired is returned to the
+ * caller.
+ *
+ * This is different from the approach with the event group connected to
+ * several queues (see `tn_queue_eventgrp_connect()`): there, the task is
+ * woken up by the flag, and then it has to poll the queues; and if several
+ * tasks wait for the same flag, all of them are woken up, but only one of
+ * them gets the item, the others wake up for nothing.
+ *
+ * Tasks that wait for the object alone (say, by `tn_sem_wait()`) take
+ * precedence over the multi-waiting tasks: the latter are considered if only
+ * there are no tasks of the former kind. Within each kind, the order is FIFO.
+ *
+ * Usage example: wait for an item from any of two queues, or for the
+ * semaphore:
+ *
+ * \code{.c}
+ *     struct TN_MultiWaitItem items[] = {
+ *        { .obj_type = TN_MULTI_WAIT_OBJ_DQUEUE, .p_obj = &my_queue_1 },
+ *        { .obj_type = TN_MULTI_WAIT_OBJ_DQUEUE, .p_obj = &my_queue_2 },
+ *        { .obj_type = TN_MULTI_WAIT_OBJ_SEM,    .p_obj = &my_sem     },
+ *     };
+ *     int fired_idx;
+ *
+ *     enum TN_RCode rc = tn_multi_wait(
+ *           items, sizeof(items) / sizeof(items[0]), &fired_idx,
+ *           TN_WAIT_INFINITE
+ *           );
+ *
+ *     if (rc == TN_RC_OK){
+ *        switch (fired_idx){
+ *           case 0:
+ *           case 1:
+ *              //-- the item received from the queue is in
+ *              //   `items[fired_idx].p_data`
+ *              break;
+ *           case 2:
+ *              //-- the semaphore is acquired
+ *              break;
+ *        }
+ *     }
+ * \endcode
+ *
+ * Restrictions:
+ *
+ * - Each object may appear in the array at most once.
+ * - The array of items must remain valid while the task waits, so it is
+ *   typically allocated on the task's stack right before the call.
+ * - Mutexes can't be waited for, since the priority inheritance and
+ *   priority ceiling protocols are defined for the single mutex only.
+ */
+
+#ifndef _TN_MULTI_WAIT_H
+#define _TN_MULTI_WAIT_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+#include "tn_eventgrp.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+struct TN_Task;
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Type of the object in the multi-wait item, see `struct #TN_MultiWaitItem`.
+ */
+enum TN_MultiWaitObjType {
+   ///
+   /// Semaphore (`struct #TN_Sem`): wait to acquire it, just like
+   /// `tn_sem_wait()` does
+   TN_MULTI_WAIT_OBJ_SEM,
+   ///
+   /// Data queue (`struct #TN_DQueue`): wait to receive an item from it
+   TN_MULTI_WAIT_OBJ_DQUEUE,
+   ///
+   /// Fixed memory pool (`struct #TN_FMem`): wait to get a memory block
+   TN_MULTI_WAIT_OBJ_FMEM,
+   ///
+   /// Event group (`struct #TN_EventGrp`): wait for some condition of its
+   /// flags
+   TN_MULTI_WAIT_OBJ_EVENTGRP,
+};
+
+/**
+ * Multi-wait item: one of the objects to wait for by `tn_multi_wait()`.
+ *
+ * The user should fill the fields `obj_type` and `p_obj`, and, for the event
+ * group, `wait_pattern` and `wait_mode`. The fields `p_data` and
+ * `actual_pattern` contain the result when the item fires. The rest of the
+ * fields are for internal kernel usage.
+ */
+struct TN_MultiWaitItem {
+   ///
+   /// Type of the object to wait for
+   enum TN_MultiWaitObjType obj_type;
+   ///
+   /// Pointer to the object to wait for: `struct #TN_Sem`, `struct
+   /// #TN_DQueue`, `struct #TN_FMem` or `struct #TN_EventGrp`, depending on
+   /// `obj_type`.
+   void *p_obj;
+   ///
+   /// For event group only: pattern to wait for, just like the `wait_pattern`
+   /// argument of `tn_eventgrp_wait()`.
+   TN_UWord wait_pattern;
+   ///
+   /// For event group only: wait mode, just like the `wait_mode` argument of
+   /// `tn_eventgrp_wait()`.
+   enum TN_EGrpWaitMode wait_mode;
+
+   ///
+   /// Result for the data queue: the received item; for the memory pool: the
+   /// address of the memory block. Valid if only the item has fired with
+   /// `#TN_RC_OK`.
+   void *p_data;
+   ///
+   /// Result for the event group: the pattern that caused the item to fire,
+   /// just like the one stored to `p_flags_pattern` by `tn_eventgrp_wait()`.
+   /// Valid if only the item has fired with `#TN_RC_OK`.
+   TN_UWord actual_pattern;
+
+   ///
+   /// For internal kernel usage: list item to include the multi-wait item in
+   /// the object's list of multi-wait items
+   struct TN_ListItem wait_queue;
+   ///
+   /// For internal kernel usage: the task which waits
+   struct TN_Task *task;
+};
+
+/**
+ * Multi-wait-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_MultiWaitTaskWait {
+   ///
+   /// Array of items the task waits for
+   struct TN_MultiWaitItem *items;
+   ///
+   /// Number of items in the array
+   int items_cnt;
+   ///
+   /// Index of the item that has fired, or -1 if none
+   int fired_idx;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+#if TN_MULTI_WAIT || defined(DOXYGEN_ACTIVE)
+
+/**
+ * Wait for any of the objects specified by the array of `items` (see the
+ * file description of \ref tn_multi_wait.h for details).
+ *
+ * If some item can be satisfied immediately, the first such item is
+ * satisfied, and the function returns without waiting. Otherwise, behavior
+ * depends on the `timeout` value: refer to `#TN_TickCnt`.
+ *
+ * The index of the item that has fired is stored to `p_fired_idx`; the
+ * result of the item (if any) is stored to the item itself: see `p_data` and
+ * `actual_pattern` fields of `struct #TN_MultiWaitItem`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param items
+ *    Array of items to wait for
+ * @param items_cnt
+ *    Number of items in the array, should be more than 0
+ * @param p_fired_idx
+ *    Pointer to where the index of the fired item should be stored. If no
+ *    item has fired (say, timeout has expired), -1 is stored there.
+ * @param timeout
+ *    refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if some item has fired, its index is stored to
+ *      `p_fired_idx`;
+ *    * `#TN_RC_DELETED` if the object of some item was deleted while the
+ *      task was waiting, index of this item is stored to `p_fired_idx`;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If the item can't be checked (say, `wait_mode` of the event group
+ *      item is wrong), the error is returned just like the corresponding
+ *      polling service would return it, and the index of the item is stored
+ *      to `p_fired_idx`;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_multi_wait(
+      struct TN_MultiWaitItem *items,
+      int items_cnt,
+      int *p_fired_idx,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_multi_wait()` with zero timeout.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_multi_wait_polling(
+      struct TN_MultiWaitItem *items,
+      int items_cnt,
+      int *p_fired_idx
+      );
+
+/**
+ * The same as `tn_multi_wait()` with zero timeout, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_multi_iwait_polling(
+      struct TN_MultiWaitItem *items,
+      int items_cnt,
+      int *p_fired_idx
+      );
+
+#endif   // TN_MULTI_WAIT
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+
+#endif // _TN_MULTI_WAIT_H
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -46,6 +46,7 @@
 #include "_tn_mutex.h"
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_trace.h"
 
 //-- header of current module
 #include "tn_mutex.h"
@@ -114,7 +115,8 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
 _TN_STATIC_INLINE enum TN_RCode _check_param_create(
       const struct TN_Mutex        *mutex,
       enum TN_MutexProtocol   protocol,
-      int                     ceil_priority
+      int                     ceil_priority,
+      enum TN_WaitOrder       wait_order
       )
 {
    enum TN_RCode rc = TN_RC_OK;
@@ -136,6 +138,8 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
          )
    {
       rc = TN_RC_WPARAM;
+   } else if (!_tn_wait_order_is_valid(wait_order)){
+      rc = TN_RC_WPARAM;
    }
 
    return rc;
@@ -143,14 +147,18 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
 
 #else
 #  define _check_param_generic(mutex)                             (TN_RC_OK)
-#  define _check_param_create(mutex, protocol, ceil_priority)     (TN_RC_OK)
+#  define _check_param_create(mutex, protocol, ceil_priority, wait_order)   \
+      (TN_RC_OK)
 #endif
 // }}}
 
 
 /**
- * Iterate through all the tasks that wait for locked mutex,
- * checking if task's priority is higher than ref_priority.
+ * Find the highest priority among the tasks that wait for locked mutex,
+ * checking if it is higher than ref_priority.
+ *
+ * If the wait queue is ordered by priority, only the first task is checked;
+ * otherwise, we have to iterate through all the waiting tasks.
  *
  * Max priority (i.e. lowest value) is returned.
  */
@@ -161,15 +169,29 @@ _TN_STATIC_INLINE int _find_max_blocked_priority(struct TN_Mutex *mutex, int ref
 
    priority = ref_priority;
 
-   //-- Iterate through all the tasks that wait for lock mutex.
-   //   Highest priority (i.e. lowest number) will be returned eventually.
-   _tn_list_for_each_entry(
-         task, struct TN_Task, &(mutex->wait_queue), task_queue
-         )
-   {
-      if (task->priority < priority){
-         //--  task priority is higher, remember it
-         priority = task->priority;
+   if (mutex->wait_order == TN_WAIT_ORDER_PRIO){
+      //-- The first task in the queue has the highest priority
+      //   (see `_tn_task_wait_prio_insert()`)
+      if (!_tn_list_is_empty(&(mutex->wait_queue))){
+         task = _tn_list_first_entry(
+               &(mutex->wait_queue), struct TN_Task, task_queue
+               );
+
+         if (task->priority < priority){
+            priority = task->priority;
+         }
+      }
+   } else {
+      //-- Iterate through all the tasks that wait for lock mutex.
+      //   Highest priority (i.e. lowest number) will be returned eventually.
+      _tn_list_for_each_entry(
+            task, struct TN_Task, &(mutex->wait_queue), task_queue
+            )
+      {
+         if (task->priority < priority){
+            //--  task priority is higher, remember it
+            priority = task->priority;
+         }
       }
    }
 
@@ -282,7 +304,9 @@ in:
       _tn_change_running_task_priority(task, priority);
    } else {
       //-- Task is not runnable, so, just set new priority to it
-      task->priority = priority;
+      //   (if the task waits in the queue ordered by priority, it is moved
+      //   to the new place there)
+      _tn_change_task_priority(task, priority);
 
       //-- and check if the task is waiting for mutex
       if (     (_tn_task_is_waiting(task))
@@ -309,6 +333,140 @@ in:
 
 }
 
+//-- Lock-free fast paths (see TN_FAST_PATH) {{{
+#if _TN_FAST_PATH_ENABLED
+
+/**
+ * Fast path of locking the mutex: if it is free, the current task becomes
+ * its holder without disabling interrupts. The mutex isn't added to the
+ * task's `mutex_queue` then: instead, it is remembered as the task's
+ * `fast_mutex`, and `_fast_lock_convert()` moves it to the `mutex_queue` as
+ * soon as some other task has to wait for it. Since each task has just a
+ * single `fast_mutex`, the task which holds some mutex locked by the fast
+ * path always takes the usual path for others.
+ *
+ * Used for `#TN_MUTEX_PROT_INHERIT` mutexes only: locking the free
+ * `#TN_MUTEX_PROT_CEILING` mutex elevates priority of the task.
+ *
+ * @return `TN_TRUE` if the mutex is locked, `TN_FALSE` if the usual path
+ * should be taken.
+ */
+_TN_STATIC_INLINE TN_BOOL _mutex_lock_fast(struct TN_Mutex *mutex)
+{
+   struct TN_Task *task = _tn_curr_run_task;
+   volatile TN_UWord *p_holder = (volatile TN_UWord *)&mutex->holder;
+   TN_BOOL done = TN_FALSE;
+
+   if (     task->fast_mutex == TN_NULL
+         && mutex->protocol == TN_MUTEX_PROT_INHERIT
+      )
+   {
+      //-- set `fast_mutex` before the mutex is actually locked: if we're
+      //   preempted right after locking it, and some other task has to wait
+      //   for it, `_fast_lock_convert()` finds it there.
+      task->fast_mutex = mutex;
+
+      for (;;){
+         if (0
+               || _TN_EXCL_LOAD(p_holder) != (TN_UWord)TN_NULL
+               || !_tn_list_is_empty(&(mutex->wait_queue))
+               || _tn_trace_is_started()
+            )
+         {
+            _TN_EXCL_CLEAR();
+            task->fast_mutex = TN_NULL;
+            break;
+         } else if (_TN_EXCL_STORE(p_holder, (TN_UWord)task) == 0){
+            //-- nobody modifies lock count of the locked mutex but the
+            //   holder, so it's safe to do it now
+            __mutex_lock_cnt_change(mutex, 1);
+            done = TN_TRUE;
+            break;
+         }
+      }
+   }
+
+   return done;
+}
+
+/**
+ * Fast path of unlocking the mutex which is locked by the fast path (see
+ * `_mutex_lock_fast()`): if it isn't locked recursively, and nobody waits
+ * for it, it is unlocked without disabling interrupts.
+ *
+ * @return `TN_TRUE` if the mutex is unlocked, `TN_FALSE` if the usual path
+ * should be taken.
+ */
+_TN_STATIC_INLINE TN_BOOL _mutex_unlock_fast(struct TN_Mutex *mutex)
+{
+   struct TN_Task *task = _tn_curr_run_task;
+   volatile TN_UWord *p_holder = (volatile TN_UWord *)&mutex->holder;
+   TN_BOOL done = TN_FALSE;
+
+   //-- NOTE: lock count is 1 here if only recursive locking is enabled
+   //   (TN_MUTEX_REC), otherwise it's always 0.
+   if (task->fast_mutex == mutex && mutex->cnt <= 1){
+      //-- lock count of the free mutex is 0: decrement it before the mutex
+      //   is unlocked, since right after that it could be locked by some
+      //   other task.
+      __mutex_lock_cnt_change(mutex, -1);
+
+      for (;;){
+         if (0
+               || _TN_EXCL_LOAD(p_holder) != (TN_UWord)task
+               || task->fast_mutex != mutex
+               || !_tn_list_is_empty(&(mutex->wait_queue))
+               || _tn_trace_is_started()
+            )
+         {
+            //-- somebody waits for the mutex (so it has been moved to our
+            //   `mutex_queue` already), or trace is started
+            _TN_EXCL_CLEAR();
+            __mutex_lock_cnt_change(mutex, 1);
+            break;
+         } else if (_TN_EXCL_STORE(p_holder, (TN_UWord)TN_NULL) == 0){
+            task->fast_mutex = TN_NULL;
+            done = TN_TRUE;
+            break;
+         }
+      }
+   }
+
+   return done;
+}
+
+/**
+ * If the mutex is locked by the fast path (see `_mutex_lock_fast()`), move
+ * it to the holder's `mutex_queue`, so that from now on it is handled as
+ * any other locked mutex. Should be called before some task starts waiting
+ * for the mutex, and before the mutex is unlocked by the usual path.
+ *
+ * \attention Interrupts should be disabled.
+ */
+_TN_STATIC_INLINE void _fast_lock_convert(struct TN_Mutex *mutex)
+{
+   struct TN_Task *holder = mutex->holder;
+
+   //-- NOTE: `fast_mutex` is set just before the task tries to lock the
+   //   mutex by the fast path, so if the task has already locked it by the
+   //   usual path, the mutex is in its `mutex_queue`.
+   if (     holder != TN_NULL
+         && holder->fast_mutex == mutex
+         && _tn_list_is_empty(&(mutex->mutex_queue))
+      )
+   {
+      _tn_list_add_tail(&(holder->mutex_queue), &(mutex->mutex_queue));
+      holder->fast_mutex = TN_NULL;
+   }
+}
+
+#else
+#  define _mutex_lock_fast(mutex)         (TN_FALSE)
+#  define _mutex_unlock_fast(mutex)       (TN_FALSE)
+#  define _fast_lock_convert(mutex)       /* nothing */
+#endif
+// }}}
+
 _TN_STATIC_INLINE void _mutex_do_lock(struct TN_Mutex *mutex, struct TN_Task *task)
 {
    mutex->holder = task;
@@ -499,6 +657,10 @@ _TN_STATIC_INLINE void _add_curr_task_to_mutex_wait_queue(
 {
    enum TN_WaitReason wait_reason;
 
+   //-- if the mutex is locked by the fast path, move it to the holder's
+   //   locked mutexes queue, since we're going to wait for it
+   _fast_lock_convert(mutex);
+
    if (mutex->protocol == TN_MUTEX_PROT_INHERIT){
       //-- Priority inheritance protocol
 
@@ -513,7 +675,9 @@ _TN_STATIC_INLINE void _add_curr_task_to_mutex_wait_queue(
       wait_reason = TN_WAIT_REASON_MUTEX_C;
    }
 
-   _tn_task_curr_to_wait_action(&(mutex->wait_queue), wait_reason, timeout);
+   _tn_task_curr_to_wait_action_ord(
+         &(mutex->wait_queue), wait_reason, timeout, mutex->wait_order
+         );
 
    //-- check if there is deadlock
    _check_deadlock_active(mutex, _tn_curr_run_task);
@@ -539,8 +703,15 @@ static void _mutex_do_unlock(struct TN_Mutex * mutex)
    //   if mutex is unlocked because task is being deleted.
    mutex->cnt = 0;
 
-   //-- Delete curr mutex from task's locked mutexes queue
+   //-- if the mutex is locked by the fast path, move it to the holder's
+   //   locked mutexes queue first
+   _fast_lock_convert(mutex);
+
+   //-- Delete curr mutex from task's locked mutexes queue, and reset the
+   //   item, so that it's clear that the mutex isn't in any queue
+   //   (see `_fast_lock_convert()`)
    _tn_list_remove_entry(&(mutex->mutex_queue));
+   _tn_list_reset(&(mutex->mutex_queue));
 
    //-- update priority for current holder
    _update_task_priority(mutex->holder);
@@ -672,7 +843,24 @@ enum TN_RCode tn_mutex_create(
       int                     ceil_priority
       )
 {
-   enum TN_RCode rc = _check_param_create(mutex, protocol, ceil_priority);
+   return tn_mutex_create_wattr(
+         mutex, protocol, ceil_priority, TN_WAIT_ORDER_FIFO
+         );
+}
+
+/*
+ * See comments in the header file (tn_mutex.h)
+ */
+enum TN_RCode tn_mutex_create_wattr(
+      struct TN_Mutex        *mutex,
+      enum TN_MutexProtocol   protocol,
+      int                     ceil_priority,
+      enum TN_WaitOrder       wait_order
+      )
+{
+   enum TN_RCode rc = _check_param_create(
+         mutex, protocol, ceil_priority, wait_order
+         );
 
    if (rc != TN_RC_OK){
       //-- just return rc as it is
@@ -688,6 +876,7 @@ enum TN_RCode tn_mutex_create(
       mutex->holder        = TN_NULL;
       mutex->ceil_priority = ceil_priority;
       mutex->cnt           = 0;
+      mutex->wait_order    = wait_order;
       mutex->id_mutex      = TN_ID_MUTEX;
    }
 
@@ -755,6 +944,8 @@ enum TN_RCode tn_mutex_lock(struct TN_Mutex *mutex, TN_TickCnt timeout)
       //-- just return rc as it is
    } else if (!tn_is_task_context()){
       rc = TN_RC_WCONTEXT;
+   } else if (_mutex_lock_fast(mutex)){
+      //-- done without disabling interrupts, rc is TN_RC_OK
    } else {
       TN_INTSAVE_DATA;
 
@@ -804,6 +995,12 @@ enum TN_RCode tn_mutex_lock(struct TN_Mutex *mutex, TN_TickCnt timeout)
          }
       }
 
+      _tn_trace_put(
+            TN_TRACE_EV_MUTEX_LOCK,
+            waited_for_mutex ? TN_RC_TIMEOUT : rc,
+            (TN_UWord)mutex
+            );
+
 #if TN_DEBUG
       if (!_tn_need_context_switch() && waited_for_mutex){
          _TN_FATAL_ERROR("");
@@ -841,6 +1038,8 @@ enum TN_RCode tn_mutex_unlock(struct TN_Mutex *mutex)
       //-- just return rc as it is
    } else if (!tn_is_task_context()){
       rc = TN_RC_WCONTEXT;
+   } else if (_mutex_unlock_fast(mutex)){
+      //-- done without disabling interrupts, rc is TN_RC_OK
    } else {
       TN_INTSAVE_DATA;
 
@@ -869,6 +1068,8 @@ enum TN_RCode tn_mutex_unlock(struct TN_Mutex *mutex)
 
       }
 
+      _tn_trace_put(TN_TRACE_EV_MUTEX_UNLOCK, rc, (TN_UWord)mutex);
+
       TN_INT_RESTORE();
       _tn_context_switch_pend_if_needed();
    }
@@ -895,6 +1096,17 @@ void _tn_mutex_unlock_all_by_task(struct TN_Task *task)
                                  //   item is removed from the list
                                  //   in _mutex_do_unlock().
 
+#if _TN_FAST_PATH_ENABLED
+   //-- the task might hold the mutex locked by the fast path (or it might be
+   //   preempted in the middle of locking or unlocking it): if it holds the
+   //   mutex, move it to the task's locked mutexes queue, so that it is
+   //   unlocked below.
+   if (task->fast_mutex != TN_NULL){
+      _fast_lock_convert(task->fast_mutex);
+      task->fast_mutex = TN_NULL;
+   }
+#endif
+
    _tn_list_for_each_entry_safe(
          mutex, struct TN_Mutex, tmp_mutex, &(task->mutex_queue), mutex_queue
          )
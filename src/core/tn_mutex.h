@@ -150,6 +150,9 @@ struct TN_Mutex {
    ///
    /// Lock count (for recursive locking)
    int cnt;
+   ///
+   /// Order of tasks in `wait_queue`, see `tn_mutex_create_wattr()`
+   enum TN_WaitOrder wait_order;
 };
 
 /*******************************************************************************
@@ -168,6 +171,10 @@ struct TN_Mutex {
  * Construct the mutex. The field `id_mutex` should not contain `#TN_ID_MUTEX`, 
  * otherwise, `#TN_RC_WPARAM` is returned.
  *
+ * Waiting tasks are queued in FIFO order; for the priority inheritance
+ * protocol, it means that the highest priority among them is found by
+ * walking through all of them, see `tn_mutex_create_wattr()`.
+ *
  * $(TN_CALL_FROM_TASK)
  * $(TN_CALL_FROM_ISR)
  * $(TN_LEGEND_LINK)
@@ -192,6 +199,56 @@ enum TN_RCode tn_mutex_create(
       int                     ceil_priority
       );
 
+/**
+ * The same as `tn_mutex_create()`, but takes additional argument: the order
+ * of waiting tasks. `tn_mutex_create()` uses `#TN_WAIT_ORDER_FIFO`.
+ *
+ * With `#TN_WAIT_ORDER_PRIO`, the mutex is handed over to the
+ * highest-priority waiting task on unlock, and, for the priority inheritance
+ * protocol, the highest priority among waiting tasks is just the priority of
+ * the first task in the queue. So, recalculation of the holder's priority
+ * (when some task starts or stops waiting, or when the holder unlocks
+ * some other mutex) takes constant time per held mutex, instead of
+ * walking through all the waiting tasks. The price is that a task which
+ * starts waiting, or whose priority changes while waiting, is inserted into
+ * the queue by walking it from the tail.
+ *
+ * \attention This constant-time lookup applies to `#TN_WAIT_ORDER_PRIO`
+ * mutexes only. The mutex created by `tn_mutex_create()` (or with
+ * `#TN_WAIT_ORDER_FIFO`) doesn't cache the highest priority of its waiters,
+ * so each recalculation still walks all the tasks waiting for it: O(n) in
+ * the number of waiters, for each such mutex held by the task, and at each
+ * step of the inheritance chain which goes through it. If bounded
+ * recalculation time matters, create all the `#TN_MUTEX_PROT_INHERIT`
+ * mutexes of the chain with `#TN_WAIT_ORDER_PRIO`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param mutex
+ *    Pointer to already allocated `struct TN_Mutex`
+ * @param protocol
+ *    Mutex protocol: priority ceiling or priority inheritance.
+ *    See `enum #TN_MutexProtocol`.
+ * @param ceil_priority
+ *    Used if only `protocol` is `#TN_MUTEX_PROT_CEILING`: maximum priority
+ *    of the task that may lock the mutex.
+ * @param wait_order
+ *    Order in which waiting tasks get the mutex, see `enum #TN_WaitOrder`
+ *
+ * @return  
+ *    * `#TN_RC_OK` if mutex was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_mutex_create_wattr(
+      struct TN_Mutex        *mutex,
+      enum TN_MutexProtocol   protocol,
+      int                     ceil_priority,
+      enum TN_WaitOrder       wait_order
+      );
+
 /**
  * Destruct mutex.
  *
@@ -266,8 +323,9 @@ enum TN_RCode tn_mutex_lock_polling(struct TN_Mutex *mutex);
  *    * If mutex is already locked by calling task, lock count is decremented.
  *      Now, if lock count is zero, mutex gets unlocked (and if there are
  *      task(s) waiting for mutex, the first one from the wait queue locks the
- *      mutex).  Otherwise, mutex remains locked with lock count decremented
- *      and function returns `#TN_RC_OK`.
+ *      mutex; see `tn_mutex_create_wattr()` for the order of the queue).
+ *      Otherwise, mutex remains locked with lock count decremented and
+ *      function returns `#TN_RC_OK`.
  *
  * $(TN_CALL_FROM_TASK)
  * $(TN_CAN_SWITCH_CONTEXT)
@@ -0,0 +1,539 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+
+#include "tn_ring.h"
+#include "_tn_ring.h"
+
+#include "tn_tasks.h"
+
+//-- for memcpy()
+#include <string.h>
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_Ring *ring
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (ring == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_ring_is_valid(ring)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_Ring *ring,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (ring == TN_NULL || data_buf == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (item_size == 0 || items_cnt <= 0 || _tn_ring_is_valid(ring)){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_item(
+      const void *p_item
+      )
+{
+   return (p_item == TN_NULL) ? TN_RC_WPARAM : TN_RC_OK;
+}
+
+#else
+#  define _check_param_generic(ring)                                   \
+   (TN_RC_OK)
+#  define _check_param_create(ring, data_buf, item_size, items_cnt)    \
+   (TN_RC_OK)
+#  define _check_param_item(p_item)                                    \
+   (TN_RC_OK)
+#endif
+// }}}
+
+//-- Ring indexes processing {{{
+
+/**
+ * Returns number of used items in the ring, given the values of `head_idx`
+ * and `tail_idx`. Both of them take values from 0 to `(2 * items_cnt - 1)`,
+ * so, the difference is from 0 to `items_cnt`, once wrapped around.
+ */
+_TN_STATIC_INLINE int _used_items_cnt(
+      const struct TN_Ring *ring,
+      int head_idx,
+      int tail_idx
+      )
+{
+   int ret = head_idx - tail_idx;
+   if (ret < 0){
+      ret += (ring->items_cnt << 1);
+   }
+   return ret;
+}
+
+/**
+ * Returns pointer to the slot in `data_buf` for the given index (either
+ * `head_idx` or `tail_idx`).
+ */
+_TN_STATIC_INLINE unsigned char *_slot_ptr_get(
+      const struct TN_Ring *ring,
+      int idx
+      )
+{
+   if (idx >= ring->items_cnt){
+      idx -= ring->items_cnt;
+   }
+   return ring->data_buf + (idx * ring->item_size);
+}
+
+/**
+ * Returns the index next to the given one (either `head_idx` or
+ * `tail_idx`), wrapped around at `(2 * items_cnt)`.
+ */
+_TN_STATIC_INLINE int _idx_next(
+      const struct TN_Ring *ring,
+      int idx
+      )
+{
+   idx++;
+   if (idx >= (ring->items_cnt << 1)){
+      idx = 0;
+   }
+   return idx;
+}
+
+// }}}
+
+/**
+ * Producer side: try to copy the item to the ring, without disabling
+ * interrupts.
+ *
+ * If there is a room in the ring, item is copied, and `#TN_RC_OK` is
+ * returned; otherwise, `#TN_RC_TIMEOUT` is returned.
+ *
+ * @param ring
+ *    Ring buffer in which item should be written
+ * @param p_item
+ *    Pointer to the item to write (`item_size` bytes are copied)
+ * @param p_wakeup_needed
+ *    Pointer to the flag which is set to `TN_TRUE` if the consumer waits
+ *    for new items, so it should be woken up by the caller.
+ */
+static enum TN_RCode _ring_write(
+      struct TN_Ring *ring,
+      const void *p_item,
+      TN_BOOL *p_wakeup_needed
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   //-- `head_idx` is modified by the producer only, i.e. by us
+   int head_idx = ring->head_idx;
+
+   *p_wakeup_needed = TN_FALSE;
+
+   if (_used_items_cnt(ring, head_idx, ring->tail_idx) >= ring->items_cnt){
+      //-- no space for new item
+      rc = TN_RC_TIMEOUT;
+   } else {
+      //-- make sure the slot is released by the consumer (`tail_idx` is
+      //   read) before we overwrite it
+      _TN_MEMORY_BARRIER();
+
+      //-- write item
+      memcpy(_slot_ptr_get(ring, head_idx), p_item, ring->item_size);
+
+      //-- make sure the item is written before it is published
+      _TN_MEMORY_BARRIER();
+
+      ring->head_idx = _idx_next(ring, head_idx);
+
+      //-- make sure the new `head_idx` is stored before the
+      //   `consumer_waiting` flag is loaded: the consumer sets the flag and
+      //   then re-checks `head_idx`, so, at least one of us sees the other's
+      //   store, and the wakeup can't be missed.
+      _TN_MEMORY_BARRIER();
+
+      *p_wakeup_needed = ring->consumer_waiting;
+   }
+
+   return rc;
+}
+
+/**
+ * Consumer side: try to copy the item from the ring, without disabling
+ * interrupts.
+ *
+ * If there is some item in the ring, it is copied, and `#TN_RC_OK` is
+ * returned; otherwise, `#TN_RC_TIMEOUT` is returned.
+ *
+ * @param ring
+ *    Ring buffer from which item should be read
+ * @param p_item
+ *    Pointer to the location at which the item should be copied
+ */
+static enum TN_RCode _ring_read(struct TN_Ring *ring, void *p_item)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   //-- `tail_idx` is modified by the consumer only, i.e. by us
+   int tail_idx = ring->tail_idx;
+
+   if (ring->head_idx == tail_idx){
+      //-- nothing to read
+      rc = TN_RC_TIMEOUT;
+   } else {
+      //-- make sure `head_idx` is read before the item
+      _TN_MEMORY_BARRIER();
+
+      //-- read item
+      memcpy(p_item, _slot_ptr_get(ring, tail_idx), ring->item_size);
+
+      //-- make sure the item is read before the slot is released
+      _TN_MEMORY_BARRIER();
+
+      ring->tail_idx = _idx_next(ring, tail_idx);
+   }
+
+   return rc;
+}
+
+/**
+ * Should be called with interrupts disabled. If the consumer is still
+ * waiting, wake it up.
+ */
+static void _consumer_wakeup(struct TN_Ring *ring)
+{
+   if (ring->consumer_waiting){
+      ring->consumer_waiting = TN_FALSE;
+
+      //-- the consumer will read the item by itself, so, no callback
+      _tn_task_first_wait_complete(
+            &ring->wait_receive_list, TN_RC_OK,
+            TN_NULL, TN_NULL, TN_NULL
+            );
+   }
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_create(
+      struct TN_Ring *ring,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_create(ring, data_buf, item_size, items_cnt);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      _tn_list_reset(&(ring->wait_receive_list));
+
+      ring->data_buf          = (unsigned char *)data_buf;
+      ring->item_size         = item_size;
+      ring->items_cnt         = items_cnt;
+
+      ring->head_idx          = 0;
+      ring->tail_idx          = 0;
+      ring->consumer_waiting  = TN_FALSE;
+
+      ring->id_ring = TN_ID_RING;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_delete(struct TN_Ring *ring)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_generic(ring);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- notify waiting task that the object is deleted
+      //   (TN_RC_DELETED is returned)
+      _tn_wait_queue_notify_deleted(&(ring->wait_receive_list));
+      ring->consumer_waiting = TN_FALSE;
+
+      ring->id_ring = TN_ID_NONE; //-- ring buffer does not exist now
+
+      TN_INT_RESTORE();
+
+      //-- we might need to switch context if _tn_wait_queue_notify_deleted()
+      //   has woken up some high-priority task
+      _tn_context_switch_pend_if_needed();
+
+   }
+
+   return rc;
+
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_write(
+      struct TN_Ring *ring,
+      const void *p_item
+      )
+{
+   TN_BOOL wakeup_needed = TN_FALSE;
+   enum TN_RCode rc = _check_param_generic(ring);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_item(p_item)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      rc = _ring_write(ring, p_item, &wakeup_needed);
+
+      if (wakeup_needed){
+         //-- the consumer waits for new items: this is the only case when
+         //   we need to enter the kernel
+         TN_INTSAVE_DATA;
+
+         TN_INT_DIS_SAVE();
+         _consumer_wakeup(ring);
+         TN_INT_RESTORE();
+
+         _tn_context_switch_pend_if_needed();
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_iwrite(
+      struct TN_Ring *ring,
+      const void *p_item
+      )
+{
+   TN_BOOL wakeup_needed = TN_FALSE;
+   enum TN_RCode rc = _check_param_generic(ring);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_item(p_item)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      rc = _ring_write(ring, p_item, &wakeup_needed);
+
+      if (wakeup_needed){
+         //-- the consumer waits for new items: this is the only case when
+         //   we need to enter the kernel
+         TN_INTSAVE_DATA_INT;
+
+         TN_INT_IDIS_SAVE();
+         _consumer_wakeup(ring);
+         TN_INT_IRESTORE();
+
+         _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_read(
+      struct TN_Ring *ring,
+      void *p_item,
+      TN_TickCnt timeout
+      )
+{
+   enum TN_RCode rc = _check_param_generic(ring);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if ((rc = _check_param_item(p_item)) != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      //-- try to read the item without entering the kernel
+      rc = _ring_read(ring, p_item);
+
+      if (rc == TN_RC_TIMEOUT && timeout != 0){
+         //-- The ring is empty right now, and user asked to wait if that
+         //   happens.
+         TN_BOOL waited = TN_FALSE;
+         TN_INTSAVE_DATA;
+
+         TN_INT_DIS_SAVE();
+
+         //-- Raise the flag, and then check the ring again: the producer
+         //   might have written new item after we've found the ring empty,
+         //   but before the flag is raised. In this case, the producer
+         //   doesn't wake us up, so we must not wait.
+         ring->consumer_waiting = TN_TRUE;
+         _TN_MEMORY_BARRIER();
+
+         if (ring->head_idx == ring->tail_idx){
+            _tn_task_curr_to_wait_action(
+                  &(ring->wait_receive_list),
+                  TN_WAIT_REASON_RING_WRECEIVE,
+                  timeout
+                  );
+
+            waited = TN_TRUE;
+         } else {
+            ring->consumer_waiting = TN_FALSE;
+         }
+
+#if TN_DEBUG
+         if (!_tn_need_context_switch() && waited){
+            _TN_FATAL_ERROR("");
+         }
+#endif
+
+         TN_INT_RESTORE();
+         _tn_context_switch_pend_if_needed();
+
+         rc = waited ? _tn_curr_run_task->task_wait_rc : TN_RC_OK;
+
+         if (rc == TN_RC_OK){
+            //-- there is an item in the ring for sure, since we're the only
+            //   consumer
+            rc = _ring_read(ring, p_item);
+            if (rc != TN_RC_OK){
+               _TN_FATAL_ERROR("rc should always be TN_RC_OK here");
+            }
+         } else {
+            //-- we haven't been woken up by the producer (timeout, etc),
+            //   so, the flag might still be set; clear it so that the
+            //   producer doesn't enter the kernel needlessly.
+            ring->consumer_waiting = TN_FALSE;
+         }
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_read_polling(struct TN_Ring *ring, void *p_item)
+{
+   return tn_ring_read(ring, p_item, 0);
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+int tn_ring_used_items_cnt_get(
+      struct TN_Ring      *ring
+      )
+{
+   int ret = -1;
+   enum TN_RCode rc = _check_param_generic(ring);
+
+   if (rc == TN_RC_OK){
+      //-- It's not needed to disable interrupts here, since both indexes
+      //   are read by just one assembler instruction each; the result
+      //   might be out of date immediately anyway.
+      ret = _used_items_cnt(ring, ring->head_idx, ring->tail_idx);
+   }
+
+   return ret;
+}
+
@@ -0,0 +1,378 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * A ring buffer is a lock-free FIFO of fixed-size items with a single
+ * producer and a single consumer (SPSC), intended for streaming data from an
+ * ISR to a task (say, samples from ADC), when even the short critical
+ * sections of the \ref tn_mqueue.h "message queue" add unwanted interrupt
+ * latency.
+ *
+ * The producer (typically an ISR) writes items to the ring without disabling
+ * interrupts: the item is copied to the free slot, and then the index of the
+ * next slot to write is updated. Only the producer modifies this index, and
+ * only the consumer modifies the index of the next slot to read, so no lock
+ * is needed; the ordering of these accesses is ensured by the memory
+ * barriers.
+ *
+ * The consumer task reads items from the ring without disabling interrupts
+ * as well, as long as the ring is not empty. When it becomes empty, and the
+ * consumer wants to wait for new items, it raises the "consumer is waiting"
+ * flag and goes to sleep (this is done in the critical section). The
+ * producer checks the flag after each item is written, and enters the kernel
+ * to wake the consumer up if only the flag is set. So the wakeup is
+ * edge-triggered: the producer interacts with the kernel once per transition
+ * of the ring from empty to non-empty while the consumer is waiting, not for
+ * each item.
+ *
+ * Restrictions:
+ *
+ * - There must be at most one producer and at most one consumer. Several
+ *   ISRs, or several tasks, must not write to the same ring; the same holds
+ *   for reading. If you need several writers or readers, use the
+ *   \ref tn_mqueue.h "message queue".
+ * - Producer ISR must be a kernel-aware one (just like for any other kernel
+ *   service), since it might need to wake the consumer up.
+ * - The producer never waits: if the ring is full, the item is not written,
+ *   and `#TN_RC_TIMEOUT` is returned.
+ * - Ring buffer can't be connected to the event group, since it would
+ *   require the producer to enter the kernel for each item.
+ */
+
+#ifndef _TN_RING_H
+#define _TN_RING_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Structure representing SPSC ring buffer object
+ */
+struct TN_Ring {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_ring;
+   ///
+   /// list of tasks waiting to read data (there may be at most one task)
+   struct TN_ListItem  wait_receive_list;
+
+   ///
+   /// buffer to store items, its size should be `(item_size * items_cnt)`
+   /// bytes.
+   unsigned char *data_buf;
+   ///
+   /// size of each item (in bytes)
+   unsigned int   item_size;
+   ///
+   /// capacity (total items count)
+   int            items_cnt;
+   ///
+   /// index of the item which will be written next time. Modified by the
+   /// producer only. Takes values from 0 to `(2 * items_cnt - 1)`, so that
+   /// full ring can be distinguished from the empty one without wasting a
+   /// slot: the actual slot is `(head_idx % items_cnt)`.
+   volatile int   head_idx;
+   ///
+   /// index of the item which will be read next time. Modified by the
+   /// consumer only. Takes values from 0 to `(2 * items_cnt - 1)`, just
+   /// like `head_idx`.
+   volatile int   tail_idx;
+   ///
+   /// flag indicating that the consumer is about to wait or is waiting for
+   /// new items. Set by the consumer, cleared by the producer when it wakes
+   /// the consumer up.
+   volatile TN_BOOL consumer_waiting;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Convenience macro for the definition of buffer for ring buffer. See
+ * `tn_ring_create()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_ring_create()` function as the `data_buf` argument)
+ * @param item_type
+ *    Type of item in the ring buffer, like `unsigned short`.
+ * @param size
+ *    Number of items in the ring buffer.
+ */
+#define TN_RING_BUF_DEF(name, item_type, size)                    \
+   TN_UWord name[                                                 \
+        (size)                                                    \
+      * (TN_MAKE_ALIG_SIZE(sizeof(item_type)) / sizeof(TN_UWord)) \
+      ]
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct ring buffer. `id_ring` member should not contain
+ * `#TN_ID_RING`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * For the definition of buffer, convenience macro `TN_RING_BUF_DEF()` is
+ * available. Typical definition looks as follows:
+ *
+ * \code{.c}
+ *     //-- number of items in the ring
+ *     #define MY_RING_SIZE    64
+ *
+ *     //-- type of ring item
+ *     struct MySample {
+ *        // ... arbitrary fields ...
+ *     };
+ *     
+ *     //-- define buffer for ring
+ *     TN_RING_BUF_DEF(my_ring_buf, struct MySample, MY_RING_SIZE);
+ *
+ *     //-- define ring structure
+ *     struct TN_Ring my_ring;
+ * \endcode
+ *
+ * And then, construct your `my_ring` as follows:
+ *
+ * \code{.c}
+ *     enum TN_RCode rc;
+ *     rc = tn_ring_create( &my_ring,
+ *                          my_ring_buf,
+ *                          TN_MAKE_ALIG_SIZE(sizeof(struct MySample)),
+ *                          MY_RING_SIZE
+ *                        );
+ *     if (rc != TN_RC_OK){
+ *        //-- handle error
+ *     }
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring       pointer to already allocated `struct TN_Ring`.
+ * @param data_buf   pointer to already allocated buffer to store items,
+ *                   its size should be at least `(item_size * items_cnt)`
+ *                   bytes.
+ * @param item_size  size of each item, in bytes. Must be non-zero.
+ * @param items_cnt  capacity of the ring (count of items that `data_buf` can
+ *                   hold). Must be non-zero.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if ring was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_ring_create(
+      struct TN_Ring *ring,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt
+      );
+
+
+/**
+ * Destruct ring buffer.
+ *
+ * The task that waits for reading from the ring (if any) becomes runnable
+ * with `#TN_RC_DELETED` code returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring       pointer to ring buffer to be deleted
+ *
+ * @return 
+ *    * `#TN_RC_OK` if ring was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_ring_delete(struct TN_Ring *ring);
+
+
+/**
+ * Write the item pointed to by `p_item` to the ring buffer specified by the
+ * `ring`: `item_size` bytes are copied from `p_item`. Interrupts are not
+ * disabled, unless the consumer task waits for new items: in this case,
+ * it is woken up.
+ *
+ * Should be called by the single producer task only.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring       pointer to ring buffer to write item to
+ * @param p_item     pointer to the item to write
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if item was successfully written;
+ *    * `#TN_RC_TIMEOUT` if the ring is full;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_ring_write(
+      struct TN_Ring *ring,
+      const void *p_item
+      );
+
+/**
+ * The same as `tn_ring_write()`, but for using in the ISR. Should be called
+ * by the single producer ISR only.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_ring_iwrite(
+      struct TN_Ring *ring,
+      const void *p_item
+      );
+
+/**
+ * Read the item from the ring buffer specified by the `ring` and copy it to
+ * the location specified by the `p_item` (`item_size` bytes are written
+ * there). Interrupts are not disabled, unless the ring is empty and the
+ * task is going to wait.
+ *
+ * If the ring is empty, behavior depends on the `timeout` value: refer to
+ * `#TN_TickCnt`.
+ *
+ * Should be called by the single consumer task only.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring       pointer to ring buffer to read item from
+ * @param p_item     pointer to location to store the item
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if item was successfully read;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_ring_read(
+      struct TN_Ring *ring,
+      void *p_item,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_ring_read()` with zero timeout
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_ring_read_polling(
+      struct TN_Ring *ring,
+      void *p_item
+      );
+
+/**
+ * Returns number of used (non-free) items in the ring. Note that the value
+ * may be out of date immediately, since the producer and the consumer don't
+ * lock the ring.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring
+ *    Pointer to ring buffer.
+ *
+ * @return
+ *    Number of used (non-free) items in the ring, or -1 if wrong params were
+ *    given (the check is performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_ring_used_items_cnt_get(
+      struct TN_Ring      *ring
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_RING_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
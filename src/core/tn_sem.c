@@ -46,6 +46,8 @@
 //-- internal tnkernel headers
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_multi_wait.h"
+#include "_tn_trace.h"
 
 
 //-- header of current module
@@ -84,7 +86,8 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
 _TN_STATIC_INLINE enum TN_RCode _check_param_create(
       const struct TN_Sem *sem,
       int start_count,
-      int max_count
+      int max_count,
+      enum TN_WaitOrder wait_order
       )
 {
    enum TN_RCode rc = TN_RC_OK;
@@ -96,6 +99,7 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
          || max_count <= 0
          || start_count < 0
          || start_count > max_count
+         || !_tn_wait_order_is_valid(wait_order)
          )
    {
       rc = TN_RC_WPARAM;
@@ -106,7 +110,96 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
 
 #else
 #  define _check_param_generic(sem)                            (TN_RC_OK)
-#  define _check_param_create(sem, start_count, max_count)     (TN_RC_OK)
+#  define _check_param_create(sem, start_count, max_count, wait_order)   \
+   (TN_RC_OK)
+#endif
+// }}}
+
+
+//-- Lock-free fast paths (see TN_FAST_PATH) {{{
+#if _TN_FAST_PATH_ENABLED
+
+/**
+ * Fast path of signalling the semaphore: if nobody waits for it and its
+ * count is below the maximum, the count is incremented without disabling
+ * interrupts.
+ *
+ * Wait queues are checked between the exclusive load and store of the
+ * count: if anything has happened in between (say, some task has started
+ * waiting), the store fails, and we just try again.
+ *
+ * @return `TN_TRUE` if the semaphore is signalled, `TN_FALSE` if the usual
+ * path should be taken.
+ */
+_TN_STATIC_INLINE TN_BOOL _sem_signal_fast(struct TN_Sem *sem)
+{
+   volatile int *p_count = &sem->count;
+   TN_BOOL done;
+
+   for (;;){
+      int count = (int)_TN_EXCL_LOAD(p_count);
+
+      if (0
+            || count >= sem->max_count
+            || !_tn_list_is_empty(&sem->wait_queue)
+            || !_tn_multi_wait_list_is_empty(&sem->multi_wait_list)
+            || _tn_trace_is_started()
+         )
+      {
+         _TN_EXCL_CLEAR();
+         done = TN_FALSE;
+         break;
+      } else if (_TN_EXCL_STORE(p_count, (TN_UWord)(count + 1)) == 0){
+         done = TN_TRUE;
+         break;
+      }
+   }
+
+   return done;
+}
+
+/**
+ * Fast path of polling the semaphore: if its count is non-zero (so, nobody
+ * waits for it), the count is decremented without disabling interrupts.
+ *
+ * @return `TN_TRUE` if the semaphore is acquired, `TN_FALSE` if the usual
+ * path should be taken.
+ */
+_TN_STATIC_INLINE TN_BOOL _sem_wait_fast(struct TN_Sem *sem)
+{
+   volatile int *p_count = &sem->count;
+   TN_BOOL done;
+
+   for (;;){
+      int count = (int)_TN_EXCL_LOAD(p_count);
+
+      if (count <= 0 || _tn_trace_is_started()){
+         _TN_EXCL_CLEAR();
+         done = TN_FALSE;
+         break;
+      } else if (_TN_EXCL_STORE(p_count, (TN_UWord)(count - 1)) == 0){
+         done = TN_TRUE;
+         break;
+      }
+   }
+
+   return done;
+}
+
+#else
+
+_TN_STATIC_INLINE TN_BOOL _sem_signal_fast(struct TN_Sem *sem)
+{
+   _TN_UNUSED(sem);
+   return TN_FALSE;
+}
+
+_TN_STATIC_INLINE TN_BOOL _sem_wait_fast(struct TN_Sem *sem)
+{
+   _TN_UNUSED(sem);
+   return TN_FALSE;
+}
+
 #endif
 // }}}
 
@@ -116,11 +209,14 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
  *
  * @param sem        semaphore to perform job on
  * @param p_worker   pointer to actual worker function
+ * @param p_fast     pointer to lock-free fast path of the worker, which
+ *                   returns `TN_FALSE` if `p_worker` should be called
  * @param timeout    see `#TN_TickCnt`
  */
 _TN_STATIC_INLINE enum TN_RCode _sem_job_perform(
       struct TN_Sem *sem,
       enum TN_RCode (p_worker)(struct TN_Sem *sem),
+      TN_BOOL (p_fast)(struct TN_Sem *sem),
       TN_TickCnt timeout
       )
 {
@@ -131,6 +227,8 @@ _TN_STATIC_INLINE enum TN_RCode _sem_job_perform(
       //-- just return rc as it is
    } else if (!tn_is_task_context()){
       rc = TN_RC_WCONTEXT;
+   } else if (p_fast(sem)){
+      //-- done without disabling interrupts, rc is TN_RC_OK
    } else {
       TN_INTSAVE_DATA;
 
@@ -139,8 +237,9 @@ _TN_STATIC_INLINE enum TN_RCode _sem_job_perform(
 
       //-- if we should wait, put current task to wait
       if (rc == TN_RC_TIMEOUT && timeout != 0){
-         _tn_task_curr_to_wait_action(
-               &(sem->wait_queue), TN_WAIT_REASON_SEM, timeout
+         _tn_task_curr_to_wait_action_ord(
+               &(sem->wait_queue), TN_WAIT_REASON_SEM, timeout,
+               sem->wait_order
                );
 
          //-- rc will be set later thanks to waited_for_sem
@@ -170,10 +269,13 @@ _TN_STATIC_INLINE enum TN_RCode _sem_job_perform(
  *
  * @param sem        semaphore to perform job on
  * @param p_worker   pointer to actual worker function
+ * @param p_fast     pointer to lock-free fast path of the worker, which
+ *                   returns `TN_FALSE` if `p_worker` should be called
  */
 _TN_STATIC_INLINE enum TN_RCode _sem_job_iperform(
       struct TN_Sem *sem,
-      enum TN_RCode (p_worker)(struct TN_Sem *sem)
+      enum TN_RCode (p_worker)(struct TN_Sem *sem),
+      TN_BOOL (p_fast)(struct TN_Sem *sem)
       )
 {
    enum TN_RCode rc = _check_param_generic(sem);
@@ -183,6 +285,8 @@ _TN_STATIC_INLINE enum TN_RCode _sem_job_iperform(
       //-- just return rc as it is
    } else if (!tn_is_isr_context()){
       rc = TN_RC_WCONTEXT;
+   } else if (p_fast(sem)){
+      //-- done without disabling interrupts, rc is TN_RC_OK
    } else {
       TN_INTSAVE_DATA_INT;
 
@@ -198,11 +302,14 @@ _TN_STATIC_INLINE enum TN_RCode _sem_signal(struct TN_Sem *sem)
 {
    enum TN_RCode rc = TN_RC_OK;
 
-   //-- wake up first (if any) task from the semaphore wait queue
+   //-- wake up first (if any) task from the semaphore wait queue;
+   //   if there are no such tasks, wake up the first multi-waiting task
+   //   (if any)
    if (  !_tn_task_first_wait_complete(
             &sem->wait_queue, TN_RC_OK,
             TN_NULL, TN_NULL, TN_NULL
             )
+      && !_tn_multi_wait_first_complete(&sem->multi_wait_list, TN_NULL)
       )
    {
       //-- no tasks are waiting for that semaphore,
@@ -214,6 +321,8 @@ _TN_STATIC_INLINE enum TN_RCode _sem_signal(struct TN_Sem *sem)
       }
    }
 
+   _tn_trace_put(TN_TRACE_EV_SEM_SIGNAL, rc, (TN_UWord)sem);
+
    return rc;
 }
 
@@ -230,6 +339,8 @@ _TN_STATIC_INLINE enum TN_RCode _sem_wait(struct TN_Sem *sem)
       rc = TN_RC_TIMEOUT;
    }
 
+   _tn_trace_put(TN_TRACE_EV_SEM_WAIT, rc, (TN_UWord)sem);
+
    return rc;
 }
 
@@ -249,18 +360,37 @@ enum TN_RCode tn_sem_create(
       int start_count,
       int max_count
       )
+{
+   return tn_sem_create_wattr(
+         sem, start_count, max_count, TN_WAIT_ORDER_FIFO
+         );
+}
+
+/*
+ * See comments in the header file (tn_sem.h)
+ */
+enum TN_RCode tn_sem_create_wattr(
+      struct TN_Sem *sem,
+      int start_count,
+      int max_count,
+      enum TN_WaitOrder wait_order
+      )
 {
    //-- perform additional params checking (if enabled by TN_CHECK_PARAM)
-   enum TN_RCode rc = _check_param_create(sem, start_count, max_count);
+   enum TN_RCode rc = _check_param_create(
+         sem, start_count, max_count, wait_order
+         );
 
    if (rc != TN_RC_OK){
       //-- just return rc as it is
    } else {
 
       _tn_list_reset(&(sem->wait_queue));
+      _tn_multi_wait_list_reset(&(sem->multi_wait_list));
 
       sem->count     = start_count;
       sem->max_count = max_count;
+      sem->wait_order = wait_order;
       sem->id_sem    = TN_ID_SEMAPHORE;
 
    }
@@ -286,6 +416,7 @@ enum TN_RCode tn_sem_delete(struct TN_Sem * sem)
 
       //-- Remove all tasks from wait queue, returning the TN_RC_DELETED code.
       _tn_wait_queue_notify_deleted(&(sem->wait_queue));
+      _tn_multi_wait_notify_deleted(&(sem->multi_wait_list));
 
       sem->id_sem = TN_ID_NONE;        //-- Semaphore does not exist now
       TN_INT_RESTORE();
@@ -302,7 +433,7 @@ enum TN_RCode tn_sem_delete(struct TN_Sem * sem)
  */
 enum TN_RCode tn_sem_signal(struct TN_Sem *sem)
 {
-   return _sem_job_perform(sem, _sem_signal, 0);
+   return _sem_job_perform(sem, _sem_signal, _sem_signal_fast, 0);
 }
 
 /*
@@ -310,7 +441,7 @@ enum TN_RCode tn_sem_signal(struct TN_Sem *sem)
  */
 enum TN_RCode tn_sem_isignal(struct TN_Sem *sem)
 {
-   return _sem_job_iperform(sem, _sem_signal);
+   return _sem_job_iperform(sem, _sem_signal, _sem_signal_fast);
 }
 
 /*
@@ -318,7 +449,7 @@ enum TN_RCode tn_sem_isignal(struct TN_Sem *sem)
  */
 enum TN_RCode tn_sem_wait(struct TN_Sem *sem, TN_TickCnt timeout)
 {
-   return _sem_job_perform(sem, _sem_wait, timeout);
+   return _sem_job_perform(sem, _sem_wait, _sem_wait_fast, timeout);
 }
 
 /*
@@ -326,7 +457,7 @@ enum TN_RCode tn_sem_wait(struct TN_Sem *sem, TN_TickCnt timeout)
  */
 enum TN_RCode tn_sem_wait_polling(struct TN_Sem *sem)
 {
-   return _sem_job_perform(sem, _sem_wait, 0);
+   return _sem_job_perform(sem, _sem_wait, _sem_wait_fast, 0);
 }
 
 /*
@@ -334,7 +465,26 @@ enum TN_RCode tn_sem_wait_polling(struct TN_Sem *sem)
  */
 enum TN_RCode tn_sem_iwait_polling(struct TN_Sem *sem)
 {
-   return _sem_job_iperform(sem, _sem_wait);
+   return _sem_job_iperform(sem, _sem_wait, _sem_wait_fast);
 }
 
 
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+#if TN_MULTI_WAIT
+
+/*
+ * See comments in the file _tn_sem.h
+ */
+enum TN_RCode _tn_sem_try_wait(struct TN_Sem *sem)
+{
+   return _sem_wait(sem);
+}
+
+#endif
+
+
@@ -100,6 +100,17 @@ struct TN_Sem {
    ///
    /// Max value of `count`
    int max_count;
+   ///
+   /// Order of tasks in `wait_queue`, see `tn_sem_create_wattr()`
+   enum TN_WaitOrder wait_order;
+
+#if TN_MULTI_WAIT || defined(DOXYGEN_ACTIVE)
+   ///
+   /// List of multi-wait items that wait for the semaphore (see
+   /// \ref tn_multi_wait.h), available if only `#TN_MULTI_WAIT` option is
+   /// non-zero.
+   struct TN_ListItem multi_wait_list;
+#endif
 };
 
 
@@ -141,6 +152,36 @@ enum TN_RCode tn_sem_create(
       int max_count
       );
 
+/**
+ * The same as `tn_sem_create()`, but takes additional argument: the order
+ * of waiting tasks. `tn_sem_create()` uses `#TN_WAIT_ORDER_FIFO`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param sem
+ *    Pointer to already allocated `struct TN_Sem`
+ * @param start_count
+ *    Initial counter value, typically it is equal to `max_count`
+ * @param max_count
+ *    Maximum counter value.
+ * @param wait_order
+ *    Order in which waiting tasks get the semaphore, see
+ *    `enum #TN_WaitOrder`
+ *
+ * @return 
+ *    * `#TN_RC_OK` if semaphore was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_sem_create_wattr(
+      struct TN_Sem *sem,
+      int start_count,
+      int max_count,
+      enum TN_WaitOrder wait_order
+      );
+
 /**
  * Destruct the semaphore.
  *
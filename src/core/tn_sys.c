@@ -54,6 +54,7 @@
 #include "_tn_timer.h"
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_trace.h"
 
 
 #include "tn_tasks.h"
@@ -70,8 +71,27 @@
 #endif
 
 //-- check TN_PRIORITIES_CNT
-#if (TN_PRIORITIES_CNT > TN_PRIORITIES_MAX_CNT)
-#  error TN_PRIORITIES_CNT is too large (maximum is TN_PRIORITIES_MAX_CNT)
+#if TN_PRIORITIES_2LEVEL_BMP
+#  if (TN_PRIORITIES_CNT > (TN_PRIORITIES_MAX_CNT * TN_INT_WIDTH))
+#     error TN_PRIORITIES_CNT is too large (maximum is TN_PRIORITIES_MAX_CNT * TN_INT_WIDTH)
+#  endif
+#else
+#  if (TN_PRIORITIES_CNT > TN_PRIORITIES_MAX_CNT)
+#     error TN_PRIORITIES_CNT is too large (maximum is TN_PRIORITIES_MAX_CNT)
+#  endif
+#endif
+
+//-- check that cycle counter is available if needed
+#if TN_PROFILER && TN_PROFILER_CYCLES && !defined(_TN_CYCLE_CNT_GET)
+#  error TN_PROFILER_CYCLES is not supported by current architecture
+#endif
+
+#if TN_INT_DIS_MEASURE && !defined(_TN_CYCLE_CNT_GET)
+#  error TN_INT_DIS_MEASURE is not supported by current architecture
+#endif
+
+#if TN_TICK_INT_MEASURE && !defined(_TN_CYCLE_CNT_GET)
+#  error TN_TICK_INT_MEASURE is not supported by current architecture
 #endif
 
 
@@ -102,8 +122,16 @@ struct TN_Task *_tn_next_task_to_run;
 // See comments in the internal/_tn_sys.h file
 struct TN_Task *_tn_curr_run_task;
 
+#if TN_PRIORITIES_2LEVEL_BMP
+// See comments in the internal/_tn_sys.h file
+volatile TN_UWord _tn_ready_to_run_bmp[ _TN_READY_BMP_GROUPS_CNT ];
+
+// See comments in the internal/_tn_sys.h file
+volatile TN_UWord _tn_ready_to_run_grp_bmp;
+#else
 // See comments in the internal/_tn_sys.h file
-volatile unsigned int _tn_ready_to_run_bmp;
+volatile TN_UWord _tn_ready_to_run_bmp;
+#endif
 
 // See comments in the internal/_tn_sys.h file
 struct TN_Task _tn_idle_task;
@@ -144,6 +172,43 @@ unsigned short _tn_tslice_ticks[TN_PRIORITIES_CNT];
 int _tn_deadlocks_cnt = 0;
 #endif
 
+#if TN_TICK_INT_MEASURE
+/// Maximum number of cycles spent in `tn_tick_int_processing()`
+volatile TN_UWord _tn_tick_int_max_cycles = 0;
+#endif
+
+#if TN_DYNAMIC_TICK
+/// Internal timer which drives round-robin, see `_tn_round_robin_update()`
+struct TN_Timer _tn_tslice_timer;
+
+/// Task for which `_tn_tslice_timer` is currently started, or `TN_NULL`
+/// if it isn't started
+struct TN_Task *_tn_tslice_task = TN_NULL;
+#endif
+
+#if TN_PROFILER && TN_PROFILER_CYCLES
+/// Nesting count of interrupts marked by `tn_sys_profiler_isr_enter()` /
+/// `tn_sys_profiler_isr_exit()` (including `tn_tick_int_processing()`)
+int _tn_profiler_isr_nest = 0;
+#endif
+
+#if TN_INT_DIS_MEASURE
+/// List of functions whose critical sections were measured
+/// (see `#TN_INT_DIS_MEASURE`)
+static struct TN_IntDisSite *volatile _tn_int_dis_sites = TN_NULL;
+
+/// Function with the longest critical section
+static struct TN_IntDisSite *volatile _tn_int_dis_worst = TN_NULL;
+
+/// Value of the cycle counter at the beginning of the current outermost
+/// critical section. Since interrupts are disabled until it ends, there
+/// may be just one such section at a time.
+static TN_UWord _tn_int_dis_start_cycles = 0;
+
+/// Whether `_tn_int_dis_start_cycles` is valid
+static TN_BOOL _tn_int_dis_active = TN_FALSE;
+#endif
+
 
 /*******************************************************************************
  *    PRIVATE DATA
@@ -182,10 +247,53 @@ static void _idle_task_body(void *par)
  */
 #if TN_DYNAMIC_TICK
 
-_TN_STATIC_INLINE void _round_robin_manage(void) {
-   /*TODO: round-robin should be powered by timers mechanism.
-    * So, when round-robin is active, the system isn't so "tickless".
-    */
+_TN_STATIC_INLINE void _round_robin_manage(void)
+{
+   //-- nothing to do here: with dynamic tick, round-robin is driven by
+   //   `_tn_tslice_timer`, see `_tn_round_robin_update()`
+}
+
+/**
+ * Callback of `_tn_tslice_timer`: time slice of the running task is over,
+ * so move it to the tail of ready queue for its priority, and start the
+ * timer for the next task (if needed).
+ *
+ * Called from `tn_tick_int_processing()` with interrupts enabled.
+ */
+static void _tslice_timer_func(struct TN_Timer *timer, void *p_user_data)
+{
+   TN_INTSAVE_DATA_INT;
+
+   TN_INT_IDIS_SAVE();
+
+   //-- Manage round robin if only context switch is not already needed for
+   //   some other reason
+   if (     _tn_curr_run_task == _tn_next_task_to_run
+         && _tn_tslice_task == _tn_next_task_to_run
+      )
+   {
+      int priority = _tn_curr_run_task->priority;
+      struct TN_ListItem *curr_que;
+
+      //-- Remove task from head and add it to the tail of
+      //-- ready queue for current priority
+      curr_que = _tn_list_remove_head(&(_tn_tasks_ready_list[priority]));
+      _tn_list_add_tail(&(_tn_tasks_ready_list[priority]), curr_que);
+
+      _tn_next_task_to_run = _tn_get_task_by_tsk_queue(
+            _tn_tasks_ready_list[priority].next
+            );
+   }
+
+   //-- the timer is already stopped: start it again for the next task
+   //   if needed
+   _tn_tslice_task = TN_NULL;
+   _tn_round_robin_update();
+
+   TN_INT_IRESTORE();
+
+   _TN_UNUSED(timer);
+   _TN_UNUSED(p_user_data);
 }
 
 #else
@@ -232,6 +340,96 @@ _TN_STATIC_INLINE void _round_robin_manage(void)
 #endif
 
 
+#if TN_PROFILER && TN_PROFILER_CYCLES
+/**
+ * Account cycles the task has been running since the last accounting:
+ * add them to the total run time and to the current consecutive run time.
+ *
+ * Interrupts should be disabled.
+ *
+ * @param task
+ *    Currently running task
+ * @param cur_cycle_cnt
+ *    Current value of the cycle counter
+ */
+_TN_STATIC_INLINE void _profiler_run_account(
+      struct TN_Task *task,
+      TN_UWord cur_cycle_cnt
+      )
+{
+   //-- unsigned subtraction takes care of counter overflow
+   TN_UWord cycles = cur_cycle_cnt - task->profiler.last_cycle_cnt;
+
+   task->profiler.timing.total_run_time += cycles;
+
+   //-- consecutive run time is saturated instead of wrapping around
+   if (task->profiler.cur_run_cycles > (TN_UWord)(~cycles)){
+      task->profiler.cur_run_cycles = (TN_UWord)(-1);
+   } else {
+      task->profiler.cur_run_cycles += cycles;
+   }
+
+   task->profiler.last_cycle_cnt = cur_cycle_cnt;
+}
+
+/**
+ * Called when interrupt is entered. If this is the outermost interrupt, the
+ * time the current task was running until now is accounted as its run time.
+ *
+ * Interrupts should be disabled.
+ */
+_TN_STATIC_INLINE void _profiler_isr_enter(void)
+{
+   if (1
+         && _tn_profiler_isr_nest++ == 0
+         && (_tn_sys_state & TN_STATE_FLAG__SYS_RUNNING)
+      )
+   {
+      _profiler_run_account(_tn_curr_run_task, _TN_CYCLE_CNT_GET());
+   }
+}
+
+/**
+ * Called when interrupt is exited. If this is the outermost interrupt, the
+ * time spent in the interrupt(s) is accounted as ISR time of the current
+ * task.
+ *
+ * Interrupts should be disabled.
+ */
+_TN_STATIC_INLINE void _profiler_isr_exit(void)
+{
+   if (1
+         && --_tn_profiler_isr_nest == 0
+         && (_tn_sys_state & TN_STATE_FLAG__SYS_RUNNING)
+      )
+   {
+      TN_UWord cur_cycle_cnt = _TN_CYCLE_CNT_GET();
+      struct TN_Task *task = _tn_curr_run_task;
+
+      //-- unsigned subtraction takes care of counter overflow
+      task->profiler.timing.total_isr_time
+         += (TN_UWord)(cur_cycle_cnt - task->profiler.last_cycle_cnt);
+      task->profiler.last_cycle_cnt = cur_cycle_cnt;
+   }
+}
+#else
+
+/**
+ * Stub empty function, it is needed when `#TN_PROFILER_CYCLES` is zero.
+ */
+_TN_STATIC_INLINE void _profiler_isr_enter(void)
+{
+}
+
+/**
+ * Stub empty function, it is needed when `#TN_PROFILER_CYCLES` is zero.
+ */
+_TN_STATIC_INLINE void _profiler_isr_exit(void)
+{
+}
+#endif
+
+
 #if _TN_ON_CONTEXT_SWITCH_HANDLER
 #if TN_PROFILER
 /**
@@ -252,6 +450,9 @@ _TN_STATIC_INLINE void _tn_sys_on_context_switch_profiler(
    _TN_BUG_ON(!TN_IS_INT_DISABLED());
 
    TN_TickCnt cur_tick_cnt = _tn_timer_sys_time_get();
+#if TN_PROFILER_CYCLES
+   TN_UWord cur_cycle_cnt = _TN_CYCLE_CNT_GET();
+#endif
 
    //-- handle task_prev (the one that was running and going to wait) {{{
    {
@@ -262,6 +463,14 @@ _TN_STATIC_INLINE void _tn_sys_on_context_switch_profiler(
       task_prev->profiler.is_running = 0;
 #endif
 
+#if TN_PROFILER_CYCLES
+      //-- account cycles since the last accounting (task got running or
+      //   interrupt was exited), and get consecutive run time
+      _profiler_run_account(task_prev, cur_cycle_cnt);
+
+      TN_UWord cur_run_time = task_prev->profiler.cur_run_cycles;
+      task_prev->profiler.cur_run_cycles = 0;
+#else
       //-- get difference between current time and last saved time:
       //   this is the time task was running.
       TN_TickCnt cur_run_time
@@ -269,12 +478,21 @@ _TN_STATIC_INLINE void _tn_sys_on_context_switch_profiler(
 
       //-- add it to total run time
       task_prev->profiler.timing.total_run_time += cur_run_time;
+#endif
 
       //-- check if we should update consecutive max run time
       if (task_prev->profiler.timing.max_consecutive_run_time < cur_run_time){
          task_prev->profiler.timing.max_consecutive_run_time = cur_run_time;
       }
 
+#if defined(_TN_FPU_CTX_SAVED)
+      //-- count context switches which had to save FPU registers of the
+      //   task (its context is already saved at this point)
+      if (_TN_FPU_CTX_SAVED(task_prev->stack_cur_pt)){
+         task_prev->profiler.timing.fpu_ctx_switch_cnt++;
+      }
+#endif
+
       //-- update current task state
       task_prev->profiler.last_tick_cnt      = cur_tick_cnt;
 #if TN_PROFILER_WAIT_TIME
@@ -319,6 +537,9 @@ _TN_STATIC_INLINE void _tn_sys_on_context_switch_profiler(
 
       //-- update current task state
       task_new->profiler.last_tick_cnt      = cur_tick_cnt;
+#if TN_PROFILER_CYCLES
+      task_new->profiler.last_cycle_cnt     = cur_cycle_cnt;
+#endif
    }
    // }}}
 }
@@ -388,6 +609,54 @@ _TN_STATIC_INLINE void _tn_sys_stack_overflow_check(
 }
 #endif
 
+#if TN_TICK_INT_MEASURE
+/**
+ * If `#TN_TICK_INT_MEASURE` is non-zero, this function is called at the
+ * beginning of `tn_tick_int_processing()`.
+ *
+ * @return
+ *    Current value of the cycle counter
+ */
+_TN_STATIC_INLINE TN_UWord _tick_int_measure_start(void)
+{
+   return _TN_CYCLE_CNT_GET();
+}
+
+/**
+ * If `#TN_TICK_INT_MEASURE` is non-zero, this function is called at the
+ * end of `tn_tick_int_processing()`, with interrupts still disabled.
+ *
+ * @param start_cycles
+ *    Value returned from `_tick_int_measure_start()`
+ */
+_TN_STATIC_INLINE void _tick_int_measure_finish(TN_UWord start_cycles)
+{
+   //-- unsigned subtraction takes care of counter overflow
+   TN_UWord cycles = _TN_CYCLE_CNT_GET() - start_cycles;
+
+   if (cycles > _tn_tick_int_max_cycles){
+      _tn_tick_int_max_cycles = cycles;
+   }
+}
+#else
+
+/**
+ * Stub empty function, it is needed when `#TN_TICK_INT_MEASURE` is zero.
+ */
+_TN_STATIC_INLINE TN_UWord _tick_int_measure_start(void)
+{
+   return 0;
+}
+
+/**
+ * Stub empty function, it is needed when `#TN_TICK_INT_MEASURE` is zero.
+ */
+_TN_STATIC_INLINE void _tick_int_measure_finish(TN_UWord start_cycles)
+{
+   _TN_UNUSED(start_cycles);
+}
+#endif
+
 /**
  * Create idle task, the task is NOT started after creation.
  */
@@ -470,6 +739,10 @@ static void _build_cfg_check(void)
       _TN_FATAL_ERROR("TN_PROFILER_WAIT_TIME doesn't match");
    }
 
+   if (kernel_build_cfg.profiler_cycles != app_build_cfg->profiler_cycles){
+      _TN_FATAL_ERROR("TN_PROFILER_CYCLES doesn't match");
+   }
+
    if (kernel_build_cfg.stack_overflow_check != app_build_cfg->stack_overflow_check){
       _TN_FATAL_ERROR("TN_STACK_OVERFLOW_CHECK doesn't match");
    }
@@ -482,10 +755,34 @@ static void _build_cfg_check(void)
       _TN_FATAL_ERROR("TN_OLD_EVENT_API doesn't match");
    }
 
+   if (kernel_build_cfg.multi_wait != app_build_cfg->multi_wait){
+      _TN_FATAL_ERROR("TN_MULTI_WAIT doesn't match");
+   }
+
+   if (kernel_build_cfg.task_notify != app_build_cfg->task_notify){
+      _TN_FATAL_ERROR("TN_TASK_NOTIFY doesn't match");
+   }
+
+   if (kernel_build_cfg.eventgrp_wait_index != app_build_cfg->eventgrp_wait_index){
+      _TN_FATAL_ERROR("TN_EVENTGRP_WAIT_INDEX doesn't match");
+   }
+
+   if (kernel_build_cfg.eventgrp_wide != app_build_cfg->eventgrp_wide){
+      _TN_FATAL_ERROR("TN_EVENTGRP_WIDE doesn't match");
+   }
+
+   if (kernel_build_cfg.fast_path != app_build_cfg->fast_path){
+      _TN_FATAL_ERROR("TN_FAST_PATH doesn't match");
+   }
+
 #if defined (__TN_ARCH_PIC24_DSPIC__)
    if (kernel_build_cfg.arch.p24.p24_sys_ipl != app_build_cfg->arch.p24.p24_sys_ipl){
       _TN_FATAL_ERROR("TN_P24_SYS_IPL doesn't match");
    }
+#elif defined (__TN_ARCH_CORTEX_M__)
+   if (kernel_build_cfg.arch.cortex_m.sys_basepri != app_build_cfg->arch.cortex_m.sys_basepri){
+      _TN_FATAL_ERROR("TN_CORTEX_M_SYS_BASEPRI doesn't match");
+   }
 #endif
 
 
@@ -528,6 +825,13 @@ void tn_sys_start(
    //-- init timers
    _tn_timers_init();
 
+#if (TN_PROFILER && TN_PROFILER_CYCLES) || TN_INT_DIS_MEASURE \
+   || TN_TICK_INT_MEASURE
+   //-- enable hardware cycle counter used by profiler and/or for measuring
+   //   critical sections and tick interrupt
+   _TN_CYCLE_CNT_INIT();
+#endif
+
    //-- check that build configuration for the kernel and application match
    //   (if only TN_CHECK_BUILD_CFG is non-zero)
    _build_cfg_check();
@@ -540,6 +844,12 @@ void tn_sys_start(
       _tn_tslice_ticks[i] = TN_NO_TIME_SLICE;
    }
 
+#if TN_DYNAMIC_TICK
+   //-- create internal timer which drives round-robin
+   _tn_timer_create(&_tn_tslice_timer, _tslice_timer_func, TN_NULL);
+   _tn_tslice_task = TN_NULL;
+#endif
+
    //-- reset generic task queue and task count to 0
    _tn_list_reset(&_tn_tasks_created_list);
    _tn_tasks_created_cnt = 0;
@@ -548,7 +858,14 @@ void tn_sys_start(
    _tn_sys_state = (enum TN_StateFlag)(0);  
 
    //-- reset bitmask of priorities with runnable tasks
+#if TN_PRIORITIES_2LEVEL_BMP
+   for (i = 0; i < _TN_READY_BMP_GROUPS_CNT; i++){
+      _tn_ready_to_run_bmp[i] = 0;
+   }
+   _tn_ready_to_run_grp_bmp = 0;
+#else
    _tn_ready_to_run_bmp = 0;
+#endif
 
    //-- reset pointers to currently running task and next task to run
    _tn_next_task_to_run = TN_NULL;
@@ -624,6 +941,14 @@ void tn_tick_int_processing(void)
 
    TN_INT_IDIS_SAVE();
 
+   //-- time spent here isn't accounted as task's run time
+   //   (if only cycle-accurate profiler is enabled)
+   _profiler_isr_enter();
+   _tn_trace_put(TN_TRACE_EV_ISR_ENTER, 0, TN_TRACE_ISR_TICK);
+
+   //-- remember when we've started (if measurement is enabled)
+   TN_UWord start_cycles = _tick_int_measure_start();
+
    //-- check stack overflow
    _tn_sys_stack_overflow_check(_tn_curr_run_task);
 
@@ -633,6 +958,12 @@ void tn_tick_int_processing(void)
    //-- manage round-robin (if used)
    _round_robin_manage();
 
+   //-- update worst-case time spent here (if measurement is enabled)
+   _tick_int_measure_finish(start_cycles);
+
+   _tn_trace_put(TN_TRACE_EV_ISR_EXIT, 0, TN_TRACE_ISR_TICK);
+   _profiler_isr_exit();
+
    TN_INT_IRESTORE();
    _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
 }
@@ -656,6 +987,10 @@ enum TN_RCode tn_sys_tslice_set(int priority, int ticks)
 
       TN_INT_DIS_SAVE();
       _tn_tslice_ticks[priority] = ticks;
+
+      //-- with dynamic tick, round-robin timer might need to be started
+      //   or stopped
+      _tn_round_robin_update();
       TN_INT_RESTORE();
    }
    return rc;
@@ -676,6 +1011,14 @@ TN_TickCnt tn_sys_time_get(void)
    return ret;
 }
 
+/*
+ * See comments in the header file (tn_sys.h)
+ */
+TN_TickCnt tn_sys_timeout_until(TN_TickCnt deadline)
+{
+   return _tn_timeout_until(deadline, tn_sys_time_get());
+}
+
 /*
  * Returns current state flags (_tn_sys_state)
  */
@@ -735,6 +1078,88 @@ TN_TaskBody *tn_cur_task_body_get(void)
 }
 
 
+#if TN_TICK_INT_MEASURE
+/*
+ * See comment in tn_sys.h file
+ */
+TN_UWord tn_sys_tick_int_max_cycles_get(void)
+{
+   return _tn_tick_int_max_cycles;
+}
+
+/*
+ * See comment in tn_sys.h file
+ */
+void tn_sys_tick_int_max_cycles_reset(void)
+{
+   _tn_tick_int_max_cycles = 0;
+}
+#endif
+
+#if TN_PROFILER && TN_PROFILER_CYCLES
+/*
+ * See comment in tn_sys.h file
+ */
+void tn_sys_profiler_isr_enter(void)
+{
+   TN_INTSAVE_DATA_INT;
+
+   TN_INT_IDIS_SAVE();
+   _profiler_isr_enter();
+   TN_INT_IRESTORE();
+}
+
+/*
+ * See comment in tn_sys.h file
+ */
+void tn_sys_profiler_isr_exit(void)
+{
+   TN_INTSAVE_DATA_INT;
+
+   TN_INT_IDIS_SAVE();
+   _profiler_isr_exit();
+   TN_INT_IRESTORE();
+}
+#endif
+
+
+#if TN_INT_DIS_MEASURE
+/*
+ * See comment in tn_sys.h file
+ */
+const struct TN_IntDisSite *tn_sys_int_dis_worst_get(void)
+{
+   return _tn_int_dis_worst;
+}
+
+/*
+ * See comment in tn_sys.h file
+ */
+const struct TN_IntDisSite *tn_sys_int_dis_sites_get(void)
+{
+   return _tn_int_dis_sites;
+}
+
+/*
+ * See comment in tn_sys.h file
+ */
+void tn_sys_int_dis_max_reset(void)
+{
+   struct TN_IntDisSite *site;
+   TN_INTSAVE_DATA_INT;
+
+   TN_INT_IDIS_SAVE();
+
+   for (site = _tn_int_dis_sites; site != TN_NULL; site = site->next){
+      site->max_cycles = 0;
+   }
+   _tn_int_dis_worst = TN_NULL;
+
+   TN_INT_IRESTORE();
+}
+#endif
+
+
 #if TN_DYNAMIC_TICK
 
 void tn_callback_dyn_tick_set(
@@ -754,6 +1179,86 @@ void tn_callback_dyn_tick_set(
  *    PROTECTED FUNCTIONS
  ******************************************************************************/
 
+#if TN_DYNAMIC_TICK
+/**
+ * See comment in the _tn_sys.h file
+ */
+void _tn_round_robin_update(void)
+{
+   struct TN_Task *task = _tn_next_task_to_run;
+
+   if (task == TN_NULL){
+      //-- system isn't started yet (see `tn_sys_start()`), nothing to do
+   } else {
+      int priority = task->priority;
+      struct TN_ListItem *pri_queue = &(_tn_tasks_ready_list[priority]);
+
+      if (     _tn_tslice_ticks[priority] != TN_NO_TIME_SLICE
+            && pri_queue->next->next != pri_queue
+         )
+      {
+         //-- there are more than 1 task in the ready queue, and round-robin
+         //   is on for the priority: start the timer, unless it's already
+         //   started for the same task
+         if (_tn_tslice_task != task){
+            _tn_tslice_task = task;
+            _tn_timer_start(&_tn_tslice_timer, _tn_tslice_ticks[priority]);
+         }
+      } else if (_tn_tslice_task != TN_NULL){
+         //-- round-robin isn't needed anymore: stop the timer, so that
+         //   it doesn't wake the system up for nothing
+         _tn_tslice_task = TN_NULL;
+         _tn_timer_cancel(&_tn_tslice_timer);
+      }
+   }
+}
+#endif
+
+#if TN_INT_DIS_MEASURE
+/**
+ * See comment in the tn_arch.h file
+ */
+void _tn_int_dis_measure_start(void)
+{
+   _tn_int_dis_start_cycles = _TN_CYCLE_CNT_GET();
+   _tn_int_dis_active = TN_TRUE;
+}
+
+/**
+ * See comment in the tn_arch.h file
+ */
+void _tn_int_dis_measure_stop(struct TN_IntDisSite *site)
+{
+   //-- if the section wasn't started by `_tn_int_dis_measure_start()`
+   //   (say, the caller passed the status obtained with interrupts already
+   //   disabled), there's nothing to measure
+   if (_tn_int_dis_active){
+      //-- unsigned subtraction takes care of counter overflow
+      TN_UWord cycles = _TN_CYCLE_CNT_GET() - _tn_int_dis_start_cycles;
+
+      _tn_int_dis_active = TN_FALSE;
+
+      if (!site->linked){
+         //-- first measurement in this function: add it to the list
+         site->next = _tn_int_dis_sites;
+         _tn_int_dis_sites = site;
+         site->linked = TN_TRUE;
+      }
+
+      if (cycles > site->max_cycles){
+         site->max_cycles = cycles;
+
+         if (     _tn_int_dis_worst == TN_NULL
+               || cycles > _tn_int_dis_worst->max_cycles
+            )
+         {
+            _tn_int_dis_worst = site;
+         }
+      }
+   }
+}
+#endif
+
 /**
  * See comment in the _tn_sys.h file
  */
@@ -846,6 +1351,7 @@ void _tn_sys_on_context_switch(
 {
    _tn_sys_stack_overflow_check(task_prev);
    _tn_sys_on_context_switch_profiler(task_prev, task_new);
+   _tn_trace_put(TN_TRACE_EV_TASK_SWITCH, 0, (TN_UWord)task_new);
 }
 #endif
 
@@ -103,6 +103,14 @@ struct TN_Mutex;
    (_p_struct)->arch.p24.p24_sys_ipl = TN_P24_SYS_IPL;            \
 }
 
+#elif defined (__TN_ARCH_CORTEX_M__)
+
+#  define _TN_BUILD_CFG_ARCH_STRUCT_FILL(_p_struct)               \
+{                                                                 \
+   (_p_struct)->arch.cortex_m.sys_basepri =                       \
+      TN_CORTEX_M_SYS_BASEPRI;                                    \
+}
+
 #else
 #  define _TN_BUILD_CFG_ARCH_STRUCT_FILL(_p_struct)
 #endif
@@ -130,9 +138,15 @@ struct TN_Mutex;
    (_p_struct)->api_make_alig_arg         = TN_API_MAKE_ALIG_ARG;       \
    (_p_struct)->profiler                  = TN_PROFILER;                \
    (_p_struct)->profiler_wait_time        = TN_PROFILER_WAIT_TIME;      \
+   (_p_struct)->profiler_cycles           = TN_PROFILER_CYCLES;         \
    (_p_struct)->stack_overflow_check      = TN_STACK_OVERFLOW_CHECK;    \
    (_p_struct)->dynamic_tick              = TN_DYNAMIC_TICK;            \
    (_p_struct)->old_events_api            = TN_OLD_EVENT_API;           \
+   (_p_struct)->multi_wait                = TN_MULTI_WAIT;              \
+   (_p_struct)->task_notify               = TN_TASK_NOTIFY;             \
+   (_p_struct)->eventgrp_wait_index       = TN_EVENTGRP_WAIT_INDEX;     \
+   (_p_struct)->eventgrp_wide             = TN_EVENTGRP_WIDE;           \
+   (_p_struct)->fast_path                 = TN_FAST_PATH;               \
                                                                         \
    _TN_BUILD_CFG_ARCH_STRUCT_FILL(_p_struct);                           \
 }
@@ -169,7 +183,7 @@ struct TN_Mutex;
 struct _TN_BuildCfg {
    ///
    /// Value of `#TN_PRIORITIES_CNT`
-   unsigned          priorities_cnt             : 7;
+   unsigned          priorities_cnt             : 11;
    ///
    /// Value of `#TN_CHECK_PARAM`
    unsigned          check_param                : 1;
@@ -200,6 +214,9 @@ struct _TN_BuildCfg {
    /// Value of `#TN_PROFILER_WAIT_TIME`
    unsigned          profiler_wait_time         : 1;
    ///
+   /// Value of `#TN_PROFILER_CYCLES`
+   unsigned          profiler_cycles            : 1;
+   ///
    /// Value of `#TN_STACK_OVERFLOW_CHECK`
    unsigned          stack_overflow_check       : 1;
    ///
@@ -209,6 +226,21 @@ struct _TN_BuildCfg {
    /// Value of `#TN_OLD_EVENT_API`
    unsigned          old_events_api             : 1;
    ///
+   /// Value of `#TN_MULTI_WAIT`
+   unsigned          multi_wait                 : 1;
+   ///
+   /// Value of `#TN_TASK_NOTIFY`
+   unsigned          task_notify                : 1;
+   ///
+   /// Value of `#TN_EVENTGRP_WAIT_INDEX`
+   unsigned          eventgrp_wait_index        : 1;
+   ///
+   /// Value of `#TN_EVENTGRP_WIDE`
+   unsigned          eventgrp_wide              : 1;
+   ///
+   /// Value of `#TN_FAST_PATH`
+   unsigned          fast_path                  : 1;
+   ///
    /// Architecture-dependent values
    union {
       ///
@@ -223,6 +255,13 @@ struct _TN_BuildCfg {
          /// Value of `#TN_P24_SYS_IPL`
          unsigned    p24_sys_ipl                : 3;
       } p24;
+      ///
+      /// Cortex-M-dependent values
+      struct {
+         ///
+         /// Value of `#TN_CORTEX_M_SYS_BASEPRI`
+         unsigned    sys_basepri                : 8;
+      } cortex_m;
    } arch;
 };
 
@@ -353,6 +392,33 @@ typedef void (TN_CBDeadlock)(
       struct TN_Task *task
       );
 
+#if TN_INT_DIS_MEASURE || defined(DOXYGEN_ACTIVE)
+/**
+ * Worst-case duration of critical sections in a particular function (see
+ * `#TN_INT_DIS_MEASURE`). One such structure is statically allocated by
+ * `#TN_INTSAVE_DATA` in each function which has critical sections; it is
+ * added to the list returned by `tn_sys_int_dis_sites_get()` when the first
+ * critical section of the function ends.
+ *
+ * Application should not modify it.
+ */
+struct TN_IntDisSite {
+   ///
+   /// Name of the function, as given by `__func__`
+   const char *func;
+   ///
+   /// Worst-case time, in cycles of the architecture-dependent cycle
+   /// counter, between disabling and restoring interrupts in the function
+   volatile TN_UWord max_cycles;
+   ///
+   /// Next item in the list, or `TN_NULL`
+   struct TN_IntDisSite *volatile next;
+   ///
+   /// Whether the item is already added to the list
+   TN_BOOL linked;
+};
+#endif
+
 
 
 
@@ -467,6 +533,33 @@ enum TN_RCode tn_sys_tslice_set(int priority, int ticks);
  */
 TN_TickCnt tn_sys_time_get(void);
 
+/**
+ * Convert absolute time (in terms of `tn_sys_time_get()`) to the relative
+ * timeout which can be given to any kernel service that can wait, such as
+ * `tn_sem_wait()` or `tn_queue_receive()`. This way, the wait can be bound
+ * by the absolute deadline: if several waits are made against the same
+ * deadline, execution time and preemption don't accumulate.
+ *
+ * Note that if the task gets preempted between the call to this function
+ * and the actual wait, the wait ends later than the deadline, by the time of
+ * the preemption. `tn_task_sleep_until()` and `tn_task_period_wait()` don't
+ * have this problem.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param deadline
+ *    Absolute time, in system ticks
+ *
+ * @return
+ *    Timeout until `deadline`, or `0` if it is already reached (so the wait
+ *    with this timeout returns `#TN_RC_TIMEOUT` immediately, if the
+ *    resource isn't available). Deadline is considered reached if it is not
+ *    more than half of the `#TN_TickCnt` range behind current time.
+ */
+TN_TickCnt tn_sys_timeout_until(TN_TickCnt deadline);
+
 
 /**
  * Set callback function that should be called whenever deadlock occurs or
@@ -614,6 +707,114 @@ _TN_STATIC_INLINE void tn_sched_restore(TN_UWord sched_state)
 }
 
 
+#if TN_TICK_INT_MEASURE || defined(DOXYGEN_ACTIVE)
+/**
+ * Returns the worst-case (maximum) number of cycles spent in
+ * `tn_tick_int_processing()` since system start or since the last call to
+ * `tn_sys_tick_int_max_cycles_reset()` (see `#TN_TICK_INT_MEASURE`). Cycles
+ * are counted by the architecture-dependent cycle counter, the same one as
+ * used by `#TN_PROFILER_CYCLES`.
+ *
+ * Note that the measured time includes execution of all the timer functions
+ * fired during the tick.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+TN_UWord tn_sys_tick_int_max_cycles_get(void);
+
+/**
+ * Reset the worst-case value returned by `tn_sys_tick_int_max_cycles_get()`
+ * to zero.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+void tn_sys_tick_int_max_cycles_reset(void);
+#endif
+
+#if (TN_PROFILER && TN_PROFILER_CYCLES) || defined(DOXYGEN_ACTIVE)
+/**
+ * Should be called at the very beginning of the ISR whose time should be
+ * attributed to the interrupts, not to the interrupted task (see
+ * `#TN_PROFILER_CYCLES`). Each call must be paired with the call to
+ * `tn_sys_profiler_isr_exit()` at the end of the same ISR. Nested
+ * interrupts are handled: the time is measured for the outermost one.
+ *
+ * Available if only both `#TN_PROFILER` and `#TN_PROFILER_CYCLES` are
+ * non-zero.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+void tn_sys_profiler_isr_enter(void);
+
+/**
+ * Should be called at the very end of the ISR, see
+ * `tn_sys_profiler_isr_enter()`.
+ *
+ * Available if only both `#TN_PROFILER` and `#TN_PROFILER_CYCLES` are
+ * non-zero.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+void tn_sys_profiler_isr_exit(void);
+#endif
+
+#if TN_INT_DIS_MEASURE || defined(DOXYGEN_ACTIVE)
+/**
+ * Returns the function whose critical section was the longest one since
+ * system start or since the last call to `tn_sys_int_dis_max_reset()`, see
+ * `#TN_INT_DIS_MEASURE`. The duration is in `max_cycles` of the returned
+ * structure.
+ *
+ * Available if only `#TN_INT_DIS_MEASURE` is non-zero.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @return
+ *    Pointer to the descriptor of the function, or `TN_NULL` if nothing
+ *    was measured yet.
+ */
+const struct TN_IntDisSite *tn_sys_int_dis_worst_get(void);
+
+/**
+ * Returns the list of all functions whose critical sections were measured
+ * so far, see `#TN_INT_DIS_MEASURE`. Use `next` field of `struct
+ * #TN_IntDisSite` to walk through the list; new items are added to its
+ * head, so the list can be walked with interrupts enabled.
+ *
+ * Available if only `#TN_INT_DIS_MEASURE` is non-zero.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @return
+ *    Pointer to the first item of the list, or `TN_NULL` if nothing
+ *    was measured yet.
+ */
+const struct TN_IntDisSite *tn_sys_int_dis_sites_get(void);
+
+/**
+ * Reset worst-case durations of all the functions (see
+ * `tn_sys_int_dis_sites_get()`) to zero. Functions stay in the list.
+ *
+ * Available if only `#TN_INT_DIS_MEASURE` is non-zero.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+void tn_sys_int_dis_max_reset(void);
+#endif
+
+
 #if TN_DYNAMIC_TICK || defined(DOXYGEN_ACTIVE)
 /**
  * $(TN_IF_ONLY_DYNAMIC_TICK_SET)
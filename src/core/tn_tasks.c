@@ -47,6 +47,8 @@
 #include "_tn_mutex.h"
 #include "_tn_timer.h"
 #include "_tn_list.h"
+#include "_tn_multi_wait.h"
+#include "_tn_trace.h"
 
 
 //-- header of current module
@@ -99,6 +101,9 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
 _TN_STATIC_INLINE void _init_mutex_queue(struct TN_Task *task)
 {
    _tn_list_reset(&(task->mutex_queue));
+#if TN_FAST_PATH
+   task->fast_mutex = TN_NULL;
+#endif
 }
 
 #if TN_MUTEX_DEADLOCK_DETECT
@@ -117,39 +122,64 @@ _TN_STATIC_INLINE void _init_deadlock_list(struct TN_Task *task)
 
 
 /**
- * Looks for first runnable task with highest priority,
- * set _tn_next_task_to_run to it.
+ * Returns index of the least significant set bit in the given bitmask,
+ * counting from 0.
  *
- * @return `TN_TRUE` if _tn_next_task_to_run was changed, `TN_FALSE` otherwise.
+ * @param bmp
+ *    Bitmask, must be non-zero.
  */
-static void _find_next_task_to_run(void)
+_TN_STATIC_INLINE int _bmp_first_set_get(TN_UWord bmp)
 {
-   int priority;
+   int ret;
 
 #ifdef _TN_FFS
    //-- architecture-dependent way to find-first-set-bit is available,
    //   so use it.
-   priority = _TN_FFS(_tn_ready_to_run_bmp);
-   priority--;
+   ret = _TN_FFS(bmp);
+   ret--;
 #else
    //-- there is no architecture-dependent way to find-first-set-bit available,
    //   so, use generic (somewhat naive) algorithm.
    int i;
-   unsigned int mask;
+   TN_UWord mask;
 
    mask = 1;
-   priority = 0;
+   ret = 0;
 
-   for (i = 0; i < TN_PRIORITIES_CNT; i++){
+   for (i = 0; i < TN_INT_WIDTH; i++){
       //-- for each bit in bmp
-      if (_tn_ready_to_run_bmp & mask){
-         priority = i;
+      if (bmp & mask){
+         ret = i;
          break;
       }
       mask = (mask << 1);
    }
 #endif
 
+   return ret;
+}
+
+/**
+ * Looks for first runnable task with highest priority,
+ * set _tn_next_task_to_run to it.
+ *
+ * @return `TN_TRUE` if _tn_next_task_to_run was changed, `TN_FALSE` otherwise.
+ */
+static void _find_next_task_to_run(void)
+{
+   int priority;
+
+#if TN_PRIORITIES_2LEVEL_BMP
+   //-- find the first non-empty group first, and then the first priority
+   //   in this group
+   int group = _bmp_first_set_get(_tn_ready_to_run_grp_bmp);
+
+   priority = group * TN_INT_WIDTH
+      + _bmp_first_set_get(_tn_ready_to_run_bmp[group]);
+#else
+   priority = _bmp_first_set_get(_tn_ready_to_run_bmp);
+#endif
+
    //-- set task to run: fetch next task from ready list of appropriate
    //   priority.
    _tn_next_task_to_run = _tn_get_task_by_tsk_queue(
@@ -267,6 +297,115 @@ _TN_STATIC_INLINE enum TN_RCode _task_job_iperform(
    return rc;
 }
 
+/**
+ * Put current task to sleep until the absolute time `deadline`, if it isn't
+ * already reached. Interrupts should be disabled.
+ *
+ * @return
+ *    * `#TN_RC_OK` if the task is put to sleep: then, caller should switch
+ *      context and get actual result from `task_wait_rc`;
+ *    * `#TN_RC_TIMEOUT` if the deadline is already reached.
+ */
+static enum TN_RCode _task_sleep_until(TN_TickCnt deadline)
+{
+   enum TN_RCode rc = TN_RC_OK;
+   TN_TickCnt timeout = _tn_timeout_until(
+         deadline, _tn_timer_sys_time_get()
+         );
+
+   if (timeout == 0){
+      rc = TN_RC_TIMEOUT;
+   } else {
+      //-- put task to wait with reason SLEEP and without wait queue.
+      _tn_task_curr_to_wait_action(TN_NULL, TN_WAIT_REASON_SLEEP, timeout);
+   }
+
+   return rc;
+}
+
+#if TN_TASK_NOTIFY
+
+/**
+ * Consume pending notification of the task: clear or decrement its
+ * notification value, depending on `opt`. Interrupts should be disabled.
+ *
+ * @return notification value before it is cleared or decremented.
+ */
+_TN_STATIC_INLINE TN_UWord _task_notify_take(
+      struct TN_Task *task,
+      enum TN_TaskNotifyWaitOpt opt
+      )
+{
+   TN_UWord value = task->notify_value;
+
+   if (opt == TN_TASK_NOTIFY_WAIT_DEC && value != 0){
+      task->notify_value = value - 1;
+   } else {
+      task->notify_value = 0;
+   }
+
+   task->notify_pending = (task->notify_value != 0);
+
+   return value;
+}
+
+/**
+ * See the comment for tn_task_notify, tn_task_inotify in the tn_tasks.h
+ */
+_TN_STATIC_INLINE enum TN_RCode _task_notify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (_tn_task_is_dormant(task)){
+      rc = TN_RC_WSTATE;
+   } else {
+      switch (action){
+         case TN_TASK_NOTIFY_SET_BITS:
+            task->notify_value |= value;
+            break;
+         case TN_TASK_NOTIFY_INCREMENT:
+            if (task->notify_value == (TN_UWord)(-1)){
+               rc = TN_RC_OVERFLOW;
+            } else {
+               task->notify_value++;
+            }
+            break;
+         case TN_TASK_NOTIFY_OVERWRITE:
+            task->notify_value = value;
+            break;
+         default:
+            rc = TN_RC_WPARAM;
+            break;
+      }
+   }
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      task->notify_pending = 1;
+
+      if (     (_tn_task_is_waiting(task))
+            && (task->task_wait_reason == TN_WAIT_REASON_NOTIFY))
+      {
+         //-- Task waits for the notification: consume it on behalf of the
+         //   task, so that it doesn't have to disable interrupts once more
+         //   when it gets running, and wake it up.
+         task->subsys_wait.notify.value = _task_notify_take(
+               task, task->subsys_wait.notify.opt
+               );
+         _tn_task_wait_complete(task, TN_RC_OK);
+      }
+   }
+
+   return rc;
+}
+
+#endif   // TN_TASK_NOTIFY
+
 /**
  * Returns TN_TRUE if there are no more items in the runqueue for given
  * priority, TN_FALSE otherwise.
@@ -286,7 +425,19 @@ _TN_STATIC_INLINE TN_BOOL _remove_entry_from_ready_queue(
 
    if (ret){
       //-- list is empty, so, modify bitmask _tn_ready_to_run_bmp
-      _tn_ready_to_run_bmp &= ~(1 << priority);
+#if TN_PRIORITIES_2LEVEL_BMP
+      unsigned int group = (unsigned int)priority / TN_INT_WIDTH;
+
+      _tn_ready_to_run_bmp[group] &=
+         ~((TN_UWord)1 << ((unsigned int)priority % TN_INT_WIDTH));
+
+      if (_tn_ready_to_run_bmp[group] == 0){
+         //-- no more runnable tasks in the whole group
+         _tn_ready_to_run_grp_bmp &= ~((TN_UWord)1 << group);
+      }
+#else
+      _tn_ready_to_run_bmp &= ~((TN_UWord)1 << priority);
+#endif
    }
 
    return ret;
@@ -297,7 +448,17 @@ _TN_STATIC_INLINE void _add_entry_to_ready_queue(
       )
 {
    _tn_list_add_tail(&(_tn_tasks_ready_list[priority]), list_node);
-   _tn_ready_to_run_bmp |= (1 << priority);
+#if TN_PRIORITIES_2LEVEL_BMP
+   {
+      unsigned int group = (unsigned int)priority / TN_INT_WIDTH;
+
+      _tn_ready_to_run_bmp[group] |=
+         ((TN_UWord)1 << ((unsigned int)priority % TN_INT_WIDTH));
+      _tn_ready_to_run_grp_bmp |= ((TN_UWord)1 << group);
+   }
+#else
+   _tn_ready_to_run_bmp |= ((TN_UWord)1 << priority);
+#endif
 }
 
 // }}}
@@ -339,6 +500,13 @@ static void _on_task_wait_complete(struct TN_Task *task)
       _tn_mutex_on_task_wait_complete(task);
    }
 
+#if TN_MULTI_WAIT
+   //-- for multi-wait, remove all task's items from the lists of objects
+   if (task->task_wait_reason == TN_WAIT_REASON_MULTI){
+      _tn_multi_wait_on_task_wait_complete(task);
+   }
+#endif
+
 }
 
 /**
@@ -658,6 +826,140 @@ enum TN_RCode tn_task_sleep(TN_TickCnt timeout)
    return rc;
 }
 
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_sleep_until(TN_TickCnt deadline)
+{
+   enum TN_RCode rc;
+
+   if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      rc = _task_sleep_until(deadline);
+      TN_INT_RESTORE();
+
+      if (rc == TN_RC_OK){
+         //-- the task is put to sleep: switch context and get actual
+         //   result
+         _tn_context_switch_pend_if_needed();
+         rc = _tn_curr_run_task->task_wait_rc;
+      }
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_period_start(
+      struct TN_TaskPeriod *per,
+      TN_TickCnt period
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+#if TN_CHECK_PARAM
+   if (per == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+#endif
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (period == 0 || period > (TN_WAIT_INFINITE / 2)){
+      rc = TN_RC_WPARAM;
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      per->period          = period;
+      per->next_release    = _tn_timer_sys_time_get() + period;
+      per->overruns_cnt    = 0;
+      TN_INT_RESTORE();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_period_wait(struct TN_TaskPeriod *per)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+#if TN_CHECK_PARAM
+   if (per == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+#endif
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+      TN_TickCnt release;
+      TN_TickCnt cur_tick_cnt;
+
+      TN_INT_DIS_SAVE();
+
+      release = per->next_release;
+      cur_tick_cnt = _tn_timer_sys_time_get();
+
+      if (     _tn_timeout_until(release, cur_tick_cnt) == 0
+            && cur_tick_cnt != release
+         )
+      {
+         //-- release time has already passed: count the releases missed,
+         //   and move to the first release in the future, keeping the phase
+         //   of the schedule
+         //   (unsigned subtraction takes care of counter overflow)
+         TN_TickCnt missed_cnt = (cur_tick_cnt - release) / per->period + 1;
+
+         per->overruns_cnt += missed_cnt;
+         per->next_release = release + missed_cnt * per->period;
+         rc = TN_RC_OVERFLOW;
+      } else {
+         //-- release time is now or in the future: advance the schedule
+         //   and sleep until the release
+         per->next_release = release + per->period;
+         rc = _task_sleep_until(release);
+      }
+
+      TN_INT_RESTORE();
+
+      if (rc == TN_RC_OK){
+         //-- the task is put to sleep: switch context and get actual
+         //   result
+         _tn_context_switch_pend_if_needed();
+         rc = _tn_curr_run_task->task_wait_rc;
+
+         if (rc == TN_RC_TIMEOUT){
+            //-- this is the normal case: release time is reached
+            rc = TN_RC_OK;
+         } else if (rc == TN_RC_OK){
+            //-- the task is woken up by tn_task_wakeup() before the release
+            //   time: this should be distinguishable from the normal release
+            rc = TN_RC_FORCED;
+         }
+      } else if (rc == TN_RC_TIMEOUT){
+         //-- it is exactly the release time now
+         rc = TN_RC_OK;
+      }
+   }
+
+   return rc;
+}
+
 /*
  * See comments in the header file (tn_tasks.h)
  */
@@ -906,6 +1208,129 @@ enum TN_RCode tn_task_profiler_timing_get(
 }
 #endif
 
+#if TN_TASK_NOTIFY
+
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_notify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      )
+{
+   enum TN_RCode rc = _check_param_generic(task);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      rc = _task_notify(task, action, value);
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_inotify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      )
+{
+   enum TN_RCode rc = _check_param_generic(task);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      rc = _task_notify(task, action, value);
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_notify_wait(
+      TN_UWord *p_value,
+      enum TN_TaskNotifyWaitOpt opt,
+      TN_TickCnt timeout
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+#if TN_CHECK_PARAM
+   if (     opt != TN_TASK_NOTIFY_WAIT_CLEAR
+         && opt != TN_TASK_NOTIFY_WAIT_DEC)
+   {
+      rc = TN_RC_WPARAM;
+   }
+#endif
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+      struct TN_Task *task = _tn_curr_run_task;
+      TN_BOOL waited_for_notify = TN_FALSE;
+      TN_UWord value = 0;
+
+      TN_INT_DIS_SAVE();
+
+      if (task->notify_pending){
+         //-- notification is already pending, take it right away
+         value = _task_notify_take(task, opt);
+      } else if (timeout == 0){
+         rc = TN_RC_TIMEOUT;
+      } else {
+         //-- put task to wait without wait queue: the notifier finds the
+         //   task directly. Notification value will be stored in
+         //   subsys_wait.notify.value by the notifier.
+         task->subsys_wait.notify.opt = opt;
+         _tn_task_curr_to_wait_action(
+               TN_NULL, TN_WAIT_REASON_NOTIFY, timeout
+               );
+         waited_for_notify = TN_TRUE;
+      }
+
+      TN_INT_RESTORE();
+
+      if (waited_for_notify){
+         _tn_context_switch_pend_if_needed();
+
+         //-- get wait result
+         rc = task->task_wait_rc;
+         if (rc == TN_RC_OK){
+            value = task->subsys_wait.notify.value;
+         }
+      }
+
+      if (rc == TN_RC_OK && p_value != TN_NULL){
+         *p_value = value;
+      }
+   }
+
+   return rc;
+}
+
+#endif   // TN_TASK_NOTIFY
+
 
 
 
@@ -937,6 +1362,9 @@ void _tn_task_set_runnable(struct TN_Task * task)
    if (priority < _tn_next_task_to_run->priority){
       _tn_next_task_to_run = task;
    }
+
+   //-- start round-robin timer if needed (with dynamic tick only)
+   _tn_round_robin_update();
 }
 
 /**
@@ -990,6 +1418,8 @@ void _tn_task_clear_runnable(struct TN_Task *task)
    //-- and reset task's queue
    _tn_list_reset(&(task->task_queue));
 
+   //-- stop or restart round-robin timer if needed (with dynamic tick only)
+   _tn_round_robin_update();
 }
 
 void _tn_task_set_waiting(
@@ -1015,8 +1445,10 @@ void _tn_task_set_waiting(
    task->task_wait_reason = wait_reason;
 
    task->waited           = TN_TRUE;
+   task->wait_prio_order  = TN_FALSE;
 
    //--- Add to the wait queue  - FIFO
+   //    (caller may then move the task by `_tn_task_wait_prio_insert()`)
 
    if (wait_que != TN_NULL){
       _tn_list_add_tail(wait_que, &(task->task_queue));
@@ -1028,6 +1460,43 @@ void _tn_task_set_waiting(
 
    //-- Add to the timers queue, if timeout is neither 0 nor `TN_WAIT_INFINITE`.
    _tn_timer_start(&task->timer, timeout);
+
+   _tn_trace_put(TN_TRACE_EV_TASK_WAIT, wait_reason, (TN_UWord)task);
+}
+
+/**
+ * See comment in the _tn_tasks.h file
+ */
+void _tn_task_wait_prio_insert(struct TN_Task *task)
+{
+   struct TN_ListItem *wait_que = task->pwait_queue;
+   struct TN_ListItem *pos;
+
+#if TN_DEBUG
+   if (!_tn_task_is_waiting(task) || wait_que == TN_NULL){
+      _TN_FATAL_ERROR("");
+   }
+#endif
+
+   _tn_list_remove_entry(&(task->task_queue));
+
+   //-- Find the last task with the same or higher priority, walking from
+   //   the tail: typically, new waiters don't have the highest priority,
+   //   so the walk is short. If there is no such task, `pos` ends up at the
+   //   list head, so the task is inserted at the head of the queue.
+   for (pos = wait_que->prev; pos != wait_que; pos = pos->prev){
+      struct TN_Task *cur
+         = _tn_list_entry(pos, struct TN_Task, task_queue);
+
+      if (cur->priority <= task->priority){
+         break;
+      }
+   }
+
+   //-- insert the task right after `pos`
+   _tn_list_add_head(pos, &(task->task_queue));
+
+   task->wait_prio_order = TN_TRUE;
 }
 
 /**
@@ -1080,6 +1549,8 @@ void _tn_task_clear_waiting(struct TN_Task *task, enum TN_RCode wait_rc)
 
    //-- Clear wait reason
    task->task_wait_reason = TN_WAIT_REASON_NONE;
+
+   _tn_trace_put(TN_TRACE_EV_TASK_WAKE, wait_rc, (TN_UWord)task);
 }
 
 void _tn_task_set_suspended(struct TN_Task *task)
@@ -1134,6 +1605,13 @@ void _tn_task_set_dormant(struct TN_Task* task)
    task->task_state  |= TN_TASK_STATE_DORMANT;   //-- Task state
 
    task->tslice_count  = 0;
+
+#if TN_TASK_NOTIFY
+   task->notify_value   = 0;
+   task->notify_pending = 0;
+#endif
+
+   _tn_trace_put(TN_TRACE_EV_TASK_DORMANT, 0, (TN_UWord)task);
 }
 
 void _tn_task_clear_dormant(struct TN_Task *task)
@@ -1161,7 +1639,12 @@ void _tn_task_clear_dormant(struct TN_Task *task)
    //-- If profiler is present, set last tick count
    //   to current tick count value
    task->profiler.last_tick_cnt = _tn_timer_sys_time_get();
+#if TN_PROFILER_CYCLES
+   task->profiler.last_cycle_cnt = _TN_CYCLE_CNT_GET();
+#endif
 #endif
+
+   _tn_trace_put(TN_TRACE_EV_TASK_ACTIVATE, task->priority, (TN_UWord)task);
 }
 
 /**
@@ -1226,6 +1709,12 @@ void _tn_change_task_priority(struct TN_Task *task, int new_priority)
       _tn_change_running_task_priority(task, new_priority);
    } else {
       task->priority = new_priority;
+
+      if (_tn_task_is_waiting(task) && task->wait_prio_order){
+         //-- task waits in the queue ordered by priority: move it to
+         //   the new place
+         _tn_task_wait_prio_insert(task);
+      }
    }
 }
 
@@ -1247,6 +1736,9 @@ void _tn_change_running_task_priority(struct TN_Task *task, int new_priority)
    _add_entry_to_ready_queue(&(task->task_queue), new_priority);
 
    _find_next_task_to_run();
+
+   //-- start or stop round-robin timer if needed (with dynamic tick only)
+   _tn_round_robin_update();
 }
 
 #if 0
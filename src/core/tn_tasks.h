@@ -123,6 +123,8 @@
 #include "tn_eventgrp.h"
 #include "tn_dqueue.h"
 #include "tn_fmem.h"
+#include "tn_mqueue.h"
+#include "tn_multi_wait.h"
 #include "tn_timer.h"
 
 
@@ -208,6 +210,32 @@ enum TN_WaitReason {
    /// memory blocks
    /// @see tn_fmem.h
    TN_WAIT_REASON_WFIXMEM,
+   ///
+   /// Task wants to put some item to the message queue, and there's no space
+   /// in the queue.
+   /// @see tn_mqueue.h
+   TN_WAIT_REASON_MQUE_WSEND,
+   ///
+   /// Task wants to receive some item from the message queue, and there's no
+   /// items in the queue
+   /// @see tn_mqueue.h
+   TN_WAIT_REASON_MQUE_WRECEIVE,
+   ///
+   /// Task wants to read some item from the ring buffer, and the ring is
+   /// empty
+   /// @see tn_ring.h
+   TN_WAIT_REASON_RING_WRECEIVE,
+   ///
+   /// Task waits for any of several objects
+   /// @see tn_multi_wait.h
+   TN_WAIT_REASON_MULTI,
+   ///
+   /// Task waits for the notification, see `tn_task_notify_wait()`
+   TN_WAIT_REASON_NOTIFY,
+   ///
+   /// Service task of the deferred call queue waits for new calls
+   /// @see tn_defer.h
+   TN_WAIT_REASON_DEFER,
 
 
    ///
@@ -242,6 +270,40 @@ enum TN_TaskExitOpt {
    TN_TASK_EXIT_OPT_DELETE = (1 << 0),
 };
 
+/**
+ * Action performed on the notification value of the task by
+ * `tn_task_notify()` / `tn_task_inotify()`
+ */
+enum TN_TaskNotifyAction {
+   ///
+   /// Bitwise OR the given value into the notification value (the task
+   /// is used like an event group)
+   TN_TASK_NOTIFY_SET_BITS,
+   ///
+   /// Increment the notification value by one; the given value is ignored
+   /// (the task is used like a counting semaphore)
+   TN_TASK_NOTIFY_INCREMENT,
+   ///
+   /// Overwrite the notification value with the given one (the task is
+   /// used like a mailbox of depth one)
+   TN_TASK_NOTIFY_OVERWRITE,
+};
+
+/**
+ * What `tn_task_notify_wait()` does with the notification value after it is
+ * received
+ */
+enum TN_TaskNotifyWaitOpt {
+   ///
+   /// Clear the value: all the pending notifications are consumed at once
+   TN_TASK_NOTIFY_WAIT_CLEAR,
+   ///
+   /// Decrement the value: the notification remains pending until the
+   /// value reaches zero. Intended for use with
+   /// `#TN_TASK_NOTIFY_INCREMENT`.
+   TN_TASK_NOTIFY_WAIT_DEC,
+};
+
 #if TN_PROFILER || DOXYGEN_ACTIVE
 /**
  * Timing structure that is managed by profiler and can be read by
@@ -249,7 +311,10 @@ enum TN_TaskExitOpt {
  * each `struct #TN_Task` structure. 
  *
  * Available if only `#TN_PROFILER` option is non-zero, also depends on
- * `#TN_PROFILER_WAIT_TIME`.
+ * `#TN_PROFILER_WAIT_TIME` and `#TN_PROFILER_CYCLES`.
+ *
+ * Time is measured in system ticks, or, if `#TN_PROFILER_CYCLES` is non-zero,
+ * run time is measured in cycles.
  */
 struct TN_TaskTiming {
    ///
@@ -269,6 +334,28 @@ struct TN_TaskTiming {
    /// Maximum consecutive time task was running.
    unsigned long        max_consecutive_run_time;
 
+#if TN_PROFILER_CYCLES || DOXYGEN_ACTIVE
+   ///
+   /// Available if only `#TN_PROFILER_CYCLES` option is non-zero.
+   ///
+   /// Total time (in cycles) spent in interrupts while the task was running:
+   /// that is, in `tn_tick_int_processing()` and in the interrupts marked by
+   /// `tn_sys_profiler_isr_enter()` / `tn_sys_profiler_isr_exit()`. This
+   /// time isn't included in `total_run_time`.
+   unsigned long long   total_isr_time;
+#endif
+
+#if defined(_TN_FPU_CTX_SAVED) || DOXYGEN_ACTIVE
+   ///
+   /// Available if only the CPU has FPU (Cortex-M4F).
+   ///
+   /// How many times task was switched out with FPU registers in its
+   /// context, i.e. how many context switches had to save FPU registers of
+   /// the task. Once task uses FPU, all its further context switches
+   /// are counted here; if it is zero, the task has never used FPU.
+   unsigned long long   fpu_ctx_switch_cnt;
+#endif
+
 #if TN_PROFILER_WAIT_TIME || DOXYGEN_ACTIVE
    ///
    /// Available if only `#TN_PROFILER_WAIT_TIME` option is non-zero.
@@ -303,6 +390,20 @@ struct _TN_TaskProfiler {
    ///
    /// Tick count of when the task got running or non-running last time.
    TN_TickCnt        last_tick_cnt;
+#if TN_PROFILER_CYCLES || DOXYGEN_ACTIVE
+   ///
+   /// Available if only `#TN_PROFILER_CYCLES` option is non-zero.
+   ///
+   /// Cycle count of when the run time of the task was accounted last time
+   /// (when the task got running, or interrupt was entered or exited).
+   TN_UWord          last_cycle_cnt;
+   ///
+   /// Available if only `#TN_PROFILER_CYCLES` option is non-zero.
+   ///
+   /// Number of cycles the task is running since it got running last time
+   /// (saturated at the max value of `#TN_UWord`).
+   TN_UWord          cur_run_cycles;
+#endif
 #if TN_PROFILER_WAIT_TIME || DOXYGEN_ACTIVE
    ///
    /// Available if only `#TN_PROFILER_WAIT_TIME` option is non-zero.
@@ -324,6 +425,23 @@ struct _TN_TaskProfiler {
 };
 #endif
 
+#if TN_TASK_NOTIFY || DOXYGEN_ACTIVE
+/**
+ * Task-specific fields related to waiting for the notification,
+ * see `tn_task_notify_wait()`.
+ */
+struct TN_TaskNotifyTaskWait {
+   ///
+   /// Notification value received by the task; it is stored here by the
+   /// notifier which completes the wait
+   TN_UWord value;
+   ///
+   /// What to do with the notification value, given to
+   /// `tn_task_notify_wait()`
+   enum TN_TaskNotifyWaitOpt opt;
+};
+#endif
+
 /**
  * Task
  */
@@ -358,6 +476,14 @@ struct TN_Task {
    ///
    /// list of all mutexes that are locked by task
    struct TN_ListItem mutex_queue;
+#if TN_FAST_PATH || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Mutex that is locked by the task by the lock-free fast path (see
+   /// `#TN_FAST_PATH`) and isn't included in `mutex_queue`: it is moved
+   /// there as soon as some other task has to wait for it. Available if
+   /// only `#TN_FAST_PATH` is non-zero.
+   struct TN_Mutex *fast_mutex;
+#endif
 #if TN_MUTEX_DEADLOCK_DETECT
    ///
    /// list of other tasks involved in deadlock. This list is non-empty
@@ -426,6 +552,19 @@ struct TN_Task {
       ///
       /// fields specific to tn_fmem.h
       struct TN_FMemTaskWait fmem;
+      ///
+      /// fields specific to tn_mqueue.h
+      struct TN_MQueueTaskWait mqueue;
+#if TN_MULTI_WAIT || defined(DOXYGEN_ACTIVE)
+      ///
+      /// fields specific to tn_multi_wait.h
+      struct TN_MultiWaitTaskWait multi;
+#endif
+#if TN_TASK_NOTIFY || defined(DOXYGEN_ACTIVE)
+      ///
+      /// fields specific to the task notifications
+      struct TN_TaskNotifyTaskWait notify;
+#endif
    } subsys_wait;
    ///
    /// Task name for debug purposes, user may want to set it by hand
@@ -434,6 +573,12 @@ struct TN_Task {
    /// Profiler data, available if only `#TN_PROFILER` is non-zero.
    struct _TN_TaskProfiler    profiler;
 #endif
+#if TN_TASK_NOTIFY || DOXYGEN_ACTIVE
+   ///
+   /// Notification value, available if only `#TN_TASK_NOTIFY` is non-zero.
+   /// See `tn_task_notify()`.
+   TN_UWord notify_value;
+#endif
 
    /// Internal flag used to optimize mutex priority algorithms.
    /// For the comments on it, see file tn_mutex.c,
@@ -446,11 +591,41 @@ struct TN_Task {
    /// if the caller is interested in the relevant value of this flag.
    unsigned          waited : 1;
 
+   /// Flag indicates that the task waits in the wait queue ordered by
+   /// priority (see `#TN_WAIT_ORDER_PRIO`), so its place in the queue
+   /// should be updated when its priority changes.
+   unsigned          wait_prio_order : 1;
+
+#if TN_TASK_NOTIFY || DOXYGEN_ACTIVE
+   /// Flag indicates that the task has a pending notification, i.e.
+   /// `tn_task_notify_wait()` will return immediately.
+   unsigned          notify_pending : 1;
+#endif
+
 
 // Other implementation specific fields may be added below
 
 };
 
+/**
+ * Schedule of periodic releases of a task, see `tn_task_period_start()` and
+ * `tn_task_period_wait()`. The structure is allocated by application,
+ * but its fields are maintained by the kernel; application may read
+ * them, but should not modify.
+ */
+struct TN_TaskPeriod {
+   ///
+   /// Release period, in system ticks
+   TN_TickCnt period;
+   ///
+   /// Absolute time (in terms of `tn_sys_time_get()`) of the next release
+   TN_TickCnt next_release;
+   ///
+   /// Number of releases missed because the task was late, i.e. it called
+   /// `tn_task_period_wait()` when the release time had already passed.
+   unsigned long overruns_cnt;
+};
+
 
 
 /*******************************************************************************
@@ -647,6 +822,111 @@ enum TN_RCode tn_task_resume(struct TN_Task *task);
  */
 enum TN_RCode tn_task_sleep(TN_TickCnt timeout);
 
+/**
+ * Put current task to sleep until the given absolute time (in terms of
+ * `tn_sys_time_get()`). Contrary to `tn_task_sleep()`, the time spent by the
+ * task before the call (including preemption) doesn't make it wake up later,
+ * so the sequence of such calls with deadlines incremented by some period
+ * doesn't drift.
+ *
+ * The deadline is compared with current time with interrupts disabled,
+ * right before going to sleep.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param deadline
+ *    Absolute time to wake up at, in system ticks. If it is already
+ *    reached (that is, it is not more than half of the `#TN_TickCnt` range
+ *    behind current time), the function returns immediately.
+ *
+ * @returns
+ *    * `#TN_RC_TIMEOUT` if task has slept until the deadline, or if the
+ *      deadline is already reached;
+ *    * `#TN_RC_OK` if task was woken up from other task by `tn_task_wakeup()`
+ *    * `#TN_RC_FORCED` if task was released from wait forcibly by 
+ *       `tn_task_release_wait()`
+ *    * `#TN_RC_WCONTEXT` if called from wrong context
+ *
+ * @see `tn_sys_timeout_until()`
+ */
+enum TN_RCode tn_task_sleep_until(TN_TickCnt deadline);
+
+/**
+ * Start periodic schedule of the current task: the first release is
+ * `period` ticks from now. Then, the task should call
+ * `tn_task_period_wait()` at the end of each iteration.
+ *
+ * Typical usage:
+ *
+ * \code{.c}
+ * struct TN_TaskPeriod per;
+ *
+ * tn_task_period_start(&per, 10);
+ * for (;;){
+ *    //-- do the job
+ *    // ...
+ *
+ *    //-- wait for the next release
+ *    tn_task_period_wait(&per);
+ * }
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param per
+ *    Schedule to initialize
+ * @param period
+ *    Release period, in system ticks. Can't be `0` or `#TN_WAIT_INFINITE`.
+ *
+ * @returns
+ *    * `#TN_RC_OK` on success;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_WPARAM` if `period` is wrong. If `#TN_CHECK_PARAM` is
+ *      non-zero, it is also returned if `per` is `TN_NULL`.
+ */
+enum TN_RCode tn_task_period_start(
+      struct TN_TaskPeriod *per,
+      TN_TickCnt period
+      );
+
+/**
+ * Wait for the next release of the periodic schedule started by
+ * `tn_task_period_start()`. Release times are kept by the kernel as
+ * absolute ones, so they don't drift regardless of how long the task
+ * executes and how often it gets preempted.
+ *
+ * If the release time has already passed when the function is called (the
+ * task is late), it returns `#TN_RC_OVERFLOW` immediately, without
+ * sleeping; all the releases that have passed are added to `overruns_cnt` of
+ * the schedule, and the next release is the first one in the future, so that
+ * the schedule keeps its phase.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param per
+ *    Schedule started by `tn_task_period_start()`
+ *
+ * @returns
+ *    * `#TN_RC_OK` if task has slept until the release time (or if it is
+ *      exactly the release time now);
+ *    * `#TN_RC_OVERFLOW` if the release time has already passed, see above;
+ *    * `#TN_RC_FORCED` if task was woken up before the release time: either
+ *      from other task by `tn_task_wakeup()`, or forcibly by
+ *      `tn_task_release_wait()`. The next release time is advanced anyway,
+ *      so the following call waits for the next release;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, `#TN_RC_WPARAM` is returned if
+ *      `per` is `TN_NULL`.
+ */
+enum TN_RCode tn_task_period_wait(struct TN_TaskPeriod *per);
+
 /**
  * Wake up task from sleep.
  *
@@ -899,6 +1179,99 @@ enum TN_RCode tn_task_profiler_timing_get(
  */
 enum TN_RCode tn_task_change_priority(struct TN_Task *task, int new_priority);
 
+#if TN_TASK_NOTIFY || DOXYGEN_ACTIVE
+
+/**
+ * Notify the task: modify its notification value as `action` says, and
+ * make the notification pending. If the task waits for the notification in
+ * `tn_task_notify_wait()`, it is woken up.
+ *
+ * This is a lightweight alternative to semaphores and event groups for the
+ * case when there is exactly one task to signal: no separate kernel object
+ * is needed, and there's no wait queue to walk.
+ *
+ * Available if only `#TN_TASK_NOTIFY` is non-zero.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param task
+ *    Task to notify
+ * @param action
+ *    What to do with the notification value, see `enum #TN_TaskNotifyAction`
+ * @param value
+ *    Value for the action; ignored by `#TN_TASK_NOTIFY_INCREMENT`
+ *
+ * @return
+ *    * `#TN_RC_OK` if successful;
+ *    * `#TN_RC_OVERFLOW` if `action` is `#TN_TASK_NOTIFY_INCREMENT` and the
+ *      notification value is already the maximum one; the value is left
+ *      intact then;
+ *    * `#TN_RC_WSTATE` if the task is dormant;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_WPARAM` if `action` is wrong;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_task_notify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      );
+
+/**
+ * The same as `tn_task_notify()` but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_task_inotify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      );
+
+/**
+ * Wait for the notification of the current task, see `tn_task_notify()`.
+ * If the notification is already pending, the function returns immediately;
+ * otherwise, the task waits for at most `timeout` ticks.
+ *
+ * Available if only `#TN_TASK_NOTIFY` is non-zero.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param p_value
+ *    Pointer to the location where notification value (before it is
+ *    cleared or decremented) should be stored; may be `TN_NULL`.
+ * @param opt
+ *    What to do with the notification value, see
+ *    `enum #TN_TaskNotifyWaitOpt`
+ * @param timeout
+ *    Refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if the notification is received;
+ *    * `#TN_RC_TIMEOUT` if there's no notification pending and `timeout`
+ *      is zero, or if timeout expired;
+ *    * `#TN_RC_FORCED` if task was released from wait forcibly by 
+ *       `tn_task_release_wait()`
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, `#TN_RC_WPARAM` is returned if
+ *      `opt` is wrong.
+ */
+enum TN_RCode tn_task_notify_wait(
+      TN_UWord *p_value,
+      enum TN_TaskNotifyWaitOpt opt,
+      TN_TickCnt timeout
+      );
+
+#endif   // TN_TASK_NOTIFY
+
 #ifdef __cplusplus
 }  /* extern "C" */
 #endif
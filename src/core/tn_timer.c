@@ -277,7 +277,7 @@ enum TN_RCode _tn_timer_create(
       timer->timeout = 0;
       timer->start_tick_cnt = 0;
 #else
-      timer->timeout_cur   = 0;
+      timer->expire_tick_cnt = 0;
 #endif
       timer->id_timer      = TN_ID_TIMER;
 
@@ -150,6 +150,56 @@
  *
  * The `N` in the TNeo is configured by the compile-time option
  * `#TN_TICK_LISTS_CNT`.
+ *
+ * The weak point of this scheme is the "generic" list: if the application has
+ * lots of long-range timers (or tasks waiting with large timeouts), all of
+ * them are walked through each `N`-th tick, so the worst-case time of the
+ * tick interrupt grows with the number of timers. To get rid of that, more
+ * levels of lists might be configured by the option `#TN_TICK_WHEEL_LEVELS`
+ * (say, `L`), just like the Linux kernel does:
+ *
+ * - Each timer remembers the absolute tick count at which it expires;
+ * - Level `0` is the "tick" lists described above: each one holds timers
+ *   which expire at some particular tick during the next `N` ticks;
+ * - Each list at level `k` (`1 <= k < L`) holds timers which expire during
+ *   some particular period of `N^k` ticks, in the next `N^(k+1)` ticks;
+ * - Timers which expire even farther are kept in the "generic" list.
+ *
+ * When the lower bits of tick count indicate that the current period of level
+ * `k` has just begun, all the timers from the appropriate list of level `k`
+ * are moved to the lower levels (the "generic" list is handled in the same
+ * way each `N^L`-th tick). So, each timer is moved at most once per level,
+ * instead of being touched each `N`-th tick, at the cost of `N` more list
+ * heads of RAM per level. With the default `L = 1`, there are no additional
+ * levels, and the behavior is exactly as described above.
+ *
+ * \section timers_dynamic_wheel_implementation Implementation of dynamic timers
+ *
+ * By default, dynamic timers are kept in a single list sorted by the
+ * expiration time. Finding the nearest timer (to tell the application when
+ * to call `tn_tick_int_processing()` next time) is trivial then, but starting
+ * a timer requires walking through the list, so it takes time proportional
+ * to the number of active timers. Remember that each wait with timeout
+ * starts a timer, too.
+ *
+ * If your application has a lot of active timers, consider turning on the
+ * option `#TN_DYNAMIC_TICK_WHEEL`: then, timers are kept in the hierarchical
+ * timing wheel. The wheel has `L` levels (`L` is configured by
+ * `#TN_DYNAMIC_TICK_WHEEL_LEVELS`), and each level has `W` slots, where `W`
+ * is `#TN_INT_WIDTH`. Each slot of level 0 corresponds to a single system
+ * tick, each slot of level 1 corresponds to `W` ticks, and so on.
+ *
+ * When timer is started, it is added to the lowest level at which its
+ * expiration time is less than `W` slots ahead, so, starting and cancelling a
+ * timer always takes constant time. When the time reaches the slot of some
+ * higher level, timers from it are "cascaded": moved to lower levels. When
+ * the time reaches the slot of level 0, all timers from it are fired.
+ *
+ * Each level also has a bitmap of non-empty slots (one `#TN_UWord`), so, the
+ * nearest slot of each level is found by a single find-first-set operation,
+ * and empty slots are skipped even if the kernel didn't get ticks for a long
+ * time. Note that the nearest slot might be a higher-level slot which needs
+ * cascading only, so the kernel might get a tick at which no timer fires.
  */
 
 
@@ -234,8 +284,8 @@ struct TN_Timer {
    ///
    /// $(TN_IF_ONLY_DYNAMIC_TICK_NOT_SET)
    ///
-   /// Current (left) timeout value
-   TN_TickCnt timeout_cur;
+   /// Tick count value at which timer expires
+   TN_TickCnt expire_tick_cnt;
 #endif
 };
 
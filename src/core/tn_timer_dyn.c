@@ -76,11 +76,32 @@ TN_CBTickCntGet        *_tn_cb_tick_cnt_get  = TN_NULL;
  *    PRIVATE DATA
  ******************************************************************************/
 
+#if !TN_DYNAMIC_TICK_WHEEL
 ///
 /// List of active non-expired timers. Timers are sorted in ascending order
 /// by the timeout value.
 static struct TN_ListItem     _timer_list__gen;
 
+#else
+///
+/// Hierarchical timing wheel: `#TN_DYNAMIC_TICK_WHEEL_LEVELS` levels, each of
+/// them has `#TN_INT_WIDTH` slots. Each slot of level `N` covers
+/// `(TN_INT_WIDTH ^ N)` system ticks. Refer to the \ref
+/// timers_dynamic_wheel_implementation for details.
+static struct TN_ListItem     _timer_wheel[ TN_DYNAMIC_TICK_WHEEL_LEVELS ]
+                                          [ TN_INT_WIDTH ];
+
+///
+/// Bitmap of non-empty slots, one word for each level of `_timer_wheel`.
+static TN_UWord               _timer_wheel_bmp[ TN_DYNAMIC_TICK_WHEEL_LEVELS ];
+
+///
+/// Time (system tick count) up to which the wheel is processed: all timers
+/// that expire at or before this time are already fired.
+static TN_TickCnt             _timer_wheel_time;
+
+#endif
+
 
 /// List of expired timers; after it is initialized, it is used only inside
 /// `_tn_timers_tick_proceed()`
@@ -101,6 +122,57 @@ static struct TN_ListItem     _timer_list__fire;
    (que ? container_of(que, struct TN_Timer, timer_queue) : 0)
 
 
+#if TN_DYNAMIC_TICK_WHEEL
+
+//-- number of bits of tick count covered by each wheel level
+#if TN_INT_WIDTH == 64
+#  define _WHEEL_SLOT_BITS       6
+#elif TN_INT_WIDTH == 32
+#  define _WHEEL_SLOT_BITS       5
+#elif TN_INT_WIDTH == 16
+#  define _WHEEL_SLOT_BITS       4
+#else
+#  error unsupported TN_INT_WIDTH for the timing wheel
+#endif
+
+#define _WHEEL_SLOTS_CNT         TN_INT_WIDTH
+#define _WHEEL_SLOTS_MASK        (_WHEEL_SLOTS_CNT - 1)
+
+//-- NOTE: level 0 can't be the top level as well, since timers from the top
+//   level might need to be placed again instead of being fired.
+#if (TN_DYNAMIC_TICK_WHEEL_LEVELS < 2)
+#  error TN_DYNAMIC_TICK_WHEEL_LEVELS must be at least 2
+#endif
+
+#if (TN_DYNAMIC_TICK_WHEEL_LEVELS * _WHEEL_SLOT_BITS > 32)
+#  error TN_DYNAMIC_TICK_WHEEL_LEVELS is too large: the wheel must not cover \
+      more than 32 bits of tick count
+#endif
+
+/**
+ * Shift of the tick count for the given wheel level: slot index of the
+ * `level` is given by `((tick_cnt >> _WHEEL_SHIFT(level)) & _WHEEL_SLOTS_MASK)`
+ */
+#define _WHEEL_SHIFT(level)      ((level) * _WHEEL_SLOT_BITS)
+
+/**
+ * Mask for the tick count shifted by `_WHEEL_SHIFT(level)`: needed to perform
+ * overflow-safe subtraction of shifted tick counts.
+ */
+#define _WHEEL_SHIFTED_MASK(level)                                      \
+   (((TN_TickCnt)-1) >> _WHEEL_SHIFT(level))
+
+/**
+ * Rotate bitmap of slots right by `cnt` bits (`cnt` should be less than
+ * `_WHEEL_SLOTS_CNT`)
+ */
+#define _WHEEL_BMP_ROTATE(bmp, cnt)                                     \
+   ((cnt) == 0                                                          \
+    ? (bmp)                                                             \
+    : (TN_UWord)(((bmp) >> (cnt)) | ((bmp) << (_WHEEL_SLOTS_CNT - (cnt)))))
+
+#endif // TN_DYNAMIC_TICK_WHEEL
+
 
 
 
@@ -132,12 +204,72 @@ static TN_TickCnt _time_left_get(
    return time_left;
 }
 
+#if !TN_DYNAMIC_TICK_WHEEL
+
+//-- Storage of active timers: sorted list {{{
+
 /**
- * Find out when the kernel needs `tn_tick_int_processing()` to be called next
- * time, and eventually call application callback `_tn_cb_tick_schedule()` with
- * found value.
+ * Reset the storage of active timers, i.e. make it empty.
  */
-static void _next_tick_schedule(TN_TickCnt cur_sys_tick_cnt)
+static void _timers_reset(void)
+{
+   //-- reset "generic" timers list
+   _tn_list_reset(&_timer_list__gen);
+}
+
+/**
+ * Put the timer to the storage of active timers. Timer's `timeout` and
+ * `start_tick_cnt` should be already set.
+ */
+static void _timer_add(struct TN_Timer *timer, TN_TickCnt cur_sys_tick_cnt)
+{
+   //-- Since timers list is sorted, we need to find the correct place
+   //   to put new timer at.
+   //
+   //   Initially, we set it to the head of the list, and then walk
+   //   through timers until we found needed place (or until list is over)
+   struct TN_ListItem *list_item = &_timer_list__gen;
+   {
+      struct TN_Timer *cur_timer;
+      struct TN_Timer *tmp_timer;
+
+      _tn_list_for_each_entry_safe(
+            cur_timer, struct TN_Timer, tmp_timer,
+            &_timer_list__gen, timer_queue
+            )
+      {
+         //-- timeout value should never be TN_WAIT_INFINITE.
+         _TN_BUG_ON(cur_timer->timeout == TN_WAIT_INFINITE);
+
+         if (_time_left_get(cur_timer, cur_sys_tick_cnt) < timer->timeout){
+            //-- Probably this is the place for new timer..
+            list_item = &cur_timer->timer_queue;
+         } else {
+            //-- Found timer with larger timeout than that of new timer.
+            //   So, list_item now contains the correct place for new timer.
+            break;
+         }
+      }
+   }
+
+   //-- put timer object at the right position.
+   _tn_list_add_head(list_item, &(timer->timer_queue));
+}
+
+/**
+ * Remove the timer from the list it is contained in (it might be either
+ * the storage of active timers, or the "fire" list)
+ */
+static void _timer_remove(struct TN_Timer *timer)
+{
+   _tn_list_remove_entry(&(timer->timer_queue));
+}
+
+/**
+ * Get time left until the nearest timer expires, or `#TN_WAIT_INFINITE` if
+ * there are no active timers.
+ */
+static TN_TickCnt _next_timeout_get(TN_TickCnt cur_sys_tick_cnt)
 {
    TN_TickCnt next_timeout;
 
@@ -155,8 +287,337 @@ static void _next_tick_schedule(TN_TickCnt cur_sys_tick_cnt)
       next_timeout = TN_WAIT_INFINITE;
    }
 
-   //-- schedule next tick
-   _tn_cb_tick_schedule(next_timeout);
+   return next_timeout;
+}
+
+/**
+ * Move all the expired timers to the "fire" list `_timer_list__fire`.
+ */
+static void _expired_timers_move(TN_TickCnt cur_sys_tick_cnt)
+{
+   struct TN_Timer *timer;
+   struct TN_Timer *tmp_timer;
+
+   //-- Walk through timers list from start until we get non-expired timer
+   //   (timers list is sorted)
+   _tn_list_for_each_entry_safe(
+         timer, struct TN_Timer, tmp_timer,
+         &_timer_list__gen, timer_queue
+         )
+   {
+      //-- timeout value should never be TN_WAIT_INFINITE.
+      _TN_BUG_ON(timer->timeout == TN_WAIT_INFINITE);
+
+      if (_time_left_get(timer, cur_sys_tick_cnt) == 0){
+         //-- it's time to fire the timer, so, move it to the "fire" list
+         //   `_timer_list__fire`
+         _tn_list_remove_entry(&(timer->timer_queue));
+         _tn_list_add_tail(&_timer_list__fire, &(timer->timer_queue));
+      } else {
+         //-- We've got non-expired timer, therefore there are no more
+         //   expired timers.
+         break;
+      }
+   }
+}
+
+// }}}
+
+#else
+
+//-- Storage of active timers: hierarchical timing wheel {{{
+
+/**
+ * Find first set bit in the bitmap of wheel slots. Bitmap must be non-zero.
+ *
+ * @return
+ *    1-based index of the least significant bit set.
+ */
+static int _wheel_ffs(TN_UWord bmp)
+{
+   _TN_BUG_ON(bmp == 0);
+
+#ifdef _TN_FFS
+   return _TN_FFS(bmp);
+#else
+   int ret = 1;
+
+   while (!(bmp & 1)){
+      bmp >>= 1;
+      ret++;
+   }
+
+   return ret;
+#endif
+}
+
+/**
+ * Put timer to the wheel, to the slot which corresponds to its expiration
+ * time.
+ *
+ * The level is chosen as the lowest one at which the expiration time is
+ * less than `_WHEEL_SLOTS_CNT` slots ahead of `_timer_wheel_time`. If
+ * expiration time is too far even for the top level, the timer is put into
+ * the farthest slot of the top level, and it will be placed again when that
+ * slot is cascaded.
+ */
+static void _wheel_timer_put(struct TN_Timer *timer)
+{
+   TN_TickCnt expire_tick_cnt = timer->start_tick_cnt + timer->timeout;
+   TN_TickCnt slots_ahead = 0;
+   int level;
+   int slot;
+
+   for (level = 0; level < TN_DYNAMIC_TICK_WHEEL_LEVELS; level++){
+      slots_ahead = (
+            (expire_tick_cnt   >> _WHEEL_SHIFT(level))
+            - (_timer_wheel_time >> _WHEEL_SHIFT(level))
+            ) & _WHEEL_SHIFTED_MASK(level);
+
+      if (slots_ahead < _WHEEL_SLOTS_CNT){
+         //-- found appropriate level
+         break;
+      } else if (level == (TN_DYNAMIC_TICK_WHEEL_LEVELS - 1)){
+         //-- timeout is too large even for the top level: put the timer
+         //   into the farthest slot of it.
+         slots_ahead = (_WHEEL_SLOTS_CNT - 1);
+         break;
+      }
+   }
+
+   slot = (int)(
+         ((_timer_wheel_time >> _WHEEL_SHIFT(level)) + slots_ahead)
+         & _WHEEL_SLOTS_MASK
+         );
+
+   _tn_list_add_tail(&_timer_wheel[level][slot], &(timer->timer_queue));
+   _timer_wheel_bmp[level] |= ((TN_UWord)1 << slot);
+}
+
+/**
+ * Find out how many ticks are left (starting from `_timer_wheel_time`) until
+ * the next wheel event: either expiration of timer(s) from level 0, or
+ * cascading of timers from some higher-level slot.
+ *
+ * @return
+ *    Count of ticks, or `#TN_WAIT_INFINITE` if the wheel is empty.
+ */
+static TN_TickCnt _wheel_next_event_get(void)
+{
+   TN_TickCnt ret = TN_WAIT_INFINITE;
+   int level;
+
+   for (level = 0; level < TN_DYNAMIC_TICK_WHEEL_LEVELS; level++){
+      TN_UWord bmp = _timer_wheel_bmp[level];
+
+      if (bmp != 0){
+         TN_TickCnt cur_slot = (_timer_wheel_time >> _WHEEL_SHIFT(level));
+         int rotate_cnt = (int)((cur_slot + 1) & _WHEEL_SLOTS_MASK);
+         TN_TickCnt ticks_left;
+
+         //-- rotate bitmap so that the slot next to the current one is at
+         //   bit 0, and find the first non-empty slot.
+         cur_slot += _wheel_ffs(_WHEEL_BMP_ROTATE(bmp, rotate_cnt));
+
+         //-- slot becomes due at its lower bound
+         ticks_left = (cur_slot << _WHEEL_SHIFT(level)) - _timer_wheel_time;
+
+         if (ticks_left < ret){
+            ret = ticks_left;
+         }
+      }
+   }
+
+   return ret;
+}
+
+/**
+ * Reset the storage of active timers, i.e. make it empty.
+ */
+static void _timers_reset(void)
+{
+   int level;
+   int slot;
+
+   for (level = 0; level < TN_DYNAMIC_TICK_WHEEL_LEVELS; level++){
+      for (slot = 0; slot < _WHEEL_SLOTS_CNT; slot++){
+         _tn_list_reset(&_timer_wheel[level][slot]);
+      }
+      _timer_wheel_bmp[level] = 0;
+   }
+
+   _timer_wheel_time = 0;
+}
+
+/**
+ * Put the timer to the storage of active timers. Timer's `timeout` and
+ * `start_tick_cnt` should be already set.
+ */
+static void _timer_add(struct TN_Timer *timer, TN_TickCnt cur_sys_tick_cnt)
+{
+   TN_UWord bmp_all = 0;
+   int level;
+
+   for (level = 0; level < TN_DYNAMIC_TICK_WHEEL_LEVELS; level++){
+      bmp_all |= _timer_wheel_bmp[level];
+   }
+
+   if (bmp_all == 0){
+      //-- The wheel is empty, so nobody schedules ticks and wheel time might
+      //   be arbitrarily far behind: just move it to the current time.
+      _timer_wheel_time = cur_sys_tick_cnt;
+   }
+
+   _wheel_timer_put(timer);
+}
+
+/**
+ * Remove the timer from the list it is contained in (it might be either
+ * some wheel slot, or the "fire" list). If the wheel slot becomes empty,
+ * the appropriate bit in the bitmap is cleared.
+ */
+static void _timer_remove(struct TN_Timer *timer)
+{
+   struct TN_ListItem *next = timer->timer_queue.next;
+   struct TN_ListItem *wheel_start = &_timer_wheel[0][0];
+   struct TN_ListItem *wheel_end
+      = wheel_start + (TN_DYNAMIC_TICK_WHEEL_LEVELS * _WHEEL_SLOTS_CNT);
+
+   //-- If the timer is the only item in the list, then the neighbor is the
+   //   list head; check whether it is a wheel slot.
+   if (     next == timer->timer_queue.prev
+         && next >= wheel_start
+         && next < wheel_end
+      )
+   {
+      int idx = (int)(next - wheel_start);
+
+      _timer_wheel_bmp[idx / _WHEEL_SLOTS_CNT] &=
+         ~((TN_UWord)1 << (idx & _WHEEL_SLOTS_MASK));
+   }
+
+   _tn_list_remove_entry(&(timer->timer_queue));
+}
+
+/**
+ * Get time left until the nearest wheel event, or `#TN_WAIT_INFINITE` if
+ * there are no active timers.
+ *
+ * Note that the event is not necessarily an expiration of some timer: it
+ * might be cascading of a higher-level slot as well, so the kernel might get
+ * a tick at which no timer fires. There is at most one such tick per slot of
+ * a higher level, which is the price for O(1) starting and cancelling of
+ * timers.
+ */
+static TN_TickCnt _next_timeout_get(TN_TickCnt cur_sys_tick_cnt)
+{
+   TN_TickCnt next_timeout = _wheel_next_event_get();
+
+   if (next_timeout != TN_WAIT_INFINITE){
+      //-- The event time is relative to `_timer_wheel_time`, which might be
+      //   behind the current time; adjust it.
+      TN_TickCnt wheel_lag = cur_sys_tick_cnt - _timer_wheel_time;
+
+      if (next_timeout > wheel_lag){
+         next_timeout -= wheel_lag;
+      } else {
+         next_timeout = 0;
+      }
+   }
+
+   return next_timeout;
+}
+
+/**
+ * Move all the expired timers to the "fire" list `_timer_list__fire`,
+ * cascading higher-level slots as needed, and advance `_timer_wheel_time` to
+ * the current time.
+ */
+static void _expired_timers_move(TN_TickCnt cur_sys_tick_cnt)
+{
+   TN_TickCnt ticks_to_go = cur_sys_tick_cnt - _timer_wheel_time;
+   TN_TickCnt ticks_next;
+
+   //-- Jump from one wheel event to another (skipping empty slots), until
+   //   the next event is in the future
+   while (
+         (ticks_next = _wheel_next_event_get()) != TN_WAIT_INFINITE
+         && ticks_next <= ticks_to_go
+         )
+   {
+      int level;
+      int slot;
+
+      _timer_wheel_time += ticks_next;
+      ticks_to_go       -= ticks_next;
+
+      //-- Cascade slots that are due now, starting from the top level,
+      //   so that timers can be cascaded through several levels at once.
+      for (level = (TN_DYNAMIC_TICK_WHEEL_LEVELS - 1); level > 0; level--){
+         TN_TickCnt low_bits_mask
+            = (((TN_TickCnt)1 << _WHEEL_SHIFT(level)) - 1);
+
+         if ((_timer_wheel_time & low_bits_mask) == 0){
+            slot = (int)(
+                  (_timer_wheel_time >> _WHEEL_SHIFT(level)) & _WHEEL_SLOTS_MASK
+                  );
+
+            if (_timer_wheel_bmp[level] & ((TN_UWord)1 << slot)){
+               struct TN_ListItem *slot_list = &_timer_wheel[level][slot];
+
+               _timer_wheel_bmp[level] &= ~((TN_UWord)1 << slot);
+
+               //-- Put each timer to the lower level (or, for the timers
+               //   which were too far in the future, maybe to the top level
+               //   again). Timer is never put back to the same slot, so
+               //   the loop is finite.
+               while (!_tn_list_is_empty(slot_list)){
+                  struct TN_Timer *timer = _tn_list_first_entry(
+                        slot_list, struct TN_Timer, timer_queue
+                        );
+
+                  _tn_list_remove_entry(&(timer->timer_queue));
+                  _wheel_timer_put(timer);
+               }
+            }
+         }
+      }
+
+      //-- All the timers from the current slot of level 0 expire right now:
+      //   move them to the "fire" list.
+      slot = (int)(_timer_wheel_time & _WHEEL_SLOTS_MASK);
+
+      if (_timer_wheel_bmp[0] & ((TN_UWord)1 << slot)){
+         struct TN_ListItem *slot_list = &_timer_wheel[0][slot];
+
+         _timer_wheel_bmp[0] &= ~((TN_UWord)1 << slot);
+
+         while (!_tn_list_is_empty(slot_list)){
+            struct TN_ListItem *item = _tn_list_remove_head(slot_list);
+            _tn_list_add_tail(&_timer_list__fire, item);
+         }
+      }
+   }
+
+   //-- There are no wheel events until the current time, so it is safe to
+   //   just move wheel time forward.
+   _timer_wheel_time = cur_sys_tick_cnt;
+}
+
+// }}}
+
+#endif // TN_DYNAMIC_TICK_WHEEL
+
+/**
+ * Find out when the kernel needs `tn_tick_int_processing()` to be called next
+ * time, and eventually call application callback `_tn_cb_tick_schedule()` with
+ * found value.
+ */
+static void _next_tick_schedule(TN_TickCnt cur_sys_tick_cnt)
+{
+   //-- schedule next tick (if there are no active timers, `TN_WAIT_INFINITE`
+   //   is given, so that no ticks are needed at all)
+   _tn_cb_tick_schedule(_next_timeout_get(cur_sys_tick_cnt));
 }
 
 
@@ -172,7 +633,7 @@ static void _timer_cancel(struct TN_Timer *timer)
    timer->start_tick_cnt = 0;
 
    //-- remove entry from timer queue
-   _tn_list_remove_entry(&(timer->timer_queue));
+   _timer_remove(timer);
 
    //-- reset the list
    _tn_list_reset(&(timer->timer_queue));
@@ -215,8 +676,8 @@ void _tn_timers_init(void)
       _TN_FATAL_ERROR("");
    }
 
-   //-- reset "generic" timers list
-   _tn_list_reset(&_timer_list__gen);
+   //-- reset the storage of active timers
+   _timers_reset();
 
    //-- reset "current" timers list
    _tn_list_reset(&_timer_list__fire);
@@ -239,32 +700,8 @@ void _tn_timers_tick_proceed(TN_UWord TN_INTSAVE_VAR)
    //-- First of all, get current time
    TN_TickCnt cur_sys_tick_cnt = _tn_timer_sys_time_get();
 
-   //-- Now, walk through timers list from start until we get non-expired timer
-   //   (timers list is sorted)
-   {
-      struct TN_Timer *timer;
-      struct TN_Timer *tmp_timer;
-
-      _tn_list_for_each_entry_safe(
-            timer, struct TN_Timer, tmp_timer,
-            &_timer_list__gen, timer_queue
-            )
-      {
-         //-- timeout value should never be TN_WAIT_INFINITE.
-         _TN_BUG_ON(timer->timeout == TN_WAIT_INFINITE);
-
-         if (_time_left_get(timer, cur_sys_tick_cnt) == 0){
-            //-- it's time to fire the timer, so, move it to the "fire" list
-            //   `_timer_list__fire`
-            _tn_list_remove_entry(&(timer->timer_queue));
-            _tn_list_add_tail(&_timer_list__fire, &(timer->timer_queue));
-         } else {
-            //-- We've got non-expired timer, therefore there are no more
-            //   expired timers.
-            break;
-         }
-      }
-   }
+   //-- Now, move all expired timers to the "fire" list
+   _expired_timers_move(cur_sys_tick_cnt);
 
    //-- Now, we have "fire" list containing expired timers. Let's walk
    //   through them, firing each one.
@@ -306,48 +743,16 @@ enum TN_RCode _tn_timer_start(struct TN_Timer *timer, TN_TickCnt timeout)
       //-- cancel the timer
       _timer_cancel(timer);
 
-      //-- walk through active timers list and get the position at which
-      //   new timer should be placed.
-
       //-- First of all, get current time
       TN_TickCnt cur_sys_tick_cnt = _tn_timer_sys_time_get();
 
-      //-- Since timers list is sorted, we need to find the correct place
-      //   to put new timer at.
-      //
-      //   Initially, we set it to the head of the list, and then walk
-      //   through timers until we found needed place (or until list is over)
-      struct TN_ListItem *list_item = &_timer_list__gen;
-      {
-         struct TN_Timer *timer;
-         struct TN_Timer *tmp_timer;
-
-         _tn_list_for_each_entry_safe(
-               timer, struct TN_Timer, tmp_timer,
-               &_timer_list__gen, timer_queue
-               )
-         {
-            //-- timeout value should never be TN_WAIT_INFINITE.
-            _TN_BUG_ON(timer->timeout == TN_WAIT_INFINITE);
-
-            if (_time_left_get(timer, cur_sys_tick_cnt) < timeout){
-               //-- Probably this is the place for new timer..
-               list_item = &timer->timer_queue;
-            } else {
-               //-- Found timer with larger timeout than that of new timer.
-               //   So, list_item now contains the correct place for new timer.
-               break;
-            }
-         }
-      }
-
-      //-- put timer object at the right position.
-      _tn_list_add_head(list_item, &(timer->timer_queue));
-
       //-- initialize timer with given timeout
       timer->timeout = timeout;
       timer->start_tick_cnt = cur_sys_tick_cnt;
 
+      //-- put timer to the storage of active timers
+      _timer_add(timer, cur_sys_tick_cnt);
+
       //-- find out when `tn_tick_int_processing()` should be called next time,
       //   and tell that to application
       _next_tick_schedule(cur_sys_tick_cnt);
@@ -69,6 +69,12 @@ struct TN_ListItem _tn_timer_list__gen;
 //-- see comments in the file _tn_timer_static.h
 struct TN_ListItem _tn_timer_list__tick[ TN_TICK_LISTS_CNT ];
 
+#if (TN_TICK_WHEEL_LEVELS > 1)
+//-- see comments in the file _tn_timer_static.h
+struct TN_ListItem _tn_timer_list__wheel
+   [ TN_TICK_WHEEL_LEVELS - 1 ][ TN_TICK_LISTS_CNT ];
+#endif
+
 //-- see comments in the file _tn_timer_static.h
 volatile TN_TickCnt _tn_sys_time_count;
 
@@ -99,8 +105,54 @@ volatile TN_TickCnt _tn_sys_time_count;
 #  error TN_TICK_LISTS_CNT must be <= 256
 #endif
 
+/**
+ * Number of bits of tick count covered by each level of "tick" lists,
+ * i.e. `log2(TN_TICK_LISTS_CNT)`
+ */
+#if   (TN_TICK_LISTS_CNT == 2)
+#  define _TICK_LISTS_BITS   1
+#elif (TN_TICK_LISTS_CNT == 4)
+#  define _TICK_LISTS_BITS   2
+#elif (TN_TICK_LISTS_CNT == 8)
+#  define _TICK_LISTS_BITS   3
+#elif (TN_TICK_LISTS_CNT == 16)
+#  define _TICK_LISTS_BITS   4
+#elif (TN_TICK_LISTS_CNT == 32)
+#  define _TICK_LISTS_BITS   5
+#elif (TN_TICK_LISTS_CNT == 64)
+#  define _TICK_LISTS_BITS   6
+#elif (TN_TICK_LISTS_CNT == 128)
+#  define _TICK_LISTS_BITS   7
+#elif (TN_TICK_LISTS_CNT == 256)
+#  define _TICK_LISTS_BITS   8
+#endif
+
+#if (TN_TICK_WHEEL_LEVELS < 1)
+#  error TN_TICK_WHEEL_LEVELS must be >= 1
+#endif
+
+//-- Timers from the "generic" list are walked through when the lower
+//   (TN_TICK_WHEEL_LEVELS * _TICK_LISTS_BITS) bits of system tick count are
+//   zero, so, this value should be less than the width of `TN_TickCnt`.
+#if ((TN_TICK_WHEEL_LEVELS * _TICK_LISTS_BITS) >= 32)
+#  error TN_TICK_WHEEL_LEVELS is too large for given TN_TICK_LISTS_CNT
+#endif
 
 
+/**
+ * Shift of the system tick count for the given level of "tick" lists: index
+ * of the list at level `level` is given by
+ * `((tick_cnt >> _LEVEL_SHIFT(level)) & TN_TICK_LISTS_MASK)`
+ */
+#define _LEVEL_SHIFT(level)      ((level) * _TICK_LISTS_BITS)
+
+/**
+ * Mask of the lower bits of system tick count which should be zero when
+ * the list at level `level` becomes due.
+ */
+#define _LEVEL_LOW_MASK(level)                                          \
+   (((TN_TickCnt)1 << _LEVEL_SHIFT(level)) - 1)
+
 /**
  * Return index in the array `#_tn_timer_list__tick`, based on given timeout.
  *
@@ -116,6 +168,94 @@ volatile TN_TickCnt _tn_sys_time_count;
  *    PRIVATE FUNCTIONS
  ******************************************************************************/
 
+/**
+ * Put active timer to the appropriate list, depending on its
+ * `expire_tick_cnt` value:
+ *
+ * - if timer expires in the next `(TN_TICK_LISTS_CNT - 1)` ticks, it is put
+ *   to one of the "tick" lists `#_tn_timer_list__tick`;
+ * - otherwise, it is put to the lowest level of `#_tn_timer_list__wheel` at
+ *   which timer expires less than `TN_TICK_LISTS_CNT` lists ahead;
+ * - if timer expires even farther, it is put to the "generic" list
+ *   `#_tn_timer_list__gen`.
+ *
+ * Note that timer is never put to the same list which is being handled right
+ * now (when timer is started, `timeout` is at least 1).
+ */
+static void _timer_put(struct TN_Timer *timer)
+{
+   TN_TickCnt cur_tick_cnt = _tn_sys_time_count;
+   TN_TickCnt expire_tick_cnt = timer->expire_tick_cnt;
+   struct TN_ListItem *list = &_tn_timer_list__gen;
+
+   if ((TN_TickCnt)(expire_tick_cnt - cur_tick_cnt) < TN_TICK_LISTS_CNT){
+      //-- timer should be added to the one of "tick" lists.
+      list = &_tn_timer_list__tick[ expire_tick_cnt & TN_TICK_LISTS_MASK ];
+   } else {
+#if (TN_TICK_WHEEL_LEVELS > 1)
+      int level;
+
+      for (level = 1; level < TN_TICK_WHEEL_LEVELS; level++){
+         //-- number of lists of the `level` between current one and the
+         //   one at which timer expires. Note that we can't just shift the
+         //   difference between tick counts, since we need to take the
+         //   overflow into account.
+         TN_TickCnt lists_ahead = (
+               (expire_tick_cnt >> _LEVEL_SHIFT(level))
+               - (cur_tick_cnt  >> _LEVEL_SHIFT(level))
+               ) & (((TN_TickCnt)-1) >> _LEVEL_SHIFT(level));
+
+         if (lists_ahead < TN_TICK_LISTS_CNT){
+            list = &_tn_timer_list__wheel[ level - 1 ][
+               (expire_tick_cnt >> _LEVEL_SHIFT(level)) & TN_TICK_LISTS_MASK
+            ];
+            break;
+         }
+      }
+#endif
+   }
+
+   _tn_list_add_tail(list, &(timer->timer_queue));
+}
+
+/**
+ * Cascade the timers from the given list: each timer is put again by
+ * `_timer_put()`, so it moves to the lower level (or stays in the "generic"
+ * list, if it still expires too far in the future).
+ */
+static void _timer_list_cascade(struct TN_ListItem *list)
+{
+   if (!_tn_list_is_empty(list)){
+      struct TN_ListItem tmp_list;
+
+      //-- Since timers might be put back to the same list (it's the case
+      //   for "generic" list), first of all, move all the timers to the
+      //   temporary list.
+      tmp_list.next = list->next;
+      tmp_list.prev = list->prev;
+      tmp_list.next->prev = &tmp_list;
+      tmp_list.prev->next = &tmp_list;
+
+      _tn_list_reset(list);
+
+      //-- now, put each timer again
+      while (!_tn_list_is_empty(&tmp_list)){
+         struct TN_Timer *timer = _tn_list_first_entry(
+               &tmp_list, struct TN_Timer, timer_queue
+               );
+
+         //-- expiration time should never be in the past.
+         _TN_BUG_ON(
+               (TN_TickCnt)(timer->expire_tick_cnt - _tn_sys_time_count)
+               > (TN_TickCnt)(TN_WAIT_INFINITE - 1)
+               );
+
+         _tn_list_remove_entry(&(timer->timer_queue));
+         _timer_put(timer);
+      }
+   }
+}
+
 
 /*******************************************************************************
  *    PUBLIC FUNCTIONS
@@ -144,6 +284,19 @@ void _tn_timers_init(void)
    for (i = 0; i < TN_TICK_LISTS_CNT; i++){
       _tn_list_reset(&_tn_timer_list__tick[i]);
    }
+
+#if (TN_TICK_WHEEL_LEVELS > 1)
+   //-- reset all higher-level timer lists
+   {
+      int level;
+
+      for (level = 0; level < (TN_TICK_WHEEL_LEVELS - 1); level++){
+         for (i = 0; i < TN_TICK_LISTS_CNT; i++){
+            _tn_list_reset(&_tn_timer_list__wheel[level][i]);
+         }
+      }
+   }
+#endif
 }
 
 /**
@@ -161,42 +314,34 @@ void _tn_timers_tick_proceed(TN_UWord TN_INTSAVE_VAR)
 
    if (tick_list_index == 0){
       //-- it happens each TN_TICK_LISTS_CNT-th system tick:
-      //   now we should walk through all the timers in the "generic" timer
-      //   list, decrement the timeout of each one by TN_TICK_LISTS_CNT,
-      //   and if resulting timeout is less than TN_TICK_LISTS_CNT,
-      //   then move that timer to the appropriate "tick" timer list.
+      //   now we should cascade the lists of higher levels which become due,
+      //   starting from the top level, so that timers might move through
+      //   several levels at once.
+      TN_TickCnt cur_tick_cnt = _tn_sys_time_count;
+
+      //-- handle "generic" timer list, it happens each
+      //   (TN_TICK_LISTS_CNT ^ TN_TICK_WHEEL_LEVELS)-th system tick
+      if ((cur_tick_cnt & _LEVEL_LOW_MASK(TN_TICK_WHEEL_LEVELS)) == 0){
+         _timer_list_cascade(&_tn_timer_list__gen);
+      }
 
-      //-- handle "generic" timer list {{{
+#if (TN_TICK_WHEEL_LEVELS > 1)
+      //-- handle current list of each higher level
       {
-         struct TN_Timer *timer;
-         struct TN_Timer *tmp_timer;
-
-         _tn_list_for_each_entry_safe(
-               timer, struct TN_Timer, tmp_timer,
-               &_tn_timer_list__gen, timer_queue
-               )
-         {
-
-            //-- timeout value should always be >= TN_TICK_LISTS_CNT here.
-            //   And it should never be TN_WAIT_INFINITE.
-            _TN_BUG_ON(0
-                  || timer->timeout_cur == TN_WAIT_INFINITE 
-                  || timer->timeout_cur < TN_TICK_LISTS_CNT
-                  );
-
-            timer->timeout_cur -= TN_TICK_LISTS_CNT;
-
-            if (timer->timeout_cur < TN_TICK_LISTS_CNT){
-               //-- it's time to move this timer to the "tick" list
-               _tn_list_remove_entry(&(timer->timer_queue));
-               _tn_list_add_tail(
-                     &_tn_timer_list__tick[_TICK_LIST_INDEX(timer->timeout_cur)],
-                     &(timer->timer_queue)
+         int level;
+
+         for (level = (TN_TICK_WHEEL_LEVELS - 1); level > 0; level--){
+            if ((cur_tick_cnt & _LEVEL_LOW_MASK(level)) == 0){
+               _timer_list_cascade(
+                     &_tn_timer_list__wheel[ level - 1 ][
+                        (cur_tick_cnt >> _LEVEL_SHIFT(level))
+                        & TN_TICK_LISTS_MASK
+                     ]
                      );
             }
          }
       }
-      //}}}
+#endif
    }
 
    //-- it happens every system tick:
@@ -222,7 +367,7 @@ void _tn_timers_tick_proceed(TN_UWord TN_INTSAVE_VAR)
       //   Although timers could be removed from the list, note that
       //   new timer can't be added to it
       //   (because timeout 0 is disallowed, and timer with timeout
-      //   TN_TICK_LISTS_CNT is added to the "generic" list),
+      //   TN_TICK_LISTS_CNT is added to the higher-level list),
       //   see implementation details in the tn_timer.h file
       while (!_tn_list_is_empty(p_cur_timer_list)){
          timer = _tn_list_first_entry(
@@ -258,23 +403,10 @@ enum TN_RCode _tn_timer_start(struct TN_Timer *timer, TN_TickCnt timeout)
 
       //-- if timer is active, cancel it first
       if ((rc = _tn_timer_cancel(timer)) == TN_RC_OK){
-
-         if (timeout < TN_TICK_LISTS_CNT){
-            //-- timer should be added to the one of "tick" lists.
-            int tick_list_index = _TICK_LIST_INDEX(timeout);
-            timer->timeout_cur = tick_list_index;
-
-            _tn_list_add_tail(
-                  &_tn_timer_list__tick[ tick_list_index ],
-                  &(timer->timer_queue)
-                  );
-         } else {
-            //-- timer should be added to the "generic" list.
-            //   We should set timeout_cur adding current "tick" index to it.
-            timer->timeout_cur = timeout + _TICK_LIST_INDEX(0);
-
-            _tn_list_add_tail(&_tn_timer_list__gen, &(timer->timer_queue));
-         }
+         //-- remember when the timer expires, and put it to the
+         //   appropriate list
+         timer->expire_tick_cnt = _tn_sys_time_count + timeout;
+         _timer_put(timer);
       }
    }
 
@@ -292,8 +424,8 @@ enum TN_RCode _tn_timer_cancel(struct TN_Timer *timer)
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
    if (_tn_timer_is_active(timer)){
-      //-- reset timeout to zero (but this is actually not necessary)
-      timer->timeout_cur = 0;
+      //-- reset expiration time to zero (but this is actually not necessary)
+      timer->expire_tick_cnt = 0;
 
       //-- remove entry from timer queue
       _tn_list_remove_entry(&(timer->timer_queue));
@@ -316,19 +448,15 @@ TN_TickCnt _tn_timer_time_left(struct TN_Timer *timer)
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
    if (_tn_timer_is_active(timer)){
-      TN_TickCnt tick_list_index = _TICK_LIST_INDEX(0);
+      time_left = timer->expire_tick_cnt - _tn_sys_time_count;
 
-      if (timer->timeout_cur > tick_list_index){
-         time_left = timer->timeout_cur - tick_list_index;
-      } else if (timer->timeout_cur < tick_list_index){
-         time_left = timer->timeout_cur + TN_TICK_LISTS_CNT - tick_list_index;
-      } else {
 #if TN_DEBUG
-         //-- timer->timeout_cur should never be equal to tick_list_index here
-         //   (if it is, timer is inactive, so, we don't get here)
+      //-- time_left should never be 0 here
+      //   (if it is, timer is already fired, so, we don't get here)
+      if (time_left == 0){
          _TN_FATAL_ERROR();
-#endif
       }
+#endif
    }
 
    return time_left;
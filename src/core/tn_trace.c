@@ -0,0 +1,208 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_sys.h"
+
+
+#include "tn_trace.h"
+#include "_tn_trace.h"
+
+//-- for memset()
+#include <string.h>
+
+
+
+#if TN_TRACE
+
+/*******************************************************************************
+ *    PROTECTED DATA
+ ******************************************************************************/
+
+// See comments in the internal/_tn_trace.h file
+struct TN_TraceHdr *_tn_trace_hdr = TN_NULL;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_start(
+      TN_UWord *buf,
+      unsigned int words_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (buf == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (words_cnt < TN_TRACE_HDR_WORDS + TN_TRACE_REC_WORDS){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_start(buf, words_cnt)                           \
+   (TN_RC_OK)
+#endif
+// }}}
+
+/**
+ * Write the record with interrupts disabled: it is used by the public
+ * functions, which might be called with interrupts enabled.
+ */
+static void _trace_put_int_dis(
+      enum TN_TraceEv ev,
+      int arg,
+      TN_UWord obj
+      )
+{
+   TN_INTSAVE_DATA;
+
+   TN_INT_DIS_SAVE();
+   _tn_trace_put(ev, arg, obj);
+   TN_INT_RESTORE();
+}
+
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_trace.h)
+ */
+enum TN_RCode tn_trace_start(TN_UWord *buf, unsigned int words_cnt)
+{
+   enum TN_RCode rc = _check_param_start(buf, words_cnt);
+
+   if (rc == TN_RC_OK){
+      struct TN_TraceHdr *hdr = (struct TN_TraceHdr *)buf;
+      unsigned int avail_cnt
+         = (words_cnt - TN_TRACE_HDR_WORDS) / TN_TRACE_REC_WORDS;
+      unsigned int recs_cnt = 1;
+      TN_INTSAVE_DATA;
+
+      //-- records count should be a power of two, so that the slot index
+      //   is taken by mask, and it stays correct when `wr_idx` wraps
+      while (recs_cnt <= (avail_cnt >> 1)){
+         recs_cnt <<= 1;
+      }
+
+      //-- stop tracing to the current buffer (if any) while the new one
+      //   is being prepared
+      tn_trace_stop();
+
+      //-- unused slots should contain zeros (`#TN_TRACE_EV_NONE`)
+      memset(buf, 0x00, words_cnt * sizeof(TN_UWord));
+
+#if defined(_TN_CYCLE_CNT_INIT)
+      //-- enable hardware cycle counter used for timestamps
+      _TN_CYCLE_CNT_INIT();
+#endif
+
+      hdr->magic     = TN_TRACE_MAGIC;
+      hdr->info      = TN_TRACE_VERSION | _TN_TRACE_TS_FLAGS;
+      hdr->recs_cnt  = recs_cnt;
+      hdr->wr_idx    = 0;
+
+      TN_INT_DIS_SAVE();
+      _tn_trace_hdr = hdr;
+      TN_INT_RESTORE();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_trace.h)
+ */
+void tn_trace_stop(void)
+{
+   TN_INTSAVE_DATA;
+
+   TN_INT_DIS_SAVE();
+   _tn_trace_hdr = TN_NULL;
+   TN_INT_RESTORE();
+}
+
+/*
+ * See comments in the header file (tn_trace.h)
+ */
+void tn_trace_isr_enter(TN_UWord isr_id)
+{
+   _trace_put_int_dis(TN_TRACE_EV_ISR_ENTER, 0, isr_id);
+}
+
+/*
+ * See comments in the header file (tn_trace.h)
+ */
+void tn_trace_isr_exit(TN_UWord isr_id)
+{
+   _trace_put_int_dis(TN_TRACE_EV_ISR_EXIT, 0, isr_id);
+}
+
+/*
+ * See comments in the header file (tn_trace.h)
+ */
+void tn_trace_user(unsigned char id, TN_UWord value)
+{
+   _trace_put_int_dis(TN_TRACE_EV_USER, id, value);
+}
+
+#endif   // TN_TRACE
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -0,0 +1,377 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Kernel event trace: a flight recorder which keeps the latest kernel events
+ * (context switches, waits and wakeups, operations on objects, interrupts)
+ * in the RAM buffer, so that the timeline of what happened right before
+ * some latency outlier can be inspected afterwards, without a debugger
+ * attached. Available if only `#TN_TRACE` option is non-zero.
+ *
+ * The application gives the buffer to the kernel by calling
+ * `tn_trace_start()`; from then on, each event is written to the buffer as a
+ * fixed-size binary record (see below). The buffer is a ring: when it is
+ * full, the oldest records are overwritten. The trace points are located in
+ * the critical sections the kernel has anyway, so, writing a record takes
+ * just a few instructions and no additional lock.
+ *
+ * In order to get the trace out of the device, the whole buffer (it is
+ * self-describing, see `struct #TN_TraceHdr`) should be dumped somehow: by
+ * the debugger, by sending it through UART from the fatal error handler,
+ * etc. Call `tn_trace_stop()` first in order to freeze the buffer. The dump
+ * (or even the dump of the whole RAM, the header is found by its magic
+ * number) is converted to the Chrome trace JSON (viewable in
+ * `chrome://tracing` or https://ui.perfetto.dev) by the host-side decoder
+ * `stuff/tntrace/tntrace.py`, which also prints the longest intervals:
+ * say, the longest time from the task wakeup to the moment it got running.
+ *
+ * Format of the buffer (all fields are of type `#TN_UWord`, in the native
+ * byte order):
+ *
+ * - header: `struct #TN_TraceHdr`;
+ * - `recs_cnt` records, each of them is `#TN_TRACE_REC_WORDS` words long:
+ *   - timestamp: value of the hardware cycle counter, if the architecture
+ *     has it (the same counter is used by `#TN_PROFILER_CYCLES`), or system
+ *     tick count otherwise (see flag `#TN_TRACE_FLAG_TS_CYCLES`). It wraps
+ *     at the full width of `#TN_UWord`;
+ *   - info: event type (`enum #TN_TraceEv`) in the bits 0..7, and the
+ *     argument of the event in the bits 8..15;
+ *   - object: address of the object the event is related to, or some
+ *     other value, depending on the event type.
+ *
+ * Record `n` (counting from 0) is written at the slot `(n % recs_cnt)`, and
+ * `wr_idx` is the number of records written so far, so the oldest record is
+ * at the slot `(wr_idx % recs_cnt)`. Unused slots contain zeros.
+ *
+ * Interrupts aren't traced automatically, except the system tick
+ * (`tn_tick_int_processing()`): the ISR of interest should call
+ * `tn_trace_isr_enter()` at the beginning and `tn_trace_isr_exit()` at the
+ * end.
+ */
+
+#ifndef _TN_TRACE_H
+#define _TN_TRACE_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Type of the trace event, stored in the bits 0..7 of the `info` word of the
+ * trace record. Values are a part of the binary format, so they must not be
+ * changed.
+ */
+enum TN_TraceEv {
+   ///
+   /// Unused slot of the buffer
+   TN_TRACE_EV_NONE              = 0,
+   ///
+   /// Context switch. object: task that got running (the task that was
+   /// running before is the one from the previous context switch)
+   TN_TRACE_EV_TASK_SWITCH       = 1,
+   ///
+   /// Task became active (it is created with `#TN_TASK_CREATE_OPT_START`
+   /// or activated). object: task, arg: its priority
+   TN_TRACE_EV_TASK_ACTIVATE     = 2,
+   ///
+   /// Task became dormant (it is exited or terminated). object: task
+   TN_TRACE_EV_TASK_DORMANT      = 3,
+   ///
+   /// Task started waiting. object: task, arg: `enum #TN_WaitReason`
+   TN_TRACE_EV_TASK_WAIT         = 4,
+   ///
+   /// Task finished waiting. object: task, arg: wait result
+   /// (`enum #TN_RCode`, as a signed byte)
+   TN_TRACE_EV_TASK_WAKE         = 5,
+   ///
+   /// Interrupt entered. object: interrupt id given to
+   /// `tn_trace_isr_enter()`, or `#TN_TRACE_ISR_TICK`.
+   TN_TRACE_EV_ISR_ENTER         = 6,
+   ///
+   /// Interrupt exited. object: the same as for `#TN_TRACE_EV_ISR_ENTER`
+   TN_TRACE_EV_ISR_EXIT          = 7,
+   ///
+   /// Attempt to signal semaphore. object: semaphore, arg: result (`enum
+   /// #TN_RCode`, as a signed byte)
+   TN_TRACE_EV_SEM_SIGNAL        = 8,
+   ///
+   /// Attempt to acquire semaphore. object: semaphore, arg: result; if
+   /// it is `#TN_RC_TIMEOUT` and the task is going to wait, the wait result
+   /// is given by the subsequent `#TN_TRACE_EV_TASK_WAKE`. The same holds
+   /// for the other "receiving" events below.
+   TN_TRACE_EV_SEM_WAIT          = 9,
+   ///
+   /// Attempt to send to data queue. object: queue, arg: result
+   TN_TRACE_EV_QUEUE_SEND        = 10,
+   ///
+   /// Attempt to receive from data queue. object: queue, arg: result
+   TN_TRACE_EV_QUEUE_RECEIVE     = 11,
+   ///
+   /// Attempt to lock mutex. object: mutex, arg: result
+   TN_TRACE_EV_MUTEX_LOCK        = 12,
+   ///
+   /// Attempt to unlock mutex. object: mutex, arg: result
+   TN_TRACE_EV_MUTEX_UNLOCK      = 13,
+   ///
+   /// Event group flags are modified. object: event group, arg: operation
+   /// (`enum #TN_EGrpOp`)
+   TN_TRACE_EV_EVENTGRP_MODIFY   = 14,
+   ///
+   /// Attempt to wait for event group flags. object: event group, arg: result
+   TN_TRACE_EV_EVENTGRP_WAIT     = 15,
+   ///
+   /// Attempt to get memory block. object: memory pool, arg: result
+   TN_TRACE_EV_FMEM_GET          = 16,
+   ///
+   /// Attempt to release memory block. object: memory pool, arg: result
+   TN_TRACE_EV_FMEM_RELEASE      = 17,
+   ///
+   /// Application-defined event written by `tn_trace_user()`.
+   /// object: value, arg: id
+   TN_TRACE_EV_USER              = 18
+};
+
+/**
+ * Header of the trace buffer, it is located at the beginning of the buffer
+ * given to `tn_trace_start()`, and it is followed by the records.
+ */
+struct TN_TraceHdr {
+   ///
+   /// Magic number `#TN_TRACE_MAGIC`, so that the decoder can find the
+   /// trace in the dump of the whole RAM
+   TN_UWord             magic;
+   ///
+   /// Version of the format (`#TN_TRACE_VERSION`) in the bits 0..7,
+   /// and flags (see `#TN_TRACE_FLAG_TS_CYCLES`) in the bits 8..15
+   TN_UWord             info;
+   ///
+   /// Number of records the buffer can hold, it is a power of two
+   TN_UWord             recs_cnt;
+   ///
+   /// Number of records written so far (wraps at the full width of
+   /// `#TN_UWord`)
+   volatile TN_UWord    wr_idx;
+};
+
+
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Magic number of the trace buffer: it is `"TNTR"` in the memory on 32-bit
+ * little-endian architectures, and `"TN"` on 16-bit ones.
+ */
+#define TN_TRACE_MAGIC           ((TN_UWord)0x52544E54UL)
+
+/**
+ * Version of the trace buffer format
+ */
+#define TN_TRACE_VERSION         1
+
+/**
+ * Flag in the `info` field of `struct #TN_TraceHdr`: if set, timestamps are
+ * in cycles of the hardware cycle counter; otherwise, they are in system
+ * ticks.
+ */
+#define TN_TRACE_FLAG_TS_CYCLES  (1 << 8)
+
+/**
+ * Size of the trace buffer header, in `#TN_UWord`s
+ */
+#define TN_TRACE_HDR_WORDS       (sizeof(struct TN_TraceHdr) / sizeof(TN_UWord))
+
+/**
+ * Size of each trace record, in `#TN_UWord`s
+ */
+#define TN_TRACE_REC_WORDS       3
+
+/**
+ * Interrupt id of the system tick interrupt (`tn_tick_int_processing()`)
+ * in the `#TN_TRACE_EV_ISR_ENTER` / `#TN_TRACE_EV_ISR_EXIT` records
+ */
+#define TN_TRACE_ISR_TICK        ((TN_UWord)-1)
+
+/**
+ * Convenience macro for the definition of the trace buffer, see
+ * `tn_trace_start()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array
+ * @param recs_cnt
+ *    Number of records; should be a power of two, otherwise, some space
+ *    is wasted.
+ */
+#define TN_TRACE_BUF_DEF(name, recs_cnt)                                  \
+   TN_UWord name[ TN_TRACE_HDR_WORDS + (recs_cnt) * TN_TRACE_REC_WORDS ]
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+#if TN_TRACE || defined(DOXYGEN_ACTIVE)
+
+/**
+ * Start tracing to the given buffer: the buffer is cleared, and the header
+ * is written to it. If tracing was already started with another buffer, it
+ * is switched to the new one.
+ *
+ * It may be called before `tn_sys_start()` as well, in order to trace the
+ * system startup.
+ *
+ * Typical usage:
+ *
+ * \code{.c}
+ *     //-- define buffer for 1024 records
+ *     TN_TRACE_BUF_DEF(my_trace_buf, 1024);
+ *
+ *     //-- ...
+ *
+ *     tn_trace_start(my_trace_buf, sizeof(my_trace_buf) / sizeof(TN_UWord));
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CALL_FROM_MAIN)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param buf
+ *    Buffer for the trace, it should be aligned by `#TN_UWord`
+ * @param words_cnt
+ *    Size of the buffer, in `#TN_UWord`s. The number of records is the
+ *    largest power of two that fits in the buffer after the header.
+ *
+ * @return
+ *    * `#TN_RC_OK` if tracing is started;
+ *    * `#TN_RC_WPARAM` if `buf` is `TN_NULL`, or it can't hold even one
+ *      record.
+ */
+enum TN_RCode tn_trace_start(TN_UWord *buf, unsigned int words_cnt);
+
+/**
+ * Stop tracing: records aren't written anymore, so that the buffer can be
+ * dumped. The buffer is left intact.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CALL_FROM_MAIN)
+ * $(TN_LEGEND_LINK)
+ */
+void tn_trace_stop(void);
+
+/**
+ * Write `#TN_TRACE_EV_ISR_ENTER` record. Should be called at the very
+ * beginning of the ISR which should be seen in the trace; each call must be
+ * paired with `tn_trace_isr_exit()` at the end of the same ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param isr_id
+ *    Arbitrary id of the interrupt (say, IRQ number); it should not be
+ *    equal to `#TN_TRACE_ISR_TICK`.
+ */
+void tn_trace_isr_enter(TN_UWord isr_id);
+
+/**
+ * Write `#TN_TRACE_EV_ISR_EXIT` record, see `tn_trace_isr_enter()`.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param isr_id
+ *    The same id as given to `tn_trace_isr_enter()`
+ */
+void tn_trace_isr_exit(TN_UWord isr_id);
+
+/**
+ * Write application-defined `#TN_TRACE_EV_USER` record: say, mark the
+ * beginning and the end of some processing, to see it on the timeline.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param id
+ *    Arbitrary id of the event, from 0 to 255.
+ * @param value
+ *    Arbitrary value.
+ */
+void tn_trace_user(unsigned char id, TN_UWord value);
+
+#endif   // TN_TRACE
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+
+#endif // _TN_TRACE_H
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
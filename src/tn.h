@@ -50,13 +50,22 @@
 
 #include "core/tn_sys.h"
 #include "core/tn_common.h"
+#include "core/tn_defer.h"
 #include "core/tn_dqueue.h"
 #include "core/tn_eventgrp.h"
+#include "core/tn_exch.h"
+#include "core/tn_exch_link_callback.h"
+#include "core/tn_exch_link_eventgrp.h"
+#include "core/tn_exch_link_queue.h"
 #include "core/tn_fmem.h"
+#include "core/tn_mqueue.h"
+#include "core/tn_multi_wait.h"
 #include "core/tn_mutex.h"
+#include "core/tn_ring.h"
 #include "core/tn_sem.h"
 #include "core/tn_tasks.h"
 #include "core/tn_timer.h"
+#include "core/tn_trace.h"
 
 
 //-- include old symbols for compatibility with old projects
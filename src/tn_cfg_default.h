@@ -124,12 +124,31 @@
  * 320 bytes. If you set it, say, to 5, you save `270` bytes, which might be
  * notable.
  *
+ * If you need more than `#TN_PRIORITIES_MAX_CNT` priorities, see
+ * `#TN_PRIORITIES_2LEVEL_BMP`.
+ *
  * Default: `#TN_PRIORITIES_MAX_CNT`.
  */
 #ifndef TN_PRIORITIES_CNT
 #  define TN_PRIORITIES_CNT      TN_PRIORITIES_MAX_CNT
 #endif
 
+/**
+ * Whether the kernel should use two-level bitmask of priorities with runnable
+ * tasks: one word per each group of `#TN_INT_WIDTH` priorities, plus one word
+ * which tells which groups are non-empty. This way, max value of
+ * `#TN_PRIORITIES_CNT` is `(TN_PRIORITIES_MAX_CNT * TN_INT_WIDTH)`, i.e.
+ * `1024` on 32-bit systems and `256` on 16-bit ones, and selection of the
+ * next task to run still takes constant time (two find-first-set-bit
+ * operations instead of one).
+ *
+ * If you don't need more than `#TN_PRIORITIES_MAX_CNT` priorities, leave it
+ * zero: the single-word bitmask is a bit faster.
+ */
+#ifndef TN_PRIORITIES_2LEVEL_BMP
+#  define TN_PRIORITIES_2LEVEL_BMP     0
+#endif
+
 /**
  * Enables additional param checking for most of the system functions.
  * It's surely useful for debug, but probably better to remove in release.
@@ -213,6 +232,45 @@
 #  define TN_TICK_LISTS_CNT    8
 #endif
 
+/**
+ *
+ * <i>Takes effect if only `#TN_DYNAMIC_TICK` is <B>not set</B></i>.
+ *
+ * Number of levels of timer lists, each level has `#TN_TICK_LISTS_CNT`
+ * lists. Minimum value: `1`.
+ *
+ * Refer to the \ref timers_static_implementation for details.
+ *
+ * With the default value `1`, there is just a single level of "tick" lists,
+ * plus the "generic" list which is walked through each `#TN_TICK_LISTS_CNT`
+ * ticks, so the worst-case time of $(TN_SYS_TIMER_LINK) ISR grows linearly
+ * with the number of long-range timers. Each additional level takes
+ * `#TN_TICK_LISTS_CNT` more list heads of RAM, and makes the "generic" list
+ * walked `#TN_TICK_LISTS_CNT` times less often; with enough levels to cover
+ * all the timeouts used by the application, timers are never walked through
+ * more than once per level.
+ *
+ * `(TN_TICK_WHEEL_LEVELS * log2(TN_TICK_LISTS_CNT))` must be less than `32`.
+ */
+#ifndef TN_TICK_WHEEL_LEVELS
+#  define TN_TICK_WHEEL_LEVELS    1
+#endif
+
+/**
+ * Whether the kernel should measure the worst-case time spent in
+ * `tn_tick_int_processing()`. The time is taken by the
+ * architecture-dependent cycle counter, the same one as used by
+ * `#TN_PROFILER_CYCLES`, so the option can't be used on architectures which
+ * don't have it (currently, PIC24/dsPIC). The worst-case value can be read by
+ * `tn_sys_tick_int_max_cycles_get()`.
+ *
+ * It's useful to pick `#TN_TICK_LISTS_CNT` and `#TN_TICK_WHEEL_LEVELS`
+ * values for a particular application.
+ */
+#ifndef TN_TICK_INT_MEASURE
+#  define TN_TICK_INT_MEASURE    0
+#endif
+
 
 /**
  * API option for `MAKE_ALIG()` macro.
@@ -270,6 +328,79 @@
 #  define TN_PROFILER_WAIT_TIME  0
 #endif
 
+/**
+ * Whether profiler should measure run time of tasks in CPU cycles instead of
+ * system ticks. If this option is non-zero, the architecture-dependent cycle
+ * counter (DWT CYCCNT on Cortex-M3/M4/M7, Core Timer on PIC32) is sampled at
+ * each context switch, so that a task which runs for 50 us of a 1 ms tick
+ * is seen as such, not as 0 or 1 tick. Not available on Cortex-M0/M0+ and
+ * PIC24/dsPIC, since they don't have such a counter.
+ *
+ * When it is non-zero:
+ *
+ * - `total_run_time` and `max_consecutive_run_time` of `struct
+ *   #TN_TaskTiming` are in cycles (on PIC32, in Core Timer ticks, which
+ *   count at half of the system clock);
+ * - time spent in `tn_tick_int_processing()` and in the interrupts marked by
+ *   `tn_sys_profiler_isr_enter()` / `tn_sys_profiler_isr_exit()` isn't
+ *   counted as run time of the interrupted task; it is counted in its
+ *   `total_isr_time` instead;
+ * - wait times (see `#TN_PROFILER_WAIT_TIME`) are still in system ticks,
+ *   since waits are typically much longer than the period of the 32-bit
+ *   cycle counter.
+ *
+ * Time between two accounting points (context switch, entry to or exit from
+ * the interrupt) should be shorter than the period of the 32-bit cycle
+ * counter. It is always so with the static tick, since the tick interrupt is
+ * an accounting point; with `#TN_DYNAMIC_TICK`, the long sleep of the idle
+ * task may be accounted incorrectly.
+ *
+ * Relevant if only `#TN_PROFILER` is non-zero.
+ */
+#ifndef TN_PROFILER_CYCLES
+#  define TN_PROFILER_CYCLES     0
+#endif
+
+/**
+ * Whether the kernel event trace is enabled: the kernel writes records about
+ * context switches, waits and wakeups, operations on objects and interrupts
+ * to the ring buffer given by `tn_trace_start()`. See \ref tn_trace.h for
+ * details.
+ *
+ * Each record costs just a few instructions, but the trace points are
+ * located on the hot paths of the kernel (including the context switch), so
+ * the option is off by default.
+ */
+#ifndef TN_TRACE
+#  define TN_TRACE               0
+#endif
+
+/**
+ * Whether the kernel should measure the duration of critical sections, i.e.
+ * the time between `TN_INT_DIS_SAVE()` and `TN_INT_RESTORE()` (and their ISR
+ * counterparts), which is the main contributor to the interrupt latency.
+ *
+ * Durations are taken by the architecture-dependent cycle counter, the same
+ * one as used by `#TN_PROFILER_CYCLES`, so the option can't be used on
+ * architectures which don't have it (currently, PIC24/dsPIC). For each
+ * function that has a critical section, the kernel keeps the worst-case
+ * duration; the worst function overall can be obtained by
+ * `tn_sys_int_dis_worst_get()`, and all of them by
+ * `tn_sys_int_dis_sites_get()`. Functions of the application which use these
+ * macros are measured as well.
+ *
+ * Only the outermost critical section is measured. Sections which
+ * are entered when interrupts are already disabled (say, by
+ * `tn_arch_int_dis()`) are not measured at all. Note also that on PIC24/dsPIC
+ * interrupts are considered disabled inside any system ISR.
+ *
+ * Each critical section gets a few instructions longer, so the
+ * option is intended for development only.
+ */
+#ifndef TN_INT_DIS_MEASURE
+#  define TN_INT_DIS_MEASURE     0
+#endif
+
 /**
  * Whether interrupt stack space should be initialized with
  * `#TN_FILL_STACK_VAL` on system start. It is useful to disable this option if
@@ -334,6 +465,46 @@
 #  define TN_DYNAMIC_TICK        0
 #endif
 
+/**
+ * <i>Takes effect if only `#TN_DYNAMIC_TICK` is <B>set</B></i>.
+ *
+ * Whether active timers should be kept in the hierarchical timing wheel
+ * instead of the single sorted list. With the sorted list, starting a timer
+ * (and therefore each wait with timeout) takes time proportional to the
+ * number of active timers; with the wheel, starting and cancelling a timer
+ * takes constant time.
+ *
+ * The wheel takes more RAM: `#TN_DYNAMIC_TICK_WHEEL_LEVELS` arrays of
+ * `#TN_INT_WIDTH` elements of `struct TN_ListItem`, so, with default
+ * settings, it takes 1 KB on 32-bit system. And the kernel might get up to
+ * one extra tick per slot of higher wheel level, at which no timer fires.
+ *
+ * So, it makes sense to turn it on if only your application has a lot
+ * (dozens or more) of simultaneously active timers and/or waits with timeout.
+ *
+ * Refer to the \ref timers_dynamic_wheel_implementation for details.
+ */
+#ifndef TN_DYNAMIC_TICK_WHEEL
+#  define TN_DYNAMIC_TICK_WHEEL  0
+#endif
+
+/**
+ * <i>Takes effect if only both `#TN_DYNAMIC_TICK` and
+ * `#TN_DYNAMIC_TICK_WHEEL` are <B>set</B></i>.
+ *
+ * Number of levels of the timing wheel. Each level covers `#TN_INT_WIDTH`
+ * times more system ticks than the previous one, so, on 32-bit system, 4
+ * levels cover `2^20` ticks (about 17 minutes with 1 ms tick). Timers with
+ * larger timeouts are still handled correctly, they just need to be placed
+ * again when the top level rolls over.
+ *
+ * On 32-bit system, the value should be from 2 to 6; on 16-bit system, from
+ * 2 to 8; on 64-bit host (POSIX port), from 2 to 5.
+ */
+#ifndef TN_DYNAMIC_TICK_WHEEL_LEVELS
+#  define TN_DYNAMIC_TICK_WHEEL_LEVELS    4
+#endif
+
 
 /**
  * Whether the old TNKernel events API compatibility mode is active.
@@ -371,6 +542,112 @@
 #endif
 
 
+/**
+ * Whether the multi-object wait is available: a task may wait for any of
+ * several semaphores, data queues, memory pools and event groups at once,
+ * see \ref tn_multi_wait.h.
+ *
+ * When it is non-zero, each of these objects has one more list (of
+ * multi-wait items), so the objects become a bit larger, and the services
+ * that wake tasks up check this list as well.
+ */
+#ifndef TN_MULTI_WAIT
+#  define TN_MULTI_WAIT          0
+#endif
+
+
+/**
+ * Whether the direct-to-task notifications are available: each task has a
+ * notification value that can be modified by other tasks and ISRs (set
+ * bits, increment or overwrite), and the task can wait for it, see
+ * `tn_task_notify()` and `tn_task_notify_wait()`.
+ *
+ * It is a lightweight replacement for a semaphore or event group when there
+ * is exactly one task to notify: no separate object is needed, and the
+ * notifier doesn't have to walk any wait queue. When it is non-zero, each
+ * task gets a couple more words, so it is disabled by default.
+ */
+#ifndef TN_TASK_NOTIFY
+#  define TN_TASK_NOTIFY         0
+#endif
+
+
+/**
+ * Whether tasks waiting for an event group should be indexed by the bits
+ * they wait for. Without the index, each modification of the event group
+ * that sets some flags walks through all the waiting tasks and checks
+ * condition of each of them, with interrupts disabled. With the index,
+ * each task is kept in the list of some particular bit, which is not yet
+ * set and without which the task can't be woken up, so the modification
+ * only visits the tasks in the lists of the bits that have just become set.
+ * Tasks waiting for any of several flags (`#TN_EVENTGRP_WMODE_OR` with more
+ * than one bit in the pattern) are kept in a separate list which is walked
+ * through only when some of their flags become set.
+ *
+ * The index takes `#TN_INT_WIDTH` elements of `struct TN_ListItem` plus two
+ * words per event group, i.e. 264 bytes per event group on 32-bit system.
+ * Note also that when several tasks compete for the same flag with
+ * `#TN_EVENTGRP_WMODE_AUTOCLR`, the winner is chosen by the index order
+ * (bit number, and FIFO for the tasks of the same bit), not by the order
+ * in which tasks have started waiting.
+ *
+ * So, it makes sense to turn it on if only your application has event
+ * groups with lots (dozens or more) of waiting tasks.
+ */
+#ifndef TN_EVENTGRP_WAIT_INDEX
+#  define TN_EVENTGRP_WAIT_INDEX 0
+#endif
+
+
+/**
+ * Whether wide event groups are available: the pattern of such event group
+ * consists of several words (so, it has more than `#TN_INT_WIDTH` flags), see
+ * \ref eventgrp_wide and `tn_eventgrp_wide_create()`. Queues can then be
+ * connected to any flag of the wide event group, see
+ * `tn_queue_eventgrp_connect_bit()`.
+ *
+ * When it is non-zero, each event group and each task get a couple more
+ * words.
+ */
+#ifndef TN_EVENTGRP_WIDE
+#  define TN_EVENTGRP_WIDE       0
+#endif
+
+
+/**
+ * Whether lock-free fast paths should be used by the services which often
+ * have nobody to wake up: `tn_sem_signal()` / `tn_sem_isignal()` when
+ * nobody waits for the semaphore and its count is below the maximum,
+ * `tn_sem_wait_polling()` and friends when the count is non-zero,
+ * `tn_eventgrp_modify()` / `tn_eventgrp_imodify()` when flags are cleared
+ * or when nobody waits for the event group, and `tn_mutex_lock()` /
+ * `tn_mutex_unlock()` of the free `#TN_MUTEX_PROT_INHERIT` mutex. Instead of
+ * disabling interrupts, these paths update the object by exclusive load /
+ * store instructions, and if the object turns out to be in use, the usual
+ * path is taken.
+ *
+ * Each task may hold a single mutex locked by the fast path; it is moved to
+ * the task's list of locked mutexes as soon as some other task has to wait
+ * for it, so that priority inheritance works just as usual. When the option
+ * is non-zero, each task gets one more word.
+ *
+ * Fast paths are available if only the architecture provides exclusive
+ * access: it is Cortex-M3/M4/M7 (LDREX/STREX), PIC32 (LL/SC) and POSIX
+ * (emulated, for testing). On Cortex-M0/M0+ and PIC24/dsPIC, the option
+ * has no effect (apart from the word in each task).
+ *
+ * Operations performed by fast paths are not recorded by the \ref
+ * tn_trace.h "trace": while the trace is started, usual paths are always
+ * taken.
+ *
+ * Disabled by default, since it makes the code larger and adds a word to
+ * each task.
+ */
+#ifndef TN_FAST_PATH
+#  define TN_FAST_PATH           0
+#endif
+
+
 /**
  * Whether the kernel should use compiler-specific forced inline qualifiers (if
  * possible) instead of "usual" `inline`, which is just a hint for the
@@ -408,6 +685,50 @@
 #  define TN_P24_SYS_IPL      4
 #endif
 
+
+
+/*******************************************************************************
+ *    Cortex-M-specific configuration
+ ******************************************************************************/
+
+
+/**
+ * Maximum system interrupt priority on Cortex-M3/M4/M4F, as a raw value
+ * of the `BASEPRI` register (i.e. already shifted to the implemented
+ * priority bits: with 4 priority bits, priority 5 is `0x50`). For details,
+ * refer to the section \ref cortex_m_interrupts "Cortex-M interrupts".
+ *
+ * If zero, the kernel disables interrupts by `PRIMASK`, so all interrupts are
+ * system ones. If non-zero, the kernel masks only interrupts with priority
+ * value numerically greater than or equal to `#TN_CORTEX_M_SYS_BASEPRI`, by
+ * `BASEPRI`: interrupts of higher priority are never disabled by the kernel,
+ * but they must not call kernel services.
+ *
+ * Not available on Cortex-M0/M0+, since they don't have `BASEPRI`.
+ *
+ * Should be >= 0 and <= 0xff. Default: 0.
+ */
+#ifndef TN_CORTEX_M_SYS_BASEPRI
+#  define TN_CORTEX_M_SYS_BASEPRI   0
+#endif
+
+/**
+ * Whether FPU lazy stacking should be enabled on Cortex-M4F. Has no effect on
+ * the cores without FPU.
+ *
+ * If non-zero, the hardware only reserves space for S0-S15 in the exception
+ * stack frame, and actually saves them if only the ISR uses FPU: this way,
+ * ISR entry is faster for the tasks that use FPU. Registers S16-S31 are
+ * anyway saved by the kernel on context switch for the tasks that have
+ * actually used FPU only.
+ *
+ * If zero, lazy stacking is disabled, and S0-S15 are always saved by the
+ * hardware on exception entry if the interrupted task has used FPU.
+ */
+#ifndef TN_CORTEX_M_FPU_LAZY
+#  define TN_CORTEX_M_FPU_LAZY      1
+#endif
+
 #endif // _TN_CFG_DEFAULT_H
 
 
@@ -0,0 +1,451 @@
+#!/usr/bin/env python3
+#
+# TNeo kernel event trace decoder.
+#
+# Reads the memory dump containing the trace buffer written by the kernel
+# (see src/core/tn_trace.h), converts it to the Chrome trace JSON (which can
+# be viewed in chrome://tracing or https://ui.perfetto.dev), and prints the
+# longest intervals found in the trace: the time from the task wakeup until
+# it got running, task run times and ISR durations.
+#
+# The dump may be either the trace buffer alone, or the dump of the whole
+# RAM: the buffer is found by its magic number.
+#
+# Usage:
+#
+#     tntrace.py dump.bin -o trace.json --freq 72000000 --names names.txt
+#
+# where names.txt is the output of `nm` for the application ELF file, so
+# that tasks and kernel objects are shown with their names.
+#
+# The design roughly follows uml/tntrace.pu: data source (the dump),
+# codec (the parser of the binary records) and events.
+
+import argparse
+import json
+import struct
+import sys
+
+
+#-- Binary format, must match src/core/tn_trace.h {{{
+
+TN_TRACE_VERSION = 1
+TN_TRACE_FLAG_TS_CYCLES = (1 << 8)
+TN_TRACE_HDR_WORDS = 4
+TN_TRACE_REC_WORDS = 3
+
+#-- struct format of TN_UWord, by its size in bytes
+WORD_FMT = {2: "H", 4: "I", 8: "Q"}
+
+EV_NONE             = 0
+EV_TASK_SWITCH      = 1
+EV_TASK_ACTIVATE    = 2
+EV_TASK_DORMANT     = 3
+EV_TASK_WAIT        = 4
+EV_TASK_WAKE        = 5
+EV_ISR_ENTER        = 6
+EV_ISR_EXIT         = 7
+EV_SEM_SIGNAL       = 8
+EV_SEM_WAIT         = 9
+EV_QUEUE_SEND       = 10
+EV_QUEUE_RECEIVE    = 11
+EV_MUTEX_LOCK       = 12
+EV_MUTEX_UNLOCK     = 13
+EV_EVENTGRP_MODIFY  = 14
+EV_EVENTGRP_WAIT    = 15
+EV_FMEM_GET         = 16
+EV_FMEM_RELEASE     = 17
+EV_USER             = 18
+
+#-- object operations: event type -> name
+OBJ_OPS = {
+    EV_SEM_SIGNAL:      "sem_signal",
+    EV_SEM_WAIT:        "sem_wait",
+    EV_QUEUE_SEND:      "queue_send",
+    EV_QUEUE_RECEIVE:   "queue_receive",
+    EV_MUTEX_LOCK:      "mutex_lock",
+    EV_MUTEX_UNLOCK:    "mutex_unlock",
+    EV_EVENTGRP_MODIFY: "eventgrp_modify",
+    EV_EVENTGRP_WAIT:   "eventgrp_wait",
+    EV_FMEM_GET:        "fmem_get",
+    EV_FMEM_RELEASE:    "fmem_release",
+}
+
+#-- enum TN_WaitReason (src/core/tn_tasks.h)
+WAIT_REASONS = [
+    "NONE",
+    "SLEEP",
+    "SEM",
+    "EVENT",
+    "DQUE_WSEND",
+    "DQUE_WRECEIVE",
+    "MUTEX_C",
+    "MUTEX_I",
+    "WFIXMEM",
+    "MQUE_WSEND",
+    "MQUE_WRECEIVE",
+    "RING_WRECEIVE",
+    "MULTI",
+    "NOTIFY",
+    "DEFER",
+]
+
+#-- enum TN_RCode (src/core/tn_common.h)
+RCODES = {
+    0:   "OK",
+    -1:  "TIMEOUT",
+    -2:  "OVERFLOW",
+    -3:  "WCONTEXT",
+    -4:  "WSTATE",
+    -5:  "WPARAM",
+    -6:  "ILLEGAL_USE",
+    -7:  "INVALID_OBJ",
+    -8:  "DELETED",
+    -9:  "FORCED",
+    -10: "INTERNAL",
+}
+
+#-- enum TN_EGrpOp (src/core/tn_eventgrp.h)
+EGRP_OPS = ["SET", "CLEAR", "TOGGLE"]
+
+# }}}
+
+
+class TraceError(Exception):
+    pass
+
+
+#-- Data source {{{
+
+class DataSrcSnapshot:
+    """
+    Memory dump containing the trace buffer: finds the buffer header and
+    provides the records in the order they were written.
+    """
+
+    def __init__(self, data, offset=None):
+        self.data = data
+        if offset is None:
+            offset, word_size = self._find()
+        else:
+            word_size = self._word_size_at(offset)
+            if word_size is None:
+                raise TraceError("no trace header at offset 0x%x" % offset)
+
+        self.offset = offset
+        self.word_size = word_size
+        self.word_mask = (1 << (8 * word_size)) - 1
+
+        magic, info, self.recs_cnt, self.wr_idx = self._words(
+            offset, TN_TRACE_HDR_WORDS)
+        self.ts_cycles = bool(info & TN_TRACE_FLAG_TS_CYCLES)
+
+    def _words(self, offset, cnt):
+        fmt = "<%d%s" % (cnt, WORD_FMT[self.word_size])
+        return struct.unpack_from(fmt, self.data, offset)
+
+    def _word_size_at(self, offset):
+        #-- 64-bit words (POSIX port on 64-bit host) go first, since their
+        #   magic starts with the 32-bit one
+        for word_size, magic in (
+                (8, b"TNTR\0\0\0\0"), (4, b"TNTR"), (2, b"TN")):
+            if offset % word_size != 0:
+                continue
+            if self.data[offset:offset + len(magic)] != magic:
+                continue
+            self.word_size = word_size
+            hdr_size = TN_TRACE_HDR_WORDS * word_size
+            if offset + hdr_size > len(self.data):
+                continue
+            _, info, recs_cnt, _ = self._words(offset, TN_TRACE_HDR_WORDS)
+            if (info & 0xff) != TN_TRACE_VERSION:
+                continue
+            if recs_cnt == 0 or (recs_cnt & (recs_cnt - 1)) != 0:
+                continue
+            size = hdr_size + recs_cnt * TN_TRACE_REC_WORDS * word_size
+            if offset + size > len(self.data):
+                continue
+            return word_size
+        return None
+
+    def _find(self):
+        offset = self.data.find(b"TN")
+        while offset >= 0:
+            word_size = self._word_size_at(offset)
+            if word_size is not None:
+                return offset, word_size
+            offset = self.data.find(b"TN", offset + 1)
+        raise TraceError("trace header is not found")
+
+    def records(self):
+        """
+        Yields raw records (timestamp, info, obj), from the oldest one.
+        """
+        rec_bytes = TN_TRACE_REC_WORDS * self.word_size
+        base = self.offset + TN_TRACE_HDR_WORDS * self.word_size
+        first = self.wr_idx % self.recs_cnt
+        for i in range(self.recs_cnt):
+            slot = (first + i) % self.recs_cnt
+            rec = self._words(base + slot * rec_bytes, TN_TRACE_REC_WORDS)
+            if (rec[1] & 0xff) != EV_NONE:
+                yield rec
+
+# }}}
+
+
+#-- Codec {{{
+
+class TraceEvent:
+    def __init__(self, ts, ev, arg, obj):
+        self.ts = ts        # in microseconds (or raw units, if no freq)
+        self.ev = ev
+        self.arg = arg
+        self.obj = obj
+
+
+class DataCodecTN:
+    """
+    Converts raw records to `TraceEvent`s: extracts the fields and converts
+    timestamps to the monotonic time (the counter wraps at the word width).
+    """
+
+    def __init__(self, data_src, freq=None):
+        self.data_src = data_src
+        self.freq = freq
+
+    def events(self):
+        src = self.data_src
+        wrap = src.word_mask + 1
+        prev_raw = None
+        ts = 0
+        for raw_ts, info, obj in src.records():
+            if prev_raw is not None:
+                ts += (raw_ts - prev_raw) % wrap
+            prev_raw = raw_ts
+
+            yield TraceEvent(
+                ts * 1e6 / self.freq if self.freq else float(ts),
+                info & 0xff,
+                (info >> 8) & 0xff,
+                obj
+            )
+
+# }}}
+
+
+#-- Output {{{
+
+class Names:
+    """
+    Names of objects, taken from the `nm` output.
+    """
+
+    def __init__(self, path=None):
+        self.names = {}
+        if path:
+            with open(path) as f:
+                for line in f:
+                    parts = line.split()
+                    if len(parts) >= 3:
+                        try:
+                            self.names[int(parts[0], 16)] = parts[2]
+                        except ValueError:
+                            pass
+
+    def get(self, addr):
+        return self.names.get(addr, "0x%x" % addr)
+
+
+def rc_name(arg):
+    #-- result code is stored as a signed byte
+    rc = arg - 0x100 if arg >= 0x80 else arg
+    return RCODES.get(rc, str(rc))
+
+
+class ChromeTraceWriter:
+    """
+    Builds Chrome trace: each task is a thread, its running intervals are
+    complete events, and interrupts are shown as the separate thread.
+    """
+
+    PID = 1
+    TID_ISR = 0
+
+    def __init__(self, names, isr_tick):
+        self.names = names
+        self.isr_tick = isr_tick
+        self.out = []
+        self.threads = {}
+
+        #-- (task, ts) of the current run interval
+        self.running = None
+        #-- stack of (isr_id, ts)
+        self.isr_stack = []
+        #-- task -> ts of the wakeup
+        self.woken = {}
+
+        #-- for outliers report: lists of (duration, description, ts)
+        self.wake_latencies = []
+        self.run_times = []
+        self.isr_times = []
+
+    def _thread(self, task):
+        if task not in self.threads:
+            self.threads[task] = "task %s" % self.names.get(task)
+        return task
+
+    def _isr_name(self, isr_id):
+        return "tick" if isr_id == self.isr_tick else "ISR %d" % isr_id
+
+    def _cur_tid(self):
+        if self.isr_stack:
+            return self.TID_ISR
+        if self.running is not None:
+            return self.running[0]
+        return self.TID_ISR
+
+    def _instant(self, ts, tid, name, args=None):
+        e = {"ph": "i", "s": "t", "pid": self.PID, "tid": tid,
+             "ts": ts, "name": name}
+        if args:
+            e["args"] = args
+        self.out.append(e)
+
+    def _complete(self, ts, dur, tid, name):
+        self.out.append({"ph": "X", "pid": self.PID, "tid": tid,
+                         "ts": ts, "dur": dur, "name": name})
+
+    def _run_finish(self, ts):
+        if self.running is not None:
+            task, start = self.running
+            self._complete(start, ts - start, task, "running")
+            self.run_times.append(
+                (ts - start, "task %s" % self.names.get(task), start))
+            self.running = None
+
+    def feed(self, e):
+        names = self.names
+        if e.ev == EV_TASK_SWITCH:
+            self._run_finish(e.ts)
+            task = self._thread(e.obj)
+            self.running = (task, e.ts)
+            woken_ts = self.woken.pop(task, None)
+            if woken_ts is not None:
+                self.wake_latencies.append((
+                    e.ts - woken_ts, "task %s" % names.get(task), woken_ts))
+
+        elif e.ev == EV_TASK_ACTIVATE:
+            self._instant(e.ts, self._thread(e.obj), "activate",
+                          {"priority": e.arg})
+
+        elif e.ev == EV_TASK_DORMANT:
+            self._instant(e.ts, self._thread(e.obj), "dormant")
+
+        elif e.ev == EV_TASK_WAIT:
+            reason = (WAIT_REASONS[e.arg] if 0 <= e.arg < len(WAIT_REASONS)
+                      else str(e.arg))
+            self._instant(e.ts, self._thread(e.obj), "wait " + reason)
+
+        elif e.ev == EV_TASK_WAKE:
+            self._instant(e.ts, self._thread(e.obj), "wake " + rc_name(e.arg))
+            self.woken[e.obj] = e.ts
+
+        elif e.ev == EV_ISR_ENTER:
+            self.isr_stack.append((e.obj, e.ts))
+
+        elif e.ev == EV_ISR_EXIT:
+            #-- the matching enter might be lost (overwritten)
+            if self.isr_stack and self.isr_stack[-1][0] == e.obj:
+                isr_id, start = self.isr_stack.pop()
+                name = self._isr_name(isr_id)
+                self._complete(start, e.ts - start, self.TID_ISR, name)
+                self.isr_times.append((e.ts - start, name, start))
+
+        elif e.ev in OBJ_OPS:
+            if e.ev == EV_EVENTGRP_MODIFY:
+                args = {"op": EGRP_OPS[e.arg] if 0 <= e.arg < 3 else e.arg}
+            else:
+                args = {"rc": rc_name(e.arg)}
+            self._instant(e.ts, self._cur_tid(),
+                          "%s %s" % (OBJ_OPS[e.ev], names.get(e.obj)), args)
+
+        elif e.ev == EV_USER:
+            self._instant(e.ts, self._cur_tid(), "user %d" % e.arg,
+                          {"value": e.obj})
+
+    def finish(self, ts):
+        self._run_finish(ts)
+        meta = [{"ph": "M", "pid": self.PID, "name": "process_name",
+                 "args": {"name": "TNeo"}},
+                {"ph": "M", "pid": self.PID, "tid": self.TID_ISR,
+                 "name": "thread_name", "args": {"name": "interrupts"}}]
+        for tid, name in self.threads.items():
+            meta.append({"ph": "M", "pid": self.PID, "tid": tid,
+                         "name": "thread_name", "args": {"name": name}})
+        return {"traceEvents": meta + self.out}
+
+# }}}
+
+
+def report(title, items, top, unit, f):
+    f.write("%s:\n" % title)
+    for dur, what, ts in sorted(items, key=lambda x: -x[0])[:top]:
+        f.write("   %12.3f %s  %s (at %.3f)\n" % (dur, unit, what, ts))
+    if not items:
+        f.write("   (none)\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert TNeo trace buffer dump to Chrome trace JSON")
+    parser.add_argument("dump", help="binary memory dump")
+    parser.add_argument("-o", "--output", help="output JSON file")
+    parser.add_argument("--offset", type=lambda x: int(x, 0),
+                        help="offset of the trace buffer in the dump "
+                             "(by default, it is found by the magic number)")
+    parser.add_argument("--freq", type=float,
+                        help="timestamp frequency in Hz: CPU (or PIC32 Core "
+                             "Timer) frequency, or tick rate if timestamps "
+                             "are in system ticks")
+    parser.add_argument("--names", help="`nm` output for the application")
+    parser.add_argument("--top", type=int, default=5,
+                        help="number of longest intervals to report")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+
+    try:
+        src = DataSrcSnapshot(data, args.offset)
+    except TraceError as e:
+        sys.exit("error: %s" % e)
+
+    codec = DataCodecTN(src, args.freq)
+    writer = ChromeTraceWriter(Names(args.names), src.word_mask)
+
+    cnt = 0
+    last_ts = 0
+    for e in codec.events():
+        writer.feed(e)
+        last_ts = e.ts
+        cnt += 1
+    trace = writer.finish(last_ts)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+
+    unit = "us" if args.freq else ("cycles" if src.ts_cycles else "ticks")
+    out = sys.stdout
+    out.write("trace at 0x%x: %d-bit words, %d of %d records, "
+              "timestamps in %s\n" % (
+                  src.offset, src.word_size * 8, cnt, src.recs_cnt,
+                  "cycles" if src.ts_cycles else "ticks"))
+    report("longest wakeup-to-run latencies",
+           writer.wake_latencies, args.top, unit, out)
+    report("longest run intervals", writer.run_times, args.top, unit, out)
+    report("longest interrupts", writer.isr_times, args.top, unit, out)
+
+
+if __name__ == "__main__":
+    main()